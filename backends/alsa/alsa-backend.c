@@ -41,10 +41,11 @@
 
 struct _AlsaBackendPrivate
 {
-    GSource    *timeout_source;
-    GList      *streams;
-    GList      *devices;
-    GHashTable *devices_ids;
+    GSource             *timeout_source;
+    MateMixerObjectList *streams;
+    GList               *devices;
+    GHashTable          *devices_ids;
+    gboolean             default_only;
 };
 
 static void alsa_backend_class_init     (AlsaBackendClass *klass);
@@ -62,6 +63,11 @@ static gboolean     alsa_backend_open            (MateMixerBackend *backend);
 static void         alsa_backend_close           (MateMixerBackend *backend);
 static const GList *alsa_backend_list_devices    (MateMixerBackend *backend);
 static const GList *alsa_backend_list_streams    (MateMixerBackend *backend);
+static void         alsa_backend_set_track_flags (MateMixerBackend *backend,
+                                                  MateMixerTrackFlags flags);
+
+static MateMixerStream *alsa_backend_get_stream (MateMixerBackend *backend,
+                                                 const gchar      *name);
 
 static gboolean     read_devices                 (AlsaBackend      *alsa);
 
@@ -81,10 +87,19 @@ static void         remove_device_by_list_item   (AlsaBackend      *alsa,
 static void         remove_stream                (AlsaBackend      *alsa,
                                                   const gchar      *name);
 
+static void         device_stream_added          (AlsaDevice       *device,
+                                                  const gchar      *name,
+                                                  AlsaBackend      *alsa);
+static void         device_stream_removed        (AlsaDevice       *device,
+                                                  const gchar      *name,
+                                                  AlsaBackend      *alsa);
+
 static void         select_default_input_stream  (AlsaBackend      *alsa);
 static void         select_default_output_stream (AlsaBackend      *alsa);
 
-static void         free_stream_list             (AlsaBackend      *alsa);
+static void         remove_device_streams        (AlsaBackend      *alsa,
+                                                  AlsaDevice       *device,
+                                                  const gchar      *name);
 
 static gint         compare_devices              (gconstpointer     a,
                                                   gconstpointer     b);
@@ -125,6 +140,9 @@ alsa_backend_class_init (AlsaBackendClass *klass)
     backend_class->close        = alsa_backend_close;
     backend_class->list_devices = alsa_backend_list_devices;
     backend_class->list_streams = alsa_backend_list_streams;
+    backend_class->get_stream   = alsa_backend_get_stream;
+
+    backend_class->set_track_flags = alsa_backend_set_track_flags;
 
     g_type_class_add_private (object_class, sizeof (AlsaBackendPrivate));
 }
@@ -146,6 +164,8 @@ alsa_backend_init (AlsaBackend *alsa)
                                                      g_str_equal,
                                                      g_free,
                                                      NULL);
+
+    alsa->priv->streams = _mate_mixer_object_list_new ();
 }
 
 static void
@@ -172,9 +192,26 @@ alsa_backend_finalize (GObject *object)
 
     g_hash_table_unref (alsa->priv->devices_ids);
 
+    _mate_mixer_object_list_free (alsa->priv->streams);
+
     G_OBJECT_CLASS (alsa_backend_parent_class)->finalize (object);
 }
 
+static void
+alsa_backend_set_track_flags (MateMixerBackend *backend, MateMixerTrackFlags flags)
+{
+    g_return_if_fail (ALSA_IS_BACKEND (backend));
+
+    /* Streams are not tracked individually, a device is either opened with
+     * all its streams or not at all */
+    flags &= MATE_MIXER_TRACK_INPUT_STREAMS |
+             MATE_MIXER_TRACK_OUTPUT_STREAMS |
+             MATE_MIXER_TRACK_DEFAULT_STREAMS;
+
+    ALSA_BACKEND (backend)->priv->default_only =
+        (flags == MATE_MIXER_TRACK_DEFAULT_STREAMS);
+}
+
 static gboolean
 alsa_backend_open (MateMixerBackend *backend)
 {
@@ -219,7 +256,7 @@ alsa_backend_close (MateMixerBackend *backend)
         alsa->priv->devices = NULL;
     }
 
-    free_stream_list (alsa);
+    _mate_mixer_object_list_clear (alsa->priv->streams);
 
     g_hash_table_remove_all (alsa->priv->devices_ids);
 
@@ -243,31 +280,15 @@ alsa_backend_list_streams (MateMixerBackend *backend)
 
     alsa = ALSA_BACKEND (backend);
 
-    if (alsa->priv->streams == NULL) {
-        GList *list;
-
-        /* Walk through the list of devices and create the stream list, each
-         * device has at most one input and one output stream */
-        list = g_list_last (alsa->priv->devices);
-
-        while (list != NULL) {
-            AlsaDevice *device = ALSA_DEVICE (list->data);
-            AlsaStream *stream;
-
-            stream = alsa_device_get_output_stream (device);
-            if (stream != NULL)
-                alsa->priv->streams =
-                    g_list_prepend (alsa->priv->streams, g_object_ref (stream));
+    return _mate_mixer_object_list_peek (alsa->priv->streams);
+}
 
-            stream = alsa_device_get_input_stream (device);
-            if (stream != NULL)
-                alsa->priv->streams =
-                    g_list_prepend (alsa->priv->streams, g_object_ref (stream));
+static MateMixerStream *
+alsa_backend_get_stream (MateMixerBackend *backend, const gchar *name)
+{
+    g_return_val_if_fail (ALSA_IS_BACKEND (backend), NULL);
 
-            list = list->prev;
-        }
-    }
-    return alsa->priv->streams;
+    return _mate_mixer_object_list_lookup (ALSA_BACKEND (backend)->priv->streams, name);
 }
 
 static gboolean
@@ -278,12 +299,16 @@ read_devices (AlsaBackend *alsa)
     gchar    card[16];
     gboolean added = FALSE;
 
+    /* Report all the cards found during the scan as a single topology change */
+    _mate_mixer_backend_begin_topology_change (MATE_MIXER_BACKEND (alsa));
+
     /* Read the default device first, it will be either one of the hardware cards
      * that will be queried later, or a software mixer */
     if (read_device (alsa, "default") == TRUE)
         added = TRUE;
 
-    for (num = -1;;) {
+    /* Skip the hardware cards when only the default device is wanted */
+    for (num = -1; alsa->priv->default_only == FALSE;) {
         /* Read number of the next sound card */
         ret = snd_card_next (&num);
         if (ret < 0 ||
@@ -302,6 +327,8 @@ read_devices (AlsaBackend *alsa)
         select_default_input_stream (alsa);
         select_default_output_stream (alsa);
     }
+
+    _mate_mixer_backend_end_topology_change (MATE_MIXER_BACKEND (alsa));
     return G_SOURCE_CONTINUE;
 }
 
@@ -386,18 +413,14 @@ add_device (AlsaBackend *alsa, AlsaDevice *device)
                               G_CALLBACK (remove_stream),
                               alsa);
 
-    g_signal_connect_swapped (G_OBJECT (device),
-                              "closed",
-                              G_CALLBACK (free_stream_list),
-                              alsa);
-    g_signal_connect_swapped (G_OBJECT (device),
-                              "stream-added",
-                              G_CALLBACK (free_stream_list),
-                              alsa);
-    g_signal_connect_swapped (G_OBJECT (device),
-                              "stream-removed",
-                              G_CALLBACK (free_stream_list),
-                              alsa);
+    g_signal_connect (G_OBJECT (device),
+                      "stream-added",
+                      G_CALLBACK (device_stream_added),
+                      alsa);
+    g_signal_connect (G_OBJECT (device),
+                      "stream-removed",
+                      G_CALLBACK (device_stream_removed),
+                      alsa);
 
     g_signal_emit_by_name (G_OBJECT (alsa),
                            "device-added",
@@ -451,8 +474,9 @@ remove_device_by_list_item (AlsaBackend *alsa, GList *item)
     g_hash_table_remove (alsa->priv->devices_ids,
                          ALSA_DEVICE_GET_ID (device));
 
-    /* The list may have been invalidated by device signals */
-    free_stream_list (alsa);
+    /* Closing the device should have removed its streams, but make sure
+     * none of them are left behind */
+    remove_device_streams (alsa, device, NULL);
 
     g_signal_emit_by_name (G_OBJECT (alsa),
                            "device-removed",
@@ -522,14 +546,44 @@ select_default_output_stream (AlsaBackend *alsa)
 }
 
 static void
-free_stream_list (AlsaBackend *alsa)
+device_stream_added (AlsaDevice *device, const gchar *name, AlsaBackend *alsa)
 {
-    if (alsa->priv->streams == NULL)
+    MateMixerStream *stream;
+
+    stream = mate_mixer_device_get_stream (MATE_MIXER_DEVICE (device), name);
+    if G_UNLIKELY (stream == NULL) {
+        g_warn_if_reached ();
         return;
+    }
+    _mate_mixer_object_list_append (alsa->priv->streams, stream);
+}
 
-    g_list_free_full (alsa->priv->streams, g_object_unref);
+static void
+device_stream_removed (AlsaDevice *device, const gchar *name, AlsaBackend *alsa)
+{
+    remove_device_streams (alsa, device, name);
+}
+
+static void
+remove_device_streams (AlsaBackend *alsa, AlsaDevice *device, const gchar *name)
+{
+    const GList *list;
 
-    alsa->priv->streams = NULL;
+    /* The stream can no longer be looked up on the device at this point, the
+     * list is short though as each device has at most two streams */
+    list = _mate_mixer_object_list_peek (alsa->priv->streams);
+    while (list != NULL) {
+        MateMixerStream *stream = MATE_MIXER_STREAM (list->data);
+
+        list = list->next;
+
+        if (mate_mixer_stream_get_device (stream) != MATE_MIXER_DEVICE (device))
+            continue;
+        if (name != NULL && strcmp (mate_mixer_stream_get_name (stream), name) != 0)
+            continue;
+
+        _mate_mixer_object_list_remove (alsa->priv->streams, stream);
+    }
 }
 
 static gint
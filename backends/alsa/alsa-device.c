@@ -23,6 +23,7 @@
 #include <glib-object.h>
 #include <alsa/asoundlib.h>
 #include <libmatemixer/matemixer.h>
+#include <libmatemixer/matemixer-private.h>
 
 #include "alsa-compat.h"
 #include "alsa-constants.h"
@@ -52,14 +53,14 @@
 
 struct _AlsaDevicePrivate
 {
-    snd_mixer_t  *handle;
-    GMainContext *context;
-    GMutex        mutex;
-    GCond         cond;
-    AlsaStream   *input;
-    AlsaStream   *output;
-    GList        *streams;
-    gboolean      events_pending;
+    snd_mixer_t         *handle;
+    GMainContext        *context;
+    GMutex               mutex;
+    GCond                cond;
+    AlsaStream          *input;
+    AlsaStream          *output;
+    MateMixerObjectList *streams;
+    gboolean             events_pending;
 };
 
 enum {
@@ -155,8 +156,6 @@ static void               get_switch_info           (snd_mixer_elem_t
 
 static void               close_mixer               (AlsaDevice                 *device);
 
-static void               free_stream_list          (AlsaDevice                 *device);
-
 static void
 alsa_device_class_init (AlsaDeviceClass *klass)
 {
@@ -196,6 +195,8 @@ alsa_device_init (AlsaDevice *device)
 
     g_mutex_init (&device->priv->mutex);
     g_cond_init (&device->priv->cond);
+
+    device->priv->streams = _mate_mixer_object_list_new ();
 }
 
 static void
@@ -208,7 +209,7 @@ alsa_device_dispose (GObject *object)
     g_clear_object (&device->priv->input);
     g_clear_object (&device->priv->output);
 
-    free_stream_list (device);
+    _mate_mixer_object_list_clear (device->priv->streams);
 
     G_OBJECT_CLASS (alsa_device_parent_class)->dispose (object);
 }
@@ -227,6 +228,8 @@ alsa_device_finalize (GObject *object)
 
     close_mixer (device);
 
+    _mate_mixer_object_list_free (device->priv->streams);
+
     G_OBJECT_CLASS (alsa_device_parent_class)->finalize (object);
 }
 
@@ -342,7 +345,9 @@ alsa_device_close (AlsaDevice *device)
             mate_mixer_stream_get_name (MATE_MIXER_STREAM (device->priv->input));
 
         alsa_stream_remove_all (device->priv->input);
-        free_stream_list (device);
+
+        _mate_mixer_object_list_remove (device->priv->streams,
+                                        device->priv->input);
 
         g_signal_emit_by_name (G_OBJECT (device),
                                "stream-removed",
@@ -354,7 +359,9 @@ alsa_device_close (AlsaDevice *device)
             mate_mixer_stream_get_name (MATE_MIXER_STREAM (device->priv->output));
 
         alsa_stream_remove_all (device->priv->output);
-        free_stream_list (device);
+
+        _mate_mixer_object_list_remove (device->priv->streams,
+                                        device->priv->output);
 
         g_signal_emit_by_name (G_OBJECT (device),
                                "stream-removed",
@@ -440,20 +447,7 @@ alsa_device_list_streams (MateMixerDevice *mmd)
 
     device = ALSA_DEVICE (mmd);
 
-    if (device->priv->streams == NULL) {
-        AlsaStream *stream;
-
-        stream = alsa_device_get_output_stream (device);
-        if (stream != NULL)
-            device->priv->streams =
-                g_list_prepend (device->priv->streams, g_object_ref (stream));
-
-        stream = alsa_device_get_input_stream (device);
-        if (stream != NULL)
-            device->priv->streams =
-                g_list_prepend (device->priv->streams, g_object_ref (stream));
-    }
-    return device->priv->streams;
+    return _mate_mixer_object_list_peek (device->priv->streams);
 }
 
 static void
@@ -484,7 +478,10 @@ add_element (AlsaDevice *device, AlsaStream *stream, AlsaElement *element)
         const gchar *name =
             mate_mixer_stream_get_name (MATE_MIXER_STREAM (stream));
 
-        free_stream_list (device);
+        _mate_mixer_object_list_append (device->priv->streams, stream);
+
+        _mate_mixer_device_index_stream (MATE_MIXER_DEVICE (device),
+                                         MATE_MIXER_STREAM (stream));
 
         /* Pretend the stream has just been created now that we have added
          * the first control */
@@ -767,7 +764,8 @@ remove_elements_by_name (AlsaDevice *device, const gchar *name)
             const gchar *stream_name =
                 mate_mixer_stream_get_name (MATE_MIXER_STREAM (device->priv->input));
 
-            free_stream_list (device);
+            _mate_mixer_object_list_remove (device->priv->streams,
+                                            device->priv->input);
             g_signal_emit_by_name (G_OBJECT (device),
                                    "stream-removed",
                                    stream_name);
@@ -780,7 +778,8 @@ remove_elements_by_name (AlsaDevice *device, const gchar *name)
             const gchar *stream_name =
                 mate_mixer_stream_get_name (MATE_MIXER_STREAM (device->priv->output));
 
-            free_stream_list (device);
+            _mate_mixer_object_list_remove (device->priv->streams,
+                                            device->priv->output);
             g_signal_emit_by_name (G_OBJECT (device),
                                    "stream-removed",
                                    stream_name);
@@ -1137,15 +1136,3 @@ close_mixer (AlsaDevice *device)
      device->priv->handle = NULL;
      snd_mixer_close (handle);
 }
-
-static void
-free_stream_list (AlsaDevice *device)
-{
-    /* This function is called each time the stream list changes */
-    if (device->priv->streams == NULL)
-        return;
-
-    g_list_free_full (device->priv->streams, g_object_unref);
-
-    device->priv->streams = NULL;
-}
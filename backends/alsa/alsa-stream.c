@@ -123,6 +123,9 @@ alsa_stream_add_control (AlsaStream *stream, AlsaStreamControl *control)
     stream->priv->controls =
         g_list_append (stream->priv->controls, g_object_ref (control));
 
+    _mate_mixer_stream_index_control (MATE_MIXER_STREAM (stream),
+                                      MATE_MIXER_STREAM_CONTROL (control));
+
     g_signal_emit_by_name (G_OBJECT (stream),
                            "control-added",
                            name);
@@ -144,6 +147,9 @@ alsa_stream_add_switch (AlsaStream *stream, AlsaSwitch *swtch)
     stream->priv->switches =
         g_list_append (stream->priv->switches, g_object_ref (swtch));
 
+    _mate_mixer_stream_index_switch (MATE_MIXER_STREAM (stream),
+                                     MATE_MIXER_STREAM_SWITCH (swtch));
+
     g_signal_emit_by_name (G_OBJECT (stream),
                            "switch-added",
                            name);
@@ -163,6 +169,9 @@ alsa_stream_add_toggle (AlsaStream *stream, AlsaToggle *toggle)
     stream->priv->switches =
         g_list_append (stream->priv->switches, g_object_ref (toggle));
 
+    _mate_mixer_stream_index_switch (MATE_MIXER_STREAM (stream),
+                                     MATE_MIXER_STREAM_SWITCH (toggle));
+
     g_signal_emit_by_name (G_OBJECT (stream),
                            "switch-added",
                            name);
@@ -46,11 +46,12 @@
 
 struct _OssBackendPrivate
 {
-    gchar      *default_device;
-    GSource    *timeout_source;
-    GList      *streams;
-    GList      *devices;
-    GHashTable *devices_paths;
+    gchar               *default_device;
+    GSource             *timeout_source;
+    MateMixerObjectList *streams;
+    GList               *devices;
+    GHashTable          *devices_paths;
+    gboolean             default_only;
 };
 
 static void oss_backend_class_init     (OssBackendClass *klass);
@@ -68,6 +69,11 @@ static gboolean     oss_backend_open             (MateMixerBackend *backend);
 static void         oss_backend_close            (MateMixerBackend *backend);
 static const GList *oss_backend_list_devices     (MateMixerBackend *backend);
 static const GList *oss_backend_list_streams     (MateMixerBackend *backend);
+static void         oss_backend_set_track_flags  (MateMixerBackend *backend,
+                                                  MateMixerTrackFlags flags);
+
+static MateMixerStream *oss_backend_get_stream (MateMixerBackend *backend,
+                                                const gchar      *name);
 
 static gboolean     read_devices                 (OssBackend       *oss);
 
@@ -98,10 +104,19 @@ static void         remove_device_by_list_item   (OssBackend       *oss,
 static void         remove_stream                (OssBackend       *oss,
                                                   const gchar      *name);
 
+static void         device_stream_added          (OssDevice        *device,
+                                                  const gchar      *name,
+                                                  OssBackend       *oss);
+static void         device_stream_removed        (OssDevice        *device,
+                                                  const gchar      *name,
+                                                  OssBackend       *oss);
+
 static void         select_default_input_stream  (OssBackend       *oss);
 static void         select_default_output_stream (OssBackend       *oss);
 
-static void         free_stream_list             (OssBackend       *oss);
+static void         remove_device_streams        (OssBackend       *oss,
+                                                  OssDevice        *device,
+                                                  const gchar      *name);
 
 static gint         compare_devices              (gconstpointer     a,
                                                   gconstpointer     b);
@@ -142,6 +157,9 @@ oss_backend_class_init (OssBackendClass *klass)
     backend_class->close        = oss_backend_close;
     backend_class->list_devices = oss_backend_list_devices;
     backend_class->list_streams = oss_backend_list_streams;
+    backend_class->get_stream   = oss_backend_get_stream;
+
+    backend_class->set_track_flags = oss_backend_set_track_flags;
 
     g_type_class_add_private (object_class, sizeof (OssBackendPrivate));
 }
@@ -163,6 +181,8 @@ oss_backend_init (OssBackend *oss)
                                                       g_str_equal,
                                                       g_free,
                                                       NULL);
+
+    oss->priv->streams = _mate_mixer_object_list_new ();
 }
 
 static void
@@ -189,9 +209,24 @@ oss_backend_finalize (GObject *object)
 
     g_hash_table_unref (oss->priv->devices_paths);
 
+    _mate_mixer_object_list_free (oss->priv->streams);
+
     G_OBJECT_CLASS (oss_backend_parent_class)->finalize (object);
 }
 
+static void
+oss_backend_set_track_flags (MateMixerBackend *backend, MateMixerTrackFlags flags)
+{
+    g_return_if_fail (OSS_IS_BACKEND (backend));
+
+    flags &= MATE_MIXER_TRACK_INPUT_STREAMS |
+             MATE_MIXER_TRACK_OUTPUT_STREAMS |
+             MATE_MIXER_TRACK_DEFAULT_STREAMS;
+
+    OSS_BACKEND (backend)->priv->default_only =
+        (flags == MATE_MIXER_TRACK_DEFAULT_STREAMS);
+}
+
 static gboolean
 oss_backend_open (MateMixerBackend *backend)
 {
@@ -239,7 +274,7 @@ oss_backend_close (MateMixerBackend *backend)
         oss->priv->default_device = NULL;
     }
 
-    free_stream_list (oss);
+    _mate_mixer_object_list_clear (oss->priv->streams);
 
     g_hash_table_remove_all (oss->priv->devices_paths);
 
@@ -263,31 +298,15 @@ oss_backend_list_streams (MateMixerBackend *backend)
 
     oss = OSS_BACKEND (backend);
 
-    if (oss->priv->streams == NULL) {
-        GList *list;
-
-        /* Walk through the list of devices and create the stream list, each
-         * device has at most one input and one output stream */
-        list = g_list_last (oss->priv->devices);
-
-        while (list != NULL) {
-            OssDevice *device = OSS_DEVICE (list->data);
-            OssStream *stream;
-
-            stream = oss_device_get_output_stream (device);
-            if (stream != NULL)
-                oss->priv->streams =
-                    g_list_prepend (oss->priv->streams, g_object_ref (stream));
+    return _mate_mixer_object_list_peek (oss->priv->streams);
+}
 
-            stream = oss_device_get_input_stream (device);
-            if (stream != NULL)
-                oss->priv->streams =
-                    g_list_prepend (oss->priv->streams, g_object_ref (stream));
+static MateMixerStream *
+oss_backend_get_stream (MateMixerBackend *backend, const gchar *name)
+{
+    g_return_val_if_fail (OSS_IS_BACKEND (backend), NULL);
 
-            list = list->prev;
-        }
-    }
-    return oss->priv->streams;
+    return _mate_mixer_object_list_lookup (OSS_BACKEND (backend)->priv->streams, name);
 }
 
 static gboolean
@@ -296,6 +315,8 @@ read_devices (OssBackend *oss)
     gint     i;
     gboolean added = FALSE;
 
+    _mate_mixer_backend_begin_topology_change (MATE_MIXER_BACKEND (oss));
+
     for (i = 0; i < OSS_MAX_DEVICES; i++) {
         gchar   *path;
         gboolean added_current;
@@ -314,6 +335,10 @@ read_devices (OssBackend *oss)
             added = TRUE;
 
         g_free (path);
+
+        /* The first device is the default one */
+        if (oss->priv->default_only == TRUE)
+            break;
     }
 
     /* If any card has been added, make sure we have the most suitable default
@@ -322,6 +347,8 @@ read_devices (OssBackend *oss)
         select_default_input_stream (oss);
         select_default_output_stream (oss);
     }
+
+    _mate_mixer_backend_end_topology_change (MATE_MIXER_BACKEND (oss));
     return G_SOURCE_CONTINUE;
 }
 
@@ -487,18 +514,14 @@ add_device (OssBackend *oss, OssDevice *device)
                               G_CALLBACK (remove_stream),
                               oss);
 
-    g_signal_connect_swapped (G_OBJECT (device),
-                              "closed",
-                              G_CALLBACK (free_stream_list),
-                              oss);
-    g_signal_connect_swapped (G_OBJECT (device),
-                              "stream-added",
-                              G_CALLBACK (free_stream_list),
-                              oss);
-    g_signal_connect_swapped (G_OBJECT (device),
-                              "stream-removed",
-                              G_CALLBACK (free_stream_list),
-                              oss);
+    g_signal_connect (G_OBJECT (device),
+                      "stream-added",
+                      G_CALLBACK (device_stream_added),
+                      oss);
+    g_signal_connect (G_OBJECT (device),
+                      "stream-removed",
+                      G_CALLBACK (device_stream_removed),
+                      oss);
 
     g_signal_emit_by_name (G_OBJECT (oss),
                            "device-added",
@@ -558,8 +581,9 @@ remove_device_by_list_item (OssBackend *oss, GList *item)
         oss->priv->default_device = NULL;
     }
 
-    /* The list may have been invalidated by device signals */
-    free_stream_list (oss);
+    /* Closing the device should have removed its streams, but make sure
+     * none of them are left behind */
+    remove_device_streams (oss, device, NULL);
 
     g_signal_emit_by_name (G_OBJECT (oss),
                            "device-removed",
@@ -670,14 +694,42 @@ select_default_output_stream (OssBackend *oss)
 }
 
 static void
-free_stream_list (OssBackend *oss)
+device_stream_added (OssDevice *device, const gchar *name, OssBackend *oss)
 {
-    if (oss->priv->streams == NULL)
+    MateMixerStream *stream;
+
+    stream = mate_mixer_device_get_stream (MATE_MIXER_DEVICE (device), name);
+    if G_UNLIKELY (stream == NULL) {
+        g_warn_if_reached ();
         return;
+    }
+    _mate_mixer_object_list_append (oss->priv->streams, stream);
+}
 
-    g_list_free_full (oss->priv->streams, g_object_unref);
+static void
+device_stream_removed (OssDevice *device, const gchar *name, OssBackend *oss)
+{
+    remove_device_streams (oss, device, name);
+}
+
+static void
+remove_device_streams (OssBackend *oss, OssDevice *device, const gchar *name)
+{
+    const GList *list;
+
+    list = _mate_mixer_object_list_peek (oss->priv->streams);
+    while (list != NULL) {
+        MateMixerStream *stream = MATE_MIXER_STREAM (list->data);
 
-    oss->priv->streams = NULL;
+        list = list->next;
+
+        if (mate_mixer_stream_get_device (stream) != MATE_MIXER_DEVICE (device))
+            continue;
+        if (name != NULL && strcmp (mate_mixer_stream_get_name (stream), name) != 0)
+            continue;
+
+        _mate_mixer_object_list_remove (oss->priv->streams, stream);
+    }
 }
 
 static gint
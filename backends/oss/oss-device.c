@@ -157,19 +157,19 @@ static const gint oss_output_priority[] = {
 
 struct _OssDevicePrivate
 {
-    gint        fd;
-    gchar      *path;
-    gint        devmask;
-    gint        stereodevs;
-    gint        recmask;
-    guint       poll_tag;
-    guint       poll_tag_restore;
-    guint       poll_counter;
-    gboolean    poll_use_counter;
-    OssPollMode poll_mode;
-    GList      *streams;
-    OssStream  *input;
-    OssStream  *output;
+    gint                 fd;
+    gchar               *path;
+    gint                 devmask;
+    gint                 stereodevs;
+    gint                 recmask;
+    guint                poll_tag;
+    guint                poll_tag_restore;
+    guint                poll_counter;
+    gboolean             poll_use_counter;
+    OssPollMode          poll_mode;
+    MateMixerObjectList *streams;
+    OssStream           *input;
+    OssStream           *output;
 };
 
 enum {
@@ -198,7 +198,6 @@ static guint        create_poll_source            (OssDevice       *device,
                                                    OssPollMode      mode);
 static guint        create_poll_restore_source    (OssDevice       *device);
 
-static void         free_stream_list              (OssDevice       *device);
 
 static gint         compare_stream_control_devnum (gconstpointer    a,
                                                    gconstpointer    b);
@@ -237,6 +236,8 @@ oss_device_init (OssDevice *device)
     device->priv = G_TYPE_INSTANCE_GET_PRIVATE (device,
                                                 OSS_TYPE_DEVICE,
                                                 OssDevicePrivate);
+
+    device->priv->streams = _mate_mixer_object_list_new ();
 }
 
 static void
@@ -249,7 +250,7 @@ oss_device_dispose (GObject *object)
     g_clear_object (&device->priv->input);
     g_clear_object (&device->priv->output);
 
-    free_stream_list (device);
+    _mate_mixer_object_list_clear (device->priv->streams);
 
     G_OBJECT_CLASS (oss_device_parent_class)->dispose (object);
 }
@@ -264,6 +265,8 @@ oss_device_finalize (GObject *object)
 
     g_free (device->priv->path);
 
+    _mate_mixer_object_list_free (device->priv->streams);
+
     G_OBJECT_CLASS (oss_device_parent_class)->finalize (object);
 }
 
@@ -366,7 +369,9 @@ oss_device_close (OssDevice *device)
             mate_mixer_stream_get_name (MATE_MIXER_STREAM (device->priv->input));
 
         oss_stream_remove_all (device->priv->input);
-        free_stream_list (device);
+
+        _mate_mixer_object_list_remove (device->priv->streams,
+                                        device->priv->input);
 
         g_signal_emit_by_name (G_OBJECT (device),
                                "stream-removed",
@@ -380,7 +385,9 @@ oss_device_close (OssDevice *device)
             mate_mixer_stream_get_name (MATE_MIXER_STREAM (device->priv->output));
 
         oss_stream_remove_all (device->priv->output);
-        free_stream_list (device);
+
+        _mate_mixer_object_list_remove (device->priv->streams,
+                                        device->priv->output);
 
         g_signal_emit_by_name (G_OBJECT (device),
                                "stream-removed",
@@ -425,6 +432,9 @@ oss_device_load (OssDevice *device)
                                            MATE_MIXER_DIRECTION_OUTPUT);
     g_free (stream_name);
 
+    _mate_mixer_object_list_append (device->priv->streams, device->priv->input);
+    _mate_mixer_object_list_append (device->priv->streams, device->priv->output);
+
     read_mixer_devices (device);
 
     /* Set default input control */
@@ -533,16 +543,7 @@ oss_device_list_streams (MateMixerDevice *mmd)
 
     device = OSS_DEVICE (mmd);
 
-    if (device->priv->streams == NULL) {
-        if (device->priv->output != NULL)
-            device->priv->streams = g_list_prepend (device->priv->streams,
-                                                    g_object_ref (device->priv->output));
-
-        if (device->priv->input != NULL)
-            device->priv->streams = g_list_prepend (device->priv->streams,
-                                                    g_object_ref (device->priv->input));
-    }
-    return device->priv->streams;
+    return _mate_mixer_object_list_peek (device->priv->streams);
 }
 
 #define OSS_MASK_HAS_DEVICE(mask,i) ((gboolean) (((mask) & (1 << (i))) > 0))
@@ -599,7 +600,8 @@ read_mixer_devices (OssDevice *device)
             const gchar *name =
                 mate_mixer_stream_get_name (MATE_MIXER_STREAM (stream));
 
-            free_stream_list (device);
+            _mate_mixer_device_index_stream (MATE_MIXER_DEVICE (device),
+                                             MATE_MIXER_STREAM (stream));
 
             /* Pretend the stream has just been created now that we are adding
              * the first control */
@@ -775,18 +777,6 @@ create_poll_restore_source (OssDevice *device)
     return tag;
 }
 
-static void
-free_stream_list (OssDevice *device)
-{
-    /* This function is called each time the stream list changes */
-    if (device->priv->streams == NULL)
-        return;
-
-    g_list_free_full (device->priv->streams, g_object_unref);
-
-    device->priv->streams = NULL;
-}
-
 static gint
 compare_stream_control_devnum (gconstpointer a, gconstpointer b)
 {
@@ -122,6 +122,9 @@ oss_stream_add_control (OssStream *stream, OssStreamControl *control)
     stream->priv->controls =
         g_list_append (stream->priv->controls, g_object_ref (control));
 
+    _mate_mixer_stream_index_control (MATE_MIXER_STREAM (stream),
+                                      MATE_MIXER_STREAM_CONTROL (control));
+
     g_signal_emit_by_name (G_OBJECT (stream),
                            "control-added",
                            name);
@@ -221,6 +224,9 @@ oss_stream_set_switch_data (OssStream *stream, gint fd, GList *options)
     oss_switch_load (stream->priv->swtch);
 
     stream->priv->switches = g_list_prepend (NULL, g_object_ref (stream->priv->swtch));
+
+    _mate_mixer_stream_index_switch (MATE_MIXER_STREAM (stream),
+                                     MATE_MIXER_STREAM_SWITCH (stream->priv->swtch));
     g_signal_emit_by_name (G_OBJECT (stream),
                            "switch-added",
                            OSS_STREAM_SWITCH_NAME);
@@ -29,8 +29,11 @@
 #include "pulse-connection.h"
 #include "pulse-device.h"
 #include "pulse-enums.h"
+#include "pulse-ext-entry.h"
 #include "pulse-ext-stream.h"
+#include "pulse-monitor.h"
 #include "pulse-stream.h"
+#include "pulse-stream-control.h"
 #include "pulse-sink.h"
 #include "pulse-sink-input.h"
 #include "pulse-source.h"
@@ -43,22 +46,39 @@
                            MATE_MIXER_BACKEND_CAN_SET_DEFAULT_INPUT_STREAM |    \
                            MATE_MIXER_BACKEND_CAN_SET_DEFAULT_OUTPUT_STREAM)
 
+/* Bounds of the delay between reconnection attempts in milliseconds */
+#define RECONNECT_DELAY_MIN  100
+#define RECONNECT_DELAY_MAX  5000
+
 struct _PulseBackendPrivate
 {
-    guint             connect_tag;
-    gboolean          connected_once;
-    GHashTable       *devices;
-    GHashTable       *sinks;
-    GHashTable       *sources;
-    GHashTable       *sink_input_map;
-    GHashTable       *source_output_map;
-    GHashTable       *ext_streams;
-    GList            *devices_list;
-    GList            *streams_list;
-    GList            *ext_streams_list;
-    MateMixerAppInfo *app_info;
-    gchar            *server_address;
-    PulseConnection  *connection;
+    guint                connect_tag;
+    guint                connect_delay;
+    gboolean             connected_once;
+    gboolean             connection_busy;
+    gboolean             ready_pending;
+    guint32              server_cookie;
+    GHashTable          *devices;
+    GHashTable          *sinks;
+    GHashTable          *sources;
+    GHashTable          *sink_input_map;
+    GHashTable          *source_output_map;
+    GHashTable          *ext_streams;
+    GHashTable          *ext_entries;
+    guint                ext_entries_generation;
+    guint                ext_entries_seen;
+    GHashTable          *hanging_devices;
+    GHashTable          *hanging_sinks;
+    GHashTable          *hanging_sources;
+    GHashTable          *hanging_sink_inputs;
+    GHashTable          *hanging_source_outputs;
+    MateMixerObjectList *devices_list;
+    MateMixerObjectList *streams_list;
+    MateMixerObjectList *ext_streams_list;
+    MateMixerAppInfo    *app_info;
+    gchar               *server_address;
+    MateMixerTrackFlags  track_flags;
+    PulseConnection     *connection;
 };
 
 #define PULSE_CHANGE_STATE(p, s)        \
@@ -72,6 +92,15 @@ struct _PulseBackendPrivate
 #define PULSE_SET_DEFAULT_SOURCE(p, s)  \
     (_mate_mixer_backend_set_default_input_stream (MATE_MIXER_BACKEND (p), MATE_MIXER_STREAM (s)))
 
+#define PULSE_DEFAULT_SINK_ONLY(p)                                      \
+        (((p)->priv->track_flags & (MATE_MIXER_TRACK_OUTPUT_STREAMS |   \
+                                    MATE_MIXER_TRACK_DEFAULT_STREAMS))  \
+         == MATE_MIXER_TRACK_DEFAULT_STREAMS)
+#define PULSE_DEFAULT_SOURCE_ONLY(p)                                    \
+        (((p)->priv->track_flags & (MATE_MIXER_TRACK_INPUT_STREAMS |    \
+                                    MATE_MIXER_TRACK_DEFAULT_STREAMS))  \
+         == MATE_MIXER_TRACK_DEFAULT_STREAMS)
+
 #define PULSE_GET_PENDING_SINK(p)                                       \
         (g_object_get_data (G_OBJECT (p),                               \
                             "__matemixer_pulse_pending_sink"))          \
@@ -102,18 +131,6 @@ struct _PulseBackendPrivate
                             "__matemixer_pulse_pending_source",         \
                             NULL))
 
-#define PULSE_GET_HANGING(o)                                            \
-        ((gboolean) GPOINTER_TO_UINT (g_object_get_data (G_OBJECT (o), "__matemixer_pulse_hanging")))
-
-#define PULSE_SET_HANGING(o)                                            \
-        (g_object_set_data (G_OBJECT (o),                               \
-                            "__matemixer_pulse_hanging",                \
-                            GUINT_TO_POINTER (1)))
-
-#define PULSE_UNSET_HANGING(o)                                          \
-        (g_object_steal_data (G_OBJECT (o),                             \
-                              "__matemixer_pulse_hanging"))
-
 static void pulse_backend_class_init     (PulseBackendClass *klass);
 static void pulse_backend_class_finalize (PulseBackendClass *klass);
 
@@ -135,10 +152,28 @@ static void             pulse_backend_set_app_info              (MateMixerBacken
 static void             pulse_backend_set_server_address        (MateMixerBackend *backend,
                                                                  const gchar      *address);
 
+static void             pulse_backend_set_track_flags           (MateMixerBackend *backend,
+                                                                 MateMixerTrackFlags flags);
+
 static const GList *    pulse_backend_list_devices              (MateMixerBackend *backend);
 static const GList *    pulse_backend_list_streams              (MateMixerBackend *backend);
 static const GList *    pulse_backend_list_stored_controls      (MateMixerBackend *backend);
 
+static MateMixerDevice *       pulse_backend_get_device         (MateMixerBackend *backend,
+                                                                 const gchar      *name);
+static MateMixerStream *       pulse_backend_get_stream         (MateMixerBackend *backend,
+                                                                 const gchar      *name);
+static MateMixerStoredControl *pulse_backend_get_stored_control (MateMixerBackend *backend,
+                                                                 const gchar      *name);
+
+static GPtrArray *      pulse_backend_match_stored_controls     (MateMixerBackend      *backend,
+                                                                 MateMixerBackendMatch  match,
+                                                                 guint                  value,
+                                                                 const gchar           *string);
+static gboolean         pulse_backend_get_stored_control_states (MateMixerBackend *backend,
+                                                                 GArray           *states,
+                                                                 GArray           *volumes);
+
 static gboolean         pulse_backend_set_default_input_stream  (MateMixerBackend *backend,
                                                                  MateMixerStream  *stream);
 
@@ -149,6 +184,10 @@ static void             on_connection_state_notify          (PulseConnection
                                                              GParamSpec                       *pspec,
                                                              PulseBackend                     *pulse);
 
+static void             on_connection_busy_notify           (PulseConnection                  *connection,
+                                                             GParamSpec                       *pspec,
+                                                             PulseBackend                     *pulse);
+
 static void             on_connection_server_info           (PulseConnection                  *connection,
                                                              const pa_server_info             *info,
                                                              PulseBackend                     *pulse);
@@ -190,14 +229,63 @@ static void             on_connection_ext_stream_loaded     (PulseConnection
 static void             on_connection_ext_stream_info       (PulseConnection                  *connection,
                                                              const pa_ext_stream_restore_info *info,
                                                              PulseBackend                     *pulse);
+static void             on_connection_list_loaded           (PulseConnection                  *connection,
+                                                             guint                             flags,
+                                                             PulseBackend                     *pulse);
 
 static gboolean         source_try_connect                  (PulseBackend                     *pulse);
 
+static void             schedule_reconnect                  (PulseBackend                     *pulse);
+
+static void             mark_hanging                        (PulseBackend                     *pulse);
+
+static PulseDevice *    adopt_device                        (PulseBackend                     *pulse,
+                                                             guint32                           index,
+                                                             const gchar                      *name);
+static PulseStream *    adopt_stream                        (GHashTable                       *streams,
+                                                             GHashTable                       *hanging,
+                                                             guint32                           index,
+                                                             const gchar                      *name,
+                                                             PulseDevice                      *device);
+
+static void             remove_hanging_sink                 (PulseBackend                     *pulse,
+                                                             PulseStream                      *stream);
+static void             remove_hanging_source               (PulseBackend                     *pulse,
+                                                             PulseStream                      *stream);
+
+static void             remove_hanging_devices              (PulseBackend                     *pulse);
+static void             remove_hanging_sinks                (PulseBackend                     *pulse);
+static void             remove_hanging_sources              (PulseBackend                     *pulse);
+static void             remove_hanging_sink_inputs          (PulseBackend                     *pulse);
+static void             remove_hanging_source_outputs       (PulseBackend                     *pulse);
+
+static void             restart_monitors                    (PulseBackend                     *pulse);
+static void             restart_stream_monitors             (PulseStream                      *stream);
+
+static void             remove_sink                         (PulseBackend                     *pulse,
+                                                             PulseStream                      *stream);
+static void             remove_source                       (PulseBackend                     *pulse,
+                                                             PulseStream                      *stream);
+
 static void             check_pending_sink                  (PulseBackend                     *pulse,
                                                              PulseStream                      *stream);
 static void             check_pending_source                (PulseBackend                     *pulse,
                                                              PulseStream                      *stream);
 
+static void             follow_default_sink                 (PulseBackend                     *pulse);
+static void             follow_default_source               (PulseBackend                     *pulse);
+
+static void             check_ready                         (PulseBackend                     *pulse);
+
+static PulseExtStream * create_ext_stream                   (PulseBackend                     *pulse,
+                                                             PulseExtEntry                    *entry);
+static PulseStream *    find_ext_stream_parent              (PulseBackend                     *pulse,
+                                                             const gchar                      *device);
+
+static gboolean         is_ext_stream_current               (PulseBackend                     *pulse,
+                                                             PulseExtStream                   *ext,
+                                                             const pa_ext_stream_restore_info *info);
+
 static void             remove_sink_input                   (PulseBackend                     *backend,
                                                              PulseSink                        *sink,
                                                              guint                             index);
@@ -205,13 +293,16 @@ static void             remove_source_output                (PulseBackend
                                                              PulseSource                      *source,
                                                              guint                             index);
 
-static void             free_list_devices                   (PulseBackend                     *pulse);
-static void             free_list_streams                   (PulseBackend                     *pulse);
-static void             free_list_ext_streams               (PulseBackend                     *pulse);
+static gboolean         is_source_output_ignored            (const pa_source_output_info      *info);
 
 static gboolean         compare_stream_names                (gpointer                          key,
                                                              gpointer                          value,
                                                              gpointer                          user_data);
+static gboolean         compare_streams                     (gpointer                          key,
+                                                             gpointer                          value,
+                                                             gpointer                          user_data);
+
+static PulseConnectionLoadFlags get_load_flags              (PulseBackend                     *pulse);
 
 static MateMixerBackendInfo info;
 
@@ -245,11 +336,17 @@ pulse_backend_class_init (PulseBackendClass *klass)
     backend_class = MATE_MIXER_BACKEND_CLASS (klass);
     backend_class->set_app_info              = pulse_backend_set_app_info;
     backend_class->set_server_address        = pulse_backend_set_server_address;
+    backend_class->set_track_flags           = pulse_backend_set_track_flags;
     backend_class->open                      = pulse_backend_open;
     backend_class->close                     = pulse_backend_close;
     backend_class->list_devices              = pulse_backend_list_devices;
     backend_class->list_streams              = pulse_backend_list_streams;
     backend_class->list_stored_controls      = pulse_backend_list_stored_controls;
+    backend_class->get_device                = pulse_backend_get_device;
+    backend_class->get_stream                = pulse_backend_get_stream;
+    backend_class->get_stored_control        = pulse_backend_get_stored_control;
+    backend_class->match_stored_controls     = pulse_backend_match_stored_controls;
+    backend_class->get_stored_control_states = pulse_backend_get_stored_control_states;
     backend_class->set_default_input_stream  = pulse_backend_set_default_input_stream;
     backend_class->set_default_output_stream = pulse_backend_set_default_output_stream;
 
@@ -286,12 +383,21 @@ pulse_backend_init (PulseBackend *pulse)
                                NULL,
                                g_object_unref);
 
+    /* Keys are the shared names owned by the PulseExtStream instances */
     pulse->priv->ext_streams =
         g_hash_table_new_full (g_str_hash,
                                g_str_equal,
-                               g_free,
+                               NULL,
                                g_object_unref);
 
+    /* Rows of the stream-restore database keyed by their shared names, a
+     * PulseExtStream is only created for the rows requested by the user */
+    pulse->priv->ext_entries =
+        g_hash_table_new_full (g_str_hash,
+                               g_str_equal,
+                               NULL,
+                               (GDestroyNotify) pulse_ext_entry_free);
+
     pulse->priv->sink_input_map =
         g_hash_table_new_full (g_direct_hash,
                                g_direct_equal,
@@ -302,6 +408,39 @@ pulse_backend_init (PulseBackend *pulse)
                                g_direct_equal,
                                NULL,
                                g_object_unref);
+
+    /* Devices and streams which existed before the connection was lost, keyed
+     * by their names as the indexes change when the server restarts */
+    pulse->priv->hanging_devices =
+        g_hash_table_new_full (g_str_hash,
+                               g_str_equal,
+                               NULL,
+                               g_object_unref);
+    pulse->priv->hanging_sinks =
+        g_hash_table_new_full (g_str_hash,
+                               g_str_equal,
+                               NULL,
+                               g_object_unref);
+    pulse->priv->hanging_sources =
+        g_hash_table_new_full (g_str_hash,
+                               g_str_equal,
+                               NULL,
+                               g_object_unref);
+
+    /* Sets of the sink input and source output indexes */
+    pulse->priv->hanging_sink_inputs =
+        g_hash_table_new (g_direct_hash, g_direct_equal);
+    pulse->priv->hanging_source_outputs =
+        g_hash_table_new (g_direct_hash, g_direct_equal);
+
+    /* Lists returned by the list_* functions, these are kept in sync with
+     * the hash tables above */
+    pulse->priv->devices_list     = _mate_mixer_object_list_new ();
+    pulse->priv->streams_list     = _mate_mixer_object_list_new ();
+    pulse->priv->ext_streams_list = _mate_mixer_object_list_new ();
+
+    pulse->priv->track_flags   = MATE_MIXER_TRACK_ALL;
+    pulse->priv->connect_delay = RECONNECT_DELAY_MIN;
 }
 
 static void
@@ -333,8 +472,18 @@ pulse_backend_finalize (GObject *object)
     g_hash_table_unref (pulse->priv->sinks);
     g_hash_table_unref (pulse->priv->sources);
     g_hash_table_unref (pulse->priv->ext_streams);
+    g_hash_table_unref (pulse->priv->ext_entries);
     g_hash_table_unref (pulse->priv->sink_input_map);
     g_hash_table_unref (pulse->priv->source_output_map);
+    g_hash_table_unref (pulse->priv->hanging_devices);
+    g_hash_table_unref (pulse->priv->hanging_sinks);
+    g_hash_table_unref (pulse->priv->hanging_sources);
+    g_hash_table_unref (pulse->priv->hanging_sink_inputs);
+    g_hash_table_unref (pulse->priv->hanging_source_outputs);
+
+    _mate_mixer_object_list_free (pulse->priv->devices_list);
+    _mate_mixer_object_list_free (pulse->priv->streams_list);
+    _mate_mixer_object_list_free (pulse->priv->ext_streams_list);
 
     G_OBJECT_CLASS (pulse_backend_parent_class)->finalize (object);
 }
@@ -363,7 +512,8 @@ pulse_backend_open (MateMixerBackend *backend)
                                        PULSE_APP_ID (pulse),
                                        PULSE_APP_VERSION (pulse),
                                        PULSE_APP_ICON (pulse),
-                                       pulse->priv->server_address);
+                                       pulse->priv->server_address,
+                                       get_load_flags (pulse));
 
     /* No connection attempt is made during the construction of the connection,
      * but it sets up the PulseAudio structures, which might fail in an
@@ -377,6 +527,10 @@ pulse_backend_open (MateMixerBackend *backend)
                       "notify::state",
                       G_CALLBACK (on_connection_state_notify),
                       pulse);
+    g_signal_connect (G_OBJECT (connection),
+                      "notify::busy",
+                      G_CALLBACK (on_connection_busy_notify),
+                      pulse);
     g_signal_connect (G_OBJECT (connection),
                       "server-info",
                       G_CALLBACK (on_connection_server_info),
@@ -433,6 +587,10 @@ pulse_backend_open (MateMixerBackend *backend)
                       "ext-stream-info",
                       G_CALLBACK (on_connection_ext_stream_info),
                       pulse);
+    g_signal_connect (G_OBJECT (connection),
+                      "list-loaded",
+                      G_CALLBACK (on_connection_list_loaded),
+                      pulse);
 
     PULSE_CHANGE_STATE (backend, MATE_MIXER_STATE_CONNECTING);
 
@@ -469,18 +627,32 @@ pulse_backend_close (MateMixerBackend *backend)
         g_clear_object (&pulse->priv->connection);
     }
 
-    free_list_devices (pulse);
-    free_list_streams (pulse);
-    free_list_ext_streams (pulse);
+    _mate_mixer_object_list_clear (pulse->priv->devices_list);
+    _mate_mixer_object_list_clear (pulse->priv->streams_list);
+    _mate_mixer_object_list_clear (pulse->priv->ext_streams_list);
 
     g_hash_table_remove_all (pulse->priv->devices);
     g_hash_table_remove_all (pulse->priv->sinks);
     g_hash_table_remove_all (pulse->priv->sources);
     g_hash_table_remove_all (pulse->priv->ext_streams);
+    g_hash_table_remove_all (pulse->priv->ext_entries);
     g_hash_table_remove_all (pulse->priv->sink_input_map);
     g_hash_table_remove_all (pulse->priv->source_output_map);
+    g_hash_table_remove_all (pulse->priv->hanging_devices);
+    g_hash_table_remove_all (pulse->priv->hanging_sinks);
+    g_hash_table_remove_all (pulse->priv->hanging_sources);
+    g_hash_table_remove_all (pulse->priv->hanging_sink_inputs);
+    g_hash_table_remove_all (pulse->priv->hanging_source_outputs);
 
     pulse->priv->connected_once = FALSE;
+    pulse->priv->connect_delay  = RECONNECT_DELAY_MIN;
+    pulse->priv->server_cookie  = 0;
+    pulse->priv->ready_pending  = FALSE;
+
+    if (pulse->priv->connection_busy == TRUE) {
+        pulse->priv->connection_busy = FALSE;
+        _mate_mixer_backend_end_topology_change (backend);
+    }
 
     PULSE_CHANGE_STATE (pulse, MATE_MIXER_STATE_IDLE);
 }
@@ -511,6 +683,14 @@ pulse_backend_set_server_address (MateMixerBackend *backend, const gchar *addres
     PULSE_BACKEND (backend)->priv->server_address = g_strdup (address);
 }
 
+static void
+pulse_backend_set_track_flags (MateMixerBackend *backend, MateMixerTrackFlags flags)
+{
+    g_return_if_fail (PULSE_IS_BACKEND (backend));
+
+    PULSE_BACKEND (backend)->priv->track_flags = flags;
+}
+
 static const GList *
 pulse_backend_list_devices (MateMixerBackend *backend)
 {
@@ -520,12 +700,7 @@ pulse_backend_list_devices (MateMixerBackend *backend)
 
     pulse = PULSE_BACKEND (backend);
 
-    if (pulse->priv->devices_list == NULL) {
-        pulse->priv->devices_list = g_hash_table_get_values (pulse->priv->devices);
-        if (pulse->priv->devices_list != NULL)
-            g_list_foreach (pulse->priv->devices_list, (GFunc) g_object_ref, NULL);
-    }
-    return pulse->priv->devices_list;
+    return _mate_mixer_object_list_peek (pulse->priv->devices_list);
 }
 
 static const GList *
@@ -537,38 +712,172 @@ pulse_backend_list_streams (MateMixerBackend *backend)
 
     pulse = PULSE_BACKEND (backend);
 
-    if (pulse->priv->streams_list == NULL) {
-        GList *sinks;
-        GList *sources;
+    return _mate_mixer_object_list_peek (pulse->priv->streams_list);
+}
+
+static const GList *
+pulse_backend_list_stored_controls (MateMixerBackend *backend)
+{
+    PulseBackend *pulse;
+
+    g_return_val_if_fail (PULSE_IS_BACKEND (backend), NULL);
 
-        sinks = g_hash_table_get_values (pulse->priv->sinks);
-        if (sinks != NULL)
-            g_list_foreach (sinks, (GFunc) g_object_ref, NULL);
+    pulse = PULSE_BACKEND (backend);
+
+    /* Create the ext-streams which have not been requested yet, request them
+     * through the backend so that they are indexed as well */
+    if (g_hash_table_size (pulse->priv->ext_streams) <
+        g_hash_table_size (pulse->priv->ext_entries)) {
+        GHashTableIter iter;
+        gpointer       name;
 
-        sources = g_hash_table_get_values (pulse->priv->sources);
-        if (sources != NULL)
-            g_list_foreach (sources, (GFunc) g_object_ref, NULL);
+        g_hash_table_iter_init (&iter, pulse->priv->ext_entries);
 
-        pulse->priv->streams_list = g_list_concat (sinks, sources);
+        while (g_hash_table_iter_next (&iter, &name, NULL) == TRUE) {
+            if (g_hash_table_contains (pulse->priv->ext_streams, name) == FALSE)
+                mate_mixer_backend_get_stored_control (backend, name);
+        }
     }
-    return pulse->priv->streams_list;
+    return _mate_mixer_object_list_peek (pulse->priv->ext_streams_list);
 }
 
-static const GList *
-pulse_backend_list_stored_controls (MateMixerBackend *backend)
+static MateMixerDevice *
+pulse_backend_get_device (MateMixerBackend *backend, const gchar *name)
 {
-    PulseBackend *pulse;
+    g_return_val_if_fail (PULSE_IS_BACKEND (backend), NULL);
+
+    return _mate_mixer_object_list_lookup (PULSE_BACKEND (backend)->priv->devices_list, name);
+}
+
+static MateMixerStream *
+pulse_backend_get_stream (MateMixerBackend *backend, const gchar *name)
+{
+    g_return_val_if_fail (PULSE_IS_BACKEND (backend), NULL);
+
+    return _mate_mixer_object_list_lookup (PULSE_BACKEND (backend)->priv->streams_list, name);
+}
+
+static MateMixerStoredControl *
+pulse_backend_get_stored_control (MateMixerBackend *backend, const gchar *name)
+{
+    PulseBackend   *pulse;
+    PulseExtEntry  *entry;
+    PulseExtStream *ext;
+
+    g_return_val_if_fail (PULSE_IS_BACKEND (backend), NULL);
+
+    pulse = PULSE_BACKEND (backend);
+
+    ext = g_hash_table_lookup (pulse->priv->ext_streams, name);
+    if (ext != NULL)
+        return MATE_MIXER_STORED_CONTROL (ext);
+
+    entry = g_hash_table_lookup (pulse->priv->ext_entries, name);
+    if (entry == NULL)
+        return NULL;
+
+    ext = create_ext_stream (pulse, entry);
+    if G_UNLIKELY (ext == NULL)
+        return NULL;
+
+    return MATE_MIXER_STORED_CONTROL (ext);
+}
+
+static GPtrArray *
+pulse_backend_match_stored_controls (MateMixerBackend      *backend,
+                                     MateMixerBackendMatch  match,
+                                     guint                  value,
+                                     const gchar           *string)
+{
+    PulseBackend   *pulse;
+    GPtrArray      *names;
+    GHashTableIter  iter;
+    gpointer        name;
 
     g_return_val_if_fail (PULSE_IS_BACKEND (backend), NULL);
 
     pulse = PULSE_BACKEND (backend);
+    names = g_ptr_array_new ();
+
+    /* Everything the stored controls are matched by is encoded in the name
+     * of the entry, so the ext-streams do not need to be created */
+    g_hash_table_iter_init (&iter, pulse->priv->ext_entries);
+
+    while (g_hash_table_iter_next (&iter, &name, NULL) == TRUE) {
+        MateMixerDirection              direction;
+        MateMixerStreamControlRole      role;
+        MateMixerStreamControlMediaRole media_role;
+        const gchar                    *app_id;
+        const gchar                    *app_name;
+        gboolean                        matches = FALSE;
+
+        pulse_ext_stream_parse_name (name,
+                                     &direction,
+                                     &role,
+                                     &media_role,
+                                     &app_id,
+                                     &app_name);
+        switch (match) {
+        case MATE_MIXER_BACKEND_MATCH_ROLE:
+            matches = (role == (MateMixerStreamControlRole) value);
+            break;
+        case MATE_MIXER_BACKEND_MATCH_MEDIA_ROLE:
+            matches = (media_role == (MateMixerStreamControlMediaRole) value);
+            break;
+        case MATE_MIXER_BACKEND_MATCH_APP_ID:
+            matches = (g_strcmp0 (app_id, string) == 0);
+            break;
+        case MATE_MIXER_BACKEND_MATCH_APP_NAME:
+            matches = (g_strcmp0 (app_name, string) == 0);
+            break;
+        }
+
+        if (matches == TRUE)
+            g_ptr_array_add (names, name);
+    }
+    return names;
+}
+
+static gboolean
+pulse_backend_get_stored_control_states (MateMixerBackend *backend,
+                                         GArray           *states,
+                                         GArray           *volumes)
+{
+    PulseBackend   *pulse;
+    GHashTableIter  iter;
+    gpointer        name;
+    gpointer        entry;
+
+    g_return_val_if_fail (PULSE_IS_BACKEND (backend), FALSE);
+
+    pulse = PULSE_BACKEND (backend);
+
+    g_hash_table_iter_init (&iter, pulse->priv->ext_entries);
+
+    while (g_hash_table_iter_next (&iter, &name, &entry) == TRUE) {
+        MateMixerControlState state;
+        PulseExtStream       *ext;
+
+        ext = g_hash_table_lookup (pulse->priv->ext_streams, name);
+        if (ext != NULL) {
+            _mate_mixer_stream_control_get_state (MATE_MIXER_STREAM_CONTROL (ext),
+                                                  &state,
+                                                  volumes);
+
+            state.control = g_object_ref (ext);
+        } else {
+            pa_ext_stream_restore_info info;
 
-    if (pulse->priv->ext_streams_list == NULL) {
-        pulse->priv->ext_streams_list = g_hash_table_get_values (pulse->priv->ext_streams);
-        if (pulse->priv->ext_streams_list != NULL)
-            g_list_foreach (pulse->priv->ext_streams_list, (GFunc) g_object_ref, NULL);
+            pulse_ext_entry_fill_info (entry, &info);
+            pulse_ext_stream_fill_state (&info, &state, volumes);
+        }
+
+        state.stream_index = MATE_MIXER_SNAPSHOT_NO_STREAM;
+        state.is_default   = FALSE;
+
+        g_array_append_val (states, state);
     }
-    return pulse->priv->ext_streams_list;
+    return TRUE;
 }
 
 static gboolean
@@ -626,32 +935,18 @@ on_connection_state_notify (PulseConnection *connection,
 
     switch (state) {
     case PULSE_CONNECTION_DISCONNECTED:
+        pulse->priv->ready_pending = FALSE;
+
         if (pulse->priv->connected_once == TRUE) {
-            /* We managed to connect once before, try to reconnect and if it
-             * fails immediately, use a timeout source.
-             * All current devices and streams are marked as hanging as it is
-             * unknown whether they are still available.
-             * Stream callbacks will unmark available streams and remaining
-             * unavailable streams will be removed when the CONNECTED state
-             * is reached. */
+            /* We managed to connect once before, so reconnect after a delay.
+             * All current devices and streams are kept, but marked as hanging
+             * as it is unknown whether they are still available.
+             * The info callbacks adopt the objects which reappear and the
+             * remaining ones are removed when their lists have been loaded */
             PULSE_CHANGE_STATE (pulse, MATE_MIXER_STATE_CONNECTING);
 
-            if G_UNLIKELY (pulse->priv->connect_tag != 0)
-                break;
-
-            if (pulse_connection_connect (connection, TRUE) == FALSE) {
-                GSource *source;
-
-                source = g_timeout_source_new (200);
-                g_source_set_callback (source,
-                                       (GSourceFunc) source_try_connect,
-                                       pulse,
-                                       NULL);
-                pulse->priv->connect_tag =
-                    g_source_attach (source, g_main_context_get_thread_default ());
-
-                g_source_unref (source);
-            }
+            mark_hanging (pulse);
+            schedule_reconnect (pulse);
             break;
         }
 
@@ -661,18 +956,70 @@ on_connection_state_notify (PulseConnection *connection,
 
     case PULSE_CONNECTION_CONNECTING:
     case PULSE_CONNECTION_AUTHORIZING:
+        PULSE_CHANGE_STATE (pulse, MATE_MIXER_STATE_CONNECTING);
+        break;
+
     case PULSE_CONNECTION_LOADING:
         PULSE_CHANGE_STATE (pulse, MATE_MIXER_STATE_CONNECTING);
+
+        /* The application controls and the stream database are loaded after
+         * the connection has been established */
+        _mate_mixer_backend_begin_loading (MATE_MIXER_BACKEND (pulse),
+                                           pulse->priv->track_flags &
+                                           (MATE_MIXER_TRACK_INPUT_APPLICATIONS |
+                                            MATE_MIXER_TRACK_OUTPUT_APPLICATIONS |
+                                            MATE_MIXER_TRACK_STORED_CONTROLS));
         break;
 
     case PULSE_CONNECTION_CONNECTED:
         pulse->priv->connected_once = TRUE;
+        pulse->priv->connect_delay  = RECONNECT_DELAY_MIN;
+
+        /* The lists of streams and cards have been loaded by now, except
+         * when only following the default streams, in which case the hanging
+         * ones are removed once the default stream is known */
+        if (PULSE_DEFAULT_SINK_ONLY (pulse) == FALSE)
+            remove_hanging_sinks (pulse);
+        if (PULSE_DEFAULT_SOURCE_ONLY (pulse) == FALSE)
+            remove_hanging_sources (pulse);
+
+        remove_hanging_devices (pulse);
+
+        /* The monitors of the streams kept from the previous connection
+         * have stopped together with it */
+        restart_monitors (pulse);
 
-        PULSE_CHANGE_STATE (pulse, MATE_MIXER_STATE_READY);
+        /* When only following the default streams, the default stream may
+         * still be on its way, wait for it to avoid reporting an empty list
+         * of streams */
+        pulse->priv->ready_pending = TRUE;
+
+        check_ready (pulse);
         break;
     }
 }
 
+static void
+on_connection_busy_notify (PulseConnection *connection,
+                           GParamSpec      *pspec,
+                           PulseBackend    *pulse)
+{
+    gboolean busy = pulse_connection_is_busy (connection);
+
+    if (pulse->priv->connection_busy == busy)
+        return;
+
+    pulse->priv->connection_busy = busy;
+
+    /* A hotplugged card arrives as a series of events, each followed by an
+     * information request, report the topology change after all of them
+     * have been answered */
+    if (busy == TRUE)
+        _mate_mixer_backend_begin_topology_change (MATE_MIXER_BACKEND (pulse));
+    else
+        _mate_mixer_backend_end_topology_change (MATE_MIXER_BACKEND (pulse));
+}
+
 static void
 on_connection_server_info (PulseConnection      *connection,
                            const pa_server_info *info,
@@ -682,8 +1029,31 @@ on_connection_server_info (PulseConnection      *connection,
     const gchar     *name_source = NULL;
     const gchar     *name_sink = NULL;
 
+    /* The cookie changes when the server is restarted, the indexes of the
+     * sink inputs and source outputs no longer refer to the same streams.
+     * This arrives before the lists of the application streams are loaded */
+    if (info->cookie != pulse->priv->server_cookie) {
+        remove_hanging_sink_inputs (pulse);
+        remove_hanging_source_outputs (pulse);
+
+        pulse->priv->server_cookie = info->cookie;
+    }
+
+    /* Identifies the server for the topology cache, the cookie is not stable
+     * enough as it changes with each restart of the server */
+    if (info->server_name != NULL && info->host_name != NULL) {
+        gchar *name = g_strdup_printf ("%s@%s", info->server_name, info->host_name);
+
+        _mate_mixer_backend_set_server_name (MATE_MIXER_BACKEND (pulse), name);
+        g_free (name);
+    }
+
+    /* A hanging default stream has not been seen since reconnecting, treat
+     * it as unknown to look it up again */
     stream = PULSE_GET_DEFAULT_SOURCE (pulse);
-    if (stream != NULL)
+    if (stream != NULL &&
+        g_hash_table_lookup (pulse->priv->hanging_sources,
+                             mate_mixer_stream_get_name (stream)) != stream)
         name_source = mate_mixer_stream_get_name (stream);
 
     if (g_strcmp0 (name_source, info->default_source_name) != 0) {
@@ -702,6 +1072,8 @@ on_connection_server_info (PulseConnection      *connection,
             if (stream != NULL) {
                 PULSE_SET_DEFAULT_SOURCE (pulse, stream);
                 PULSE_SET_PENDING_SOURCE_NULL (pulse);
+
+                follow_default_source (pulse);
             } else {
                 g_debug ("Default input stream changed to unknown stream %s",
                          info->default_source_name);
@@ -711,15 +1083,24 @@ on_connection_server_info (PulseConnection      *connection,
                 /* In most cases (for example changing profile) the stream info
                  * arrives by itself, but do not rely on it and request it
                  * explicitly */
-                pulse_connection_load_source_info_name (pulse->priv->connection,
-                                                        info->default_source_name);
+                if (pulse->priv->track_flags & (MATE_MIXER_TRACK_INPUT_STREAMS |
+                                                MATE_MIXER_TRACK_DEFAULT_STREAMS))
+                    pulse_connection_load_source_info_name (pulse->priv->connection,
+                                                            info->default_source_name);
             }
-        } else
+        } else {
             PULSE_SET_DEFAULT_SOURCE (pulse, NULL);
+            PULSE_SET_PENDING_SOURCE_NULL (pulse);
+
+            if (PULSE_DEFAULT_SOURCE_ONLY (pulse))
+                remove_hanging_sources (pulse);
+        }
     }
 
     stream = PULSE_GET_DEFAULT_SINK (pulse);
-    if (stream != NULL)
+    if (stream != NULL &&
+        g_hash_table_lookup (pulse->priv->hanging_sinks,
+                             mate_mixer_stream_get_name (stream)) != stream)
         name_sink = mate_mixer_stream_get_name (stream);
 
     if (g_strcmp0 (name_sink, info->default_sink_name) != 0) {
@@ -738,6 +1119,8 @@ on_connection_server_info (PulseConnection      *connection,
             if (stream != NULL) {
                 PULSE_SET_DEFAULT_SINK (pulse, stream);
                 PULSE_SET_PENDING_SINK_NULL (pulse);
+
+                follow_default_sink (pulse);
             } else {
                 g_debug ("Default output stream changed to unknown stream %s",
                          info->default_sink_name);
@@ -747,11 +1130,18 @@ on_connection_server_info (PulseConnection      *connection,
                 /* In most cases (for example changing profile) the stream info
                  * arrives by itself, but do not rely on it and request it
                  * explicitly */
-                pulse_connection_load_sink_info_name (pulse->priv->connection,
-                                                      info->default_sink_name);
+                if (pulse->priv->track_flags & (MATE_MIXER_TRACK_OUTPUT_STREAMS |
+                                                MATE_MIXER_TRACK_DEFAULT_STREAMS))
+                    pulse_connection_load_sink_info_name (pulse->priv->connection,
+                                                          info->default_sink_name);
             }
-        } else
+        } else {
             PULSE_SET_DEFAULT_SINK (pulse, NULL);
+            PULSE_SET_PENDING_SINK_NULL (pulse);
+
+            if (PULSE_DEFAULT_SINK_ONLY (pulse))
+                remove_hanging_sinks (pulse);
+        }
     }
 
     if (mate_mixer_backend_get_state (MATE_MIXER_BACKEND (pulse)) != MATE_MIXER_STATE_READY)
@@ -759,6 +1149,9 @@ on_connection_server_info (PulseConnection      *connection,
                  info->server_name,
                  info->server_version,
                  info->host_name);
+
+    /* The default stream might have been unset or found in the meantime */
+    check_ready (pulse);
 }
 
 static void
@@ -769,6 +1162,9 @@ on_connection_card_info (PulseConnection    *connection,
     PulseDevice *device;
 
     device = g_hash_table_lookup (pulse->priv->devices, GUINT_TO_POINTER (info->index));
+    if (device == NULL)
+        device = adopt_device (pulse, info->index, info->name);
+
     if (device == NULL) {
         device = pulse_device_new (connection, info);
 
@@ -776,7 +1172,7 @@ on_connection_card_info (PulseConnection    *connection,
                              GUINT_TO_POINTER (info->index),
                              device);
 
-        free_list_devices (pulse);
+        _mate_mixer_object_list_append (pulse->priv->devices_list, device);
         g_signal_emit_by_name (G_OBJECT (pulse),
                                "device-added",
                                mate_mixer_device_get_name (MATE_MIXER_DEVICE (device)));
@@ -790,21 +1186,21 @@ on_connection_card_removed (PulseConnection *connection,
                             PulseBackend    *pulse)
 {
     PulseDevice *device;
-    gchar       *name;
 
     device = g_hash_table_lookup (pulse->priv->devices, GUINT_TO_POINTER (index));
     if G_UNLIKELY (device == NULL)
         return;
 
-    name = g_strdup (mate_mixer_device_get_name (MATE_MIXER_DEVICE (device)));
+    g_object_ref (device);
+
+    _mate_mixer_object_list_remove (pulse->priv->devices_list, device);
 
     g_hash_table_remove (pulse->priv->devices, GUINT_TO_POINTER (index));
 
-    free_list_devices (pulse);
     g_signal_emit_by_name (G_OBJECT (pulse),
                            "device-removed",
-                           name);
-    g_free (name);
+                           mate_mixer_device_get_name (MATE_MIXER_DEVICE (device)));
+    g_object_unref (device);
 }
 
 static void
@@ -821,13 +1217,39 @@ on_connection_sink_info (PulseConnection    *connection,
 
     stream = g_hash_table_lookup (pulse->priv->sinks, GUINT_TO_POINTER (info->index));
     if (stream == NULL) {
+        stream = adopt_stream (pulse->priv->sinks,
+                               pulse->priv->hanging_sinks,
+                               info->index,
+                               info->name,
+                               device);
+        if (stream != NULL) {
+            pulse_sink_update (PULSE_SINK (stream), info);
+
+            /* Adopted after the connection has been established when only
+             * following the default sink */
+            if (pulse_connection_get_state (connection) == PULSE_CONNECTION_CONNECTED)
+                restart_stream_monitors (stream);
+
+            check_pending_sink (pulse, stream);
+            return;
+        }
+
+        /* Remove a hanging sink of the same name before adding its replacement */
+        stream = g_hash_table_lookup (pulse->priv->hanging_sinks, info->name);
+        if (stream != NULL)
+            remove_hanging_sink (pulse, stream);
+
+        if (PULSE_DEFAULT_SINK_ONLY (pulse) &&
+            g_strcmp0 (info->name, PULSE_GET_PENDING_SINK (pulse)) != 0)
+            return;
+
         stream = PULSE_STREAM (pulse_sink_new (connection, info, device));
 
         g_hash_table_insert (pulse->priv->sinks,
                              GUINT_TO_POINTER (info->index),
                              stream);
 
-        free_list_streams (pulse);
+        _mate_mixer_object_list_append (pulse->priv->streams_list, stream);
 
         if (device != NULL) {
             pulse_device_add_stream (device, stream);
@@ -853,7 +1275,6 @@ on_connection_sink_removed (PulseConnection *connection,
                             PulseBackend    *pulse)
 {
     PulseStream *stream;
-    PulseDevice *device;
 
     stream = g_hash_table_lookup (pulse->priv->sinks, GUINT_TO_POINTER (idx));
     if G_UNLIKELY (stream == NULL)
@@ -862,28 +1283,8 @@ on_connection_sink_removed (PulseConnection *connection,
     g_object_ref (stream);
 
     g_hash_table_remove (pulse->priv->sinks, GUINT_TO_POINTER (idx));
-    free_list_streams (pulse);
-
-    device = pulse_stream_get_device (stream);
-    if (device != NULL) {
-        pulse_device_remove_stream (device, stream);
-    } else {
-        g_signal_emit_by_name (G_OBJECT (pulse),
-                               "stream-removed",
-                               mate_mixer_stream_get_name (MATE_MIXER_STREAM (stream)));
-    }
-
-    /* The removed stream might be one of the default streams, this happens
-     * especially when switching profiles, after which PulseAudio removes the
-     * old streams and creates new ones with different names */
-    if (MATE_MIXER_STREAM (stream) == PULSE_GET_DEFAULT_SINK (pulse)) {
-        PULSE_SET_DEFAULT_SINK (pulse, NULL);
 
-        /* PulseAudio usually sends a server info update by itself when default
-         * stream changes, but there is at least one case when it does not - setting
-         * a card profile to off, so to be sure request an update explicitely */
-        pulse_connection_load_server_info (pulse->priv->connection);
-    }
+    remove_sink (pulse, stream);
     g_object_unref (stream);
 }
 
@@ -924,6 +1325,8 @@ on_connection_sink_input_info (PulseConnection          *connection,
         remove_sink_input (pulse, prev, info->index);
     }
 
+    g_hash_table_remove (pulse->priv->hanging_sink_inputs, GUINT_TO_POINTER (info->index));
+
     if (pulse_sink_add_input (sink, info) == TRUE)
         g_hash_table_insert (pulse->priv->sink_input_map,
                              GUINT_TO_POINTER (info->index),
@@ -958,13 +1361,39 @@ on_connection_source_info (PulseConnection      *connection,
 
     stream = g_hash_table_lookup (pulse->priv->sources, GUINT_TO_POINTER (info->index));
     if (stream == NULL) {
+        stream = adopt_stream (pulse->priv->sources,
+                               pulse->priv->hanging_sources,
+                               info->index,
+                               info->name,
+                               device);
+        if (stream != NULL) {
+            pulse_source_update (PULSE_SOURCE (stream), info);
+
+            /* Adopted after the connection has been established when only
+             * following the default source */
+            if (pulse_connection_get_state (connection) == PULSE_CONNECTION_CONNECTED)
+                restart_stream_monitors (stream);
+
+            check_pending_source (pulse, stream);
+            return;
+        }
+
+        /* Remove a hanging source of the same name before adding its replacement */
+        stream = g_hash_table_lookup (pulse->priv->hanging_sources, info->name);
+        if (stream != NULL)
+            remove_hanging_source (pulse, stream);
+
+        if (PULSE_DEFAULT_SOURCE_ONLY (pulse) &&
+            g_strcmp0 (info->name, PULSE_GET_PENDING_SOURCE (pulse)) != 0)
+            return;
+
         stream = PULSE_STREAM (pulse_source_new (connection, info, device));
 
         g_hash_table_insert (pulse->priv->sources,
                              GUINT_TO_POINTER (info->index),
                              stream);
 
-        free_list_streams (pulse);
+        _mate_mixer_object_list_append (pulse->priv->streams_list, stream);
 
         if (device != NULL) {
             pulse_device_add_stream (device, stream);
@@ -989,7 +1418,6 @@ on_connection_source_removed (PulseConnection *connection,
                               guint            idx,
                               PulseBackend    *pulse)
 {
-    PulseDevice *device;
     PulseStream *stream;
 
     stream = g_hash_table_lookup (pulse->priv->sources, GUINT_TO_POINTER (idx));
@@ -999,28 +1427,8 @@ on_connection_source_removed (PulseConnection *connection,
     g_object_ref (stream);
 
     g_hash_table_remove (pulse->priv->sources, GUINT_TO_POINTER (idx));
-    free_list_streams (pulse);
-
-    device = pulse_stream_get_device (stream);
-    if (device != NULL) {
-        pulse_device_remove_stream (device, stream);
-    } else {
-        g_signal_emit_by_name (G_OBJECT (pulse),
-                               "stream-removed",
-                               mate_mixer_stream_get_name (MATE_MIXER_STREAM (stream)));
-    }
-
-    /* The removed stream might be one of the default streams, this happens
-     * especially when switching profiles, after which PulseAudio removes the
-     * old streams and creates new ones with different names */
-    if (MATE_MIXER_STREAM (stream) == PULSE_GET_DEFAULT_SOURCE (pulse)) {
-        PULSE_SET_DEFAULT_SOURCE (pulse, NULL);
 
-        /* PulseAudio usually sends a server info update by itself when default
-         * stream changes, but there is at least one case when it does not - setting
-         * a card profile to off, so to be sure request an update explicitely */
-        pulse_connection_load_server_info (pulse->priv->connection);
-    }
+    remove_source (pulse, stream);
     g_object_unref (stream);
 }
 
@@ -1032,6 +1440,13 @@ on_connection_source_output_info (PulseConnection             *connection,
     PulseSource *source = NULL;
     PulseSource *prev;
 
+    if (is_source_output_ignored (info) == TRUE) {
+        prev = g_hash_table_lookup (pulse->priv->source_output_map, GUINT_TO_POINTER (info->index));
+        if G_UNLIKELY (prev != NULL)
+            remove_source_output (pulse, prev, info->index);
+        return;
+    }
+
     if G_LIKELY (info->source != PA_INVALID_INDEX)
         source = g_hash_table_lookup (pulse->priv->sources, GUINT_TO_POINTER (info->source));
 
@@ -1061,6 +1476,8 @@ on_connection_source_output_info (PulseConnection             *connection,
         remove_source_output (pulse, prev, info->index);
     }
 
+    g_hash_table_remove (pulse->priv->hanging_source_outputs, GUINT_TO_POINTER (info->index));
+
     if (pulse_source_add_output (source, info) == TRUE)
         g_hash_table_insert (pulse->priv->source_output_map,
                              GUINT_TO_POINTER (info->index),
@@ -1086,50 +1503,57 @@ on_connection_ext_stream_info (PulseConnection                  *connection,
                                const pa_ext_stream_restore_info *info,
                                PulseBackend                     *pulse)
 {
+    PulseExtEntry  *entry;
     PulseExtStream *ext;
-    PulseStream    *parent = NULL;
-
-    if (info->device != NULL) {
-        parent = g_hash_table_find (pulse->priv->sinks, compare_stream_names,
-                                    (gpointer) info->device);
-
-        if (parent == NULL)
-            parent = g_hash_table_find (pulse->priv->sources, compare_stream_names,
-                                        (gpointer) info->device);
-    }
 
-    ext = g_hash_table_lookup (pulse->priv->ext_streams, info->name);
-    if (ext == NULL) {
-        ext = pulse_ext_stream_new (connection, info, parent);
+    entry = g_hash_table_lookup (pulse->priv->ext_entries, info->name);
+    if (entry == NULL) {
+        entry = pulse_ext_entry_new (info);
+        entry->generation = pulse->priv->ext_entries_generation;
 
-        g_hash_table_insert (pulse->priv->ext_streams,
-                             g_strdup (info->name),
-                             ext);
+        g_hash_table_insert (pulse->priv->ext_entries,
+                             (gpointer) entry->name,
+                             entry);
 
-        free_list_ext_streams (pulse);
+        pulse->priv->ext_entries_seen++;
 
         g_signal_emit_by_name (G_OBJECT (pulse),
                                "stored-control-added",
-                               mate_mixer_stream_control_get_name (MATE_MIXER_STREAM_CONTROL (ext)));
-    } else {
-        pulse_ext_stream_update (ext, info, parent);
+                               entry->name);
+        return;
+    }
 
-        /* The object might be hanging if ext-streams are being loaded, remove
-         * the hanging flag to prevent it from being removed */
-        PULSE_UNSET_HANGING (ext);
+    if (pulse_ext_entry_update (entry, info) == FALSE) {
+        entry = pulse_ext_entry_new (info);
+
+        g_hash_table_replace (pulse->priv->ext_entries,
+                              (gpointer) entry->name,
+                              entry);
     }
+
+    /* Keep the entry from being removed when the list is loaded */
+    entry->generation = pulse->priv->ext_entries_generation;
+    pulse->priv->ext_entries_seen++;
+
+    /* The whole database is sent after every change, most entries
+     * are the same as in the previous list */
+    ext = g_hash_table_lookup (pulse->priv->ext_streams, info->name);
+    if (ext == NULL || is_ext_stream_current (pulse, ext, info) == TRUE)
+        return;
+
+    pulse_ext_stream_update (ext, info, find_ext_stream_parent (pulse, info->device));
 }
 
 static void
 on_connection_ext_stream_loading (PulseConnection *connection, PulseBackend *pulse)
 {
-    GHashTableIter iter;
-    gpointer       ext;
-
-    g_hash_table_iter_init (&iter, pulse->priv->ext_streams);
+    /* Entries which are not stamped with the new generation by the time the
+     * list is loaded have been removed from the database, zero is the
+     * generation of objects without the mark */
+    if (++pulse->priv->ext_entries_generation == 0)
+        pulse->priv->ext_entries_generation = 1;
 
-    while (g_hash_table_iter_next (&iter, NULL, &ext) == TRUE)
-        PULSE_SET_HANGING (ext);
+    pulse->priv->ext_entries_seen = 0;
 }
 
 static void
@@ -1137,43 +1561,375 @@ on_connection_ext_stream_loaded (PulseConnection *connection, PulseBackend *puls
 {
     GHashTableIter iter;
     gpointer       name;
-    gpointer       ext;
+    gpointer       entry;
 
-    g_hash_table_iter_init (&iter, pulse->priv->ext_streams);
+    /* Nothing has been removed if every known entry has been seen */
+    if (pulse->priv->ext_entries_seen < g_hash_table_size (pulse->priv->ext_entries)) {
+        g_hash_table_iter_init (&iter, pulse->priv->ext_entries);
 
-    while (g_hash_table_iter_next (&iter, &name, &ext) == TRUE) {
-        if (PULSE_GET_HANGING (ext) == FALSE)
-            continue;
+        while (g_hash_table_iter_next (&iter, &name, &entry) == TRUE) {
+            PulseExtStream *ext;
+            const gchar    *removed;
 
-        g_hash_table_iter_remove (&iter);
-        free_list_ext_streams (pulse);
+            if (((PulseExtEntry *) entry)->generation == pulse->priv->ext_entries_generation)
+                continue;
 
-        g_signal_emit_by_name (G_OBJECT (pulse),
-                               "stored-control-removed",
-                               name);
-    }
-}
+            ext = g_hash_table_lookup (pulse->priv->ext_streams, name);
+            if (ext != NULL) {
+                _mate_mixer_object_list_remove (pulse->priv->ext_streams_list, ext);
 
-static gboolean
-source_try_connect (PulseBackend *pulse)
-{
-    /* When the connect call succeeds, return FALSE to remove the source
-     * and wait for the connection state notifications, otherwise this function
-     * will be called again */
-    if (pulse_connection_connect (pulse->priv->connection, TRUE) == TRUE) {
-        pulse->priv->connect_tag = 0;
-        return G_SOURCE_REMOVE;
+                g_hash_table_remove (pulse->priv->ext_streams, name);
+            }
+
+            /* The shared name is released by the entry, keep it until the
+             * signal has been emitted */
+            removed = _mate_mixer_name_ref (name);
+
+            g_hash_table_iter_remove (&iter);
+
+            g_signal_emit_by_name (G_OBJECT (pulse),
+                                   "stored-control-removed",
+                                   removed);
+            _mate_mixer_name_unref (removed);
+        }
     }
-    return G_SOURCE_CONTINUE;
+
+    _mate_mixer_backend_end_loading (MATE_MIXER_BACKEND (pulse),
+                                     MATE_MIXER_TRACK_STORED_CONTROLS);
 }
 
 static void
-check_pending_sink (PulseBackend *pulse, PulseStream *stream)
+on_connection_list_loaded (PulseConnection *connection,
+                           guint            flags,
+                           PulseBackend    *pulse)
 {
-    const gchar *pending;
-    const gchar *name;
+    if (flags & PULSE_CONNECTION_LOAD_SINK_INPUTS) {
+        remove_hanging_sink_inputs (pulse);
 
-    /* See if the currently added sream matches the default input stream
+        _mate_mixer_backend_end_loading (MATE_MIXER_BACKEND (pulse),
+                                         MATE_MIXER_TRACK_OUTPUT_APPLICATIONS);
+    }
+    if (flags & PULSE_CONNECTION_LOAD_SOURCE_OUTPUTS) {
+        remove_hanging_source_outputs (pulse);
+
+        _mate_mixer_backend_end_loading (MATE_MIXER_BACKEND (pulse),
+                                         MATE_MIXER_TRACK_INPUT_APPLICATIONS);
+    }
+}
+
+static gboolean
+source_try_connect (PulseBackend *pulse)
+{
+    pulse->priv->connect_tag = 0;
+
+    /* When the connect call succeeds, wait for the connection state
+     * notifications, otherwise try again after a longer delay */
+    if (pulse_connection_connect (pulse->priv->connection, TRUE) == FALSE)
+        schedule_reconnect (pulse);
+
+    return G_SOURCE_REMOVE;
+}
+
+static void
+schedule_reconnect (PulseBackend *pulse)
+{
+    GSource *source;
+    guint    delay;
+
+    if G_UNLIKELY (pulse->priv->connect_tag != 0)
+        return;
+
+    /* Every client loses the connection at the same moment when the server
+     * restarts, pick a random delay between a half and the full backoff
+     * to avoid all of them reconnecting at once */
+    delay = g_random_int_range (pulse->priv->connect_delay / 2,
+                                pulse->priv->connect_delay + 1);
+
+    pulse->priv->connect_delay = MIN (pulse->priv->connect_delay * 2,
+                                      RECONNECT_DELAY_MAX);
+
+    source = g_timeout_source_new (delay);
+    g_source_set_callback (source,
+                           (GSourceFunc) source_try_connect,
+                           pulse,
+                           NULL);
+    pulse->priv->connect_tag =
+        g_source_attach (source, g_main_context_get_thread_default ());
+
+    g_source_unref (source);
+}
+
+static void
+mark_hanging (PulseBackend *pulse)
+{
+    GHashTableIter iter;
+    gpointer       key;
+    gpointer       value;
+
+    /* Move the devices and streams aside, the server might reuse their
+     * indexes for different objects after a restart */
+    g_hash_table_iter_init (&iter, pulse->priv->devices);
+
+    while (g_hash_table_iter_next (&iter, NULL, &value) == TRUE) {
+        g_hash_table_replace (pulse->priv->hanging_devices,
+                              (gpointer) mate_mixer_device_get_name (MATE_MIXER_DEVICE (value)),
+                              value);
+        g_hash_table_iter_steal (&iter);
+    }
+
+    g_hash_table_iter_init (&iter, pulse->priv->sinks);
+
+    while (g_hash_table_iter_next (&iter, NULL, &value) == TRUE) {
+        g_hash_table_replace (pulse->priv->hanging_sinks,
+                              (gpointer) mate_mixer_stream_get_name (MATE_MIXER_STREAM (value)),
+                              value);
+        g_hash_table_iter_steal (&iter);
+    }
+
+    g_hash_table_iter_init (&iter, pulse->priv->sources);
+
+    while (g_hash_table_iter_next (&iter, NULL, &value) == TRUE) {
+        g_hash_table_replace (pulse->priv->hanging_sources,
+                              (gpointer) mate_mixer_stream_get_name (MATE_MIXER_STREAM (value)),
+                              value);
+        g_hash_table_iter_steal (&iter);
+    }
+
+    /* Sink inputs and source outputs keep their indexes unless the server
+     * restarts, which is recognized by the server cookie */
+    g_hash_table_iter_init (&iter, pulse->priv->sink_input_map);
+
+    while (g_hash_table_iter_next (&iter, &key, NULL) == TRUE)
+        g_hash_table_insert (pulse->priv->hanging_sink_inputs, key, key);
+
+    g_hash_table_iter_init (&iter, pulse->priv->source_output_map);
+
+    while (g_hash_table_iter_next (&iter, &key, NULL) == TRUE)
+        g_hash_table_insert (pulse->priv->hanging_source_outputs, key, key);
+}
+
+static PulseDevice *
+adopt_device (PulseBackend *pulse, guint32 index, const gchar *name)
+{
+    PulseDevice *device;
+
+    device = g_hash_table_lookup (pulse->priv->hanging_devices, name);
+    if (device == NULL)
+        return NULL;
+
+    g_hash_table_steal (pulse->priv->hanging_devices, name);
+
+    pulse_device_set_index (device, index);
+
+    g_hash_table_insert (pulse->priv->devices,
+                         GUINT_TO_POINTER (index),
+                         device);
+    return device;
+}
+
+static PulseStream *
+adopt_stream (GHashTable  *streams,
+              GHashTable  *hanging,
+              guint32      index,
+              const gchar *name,
+              PulseDevice *device)
+{
+    PulseStream *stream;
+
+    stream = g_hash_table_lookup (hanging, name);
+    if (stream == NULL)
+        return NULL;
+
+    /* The device of a stream cannot be changed, a stream whose device has
+     * not reappeared is left hanging and has to be replaced */
+    if (pulse_stream_get_device (stream) != device)
+        return NULL;
+
+    g_hash_table_steal (hanging, name);
+
+    pulse_stream_set_index (stream, index);
+
+    g_hash_table_insert (streams,
+                         GUINT_TO_POINTER (index),
+                         stream);
+    return stream;
+}
+
+static void
+remove_hanging_devices (PulseBackend *pulse)
+{
+    GHashTableIter iter;
+    gpointer       device;
+
+    g_hash_table_iter_init (&iter, pulse->priv->hanging_devices);
+
+    while (g_hash_table_iter_next (&iter, NULL, &device) == TRUE) {
+        g_object_ref (device);
+
+        _mate_mixer_object_list_remove (pulse->priv->devices_list, device);
+
+        g_hash_table_iter_remove (&iter);
+
+        g_signal_emit_by_name (G_OBJECT (pulse),
+                               "device-removed",
+                               mate_mixer_device_get_name (MATE_MIXER_DEVICE (device)));
+        g_object_unref (device);
+    }
+}
+
+static void
+remove_hanging_sink (PulseBackend *pulse, PulseStream *stream)
+{
+    g_object_ref (stream);
+
+    g_hash_table_remove (pulse->priv->hanging_sinks,
+                         mate_mixer_stream_get_name (MATE_MIXER_STREAM (stream)));
+
+    g_hash_table_foreach_remove (pulse->priv->sink_input_map,
+                                 compare_streams,
+                                 stream);
+
+    remove_sink (pulse, stream);
+    g_object_unref (stream);
+}
+
+static void
+remove_hanging_sinks (PulseBackend *pulse)
+{
+    GHashTableIter iter;
+    gpointer       stream;
+
+    g_hash_table_iter_init (&iter, pulse->priv->hanging_sinks);
+
+    while (g_hash_table_iter_next (&iter, NULL, &stream) == TRUE) {
+        g_object_ref (stream);
+        g_hash_table_iter_remove (&iter);
+
+        g_hash_table_foreach_remove (pulse->priv->sink_input_map,
+                                     compare_streams,
+                                     stream);
+
+        remove_sink (pulse, stream);
+        g_object_unref (stream);
+    }
+}
+
+static void
+remove_hanging_source (PulseBackend *pulse, PulseStream *stream)
+{
+    g_object_ref (stream);
+
+    g_hash_table_remove (pulse->priv->hanging_sources,
+                         mate_mixer_stream_get_name (MATE_MIXER_STREAM (stream)));
+
+    g_hash_table_foreach_remove (pulse->priv->source_output_map,
+                                 compare_streams,
+                                 stream);
+
+    remove_source (pulse, stream);
+    g_object_unref (stream);
+}
+
+static void
+remove_hanging_sources (PulseBackend *pulse)
+{
+    GHashTableIter iter;
+    gpointer       stream;
+
+    g_hash_table_iter_init (&iter, pulse->priv->hanging_sources);
+
+    while (g_hash_table_iter_next (&iter, NULL, &stream) == TRUE) {
+        g_object_ref (stream);
+        g_hash_table_iter_remove (&iter);
+
+        g_hash_table_foreach_remove (pulse->priv->source_output_map,
+                                     compare_streams,
+                                     stream);
+
+        remove_source (pulse, stream);
+        g_object_unref (stream);
+    }
+}
+
+static void
+remove_hanging_sink_inputs (PulseBackend *pulse)
+{
+    GHashTableIter iter;
+    gpointer       index;
+
+    g_hash_table_iter_init (&iter, pulse->priv->hanging_sink_inputs);
+
+    while (g_hash_table_iter_next (&iter, &index, NULL) == TRUE) {
+        PulseSink *sink = g_hash_table_lookup (pulse->priv->sink_input_map, index);
+
+        /* The sink might have been removed together with its inputs */
+        if (sink != NULL)
+            remove_sink_input (pulse, sink, GPOINTER_TO_UINT (index));
+
+        g_hash_table_iter_remove (&iter);
+    }
+}
+
+static void
+remove_hanging_source_outputs (PulseBackend *pulse)
+{
+    GHashTableIter iter;
+    gpointer       index;
+
+    g_hash_table_iter_init (&iter, pulse->priv->hanging_source_outputs);
+
+    while (g_hash_table_iter_next (&iter, &index, NULL) == TRUE) {
+        PulseSource *source = g_hash_table_lookup (pulse->priv->source_output_map, index);
+
+        if (source != NULL)
+            remove_source_output (pulse, source, GPOINTER_TO_UINT (index));
+
+        g_hash_table_iter_remove (&iter);
+    }
+}
+
+static void
+restart_monitors (PulseBackend *pulse)
+{
+    const GList *streams;
+
+    streams = _mate_mixer_object_list_peek (pulse->priv->streams_list);
+
+    for (; streams != NULL; streams = streams->next) {
+        MateMixerStream *stream = MATE_MIXER_STREAM (streams->data);
+        const gchar     *name   = mate_mixer_stream_get_name (stream);
+
+        /* Streams which are still hanging have the indexes of the lost
+         * connection, they are either adopted or removed later */
+        if (g_hash_table_lookup (pulse->priv->hanging_sinks, name) == stream ||
+            g_hash_table_lookup (pulse->priv->hanging_sources, name) == stream)
+            continue;
+
+        restart_stream_monitors (PULSE_STREAM (stream));
+    }
+}
+
+static void
+restart_stream_monitors (PulseStream *stream)
+{
+    const GList *controls;
+
+    controls = mate_mixer_stream_list_controls (MATE_MIXER_STREAM (stream));
+    while (controls != NULL) {
+        if (PULSE_IS_STREAM_CONTROL (controls->data))
+            pulse_stream_control_restart_monitor (PULSE_STREAM_CONTROL (controls->data));
+
+        controls = controls->next;
+    }
+}
+
+static void
+check_pending_sink (PulseBackend *pulse, PulseStream *stream)
+{
+    const gchar *pending;
+    const gchar *name;
+
+    /* See if the currently added sream matches the default input stream
      * we are waiting for */
     pending = PULSE_GET_PENDING_SINK (pulse);
     if (pending == NULL)
@@ -1187,6 +1943,10 @@ check_pending_sink (PulseBackend *pulse, PulseStream *stream)
 
     PULSE_SET_PENDING_SINK_NULL (pulse);
     PULSE_SET_DEFAULT_SINK (pulse, stream);
+
+    follow_default_sink (pulse);
+
+    check_ready (pulse);
 }
 
 static void
@@ -1209,55 +1969,284 @@ check_pending_source (PulseBackend *pulse, PulseStream *stream)
 
     PULSE_SET_PENDING_SOURCE_NULL (pulse);
     PULSE_SET_DEFAULT_SOURCE (pulse, stream);
+
+    follow_default_source (pulse);
+
+    check_ready (pulse);
 }
 
 static void
-remove_sink_input (PulseBackend *pulse, PulseSink *sink, guint index)
+follow_default_sink (PulseBackend *pulse)
 {
-    pulse_sink_remove_input (sink, index);
+    MateMixerStream *stream;
+    GList           *list;
+    GList           *item;
 
-    g_hash_table_remove (pulse->priv->sink_input_map, GUINT_TO_POINTER (index));
+    if (PULSE_DEFAULT_SINK_ONLY (pulse) == FALSE)
+        return;
+
+    stream = PULSE_GET_DEFAULT_SINK (pulse);
+
+    pulse_connection_follow_sink (pulse->priv->connection,
+                                  pulse_stream_get_index (PULSE_STREAM (stream)));
+
+    /* Only the default sink is kept, drop the previous one together with
+     * the sink inputs which belong to it */
+    list = g_hash_table_get_keys (pulse->priv->sinks);
+
+    for (item = list; item != NULL; item = item->next) {
+        PulseStream *sink = g_hash_table_lookup (pulse->priv->sinks, item->data);
+
+        if (MATE_MIXER_STREAM (sink) == stream)
+            continue;
+
+        g_hash_table_foreach_remove (pulse->priv->sink_input_map,
+                                     compare_streams,
+                                     sink);
+
+        on_connection_sink_removed (pulse->priv->connection,
+                                    GPOINTER_TO_UINT (item->data),
+                                    pulse);
+    }
+    g_list_free (list);
+
+    /* The previous default sink might not have reappeared after reconnecting */
+    remove_hanging_sinks (pulse);
+
+    /* Sink inputs of a sink which was unknown until now have been ignored */
+    if (pulse->priv->track_flags & MATE_MIXER_TRACK_OUTPUT_APPLICATIONS)
+        pulse_connection_load_sink_input_info (pulse->priv->connection, PA_INVALID_INDEX);
 }
 
 static void
-remove_source_output (PulseBackend *pulse, PulseSource *source, guint index)
+follow_default_source (PulseBackend *pulse)
 {
-    pulse_source_remove_output (source, index);
+    MateMixerStream *stream;
+    GList           *list;
+    GList           *item;
 
-    g_hash_table_remove (pulse->priv->source_output_map, GUINT_TO_POINTER (index));
+    if (PULSE_DEFAULT_SOURCE_ONLY (pulse) == FALSE)
+        return;
+
+    stream = PULSE_GET_DEFAULT_SOURCE (pulse);
+
+    pulse_connection_follow_source (pulse->priv->connection,
+                                    pulse_stream_get_index (PULSE_STREAM (stream)));
+
+    list = g_hash_table_get_keys (pulse->priv->sources);
+
+    for (item = list; item != NULL; item = item->next) {
+        PulseStream *source = g_hash_table_lookup (pulse->priv->sources, item->data);
+
+        if (MATE_MIXER_STREAM (source) == stream)
+            continue;
+
+        g_hash_table_foreach_remove (pulse->priv->source_output_map,
+                                     compare_streams,
+                                     source);
+
+        on_connection_source_removed (pulse->priv->connection,
+                                      GPOINTER_TO_UINT (item->data),
+                                      pulse);
+    }
+    g_list_free (list);
+
+    remove_hanging_sources (pulse);
+
+    if (pulse->priv->track_flags & MATE_MIXER_TRACK_INPUT_APPLICATIONS)
+        pulse_connection_load_source_output_info (pulse->priv->connection, PA_INVALID_INDEX);
 }
 
 static void
-free_list_devices (PulseBackend *pulse)
+check_ready (PulseBackend *pulse)
 {
-    if (pulse->priv->devices_list == NULL)
+    if (pulse->priv->ready_pending == FALSE)
         return;
 
-    g_list_free_full (pulse->priv->devices_list, g_object_unref);
+    /* Wait until the default streams we follow have been loaded, there is
+     * nothing to wait for if the server has no default stream */
+    if (PULSE_DEFAULT_SINK_ONLY (pulse) == TRUE &&
+        PULSE_GET_PENDING_SINK (pulse) != NULL)
+        return;
+    if (PULSE_DEFAULT_SOURCE_ONLY (pulse) == TRUE &&
+        PULSE_GET_PENDING_SOURCE (pulse) != NULL)
+        return;
+
+    pulse->priv->ready_pending = FALSE;
+
+    PULSE_CHANGE_STATE (pulse, MATE_MIXER_STATE_READY);
+}
+
+static PulseExtStream *
+create_ext_stream (PulseBackend *pulse, PulseExtEntry *entry)
+{
+    PulseExtStream            *ext;
+    pa_ext_stream_restore_info info;
+
+    pulse_ext_entry_fill_info (entry, &info);
+
+    ext = pulse_ext_stream_new (pulse->priv->connection,
+                                &info,
+                                find_ext_stream_parent (pulse, info.device));
+    if G_UNLIKELY (ext == NULL)
+        return NULL;
+
+    g_hash_table_replace (pulse->priv->ext_streams,
+                          (gpointer) mate_mixer_stream_control_get_name (MATE_MIXER_STREAM_CONTROL (ext)),
+                          ext);
 
-    pulse->priv->devices_list = NULL;
+    _mate_mixer_object_list_append (pulse->priv->ext_streams_list, ext);
+    return ext;
+}
+
+static PulseStream *
+find_ext_stream_parent (PulseBackend *pulse, const gchar *device)
+{
+    PulseStream *parent;
+
+    if (device == NULL)
+        return NULL;
+
+    parent = g_hash_table_find (pulse->priv->sinks, compare_stream_names,
+                                (gpointer) device);
+    if (parent == NULL)
+        parent = g_hash_table_find (pulse->priv->sources, compare_stream_names,
+                                    (gpointer) device);
+    return parent;
+}
+
+static gboolean
+is_ext_stream_current (PulseBackend                     *pulse,
+                       PulseExtStream                   *ext,
+                       const pa_ext_stream_restore_info *info)
+{
+    MateMixerStream *parent;
+    gpointer         index;
+
+    if (pulse_ext_stream_is_current (ext, info) == FALSE)
+        return FALSE;
+    if (info->device == NULL)
+        return TRUE;
+
+    /* The entry is the same, but the stream it refers to might have appeared
+     * or disappeared since the entry was last applied */
+    parent = mate_mixer_stream_control_get_stream (MATE_MIXER_STREAM_CONTROL (ext));
+    if (parent == NULL)
+        return FALSE;
+
+    index = GUINT_TO_POINTER (pulse_stream_get_index (PULSE_STREAM (parent)));
+
+    if (PULSE_IS_SINK (parent))
+        return g_hash_table_lookup (pulse->priv->sinks, index) == parent;
+    else
+        return g_hash_table_lookup (pulse->priv->sources, index) == parent;
 }
 
 static void
-free_list_streams (PulseBackend *pulse)
+remove_sink (PulseBackend *pulse, PulseStream *stream)
 {
-    if (pulse->priv->streams_list == NULL)
-        return;
+    PulseDevice *device;
 
-    g_list_free_full (pulse->priv->streams_list, g_object_unref);
+    _mate_mixer_object_list_remove (pulse->priv->streams_list, stream);
 
-    pulse->priv->streams_list = NULL;
+    device = pulse_stream_get_device (stream);
+    if (device != NULL) {
+        pulse_device_remove_stream (device, stream);
+    } else {
+        g_signal_emit_by_name (G_OBJECT (pulse),
+                               "stream-removed",
+                               mate_mixer_stream_get_name (MATE_MIXER_STREAM (stream)));
+    }
+
+    /* The removed stream might be one of the default streams, this happens
+     * especially when switching profiles, after which PulseAudio removes the
+     * old streams and creates new ones with different names */
+    if (MATE_MIXER_STREAM (stream) == PULSE_GET_DEFAULT_SINK (pulse)) {
+        PULSE_SET_DEFAULT_SINK (pulse, NULL);
+
+        /* PulseAudio usually sends a server info update by itself when default
+         * stream changes, but there is at least one case when it does not - setting
+         * a card profile to off, so to be sure request an update explicitely */
+        pulse_connection_load_server_info (pulse->priv->connection);
+    }
 }
 
 static void
-free_list_ext_streams (PulseBackend *pulse)
+remove_source (PulseBackend *pulse, PulseStream *stream)
 {
-    if (pulse->priv->ext_streams_list == NULL)
-        return;
+    PulseDevice *device;
+
+    _mate_mixer_object_list_remove (pulse->priv->streams_list, stream);
+
+    device = pulse_stream_get_device (stream);
+    if (device != NULL) {
+        pulse_device_remove_stream (device, stream);
+    } else {
+        g_signal_emit_by_name (G_OBJECT (pulse),
+                               "stream-removed",
+                               mate_mixer_stream_get_name (MATE_MIXER_STREAM (stream)));
+    }
 
-    g_list_free_full (pulse->priv->ext_streams_list, g_object_unref);
+    /* The removed stream might be one of the default streams, this happens
+     * especially when switching profiles, after which PulseAudio removes the
+     * old streams and creates new ones with different names */
+    if (MATE_MIXER_STREAM (stream) == PULSE_GET_DEFAULT_SOURCE (pulse)) {
+        PULSE_SET_DEFAULT_SOURCE (pulse, NULL);
 
-    pulse->priv->ext_streams_list = NULL;
+        /* PulseAudio usually sends a server info update by itself when default
+         * stream changes, but there is at least one case when it does not - setting
+         * a card profile to off, so to be sure request an update explicitely */
+        pulse_connection_load_server_info (pulse->priv->connection);
+    }
+}
+
+static void
+remove_sink_input (PulseBackend *pulse, PulseSink *sink, guint index)
+{
+    pulse_sink_remove_input (sink, index);
+
+    g_hash_table_remove (pulse->priv->sink_input_map, GUINT_TO_POINTER (index));
+}
+
+static void
+remove_source_output (PulseBackend *pulse, PulseSource *source, guint index)
+{
+    pulse_source_remove_output (source, index);
+
+    g_hash_table_remove (pulse->priv->source_output_map, GUINT_TO_POINTER (index));
+}
+
+static gboolean
+is_source_output_ignored (const pa_source_output_info *info)
+{
+    const gchar *prop;
+    guint        i;
+
+    /* Applications which only create record streams to drive level meters */
+    static const gchar *meter_apps[] = {
+        "org.PulseAudio.pavucontrol",
+        "org.gnome.VolumeControl",
+        "org.kde.kmixd"
+    };
+
+    if (info->proplist != NULL) {
+        /* Peak monitor created by this library, possibly in another process */
+        if (pa_proplist_contains (info->proplist, PULSE_MONITOR_PROPERTY) == 1)
+            return TRUE;
+
+        prop = pa_proplist_gets (info->proplist, PA_PROP_APPLICATION_ID);
+        if (prop != NULL)
+            for (i = 0; i < G_N_ELEMENTS (meter_apps); i++)
+                if (strcmp (prop, meter_apps[i]) == 0)
+                    return TRUE;
+    }
+
+    /* Streams created with PA_STREAM_PEAK_DETECT are always resampled using
+     * the "peaks" method, which makes them unusable for anything but metering */
+    if (info->resample_method != NULL && strcmp (info->resample_method, "peaks") == 0)
+        return TRUE;
+
+    return FALSE;
 }
 
 static gboolean
@@ -1267,3 +2256,35 @@ compare_stream_names (gpointer key, gpointer value, gpointer user_data)
 
     return strcmp (mate_mixer_stream_get_name (stream), (const gchar *) user_data) == 0;
 }
+
+static gboolean
+compare_streams (gpointer key, gpointer value, gpointer user_data)
+{
+    return value == user_data;
+}
+
+static PulseConnectionLoadFlags
+get_load_flags (PulseBackend *pulse)
+{
+    PulseConnectionLoadFlags flags = 0;
+
+    if (pulse->priv->track_flags & MATE_MIXER_TRACK_DEVICES)
+        flags |= PULSE_CONNECTION_LOAD_CARDS;
+    if (pulse->priv->track_flags & MATE_MIXER_TRACK_INPUT_STREAMS)
+        flags |= PULSE_CONNECTION_LOAD_SOURCES;
+    if (pulse->priv->track_flags & MATE_MIXER_TRACK_OUTPUT_STREAMS)
+        flags |= PULSE_CONNECTION_LOAD_SINKS;
+    if (pulse->priv->track_flags & MATE_MIXER_TRACK_INPUT_APPLICATIONS)
+        flags |= PULSE_CONNECTION_LOAD_SOURCE_OUTPUTS;
+    if (pulse->priv->track_flags & MATE_MIXER_TRACK_OUTPUT_APPLICATIONS)
+        flags |= PULSE_CONNECTION_LOAD_SINK_INPUTS;
+    if (pulse->priv->track_flags & MATE_MIXER_TRACK_STORED_CONTROLS)
+        flags |= PULSE_CONNECTION_LOAD_EXT_STREAMS;
+
+    if (PULSE_DEFAULT_SINK_ONLY (pulse))
+        flags |= PULSE_CONNECTION_LOAD_DEFAULT_SINK;
+    if (PULSE_DEFAULT_SOURCE_ONLY (pulse))
+        flags |= PULSE_CONNECTION_LOAD_DEFAULT_SOURCE;
+
+    return flags;
+}
@@ -29,22 +29,59 @@
 #include "pulse-enum-types.h"
 #include "pulse-monitor.h"
 
+typedef struct
+{
+    PulseConnection          *connection;
+    gint64                    key;
+    PulseConnectionWriteFunc  func;
+    gpointer                  user_data;
+    gboolean                  skipped;
+} PulseWrite;
+
+typedef struct
+{
+    PulseConnection *connection;
+    gint64           key;
+    guint32          index;
+    gboolean         dirty;
+    gboolean         counted;
+} PulseRefresh;
+
+typedef struct
+{
+    PulseConnection *connection;
+    gboolean         counted;
+} PulseLookup;
+
 struct _PulseConnectionPrivate
 {
-    gchar               *server;
-    guint                outstanding;
-    pa_context          *context;
-    pa_proplist         *proplist;
-    pa_glib_mainloop    *mainloop;
-    gboolean             ext_streams_loading;
-    gboolean             ext_streams_dirty;
-    PulseConnectionState state;
+    gchar                    *server;
+    guint                     outstanding;
+    guint                     requests;
+    GList                    *writes;
+    GHashTable               *refreshes;
+    GList                    *lookups;
+    GHashTable               *monitors;
+    pa_threaded_mainloop     *monitor_mainloop;
+    pa_context               *monitor_context;
+    GMainContext             *monitor_main_context;
+    GSource                  *monitor_source;
+    PulseConnectionLoadFlags  load_flags;
+    guint32                   followed_sink;
+    guint32                   followed_source;
+    pa_context               *context;
+    pa_proplist              *proplist;
+    pa_glib_mainloop         *mainloop;
+    gboolean                  ext_streams_loading;
+    gboolean                  ext_streams_dirty;
+    PulseConnectionState      state;
 };
 
 enum {
     PROP_0,
     PROP_SERVER,
     PROP_STATE,
+    PROP_BUSY,
     N_PROPERTIES
 };
 
@@ -65,6 +102,7 @@ enum {
     EXT_STREAM_LOADING,
     EXT_STREAM_LOADED,
     EXT_STREAM_INFO,
+    LIST_LOADED,
     N_SIGNALS
 };
 
@@ -88,8 +126,13 @@ G_DEFINE_TYPE (PulseConnection, pulse_connection, G_TYPE_OBJECT);
 
 static gchar    *create_app_name             (void);
 
+static pa_subscription_mask_t create_subscription_mask (PulseConnectionLoadFlags flags);
+
 static gboolean  load_lists                  (PulseConnection                  *connection);
 static gboolean  load_list_finished          (PulseConnection                  *connection);
+static void      load_deferred_lists         (PulseConnection                  *connection);
+static void      request_started             (PulseConnection                  *connection);
+static void      request_finished            (PulseConnection                  *connection);
 
 static void      pulse_state_cb              (pa_context                       *c,
                                               void                             *userdata);
@@ -123,6 +166,43 @@ static void      pulse_source_output_info_cb (pa_context                       *
                                               const pa_source_output_info      *info,
                                               int                               eol,
                                               void                             *userdata);
+static void      pulse_card_lookup_cb        (pa_context                       *c,
+                                              const pa_card_info               *info,
+                                              int                               eol,
+                                              void                             *userdata);
+static void      pulse_sink_lookup_cb        (pa_context                       *c,
+                                              const pa_sink_info               *info,
+                                              int                               eol,
+                                              void                             *userdata);
+static void      pulse_source_lookup_cb      (pa_context                       *c,
+                                              const pa_source_info             *info,
+                                              int                               eol,
+                                              void                             *userdata);
+static void      pulse_card_refresh_cb          (pa_context                  *c,
+                                                 const pa_card_info          *info,
+                                                 int                          eol,
+                                                 void                        *userdata);
+static void      pulse_sink_refresh_cb          (pa_context                  *c,
+                                                 const pa_sink_info          *info,
+                                                 int                          eol,
+                                                 void                        *userdata);
+static void      pulse_source_refresh_cb        (pa_context                  *c,
+                                                 const pa_source_info        *info,
+                                                 int                          eol,
+                                                 void                        *userdata);
+static void      pulse_sink_input_refresh_cb    (pa_context                  *c,
+                                                 const pa_sink_input_info    *info,
+                                                 int                          eol,
+                                                 void                        *userdata);
+static void      pulse_source_output_refresh_cb (pa_context                  *c,
+                                                 const pa_source_output_info *info,
+                                                 int                          eol,
+                                                 void                        *userdata);
+
+static void      pulse_write_cb              (pa_context                       *c,
+                                              int                               success,
+                                              void                             *userdata);
+
 static void      pulse_ext_stream_restore_cb (pa_context                       *c,
                                               const pa_ext_stream_restore_info *info,
                                               int                               eol,
@@ -133,6 +213,56 @@ static void      change_state                (PulseConnection                  *
 
 static gboolean  process_pulse_operation     (PulseConnection                  *connection,
                                               pa_operation                     *op);
+static gboolean  process_pulse_request       (PulseConnection                  *connection,
+                                              pa_operation                     *op,
+                                              gboolean                          counted);
+static gboolean  process_pulse_write         (PulseConnection                  *connection,
+                                              pa_operation                     *op,
+                                              PulseWrite                       *write);
+static gboolean  process_pulse_refresh       (PulseConnection                  *connection,
+                                              pa_operation                     *op,
+                                              PulseRefresh                     *refresh);
+static gboolean  process_pulse_lookup        (PulseConnection                  *connection,
+                                              pa_operation                     *op,
+                                              PulseLookup                      *lookup);
+
+static PulseWrite *create_write  (PulseConnection          *connection,
+                                  gint64                    key,
+                                  PulseConnectionWriteFunc  func,
+                                  gpointer                  user_data);
+static void        finish_writes (PulseConnection          *connection);
+
+static gboolean    mark_write_skipped (PulseConnection              *connection,
+                                       pa_subscription_event_type_t  facility,
+                                       guint32                       index);
+
+static gboolean      mark_refresh_dirty (PulseConnection              *connection,
+                                         pa_subscription_event_type_t  facility,
+                                         guint32                       index);
+static PulseRefresh *create_refresh     (PulseConnection              *connection,
+                                         pa_subscription_event_type_t  facility,
+                                         guint32                       index);
+static gboolean      finish_refresh     (PulseConnection              *connection,
+                                         PulseRefresh                 *refresh);
+static void          free_refresh       (PulseRefresh                 *refresh);
+
+static PulseLookup  *create_lookup      (PulseConnection              *connection);
+static void          finish_lookup      (PulseConnection              *connection,
+                                         PulseLookup                  *lookup);
+static void          free_lookups       (PulseConnection              *connection);
+
+static gint64        object_key         (pa_subscription_event_type_t  facility,
+                                         guint32                       index);
+
+static void          on_monitor_finalized (PulseConnection *connection,
+                                           GObject         *object);
+static void          forget_monitors      (PulseConnection *connection);
+
+static pa_context   *get_monitor_context      (PulseConnection *connection);
+static void          close_monitor_context    (PulseConnection *connection);
+static void          monitor_context_state_cb (pa_context      *context,
+                                               void            *userdata);
+static gboolean      monitor_context_changed  (PulseConnection *connection);
 
 static void
 pulse_connection_class_init (PulseConnectionClass *klass)
@@ -162,6 +292,14 @@ pulse_connection_class_init (PulseConnectionClass *klass)
                            G_PARAM_READABLE |
                            G_PARAM_STATIC_STRINGS);
 
+    properties[PROP_BUSY] =
+        g_param_spec_boolean ("busy",
+                              "Busy",
+                              "Information requested after a server event is still being loaded",
+                              FALSE,
+                              G_PARAM_READABLE |
+                              G_PARAM_STATIC_STRINGS);
+
     g_object_class_install_properties (object_class, N_PROPERTIES, properties);
 
     signals[SERVER_INFO] =
@@ -332,6 +470,18 @@ pulse_connection_class_init (PulseConnectionClass *klass)
                       1,
                       G_TYPE_POINTER);
 
+    signals[LIST_LOADED] =
+        g_signal_new ("list-loaded",
+                      G_TYPE_FROM_CLASS (object_class),
+                      G_SIGNAL_RUN_LAST,
+                      G_STRUCT_OFFSET (PulseConnectionClass, list_loaded),
+                      NULL,
+                      NULL,
+                      g_cclosure_marshal_VOID__UINT,
+                      G_TYPE_NONE,
+                      1,
+                      G_TYPE_UINT);
+
     g_type_class_add_private (object_class, sizeof (PulseConnectionPrivate));
 }
 
@@ -352,6 +502,9 @@ pulse_connection_get_property (GObject    *object,
     case PROP_STATE:
         g_value_set_enum (value, connection->priv->state);
         break;
+    case PROP_BUSY:
+        g_value_set_boolean (value, connection->priv->requests > 0);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, param_id, pspec);
         break;
@@ -385,6 +538,16 @@ pulse_connection_init (PulseConnection *connection)
     connection->priv = G_TYPE_INSTANCE_GET_PRIVATE (connection,
                                                     PULSE_TYPE_CONNECTION,
                                                     PulseConnectionPrivate);
+
+    connection->priv->refreshes = g_hash_table_new_full (g_int64_hash,
+                                                         g_int64_equal,
+                                                         NULL,
+                                                         (GDestroyNotify) free_refresh);
+
+    connection->priv->monitors = g_hash_table_new_full (g_str_hash,
+                                                        g_str_equal,
+                                                        g_free,
+                                                        NULL);
 }
 
 static void
@@ -399,6 +562,24 @@ pulse_connection_finalize (GObject *object)
     if (connection->priv->context != NULL)
         pa_context_unref (connection->priv->context);
 
+    finish_writes (connection);
+
+    g_hash_table_destroy (connection->priv->refreshes);
+
+    free_lookups (connection);
+
+    forget_monitors (connection);
+    g_hash_table_destroy (connection->priv->monitors);
+
+    if (connection->priv->monitor_mainloop != NULL) {
+        pa_threaded_mainloop_stop (connection->priv->monitor_mainloop);
+
+        close_monitor_context (connection);
+        pa_threaded_mainloop_free (connection->priv->monitor_mainloop);
+
+        g_main_context_unref (connection->priv->monitor_main_context);
+    }
+
     pa_proplist_free (connection->priv->proplist);
     pa_glib_mainloop_free (connection->priv->mainloop);
 
@@ -406,11 +587,12 @@ pulse_connection_finalize (GObject *object)
 }
 
 PulseConnection *
-pulse_connection_new (const gchar *app_name,
-                      const gchar *app_id,
-                      const gchar *app_version,
-                      const gchar *app_icon,
-                      const gchar *server_address)
+pulse_connection_new (const gchar              *app_name,
+                      const gchar              *app_id,
+                      const gchar              *app_version,
+                      const gchar              *app_icon,
+                      const gchar              *server_address,
+                      PulseConnectionLoadFlags  load_flags)
 {
     pa_glib_mainloop *mainloop;
     pa_proplist      *proplist;
@@ -448,6 +630,10 @@ pulse_connection_new (const gchar *app_name,
 
     connection->priv->mainloop = mainloop;
     connection->priv->proplist = proplist;
+    connection->priv->load_flags = load_flags;
+
+    connection->priv->followed_sink   = PA_INVALID_INDEX;
+    connection->priv->followed_source = PA_INVALID_INDEX;
 
     return connection;
 }
@@ -510,6 +696,31 @@ pulse_connection_disconnect (PulseConnection *connection)
     connection->priv->ext_streams_loading = FALSE;
     connection->priv->ext_streams_dirty = FALSE;
 
+    /* Callbacks of the operations are never called once the context is gone */
+    finish_writes (connection);
+
+    g_hash_table_remove_all (connection->priv->refreshes);
+
+    free_lookups (connection);
+
+    /* Monitor streams belong to the old context, existing monitors stay with
+     * their owners but new ones must not share them */
+    forget_monitors (connection);
+
+    if (connection->priv->monitor_mainloop != NULL) {
+        pa_threaded_mainloop_lock (connection->priv->monitor_mainloop);
+        close_monitor_context (connection);
+        pa_threaded_mainloop_unlock (connection->priv->monitor_mainloop);
+    }
+
+    connection->priv->followed_sink   = PA_INVALID_INDEX;
+    connection->priv->followed_source = PA_INVALID_INDEX;
+
+    if (connection->priv->requests > 0) {
+        connection->priv->requests = 0;
+        g_object_notify_by_pspec (G_OBJECT (connection), properties[PROP_BUSY]);
+    }
+
     change_state (connection, PULSE_CONNECTION_DISCONNECTED);
 }
 
@@ -521,6 +732,32 @@ pulse_connection_get_state (PulseConnection *connection)
     return connection->priv->state;
 }
 
+gboolean
+pulse_connection_is_busy (PulseConnection *connection)
+{
+    g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
+
+    return connection->priv->requests > 0;
+}
+
+void
+pulse_connection_follow_sink (PulseConnection *connection, guint32 index)
+{
+    g_return_if_fail (PULSE_IS_CONNECTION (connection));
+
+    /* Unless all sinks are loaded, only changes of the followed sink are
+     * requested from the server */
+    connection->priv->followed_sink = index;
+}
+
+void
+pulse_connection_follow_source (PulseConnection *connection, guint32 index)
+{
+    g_return_if_fail (PULSE_IS_CONNECTION (connection));
+
+    connection->priv->followed_source = index;
+}
+
 gboolean
 pulse_connection_load_server_info (PulseConnection *connection)
 {
@@ -542,6 +779,7 @@ pulse_connection_load_server_info (PulseConnection *connection)
 gboolean
 pulse_connection_load_card_info (PulseConnection *connection, guint32 index)
 {
+    PulseRefresh *refresh;
     pa_operation *op;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
@@ -550,22 +788,28 @@ pulse_connection_load_card_info (PulseConnection *connection, guint32 index)
         connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    if (mark_refresh_dirty (connection, PA_SUBSCRIPTION_EVENT_CARD, index) == TRUE)
+        return TRUE;
+
+    refresh = create_refresh (connection, PA_SUBSCRIPTION_EVENT_CARD, index);
+
     if (index == PA_INVALID_INDEX)
+        op = pa_context_get_card_info_list (connection->priv->context,
+                                            pulse_card_refresh_cb,
+                                            refresh);
+    else
         op = pa_context_get_card_info_by_index (connection->priv->context,
                                                 index,
-                                                pulse_card_info_cb,
-                                                connection);
-    else
-        op = pa_context_get_card_info_list (connection->priv->context,
-                                            pulse_card_info_cb,
-                                            connection);
+                                                pulse_card_refresh_cb,
+                                                refresh);
 
-    return process_pulse_operation (connection, op);
+    return process_pulse_refresh (connection, op, refresh);
 }
 
 gboolean
 pulse_connection_load_card_info_name (PulseConnection *connection, const gchar *name)
 {
+    PulseLookup  *lookup;
     pa_operation *op;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
@@ -575,17 +819,20 @@ pulse_connection_load_card_info_name (PulseConnection *connection, const gchar *
         connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    lookup = create_lookup (connection);
+
     op = pa_context_get_card_info_by_name (connection->priv->context,
                                            name,
-                                           pulse_card_info_cb,
-                                           connection);
+                                           pulse_card_lookup_cb,
+                                           lookup);
 
-    return process_pulse_operation (connection, op);
+    return process_pulse_lookup (connection, op, lookup);
 }
 
 gboolean
 pulse_connection_load_sink_info (PulseConnection *connection, guint32 index)
 {
+    PulseRefresh *refresh;
     pa_operation *op;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
@@ -594,22 +841,28 @@ pulse_connection_load_sink_info (PulseConnection *connection, guint32 index)
         connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    if (mark_refresh_dirty (connection, PA_SUBSCRIPTION_EVENT_SINK, index) == TRUE)
+        return TRUE;
+
+    refresh = create_refresh (connection, PA_SUBSCRIPTION_EVENT_SINK, index);
+
     if (index == PA_INVALID_INDEX)
+        op = pa_context_get_sink_info_list (connection->priv->context,
+                                            pulse_sink_refresh_cb,
+                                            refresh);
+    else
         op = pa_context_get_sink_info_by_index (connection->priv->context,
                                                 index,
-                                                pulse_sink_info_cb,
-                                                connection);
-    else
-        op = pa_context_get_sink_info_list (connection->priv->context,
-                                            pulse_sink_info_cb,
-                                            connection);
+                                                pulse_sink_refresh_cb,
+                                                refresh);
 
-    return process_pulse_operation (connection, op);
+    return process_pulse_refresh (connection, op, refresh);
 }
 
 gboolean
 pulse_connection_load_sink_info_name (PulseConnection *connection, const gchar *name)
 {
+    PulseLookup  *lookup;
     pa_operation *op;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
@@ -619,17 +872,20 @@ pulse_connection_load_sink_info_name (PulseConnection *connection, const gchar *
         connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    lookup = create_lookup (connection);
+
     op = pa_context_get_sink_info_by_name (connection->priv->context,
                                            name,
-                                           pulse_sink_info_cb,
-                                           connection);
+                                           pulse_sink_lookup_cb,
+                                           lookup);
 
-    return process_pulse_operation (connection, op);
+    return process_pulse_lookup (connection, op, lookup);
 }
 
 gboolean
 pulse_connection_load_sink_input_info (PulseConnection *connection, guint32 index)
 {
+    PulseRefresh *refresh;
     pa_operation *op;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
@@ -638,22 +894,28 @@ pulse_connection_load_sink_input_info (PulseConnection *connection, guint32 inde
         connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    if (mark_refresh_dirty (connection, PA_SUBSCRIPTION_EVENT_SINK_INPUT, index) == TRUE)
+        return TRUE;
+
+    refresh = create_refresh (connection, PA_SUBSCRIPTION_EVENT_SINK_INPUT, index);
+
     if (index == PA_INVALID_INDEX)
+        op = pa_context_get_sink_input_info_list (connection->priv->context,
+                                                  pulse_sink_input_refresh_cb,
+                                                  refresh);
+    else
         op = pa_context_get_sink_input_info (connection->priv->context,
                                              index,
-                                             pulse_sink_input_info_cb,
-                                             connection);
-    else
-        op = pa_context_get_sink_input_info_list (connection->priv->context,
-                                                  pulse_sink_input_info_cb,
-                                                  connection);
+                                             pulse_sink_input_refresh_cb,
+                                             refresh);
 
-    return process_pulse_operation (connection, op);
+    return process_pulse_refresh (connection, op, refresh);
 }
 
 gboolean
 pulse_connection_load_source_info (PulseConnection *connection, guint32 index)
 {
+    PulseRefresh *refresh;
     pa_operation *op;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
@@ -662,22 +924,28 @@ pulse_connection_load_source_info (PulseConnection *connection, guint32 index)
         connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    if (mark_refresh_dirty (connection, PA_SUBSCRIPTION_EVENT_SOURCE, index) == TRUE)
+        return TRUE;
+
+    refresh = create_refresh (connection, PA_SUBSCRIPTION_EVENT_SOURCE, index);
+
     if (index == PA_INVALID_INDEX)
+        op = pa_context_get_source_info_list (connection->priv->context,
+                                              pulse_source_refresh_cb,
+                                              refresh);
+    else
         op = pa_context_get_source_info_by_index (connection->priv->context,
                                                   index,
-                                                  pulse_source_info_cb,
-                                                  connection);
-    else
-        op = pa_context_get_source_info_list (connection->priv->context,
-                                              pulse_source_info_cb,
-                                              connection);
+                                                  pulse_source_refresh_cb,
+                                                  refresh);
 
-    return process_pulse_operation (connection, op);
+    return process_pulse_refresh (connection, op, refresh);
 }
 
 gboolean
 pulse_connection_load_source_info_name (PulseConnection *connection, const gchar *name)
 {
+    PulseLookup  *lookup;
     pa_operation *op;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
@@ -687,17 +955,20 @@ pulse_connection_load_source_info_name (PulseConnection *connection, const gchar
         connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    lookup = create_lookup (connection);
+
     op = pa_context_get_source_info_by_name (connection->priv->context,
                                              name,
-                                             pulse_source_info_cb,
-                                             connection);
+                                             pulse_source_lookup_cb,
+                                             lookup);
 
-    return process_pulse_operation (connection, op);
+    return process_pulse_lookup (connection, op, lookup);
 }
 
 gboolean
 pulse_connection_load_source_output_info (PulseConnection *connection, guint32 index)
 {
+    PulseRefresh *refresh;
     pa_operation *op;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
@@ -706,17 +977,22 @@ pulse_connection_load_source_output_info (PulseConnection *connection, guint32 i
         connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    if (mark_refresh_dirty (connection, PA_SUBSCRIPTION_EVENT_SOURCE_OUTPUT, index) == TRUE)
+        return TRUE;
+
+    refresh = create_refresh (connection, PA_SUBSCRIPTION_EVENT_SOURCE_OUTPUT, index);
+
     if (index == PA_INVALID_INDEX)
+        op = pa_context_get_source_output_info_list (connection->priv->context,
+                                                     pulse_source_output_refresh_cb,
+                                                     refresh);
+    else
         op = pa_context_get_source_output_info (connection->priv->context,
                                                 index,
-                                                pulse_source_output_info_cb,
-                                                connection);
-    else
-        op = pa_context_get_source_output_info_list (connection->priv->context,
-                                                     pulse_source_output_info_cb,
-                                                     connection);
+                                                pulse_source_output_refresh_cb,
+                                                refresh);
 
-    return process_pulse_operation (connection, op);
+    return process_pulse_refresh (connection, op, refresh);
 }
 
 gboolean
@@ -752,7 +1028,13 @@ pulse_connection_load_ext_stream_info (PulseConnection *connection)
                                      pulse_ext_stream_restore_cb,
                                      connection);
 
-    if (process_pulse_operation (connection, op) == FALSE) {
+    /* The server might be running without the stream-restore module, which
+     * is not an error */
+    if (op == NULL)
+        g_debug ("Stream restore database is not available: %s",
+                 pa_strerror (pa_context_errno (connection->priv->context)));
+
+    if (op == NULL || process_pulse_operation (connection, op) == FALSE) {
         connection->priv->ext_streams_loading = FALSE;
 
         g_signal_emit (G_OBJECT (connection),
@@ -760,23 +1042,82 @@ pulse_connection_load_ext_stream_info (PulseConnection *connection)
                        0);
         return FALSE;
     }
+
+    request_started (connection);
     return TRUE;
 }
 
 PulseMonitor *
-pulse_connection_create_monitor (PulseConnection *connection,
-                                 guint32          index_source,
-                                 guint32          index_sink_input)
+pulse_connection_get_monitor (PulseConnection       *connection,
+                              guint32                index_source,
+                              guint32                index_sink_input,
+                              guint                  rate,
+                              MateMixerMonitorFlags  flags,
+                              const pa_channel_map  *map)
 {
+    PulseMonitor         *monitor;
+    pa_context           *context  = connection->priv->context;
+    pa_threaded_mainloop *mainloop = NULL;
+    gchar                *key;
+    gchar                 map_str[PA_CHANNEL_MAP_SNPRINT_MAX] = "";
+
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), NULL);
 
     if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return NULL;
 
-    return pulse_monitor_new (connection->priv->context,
-                              connection->priv->proplist,
-                              index_source,
-                              index_sink_input);
+    /* The channel map is only used when measuring each channel */
+    if ((flags & MATE_MIXER_MONITOR_PER_CHANNEL) == 0)
+        map = NULL;
+    if (map != NULL)
+        pa_channel_map_snprint (map_str, sizeof (map_str), map);
+
+    key = g_strdup_printf ("%u:%u:%u:%u:%s",
+                           index_source,
+                           index_sink_input,
+                           rate,
+                           (guint) flags,
+                           map_str);
+
+    /* Monitors with the same source, sink input and options are shared by all
+     * the consumers, the table does not hold a reference so the stream is
+     * closed as soon as the last consumer releases the monitor */
+    monitor = g_hash_table_lookup (connection->priv->monitors, key);
+    if (monitor != NULL) {
+        g_free (key);
+        return g_object_ref (monitor);
+    }
+
+    if (flags & MATE_MIXER_MONITOR_THREADED) {
+        context = get_monitor_context (connection);
+        if (context == NULL) {
+            g_free (key);
+            return NULL;
+        }
+        mainloop = connection->priv->monitor_mainloop;
+    }
+
+    monitor = pulse_monitor_new (context,
+                                 mainloop,
+                                 connection->priv->proplist,
+                                 index_source,
+                                 index_sink_input);
+
+    pulse_monitor_set_options (monitor, rate, flags);
+    if (map != NULL)
+        pulse_monitor_set_channel_map (monitor, map);
+
+    if (pulse_monitor_set_enabled (monitor, TRUE) == FALSE) {
+        g_object_unref (monitor);
+        g_free (key);
+        return NULL;
+    }
+
+    g_hash_table_insert (connection->priv->monitors, key, monitor);
+    g_object_weak_ref (G_OBJECT (monitor),
+                       (GWeakNotify) on_monitor_finalized,
+                       connection);
+    return monitor;
 }
 
 gboolean
@@ -860,10 +1201,13 @@ pulse_connection_set_sink_mute (PulseConnection *connection,
 }
 
 gboolean
-pulse_connection_set_sink_volume (PulseConnection  *connection,
-                                  guint32           index,
-                                  const pa_cvolume *volume)
+pulse_connection_set_sink_volume (PulseConnection          *connection,
+                                  guint32                   index,
+                                  const pa_cvolume         *volume,
+                                  PulseConnectionWriteFunc  func,
+                                  gpointer                  user_data)
 {
+    PulseWrite   *write;
     pa_operation *op;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
@@ -872,12 +1216,18 @@ pulse_connection_set_sink_volume (PulseConnection  *connection,
     if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    write = create_write (connection,
+                          object_key (PA_SUBSCRIPTION_EVENT_SINK, index),
+                          func,
+                          user_data);
+
     op = pa_context_set_sink_volume_by_index (connection->priv->context,
                                               index,
                                               volume,
-                                              NULL, NULL);
+                                              (write != NULL) ? pulse_write_cb : NULL,
+                                              write);
 
-    return process_pulse_operation (connection, op);
+    return process_pulse_write (connection, op, write);
 }
 
 gboolean
@@ -922,10 +1272,13 @@ pulse_connection_set_sink_input_mute (PulseConnection  *connection,
 }
 
 gboolean
-pulse_connection_set_sink_input_volume (PulseConnection  *connection,
-                                        guint32           index,
-                                        const pa_cvolume *volume)
+pulse_connection_set_sink_input_volume (PulseConnection          *connection,
+                                        guint32                   index,
+                                        const pa_cvolume         *volume,
+                                        PulseConnectionWriteFunc  func,
+                                        gpointer                  user_data)
 {
+    PulseWrite   *write;
     pa_operation *op;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
@@ -934,12 +1287,18 @@ pulse_connection_set_sink_input_volume (PulseConnection  *connection,
     if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    write = create_write (connection,
+                          object_key (PA_SUBSCRIPTION_EVENT_SINK_INPUT, index),
+                          func,
+                          user_data);
+
     op = pa_context_set_sink_input_volume (connection->priv->context,
                                            index,
                                            volume,
-                                           NULL, NULL);
+                                           (write != NULL) ? pulse_write_cb : NULL,
+                                           write);
 
-    return process_pulse_operation (connection, op);
+    return process_pulse_write (connection, op, write);
 }
 
 gboolean
@@ -963,10 +1322,13 @@ pulse_connection_set_source_mute (PulseConnection *connection,
 }
 
 gboolean
-pulse_connection_set_source_volume (PulseConnection  *connection,
-                                    guint32           index,
-                                    const pa_cvolume *volume)
+pulse_connection_set_source_volume (PulseConnection          *connection,
+                                    guint32                   index,
+                                    const pa_cvolume         *volume,
+                                    PulseConnectionWriteFunc  func,
+                                    gpointer                  user_data)
 {
+    PulseWrite   *write;
     pa_operation *op;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
@@ -975,12 +1337,18 @@ pulse_connection_set_source_volume (PulseConnection  *connection,
     if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    write = create_write (connection,
+                          object_key (PA_SUBSCRIPTION_EVENT_SOURCE, index),
+                          func,
+                          user_data);
+
     op = pa_context_set_source_volume_by_index (connection->priv->context,
                                                 index,
                                                 volume,
-                                                NULL, NULL);
+                                                (write != NULL) ? pulse_write_cb : NULL,
+                                                write);
 
-    return process_pulse_operation (connection, op);
+    return process_pulse_write (connection, op, write);
 }
 
 gboolean
@@ -1025,10 +1393,13 @@ pulse_connection_set_source_output_mute (PulseConnection *connection,
 }
 
 gboolean
-pulse_connection_set_source_output_volume (PulseConnection  *connection,
-                                           guint32           index,
-                                           const pa_cvolume *volume)
+pulse_connection_set_source_output_volume (PulseConnection          *connection,
+                                           guint32                   index,
+                                           const pa_cvolume         *volume,
+                                           PulseConnectionWriteFunc  func,
+                                           gpointer                  user_data)
 {
+    PulseWrite   *write;
     pa_operation *op;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
@@ -1037,12 +1408,18 @@ pulse_connection_set_source_output_volume (PulseConnection  *connection,
     if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    write = create_write (connection,
+                          object_key (PA_SUBSCRIPTION_EVENT_SOURCE_OUTPUT, index),
+                          func,
+                          user_data);
+
     op = pa_context_set_source_output_volume (connection->priv->context,
                                               index,
                                               volume,
-                                              NULL, NULL);
+                                              (write != NULL) ? pulse_write_cb : NULL,
+                                              write);
 
-    return process_pulse_operation (connection, op);
+    return process_pulse_write (connection, op, write);
 }
 
 gboolean
@@ -1163,8 +1540,11 @@ pulse_connection_kill_source_output (PulseConnection *connection,
 
 gboolean
 pulse_connection_write_ext_stream (PulseConnection                  *connection,
-                                   const pa_ext_stream_restore_info *info)
+                                   const pa_ext_stream_restore_info *info,
+                                   PulseConnectionWriteFunc          func,
+                                   gpointer                          user_data)
 {
+    PulseWrite   *write;
     pa_operation *op;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), FALSE);
@@ -1173,13 +1553,16 @@ pulse_connection_write_ext_stream (PulseConnection                  *connection,
     if (connection->priv->state != PULSE_CONNECTION_CONNECTED)
         return FALSE;
 
+    write = create_write (connection, -1, func, user_data);
+
     op = pa_ext_stream_restore_write (connection->priv->context,
                                       PA_UPDATE_REPLACE,
                                       info, 1,
                                       TRUE,
-                                      NULL, NULL);
+                                      (write != NULL) ? pulse_write_cb : NULL,
+                                      write);
 
-    return process_pulse_operation (connection, op);
+    return process_pulse_write (connection, op, write);
 }
 
 gboolean
@@ -1225,71 +1608,78 @@ create_app_name (void)
     return g_strdup_printf ("libmatemixer-%lu", (gulong) getpid ());
 }
 
+static pa_subscription_mask_t
+create_subscription_mask (PulseConnectionLoadFlags flags)
+{
+    pa_subscription_mask_t mask = PA_SUBSCRIPTION_MASK_SERVER;
+
+    if (flags & PULSE_CONNECTION_LOAD_CARDS)
+        mask |= PA_SUBSCRIPTION_MASK_CARD;
+    if (flags & (PULSE_CONNECTION_LOAD_SINKS | PULSE_CONNECTION_LOAD_DEFAULT_SINK))
+        mask |= PA_SUBSCRIPTION_MASK_SINK;
+    if (flags & (PULSE_CONNECTION_LOAD_SOURCES | PULSE_CONNECTION_LOAD_DEFAULT_SOURCE))
+        mask |= PA_SUBSCRIPTION_MASK_SOURCE;
+    if (flags & PULSE_CONNECTION_LOAD_SINK_INPUTS)
+        mask |= PA_SUBSCRIPTION_MASK_SINK_INPUT;
+    if (flags & PULSE_CONNECTION_LOAD_SOURCE_OUTPUTS)
+        mask |= PA_SUBSCRIPTION_MASK_SOURCE_OUTPUT;
+
+    return mask;
+}
+
 static gboolean
 load_lists (PulseConnection *connection)
 {
-    GSList       *ops = NULL;
-    pa_operation *op;
+    GSList                   *ops = NULL;
+    pa_operation             *op;
+    PulseConnectionLoadFlags  flags;
 
     if G_UNLIKELY (connection->priv->outstanding > 0) {
         g_warn_if_reached ();
         return FALSE;
     }
 
-    op = pa_context_get_card_info_list (connection->priv->context,
-                                        pulse_card_info_cb,
-                                        connection);
-    if G_UNLIKELY (op == NULL)
-        goto error;
-
-    ops = g_slist_prepend (ops, op);
-
-    op = pa_context_get_sink_info_list (connection->priv->context,
-                                        pulse_sink_info_cb,
-                                        connection);
-    if G_UNLIKELY (op == NULL)
-        goto error;
-
-    ops = g_slist_prepend (ops, op);
-
-    op = pa_context_get_sink_input_info_list (connection->priv->context,
-                                              pulse_sink_input_info_cb,
-                                              connection);
-    if G_UNLIKELY (op == NULL)
-        goto error;
-
-    ops = g_slist_prepend (ops, op);
+    flags = connection->priv->load_flags;
 
-    op = pa_context_get_source_info_list (connection->priv->context,
-                                          pulse_source_info_cb,
-                                          connection);
-    if G_UNLIKELY (op == NULL)
-        goto error;
+    if (flags & PULSE_CONNECTION_LOAD_CARDS) {
+        op = pa_context_get_card_info_list (connection->priv->context,
+                                            pulse_card_info_cb,
+                                            connection);
+        if G_UNLIKELY (op == NULL)
+            goto error;
 
-    ops = g_slist_prepend (ops, op);
+        ops = g_slist_prepend (ops, op);
+    }
 
-    op = pa_context_get_source_output_info_list (connection->priv->context,
-                                                 pulse_source_output_info_cb,
-                                                 connection);
-    if G_UNLIKELY (op == NULL)
-        goto error;
+    if (flags & PULSE_CONNECTION_LOAD_SINKS) {
+        op = pa_context_get_sink_info_list (connection->priv->context,
+                                            pulse_sink_info_cb,
+                                            connection);
+        if G_UNLIKELY (op == NULL)
+            goto error;
 
-    ops = g_slist_prepend (ops, op);
+        ops = g_slist_prepend (ops, op);
+    }
 
-    connection->priv->outstanding = 5;
+    if (flags & PULSE_CONNECTION_LOAD_SOURCES) {
+        op = pa_context_get_source_info_list (connection->priv->context,
+                                              pulse_source_info_cb,
+                                              connection);
+        if G_UNLIKELY (op == NULL)
+            goto error;
 
-    /* This might not always be supported */
-    op = pa_ext_stream_restore_read (connection->priv->context,
-                                     pulse_ext_stream_restore_cb,
-                                     connection);
-    if (op != NULL) {
         ops = g_slist_prepend (ops, op);
-        connection->priv->outstanding++;
     }
 
+    connection->priv->outstanding = g_slist_length (ops);
+
     g_slist_foreach (ops, (GFunc) pa_operation_unref, NULL);
     g_slist_free (ops);
 
+    /* With no lists to wait for, go straight to the final step */
+    if (connection->priv->outstanding == 0)
+        return pulse_connection_load_server_info (connection);
+
     return TRUE;
 
 error:
@@ -1324,6 +1714,73 @@ load_list_finished (PulseConnection *connection)
     return TRUE;
 }
 
+static void
+load_deferred_lists (PulseConnection *connection)
+{
+    pa_operation             *op;
+    PulseConnectionLoadFlags  flags;
+
+    /* Sink inputs, source outputs and the stream database are requested after
+     * the server information, which completes the connection process.
+     * The server answers the requests in order, so these lists arrive after
+     * the connected state is reached and the lists keep the connection busy
+     * until they are complete */
+    flags = connection->priv->load_flags;
+
+    if (flags & PULSE_CONNECTION_LOAD_SINK_INPUTS) {
+        op = pa_context_get_sink_input_info_list (connection->priv->context,
+                                                  pulse_sink_input_info_cb,
+                                                  connection);
+
+        if (process_pulse_operation (connection, op) == TRUE)
+            request_started (connection);
+        else
+            g_signal_emit (G_OBJECT (connection),
+                           signals[LIST_LOADED],
+                           0,
+                           PULSE_CONNECTION_LOAD_SINK_INPUTS);
+    }
+
+    if (flags & PULSE_CONNECTION_LOAD_SOURCE_OUTPUTS) {
+        op = pa_context_get_source_output_info_list (connection->priv->context,
+                                                     pulse_source_output_info_cb,
+                                                     connection);
+
+        if (process_pulse_operation (connection, op) == TRUE)
+            request_started (connection);
+        else
+            g_signal_emit (G_OBJECT (connection),
+                           signals[LIST_LOADED],
+                           0,
+                           PULSE_CONNECTION_LOAD_SOURCE_OUTPUTS);
+    }
+
+    /* This might not always be supported */
+    if (flags & PULSE_CONNECTION_LOAD_EXT_STREAMS)
+        pulse_connection_load_ext_stream_info (connection);
+}
+
+static void
+request_started (PulseConnection *connection)
+{
+    connection->priv->requests++;
+
+    if (connection->priv->requests == 1)
+        g_object_notify_by_pspec (G_OBJECT (connection), properties[PROP_BUSY]);
+}
+
+static void
+request_finished (PulseConnection *connection)
+{
+    if G_UNLIKELY (connection->priv->requests == 0)
+        return;
+
+    connection->priv->requests--;
+
+    if (connection->priv->requests == 0)
+        g_object_notify_by_pspec (G_OBJECT (connection), properties[PROP_BUSY]);
+}
+
 static void
 pulse_state_cb (pa_context *c, void *userdata)
 {
@@ -1352,20 +1809,17 @@ pulse_state_cb (pa_context *c, void *userdata)
                                                 pulse_restore_subscribe_cb,
                                                 connection);
 
-        op = pa_ext_stream_restore_subscribe (connection->priv->context,
-                                              TRUE,
-                                              NULL, NULL);
+        if (connection->priv->load_flags & PULSE_CONNECTION_LOAD_EXT_STREAMS) {
+            op = pa_ext_stream_restore_subscribe (connection->priv->context,
+                                                  TRUE,
+                                                  NULL, NULL);
 
-        /* Keep going if this operation fails */
-        process_pulse_operation (connection, op);
+            /* Keep going if this operation fails */
+            process_pulse_operation (connection, op);
+        }
 
         op = pa_context_subscribe (connection->priv->context,
-                                   PA_SUBSCRIPTION_MASK_SERVER |
-                                   PA_SUBSCRIPTION_MASK_CARD |
-                                   PA_SUBSCRIPTION_MASK_SINK |
-                                   PA_SUBSCRIPTION_MASK_SOURCE |
-                                   PA_SUBSCRIPTION_MASK_SINK_INPUT |
-                                   PA_SUBSCRIPTION_MASK_SOURCE_OUTPUT,
+                                   create_subscription_mask (connection->priv->load_flags),
                                    NULL, NULL);
 
         if (process_pulse_operation (connection, op) == TRUE) {
@@ -1400,6 +1854,14 @@ pulse_subscribe_cb (pa_context                   *c,
 
     connection = PULSE_CONNECTION (userdata);
 
+    /* Skip change events echoing our own writes while a write to the same
+     * object is in progress, the information would be outdated anyway. The
+     * skipped event is replayed once the write is acknowledged to pick up
+     * possible changes made by other clients in the meantime */
+    if ((t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) == PA_SUBSCRIPTION_EVENT_CHANGE &&
+        mark_write_skipped (connection, t & PA_SUBSCRIPTION_EVENT_FACILITY_MASK, idx) == TRUE)
+        return;
+
     switch (t & PA_SUBSCRIPTION_EVENT_FACILITY_MASK) {
     case PA_SUBSCRIPTION_EVENT_SERVER:
         pulse_connection_load_server_info (connection);
@@ -1421,7 +1883,8 @@ pulse_subscribe_cb (pa_context                   *c,
                            signals[SINK_REMOVED],
                            0,
                            idx);
-        else
+        else if (connection->priv->load_flags & PULSE_CONNECTION_LOAD_SINKS ||
+                 connection->priv->followed_sink == idx)
             pulse_connection_load_sink_info (connection, idx);
         break;
 
@@ -1441,7 +1904,8 @@ pulse_subscribe_cb (pa_context                   *c,
                            signals[SOURCE_REMOVED],
                            0,
                            idx);
-        else
+        else if (connection->priv->load_flags & PULSE_CONNECTION_LOAD_SOURCES ||
+                 connection->priv->followed_source == idx)
             pulse_connection_load_source_info (connection, idx);
         break;
 
@@ -1483,8 +1947,11 @@ pulse_server_info_cb (pa_context           *c,
 
     /* This notification may arrive at any time, but it also finalizes the
      * connection process */
-    if (connection->priv->state == PULSE_CONNECTION_LOADING)
+    if (connection->priv->state == PULSE_CONNECTION_LOADING) {
+        load_deferred_lists (connection);
+
         change_state (connection, PULSE_CONNECTION_CONNECTED);
+    }
 }
 
 static void
@@ -1542,8 +2009,12 @@ pulse_sink_input_info_cb (pa_context               *c,
     connection = PULSE_CONNECTION (userdata);
 
     if (eol) {
-        if (connection->priv->state == PULSE_CONNECTION_LOADING)
-            load_list_finished (connection);
+        g_signal_emit (G_OBJECT (connection),
+                       signals[LIST_LOADED],
+                       0,
+                       PULSE_CONNECTION_LOAD_SINK_INPUTS);
+
+        request_finished (connection);
         return;
     }
 
@@ -1586,8 +2057,12 @@ pulse_source_output_info_cb (pa_context                  *c,
     connection = PULSE_CONNECTION (userdata);
 
     if (eol) {
-        if (connection->priv->state == PULSE_CONNECTION_LOADING)
-            load_list_finished (connection);
+        g_signal_emit (G_OBJECT (connection),
+                       signals[LIST_LOADED],
+                       0,
+                       PULSE_CONNECTION_LOAD_SOURCE_OUTPUTS);
+
+        request_finished (connection);
         return;
     }
 
@@ -1598,29 +2073,258 @@ pulse_source_output_info_cb (pa_context                  *c,
 }
 
 static void
-pulse_ext_stream_restore_cb (pa_context                       *c,
-                             const pa_ext_stream_restore_info *info,
-                             int                               eol,
-                             void                             *userdata)
+pulse_card_lookup_cb (pa_context         *c,
+                      const pa_card_info *info,
+                      int                 eol,
+                      void               *userdata)
 {
-    PulseConnection *connection;
-
-    connection = PULSE_CONNECTION (userdata);
+    PulseLookup *lookup = userdata;
 
     if (eol) {
-        connection->priv->ext_streams_loading = FALSE;
-        g_signal_emit (G_OBJECT (connection),
-                       signals[EXT_STREAM_LOADED],
-                       0);
-
-        if (connection->priv->state == PULSE_CONNECTION_LOADING) {
-            if (load_list_finished (connection) == FALSE)
-                return;
-        }
+        finish_lookup (lookup->connection, lookup);
+        return;
+    }
 
-        if (connection->priv->ext_streams_dirty == TRUE)
+    g_signal_emit (G_OBJECT (lookup->connection),
+                   signals[CARD_INFO],
+                   0,
+                   info);
+}
+
+static void
+pulse_sink_lookup_cb (pa_context         *c,
+                      const pa_sink_info *info,
+                      int                 eol,
+                      void               *userdata)
+{
+    PulseLookup *lookup = userdata;
+
+    if (eol) {
+        finish_lookup (lookup->connection, lookup);
+        return;
+    }
+
+    g_signal_emit (G_OBJECT (lookup->connection),
+                   signals[SINK_INFO],
+                   0,
+                   info);
+}
+
+static void
+pulse_source_lookup_cb (pa_context           *c,
+                        const pa_source_info *info,
+                        int                   eol,
+                        void                 *userdata)
+{
+    PulseLookup *lookup = userdata;
+
+    if (eol) {
+        finish_lookup (lookup->connection, lookup);
+        return;
+    }
+
+    g_signal_emit (G_OBJECT (lookup->connection),
+                   signals[SOURCE_INFO],
+                   0,
+                   info);
+}
+
+static void
+pulse_card_refresh_cb (pa_context         *c,
+                       const pa_card_info *info,
+                       int                 eol,
+                       void               *userdata)
+{
+    PulseConnection *connection;
+    PulseRefresh    *refresh;
+
+    refresh    = userdata;
+    connection = refresh->connection;
+
+    if (eol) {
+        guint32  index   = refresh->index;
+        gboolean counted = refresh->counted;
+
+        if (finish_refresh (connection, refresh) == TRUE)
+            pulse_connection_load_card_info (connection, index);
+
+        if (counted == TRUE)
+            request_finished (connection);
+        return;
+    }
+
+    g_signal_emit (G_OBJECT (connection),
+                   signals[CARD_INFO],
+                   0,
+                   info);
+}
+
+static void
+pulse_sink_refresh_cb (pa_context         *c,
+                       const pa_sink_info *info,
+                       int                 eol,
+                       void               *userdata)
+{
+    PulseConnection *connection;
+    PulseRefresh    *refresh;
+
+    refresh    = userdata;
+    connection = refresh->connection;
+
+    if (eol) {
+        guint32  index   = refresh->index;
+        gboolean counted = refresh->counted;
+
+        if (finish_refresh (connection, refresh) == TRUE)
+            pulse_connection_load_sink_info (connection, index);
+
+        if (counted == TRUE)
+            request_finished (connection);
+        return;
+    }
+
+    g_signal_emit (G_OBJECT (connection),
+                   signals[SINK_INFO],
+                   0,
+                   info);
+}
+
+static void
+pulse_source_refresh_cb (pa_context           *c,
+                         const pa_source_info *info,
+                         int                   eol,
+                         void                 *userdata)
+{
+    PulseConnection *connection;
+    PulseRefresh    *refresh;
+
+    refresh    = userdata;
+    connection = refresh->connection;
+
+    if (eol) {
+        guint32  index   = refresh->index;
+        gboolean counted = refresh->counted;
+
+        if (finish_refresh (connection, refresh) == TRUE)
+            pulse_connection_load_source_info (connection, index);
+
+        if (counted == TRUE)
+            request_finished (connection);
+        return;
+    }
+
+    g_signal_emit (G_OBJECT (connection),
+                   signals[SOURCE_INFO],
+                   0,
+                   info);
+}
+
+static void
+pulse_sink_input_refresh_cb (pa_context               *c,
+                             const pa_sink_input_info *info,
+                             int                       eol,
+                             void                     *userdata)
+{
+    PulseConnection *connection;
+    PulseRefresh    *refresh;
+
+    refresh    = userdata;
+    connection = refresh->connection;
+
+    if (eol) {
+        guint32  index   = refresh->index;
+        gboolean counted = refresh->counted;
+
+        if (finish_refresh (connection, refresh) == TRUE)
+            pulse_connection_load_sink_input_info (connection, index);
+
+        if (counted == TRUE)
+            request_finished (connection);
+        return;
+    }
+
+    g_signal_emit (G_OBJECT (connection),
+                   signals[SINK_INPUT_INFO],
+                   0,
+                   info);
+}
+
+static void
+pulse_source_output_refresh_cb (pa_context                  *c,
+                                const pa_source_output_info *info,
+                                int                          eol,
+                                void                        *userdata)
+{
+    PulseConnection *connection;
+    PulseRefresh    *refresh;
+
+    refresh    = userdata;
+    connection = refresh->connection;
+
+    if (eol) {
+        guint32  index   = refresh->index;
+        gboolean counted = refresh->counted;
+
+        if (finish_refresh (connection, refresh) == TRUE)
+            pulse_connection_load_source_output_info (connection, index);
+
+        if (counted == TRUE)
+            request_finished (connection);
+        return;
+    }
+
+    g_signal_emit (G_OBJECT (connection),
+                   signals[SOURCE_OUTPUT_INFO],
+                   0,
+                   info);
+}
+
+static void
+pulse_write_cb (pa_context *c, int success, void *userdata)
+{
+    PulseWrite      *write = userdata;
+    PulseConnection *connection = write->connection;
+    gint64           key;
+    gboolean         skipped;
+
+    connection->priv->writes = g_list_remove (connection->priv->writes, write);
+
+    write->func ((success != 0) ? TRUE : FALSE, write->user_data);
+
+    key     = write->key;
+    skipped = write->skipped;
+
+    g_slice_free (PulseWrite, write);
+
+    /* Replay a change event skipped while the write was in progress, it is
+     * skipped again if the callback has issued another write to the object */
+    if (skipped == TRUE && connection->priv->state == PULSE_CONNECTION_CONNECTED)
+        pulse_subscribe_cb (c,
+                            (pa_subscription_event_type_t) (key >> 32) | PA_SUBSCRIPTION_EVENT_CHANGE,
+                            (guint32) key,
+                            connection);
+}
+
+static void
+pulse_ext_stream_restore_cb (pa_context                       *c,
+                             const pa_ext_stream_restore_info *info,
+                             int                               eol,
+                             void                             *userdata)
+{
+    PulseConnection *connection;
+
+    connection = PULSE_CONNECTION (userdata);
+
+    if (eol) {
+        connection->priv->ext_streams_loading = FALSE;
+        g_signal_emit (G_OBJECT (connection),
+                       signals[EXT_STREAM_LOADED],
+                       0);
+
+        if (connection->priv->ext_streams_dirty == TRUE)
             pulse_connection_load_ext_stream_info (connection);
 
+        request_finished (connection);
         return;
     }
 
@@ -1653,3 +2357,406 @@ process_pulse_operation (PulseConnection *connection, pa_operation *op)
     pa_operation_unref (op);
     return TRUE;
 }
+
+static gboolean
+process_pulse_request (PulseConnection *connection, pa_operation *op, gboolean counted)
+{
+    if (process_pulse_operation (connection, op) == FALSE)
+        return FALSE;
+
+    /* Keep track of information requested in reaction to server events, the
+     * connection is busy until all the requested information arrives */
+    if (counted == TRUE)
+        request_started (connection);
+
+    return TRUE;
+}
+
+static gboolean
+process_pulse_write (PulseConnection *connection, pa_operation *op, PulseWrite *write)
+{
+    if (process_pulse_operation (connection, op) == FALSE) {
+        /* The callback will never be called */
+        if (write != NULL)
+            g_slice_free (PulseWrite, write);
+        return FALSE;
+    }
+
+    if (write != NULL)
+        connection->priv->writes = g_list_prepend (connection->priv->writes, write);
+
+    return TRUE;
+}
+
+static PulseWrite *
+create_write (PulseConnection          *connection,
+              gint64                    key,
+              PulseConnectionWriteFunc  func,
+              gpointer                  user_data)
+{
+    PulseWrite *write;
+
+    if (func == NULL)
+        return NULL;
+
+    write = g_slice_new (PulseWrite);
+    write->connection = connection;
+    write->key        = key;
+    write->func       = func;
+    write->user_data  = user_data;
+    write->skipped    = FALSE;
+    return write;
+}
+
+static void
+finish_writes (PulseConnection *connection)
+{
+    GList *writes;
+    GList *list;
+
+    /* The callbacks may issue new writes, which will fail */
+    writes = connection->priv->writes;
+    connection->priv->writes = NULL;
+
+    for (list = writes; list != NULL; list = list->next) {
+        PulseWrite *write = list->data;
+
+        write->func (FALSE, write->user_data);
+
+        g_slice_free (PulseWrite, write);
+    }
+    g_list_free (writes);
+}
+
+static gboolean
+mark_write_skipped (PulseConnection              *connection,
+                    pa_subscription_event_type_t  facility,
+                    guint32                       index)
+{
+    GList    *list;
+    gint64    key;
+    gboolean  pending = FALSE;
+
+    key = object_key (facility, index);
+
+    for (list = connection->priv->writes; list != NULL; list = list->next) {
+        PulseWrite *write = list->data;
+
+        if (write->key == key) {
+            write->skipped = TRUE;
+            pending = TRUE;
+        }
+    }
+    return pending;
+}
+
+static gboolean
+process_pulse_refresh (PulseConnection *connection, pa_operation *op, PulseRefresh *refresh)
+{
+    if (process_pulse_request (connection, op, refresh->counted) == FALSE) {
+        free_refresh (refresh);
+        return FALSE;
+    }
+
+    g_hash_table_insert (connection->priv->refreshes, &refresh->key, refresh);
+    return TRUE;
+}
+
+static gboolean
+process_pulse_lookup (PulseConnection *connection, pa_operation *op, PulseLookup *lookup)
+{
+    if (process_pulse_request (connection, op, lookup->counted) == FALSE) {
+        g_slice_free (PulseLookup, lookup);
+        return FALSE;
+    }
+
+    connection->priv->lookups = g_list_prepend (connection->priv->lookups, lookup);
+    return TRUE;
+}
+
+static gint64
+object_key (pa_subscription_event_type_t facility, guint32 index)
+{
+    return ((gint64) facility << 32) | index;
+}
+
+static gboolean
+mark_refresh_dirty (PulseConnection              *connection,
+                    pa_subscription_event_type_t  facility,
+                    guint32                       index)
+{
+    PulseRefresh *refresh;
+    gint64        key;
+
+    /* Servers often send bursts of change events for the same object, while
+     * information about the object is being downloaded, only remember that it
+     * needs to be downloaded again once the current request finishes */
+    key = object_key (facility, index);
+
+    refresh = g_hash_table_lookup (connection->priv->refreshes, &key);
+    if (refresh == NULL)
+        return FALSE;
+
+    refresh->dirty = TRUE;
+    return TRUE;
+}
+
+static PulseRefresh *
+create_refresh (PulseConnection              *connection,
+                pa_subscription_event_type_t  facility,
+                guint32                       index)
+{
+    PulseRefresh *refresh;
+
+    refresh = g_slice_new0 (PulseRefresh);
+    refresh->connection = connection;
+    refresh->key        = object_key (facility, index);
+    refresh->index      = index;
+
+    /* Only requests made once connected keep the connection busy, the ones
+     * made while loading are covered by the loading itself */
+    refresh->counted    = (connection->priv->state == PULSE_CONNECTION_CONNECTED);
+
+    return refresh;
+}
+
+static gboolean
+finish_refresh (PulseConnection *connection, PulseRefresh *refresh)
+{
+    gboolean dirty = refresh->dirty;
+
+    /* Let the caller request the information again if it has changed while
+     * the request was in progress; the follow-up request should be made before
+     * finishing the current one to avoid toggling the busy flag */
+    g_hash_table_remove (connection->priv->refreshes, &refresh->key);
+    return dirty;
+}
+
+static void
+free_refresh (PulseRefresh *refresh)
+{
+    g_slice_free (PulseRefresh, refresh);
+}
+
+static PulseLookup *
+create_lookup (PulseConnection *connection)
+{
+    PulseLookup *lookup;
+
+    lookup = g_slice_new (PulseLookup);
+    lookup->connection = connection;
+    lookup->counted    = (connection->priv->state == PULSE_CONNECTION_CONNECTED);
+
+    return lookup;
+}
+
+static void
+finish_lookup (PulseConnection *connection, PulseLookup *lookup)
+{
+    connection->priv->lookups = g_list_remove (connection->priv->lookups, lookup);
+
+    if (lookup->counted == TRUE)
+        request_finished (connection);
+
+    g_slice_free (PulseLookup, lookup);
+}
+
+static void
+free_lookups (PulseConnection *connection)
+{
+    GList *list;
+
+    /* The callbacks are never called once the context is gone */
+    for (list = connection->priv->lookups; list != NULL; list = list->next)
+        g_slice_free (PulseLookup, list->data);
+
+    g_list_free (connection->priv->lookups);
+    connection->priv->lookups = NULL;
+}
+
+static void
+on_monitor_finalized (PulseConnection *connection, GObject *object)
+{
+    GHashTableIter iter;
+    gpointer       value;
+
+    g_hash_table_iter_init (&iter, connection->priv->monitors);
+
+    while (g_hash_table_iter_next (&iter, NULL, &value) == TRUE)
+        if (value == (gpointer) object) {
+            g_hash_table_iter_remove (&iter);
+            break;
+        }
+}
+
+static void
+forget_monitors (PulseConnection *connection)
+{
+    GHashTableIter iter;
+    gpointer       value;
+
+    g_hash_table_iter_init (&iter, connection->priv->monitors);
+
+    while (g_hash_table_iter_next (&iter, NULL, &value) == TRUE)
+        g_object_weak_unref (G_OBJECT (value),
+                             (GWeakNotify) on_monitor_finalized,
+                             connection);
+
+    g_hash_table_remove_all (connection->priv->monitors);
+}
+
+static pa_context *
+get_monitor_context (PulseConnection *connection)
+{
+    pa_threaded_mainloop *mainloop;
+    pa_context           *context;
+
+    /* Threaded monitors use their own context in a separate thread, which
+     * is started when the first such monitor is requested */
+    if (connection->priv->monitor_mainloop == NULL) {
+        mainloop = pa_threaded_mainloop_new ();
+        if G_UNLIKELY (mainloop == NULL) {
+            g_warning ("Failed to create PulseAudio threaded main loop");
+            return NULL;
+        }
+
+        if G_UNLIKELY (pa_threaded_mainloop_start (mainloop) < 0) {
+            g_warning ("Failed to start PulseAudio threaded main loop");
+            pa_threaded_mainloop_free (mainloop);
+            return NULL;
+        }
+        connection->priv->monitor_mainloop     = mainloop;
+        connection->priv->monitor_main_context = g_main_context_ref_thread_default ();
+    } else
+        mainloop = connection->priv->monitor_mainloop;
+
+    pa_threaded_mainloop_lock (mainloop);
+
+    context = connection->priv->monitor_context;
+    if (context != NULL) {
+        /* The context may still be connecting, monitors created meanwhile
+         * are started once it becomes ready */
+        if (PA_CONTEXT_IS_GOOD (pa_context_get_state (context))) {
+            pa_threaded_mainloop_unlock (mainloop);
+            return context;
+        }
+
+        /* The server of the old context has gone away */
+        close_monitor_context (connection);
+    }
+
+    context = pa_context_new_with_proplist (pa_threaded_mainloop_get_api (mainloop),
+                                            NULL,
+                                            connection->priv->proplist);
+    if G_UNLIKELY (context == NULL) {
+        g_warning ("Failed to create PulseAudio monitor context");
+        pa_threaded_mainloop_unlock (mainloop);
+        return NULL;
+    }
+
+    pa_context_set_state_callback (context,
+                                   monitor_context_state_cb,
+                                   connection);
+
+    connection->priv->monitor_context = context;
+
+    /* Do not wait for the connection to be established, the monitor streams
+     * are connected from monitor_context_changed() */
+    if (pa_context_connect (context,
+                            connection->priv->server,
+                            PA_CONTEXT_NOFLAGS,
+                            NULL) < 0) {
+        g_warning ("Failed to connect PulseAudio monitor context: %s",
+                   pa_strerror (pa_context_errno (context)));
+
+        close_monitor_context (connection);
+        context = NULL;
+    }
+
+    pa_threaded_mainloop_unlock (mainloop);
+    return context;
+}
+
+static void
+close_monitor_context (PulseConnection *connection)
+{
+    if (connection->priv->monitor_source != NULL) {
+        g_source_destroy (connection->priv->monitor_source);
+        g_source_unref (connection->priv->monitor_source);
+
+        connection->priv->monitor_source = NULL;
+    }
+
+    if (connection->priv->monitor_context == NULL)
+        return;
+
+    pa_context_set_state_callback (connection->priv->monitor_context, NULL, NULL);
+    pa_context_disconnect (connection->priv->monitor_context);
+    pa_context_unref (connection->priv->monitor_context);
+
+    connection->priv->monitor_context = NULL;
+}
+
+static void
+monitor_context_state_cb (pa_context *context, void *userdata)
+{
+    PulseConnection    *connection;
+    pa_context_state_t  state;
+
+    connection = PULSE_CONNECTION (userdata);
+
+    state = pa_context_get_state (context);
+    if (state != PA_CONTEXT_READY && PA_CONTEXT_IS_GOOD (state))
+        return;
+
+    /* Called in the thread of the monitor main loop with the lock held, the
+     * monitors are started in the main loop of the connection */
+    if (connection->priv->monitor_source == NULL) {
+        GSource *source = g_idle_source_new ();
+
+        /* The source is destroyed together with the monitor context */
+        g_source_set_callback (source,
+                               (GSourceFunc) monitor_context_changed,
+                               connection,
+                               NULL);
+        g_source_attach (source, connection->priv->monitor_main_context);
+
+        connection->priv->monitor_source = source;
+    }
+}
+
+static gboolean
+monitor_context_changed (PulseConnection *connection)
+{
+    pa_threaded_mainloop *mainloop = connection->priv->monitor_mainloop;
+    pa_context_state_t    state;
+    int                   error = 0;
+    GList                *list;
+    GList                *item;
+
+    pa_threaded_mainloop_lock (mainloop);
+
+    g_source_unref (connection->priv->monitor_source);
+    connection->priv->monitor_source = NULL;
+
+    state = pa_context_get_state (connection->priv->monitor_context);
+    if (state != PA_CONTEXT_READY)
+        error = pa_context_errno (connection->priv->monitor_context);
+
+    pa_threaded_mainloop_unlock (mainloop);
+
+    if (state != PA_CONTEXT_READY)
+        g_warning ("Failed to connect PulseAudio monitor context: %s",
+                   pa_strerror (error));
+
+    /* Monitors waiting for the context are connected now, or turned off if
+     * the context has failed, the table may change while doing that */
+    list = g_hash_table_get_values (connection->priv->monitors);
+    g_list_foreach (list, (GFunc) g_object_ref, NULL);
+
+    for (item = list; item != NULL; item = item->next)
+        pulse_monitor_start_pending (PULSE_MONITOR (item->data));
+
+    g_list_free_full (list, g_object_unref);
+    return G_SOURCE_REMOVE;
+}
@@ -21,6 +21,8 @@
 #include <glib.h>
 #include <glib-object.h>
 
+#include <libmatemixer/matemixer.h>
+
 #include <pulse/pulseaudio.h>
 #include <pulse/ext-stream-restore.h>
 
@@ -45,6 +47,10 @@ G_BEGIN_DECLS
 typedef struct _PulseConnectionClass    PulseConnectionClass;
 typedef struct _PulseConnectionPrivate  PulseConnectionPrivate;
 
+/* Called when the server has processed a write request or when the request
+ * is abandoned because the connection has been closed */
+typedef void (*PulseConnectionWriteFunc) (gboolean success, gpointer user_data);
+
 struct _PulseConnection
 {
     GObject parent;
@@ -90,6 +96,9 @@ struct _PulseConnectionClass
     void (*ext_stream_loaded)     (PulseConnection                  *connection);
     void (*ext_stream_info)       (PulseConnection                  *connection,
                                    const pa_ext_stream_restore_info *info);
+
+    void (*list_loaded)           (PulseConnection                  *connection,
+                                   guint                             flags);
 };
 
 GType                pulse_connection_get_type                 (void) G_GNUC_CONST;
@@ -98,7 +107,8 @@ PulseConnection *    pulse_connection_new                      (const gchar
                                                                 const gchar                      *app_id,
                                                                 const gchar                      *app_version,
                                                                 const gchar                      *app_icon,
-                                                                const gchar                      *server_address);
+                                                                const gchar                      *server_address,
+                                                                PulseConnectionLoadFlags          load_flags);
 
 gboolean             pulse_connection_connect                  (PulseConnection                  *connection,
                                                                 gboolean                          wait_for_daemon);
@@ -106,6 +116,13 @@ void                 pulse_connection_disconnect               (PulseConnection
 
 PulseConnectionState pulse_connection_get_state                (PulseConnection                  *connection);
 
+gboolean             pulse_connection_is_busy                  (PulseConnection                  *connection);
+
+void                 pulse_connection_follow_sink              (PulseConnection                  *connection,
+                                                                guint32                           index);
+void                 pulse_connection_follow_source            (PulseConnection                  *connection,
+                                                                guint32                           index);
+
 gboolean             pulse_connection_load_server_info         (PulseConnection                  *connection);
 
 gboolean             pulse_connection_load_card_info           (PulseConnection                  *connection,
@@ -131,9 +148,12 @@ gboolean             pulse_connection_load_source_output_info  (PulseConnection
 
 gboolean             pulse_connection_load_ext_stream_info     (PulseConnection                  *connection);
 
-PulseMonitor *       pulse_connection_create_monitor           (PulseConnection                  *connection,
+PulseMonitor *       pulse_connection_get_monitor              (PulseConnection                  *connection,
                                                                 guint32                           index_source,
-                                                                guint32                           index_sink_input);
+                                                                guint32                           index_sink_input,
+                                                                guint                             rate,
+                                                                MateMixerMonitorFlags             flags,
+                                                                const pa_channel_map             *map);
 
 gboolean             pulse_connection_set_default_sink         (PulseConnection                  *connection,
                                                                 const gchar                      *name);
@@ -149,7 +169,9 @@ gboolean             pulse_connection_set_sink_mute            (PulseConnection
                                                                 gboolean                          mute);
 gboolean             pulse_connection_set_sink_volume          (PulseConnection                  *connection,
                                                                 guint32                           index,
-                                                                const pa_cvolume                 *volume);
+                                                                const pa_cvolume                 *volume,
+                                                                PulseConnectionWriteFunc          func,
+                                                                gpointer                          user_data);
 gboolean             pulse_connection_set_sink_port            (PulseConnection                  *connection,
                                                                 guint32                           index,
                                                                 const gchar                      *port);
@@ -159,14 +181,18 @@ gboolean             pulse_connection_set_sink_input_mute      (PulseConnection
                                                                 gboolean                          mute);
 gboolean             pulse_connection_set_sink_input_volume    (PulseConnection                  *connection,
                                                                 guint32                           index,
-                                                                const pa_cvolume                 *volume);
+                                                                const pa_cvolume                 *volume,
+                                                                PulseConnectionWriteFunc          func,
+                                                                gpointer                          user_data);
 
 gboolean             pulse_connection_set_source_mute          (PulseConnection                  *connection,
                                                                 guint32                           index,
                                                                 gboolean                          mute);
 gboolean             pulse_connection_set_source_volume        (PulseConnection                  *connection,
                                                                 guint32                           index,
-                                                                const pa_cvolume                 *volume);
+                                                                const pa_cvolume                 *volume,
+                                                                PulseConnectionWriteFunc          func,
+                                                                gpointer                          user_data);
 gboolean             pulse_connection_set_source_port          (PulseConnection                  *connection,
                                                                 guint32                           index,
                                                                 const gchar                      *port);
@@ -176,7 +202,9 @@ gboolean             pulse_connection_set_source_output_mute   (PulseConnection
                                                                 gboolean                          mute);
 gboolean             pulse_connection_set_source_output_volume (PulseConnection                  *connection,
                                                                 guint32                           index,
-                                                                const pa_cvolume                 *volume);
+                                                                const pa_cvolume                 *volume,
+                                                                PulseConnectionWriteFunc          func,
+                                                                gpointer                          user_data);
 
 gboolean             pulse_connection_suspend_sink             (PulseConnection                  *connection,
                                                                 guint32                           index,
@@ -198,7 +226,9 @@ gboolean             pulse_connection_kill_source_output       (PulseConnection
                                                                 guint32                           index);
 
 gboolean             pulse_connection_write_ext_stream         (PulseConnection                  *connection,
-                                                                const pa_ext_stream_restore_info *info);
+                                                                const pa_ext_stream_restore_info *info,
+                                                                PulseConnectionWriteFunc          func,
+                                                                gpointer                          user_data);
 gboolean             pulse_connection_delete_ext_stream        (PulseConnection                  *connection,
                                                                 const gchar                      *name);
 
@@ -34,13 +34,13 @@
 
 struct _PulseDevicePrivate
 {
-    guint32            index;
-    GHashTable        *ports;
-    GHashTable        *streams;
-    GList             *streams_list;
-    PulseConnection   *connection;
-    PulseDeviceSwitch *pswitch;
-    GList             *pswitch_list;
+    guint32              index;
+    GHashTable          *ports;
+    GHashTable          *streams;
+    MateMixerObjectList *streams_list;
+    PulseConnection     *connection;
+    PulseDeviceSwitch   *pswitch;
+    GList               *pswitch_list;
 };
 
 enum {
@@ -78,8 +78,6 @@ static const GList *    pulse_device_list_switches (MateMixerDevice    *mmd);
 static void             pulse_device_load          (PulseDevice        *device,
                                                     const pa_card_info *info);
 
-static void             free_list_streams          (PulseDevice        *device);
-
 static void
 pulse_device_class_init (PulseDeviceClass *klass)
 {
@@ -175,15 +173,18 @@ pulse_device_init (PulseDevice *device)
                                                 PULSE_TYPE_DEVICE,
                                                 PulseDevicePrivate);
 
+    /* Keys are the shared names owned by the ports and streams */
     device->priv->ports = g_hash_table_new_full (g_str_hash,
                                                  g_str_equal,
-                                                 g_free,
+                                                 NULL,
                                                  g_object_unref);
 
     device->priv->streams = g_hash_table_new_full (g_str_hash,
                                                    g_str_equal,
-                                                   g_free,
+                                                   NULL,
                                                    g_object_unref);
+
+    device->priv->streams_list = _mate_mixer_object_list_new ();
 }
 
 static void
@@ -199,7 +200,7 @@ pulse_device_dispose (GObject *object)
     g_clear_object (&device->priv->connection);
     g_clear_object (&device->priv->pswitch);
 
-    free_list_streams (device);
+    _mate_mixer_object_list_clear (device->priv->streams_list);
 
     if (device->priv->pswitch_list != NULL) {
         g_list_free (device->priv->pswitch_list);
@@ -218,6 +219,8 @@ pulse_device_finalize (GObject *object)
     g_hash_table_unref (device->priv->ports);
     g_hash_table_unref (device->priv->streams);
 
+    _mate_mixer_object_list_free (device->priv->streams_list);
+
     G_OBJECT_CLASS (pulse_device_parent_class)->finalize (object);
 }
 
@@ -239,7 +242,8 @@ pulse_device_new (PulseConnection *connection, const pa_card_info *info)
     if G_UNLIKELY (icon == NULL)
         icon = "audio-card";
 
-    /* Consider the device index as unchanging parameter */
+    /* The index only changes when the device is matched again after
+     * reconnecting to the server, see pulse_device_set_index() */
     device = g_object_new (PULSE_TYPE_DEVICE,
                            "index", info->index,
                            "connection", connection,
@@ -281,11 +285,11 @@ pulse_device_add_stream (PulseDevice *device, PulseStream *stream)
 
     name = mate_mixer_stream_get_name (MATE_MIXER_STREAM (stream));
 
-    g_hash_table_insert (device->priv->streams,
-                         g_strdup (name),
-                         g_object_ref (stream));
+    g_hash_table_replace (device->priv->streams,
+                          (gpointer) name,
+                          g_object_ref (stream));
 
-    free_list_streams (device);
+    _mate_mixer_object_list_append (device->priv->streams_list, stream);
 
     g_signal_emit_by_name (G_OBJECT (device),
                            "stream-added",
@@ -302,7 +306,7 @@ pulse_device_remove_stream (PulseDevice *device, PulseStream *stream)
 
     name = mate_mixer_stream_get_name (MATE_MIXER_STREAM (stream));
 
-    free_list_streams (device);
+    _mate_mixer_object_list_remove (device->priv->streams_list, stream);
 
     g_hash_table_remove (device->priv->streams, name);
     g_signal_emit_by_name (G_OBJECT (device),
@@ -318,6 +322,16 @@ pulse_device_get_index (PulseDevice *device)
     return device->priv->index;
 }
 
+void
+pulse_device_set_index (PulseDevice *device, guint32 index)
+{
+    g_return_if_fail (PULSE_IS_DEVICE (device));
+
+    /* PulseAudio assigns new indexes to the cards when the server is
+     * restarted, the backend keeps the device and only updates the index */
+    device->priv->index = index;
+}
+
 PulseConnection *
 pulse_device_get_connection (PulseDevice *device)
 {
@@ -353,12 +367,7 @@ pulse_device_list_streams (MateMixerDevice *mmd)
 
     device = PULSE_DEVICE (mmd);
 
-    if (device->priv->streams_list == NULL) {
-        device->priv->streams_list = g_hash_table_get_values (device->priv->streams);
-        if (device->priv->streams_list != NULL)
-            g_list_foreach (device->priv->streams_list, (GFunc) g_object_ref, NULL);
-    }
-    return device->priv->streams_list;
+    return _mate_mixer_object_list_peek (device->priv->streams_list);
 }
 
 static const GList *
@@ -387,9 +396,9 @@ pulse_device_load (PulseDevice *device, const pa_card_info *info)
                                icon,
                                info->ports[i]->priority);
 
-        g_hash_table_insert (device->priv->ports,
-                             g_strdup (name),
-                             port);
+        g_hash_table_replace (device->priv->ports,
+                              (gpointer) mate_mixer_switch_option_get_name (MATE_MIXER_SWITCH_OPTION (port)),
+                              port);
     }
 
     /* Create the device profile switch */
@@ -426,14 +435,3 @@ pulse_device_load (PulseDevice *device, const pa_card_info *info)
         g_object_unref (profile);
     }
 }
-
-static void
-free_list_streams (PulseDevice *device)
-{
-    if (device->priv->streams_list == NULL)
-        return;
-
-    g_list_free_full (device->priv->streams_list, g_object_unref);
-
-    device->priv->streams_list = NULL;
-}
@@ -72,6 +72,9 @@ void             pulse_device_remove_stream  (PulseDevice        *device,
                                               PulseStream        *stream);
 
 guint32          pulse_device_get_index      (PulseDevice        *device);
+void             pulse_device_set_index      (PulseDevice        *device,
+                                              guint32             index);
+
 PulseConnection *pulse_device_get_connection (PulseDevice        *device);
 
 PulsePort *      pulse_device_get_port       (PulseDevice        *device,
@@ -26,4 +26,15 @@ typedef enum {
     PULSE_CONNECTION_CONNECTED
 } PulseConnectionState;
 
+typedef enum {
+    PULSE_CONNECTION_LOAD_CARDS          = 1 << 0,
+    PULSE_CONNECTION_LOAD_SINKS          = 1 << 1,
+    PULSE_CONNECTION_LOAD_SOURCES        = 1 << 2,
+    PULSE_CONNECTION_LOAD_SINK_INPUTS    = 1 << 3,
+    PULSE_CONNECTION_LOAD_SOURCE_OUTPUTS = 1 << 4,
+    PULSE_CONNECTION_LOAD_EXT_STREAMS    = 1 << 5,
+    PULSE_CONNECTION_LOAD_DEFAULT_SINK   = 1 << 6,
+    PULSE_CONNECTION_LOAD_DEFAULT_SOURCE = 1 << 7
+} PulseConnectionLoadFlags;
+
 #endif /* PULSE_ENUMS_H */
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+
+#include <libmatemixer/matemixer-private.h>
+
+#include <pulse/pulseaudio.h>
+#include <pulse/ext-stream-restore.h>
+
+#include "pulse-ext-entry.h"
+
+static void store_info (PulseExtEntry                    *entry,
+                        const pa_ext_stream_restore_info *info);
+
+PulseExtEntry *
+pulse_ext_entry_new (const pa_ext_stream_restore_info *info)
+{
+    PulseExtEntry *entry;
+    guint          n_data;
+
+    g_return_val_if_fail (info != NULL, NULL);
+
+    /* The data array is sized for the number of channels in use, but always
+     * has space for at least one item */
+    n_data = info->volume.channels + info->channel_map.channels;
+
+    entry = g_malloc (G_STRUCT_OFFSET (PulseExtEntry, data) +
+                      MAX (n_data, 1) * sizeof (guint32));
+
+    entry->name        = _mate_mixer_name_ref (info->name);
+    entry->device      = NULL;
+    entry->generation  = 0;
+    entry->n_volumes   = info->volume.channels;
+    entry->n_positions = info->channel_map.channels;
+
+    store_info (entry, info);
+    return entry;
+}
+
+void
+pulse_ext_entry_free (PulseExtEntry *entry)
+{
+    _mate_mixer_name_unref (entry->name);
+    _mate_mixer_name_unref (entry->device);
+    g_free (entry);
+}
+
+gboolean
+pulse_ext_entry_update (PulseExtEntry *entry, const pa_ext_stream_restore_info *info)
+{
+    g_return_val_if_fail (entry != NULL, FALSE);
+    g_return_val_if_fail (info != NULL, FALSE);
+
+    /* The caller has to replace the entry when the number of channels changes */
+    if (entry->n_volumes != info->volume.channels ||
+        entry->n_positions != info->channel_map.channels)
+        return FALSE;
+
+    store_info (entry, info);
+    return TRUE;
+}
+
+void
+pulse_ext_entry_fill_info (PulseExtEntry *entry, pa_ext_stream_restore_info *info)
+{
+    guint i;
+
+    g_return_if_fail (entry != NULL);
+    g_return_if_fail (info != NULL);
+
+    pa_cvolume_init (&info->volume);
+    pa_channel_map_init (&info->channel_map);
+
+    info->name   = entry->name;
+    info->device = entry->device;
+    info->mute   = entry->mute;
+
+    info->volume.channels = entry->n_volumes;
+    for (i = 0; i < entry->n_volumes; i++)
+        info->volume.values[i] = entry->data[i];
+
+    info->channel_map.channels = entry->n_positions;
+    for (i = 0; i < entry->n_positions; i++)
+        info->channel_map.map[i] = (pa_channel_position_t) entry->data[entry->n_volumes + i];
+}
+
+static void
+store_info (PulseExtEntry *entry, const pa_ext_stream_restore_info *info)
+{
+    guint i;
+
+    /* Device names are few and shared by many entries */
+    if (g_strcmp0 (entry->device, info->device) != 0) {
+        _mate_mixer_name_unref (entry->device);
+        entry->device = _mate_mixer_name_ref (info->device);
+    }
+
+    entry->mute = info->mute ? TRUE : FALSE;
+
+    for (i = 0; i < entry->n_volumes; i++)
+        entry->data[i] = info->volume.values[i];
+
+    for (i = 0; i < entry->n_positions; i++)
+        entry->data[entry->n_volumes + i] = (guint32) info->channel_map.map[i];
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PULSE_EXT_ENTRY_H
+#define PULSE_EXT_ENTRY_H
+
+#include <glib.h>
+
+#include <pulse/pulseaudio.h>
+#include <pulse/ext-stream-restore.h>
+
+#include "pulse-types.h"
+
+G_BEGIN_DECLS
+
+/*
+ * A row of the stream-restore database, kept for every known ext-stream
+ * while the PulseExtStream instance is only created when needed.
+ *
+ * The volumes are followed by the channel positions in the data array,
+ * only the channels in use are stored.
+ */
+struct _PulseExtEntry
+{
+    const gchar *name;
+    const gchar *device;
+    guint        generation;
+    gboolean     mute;
+    guint8       n_volumes;
+    guint8       n_positions;
+    guint32      data[1];
+};
+
+PulseExtEntry *pulse_ext_entry_new       (const pa_ext_stream_restore_info *info);
+void           pulse_ext_entry_free      (PulseExtEntry                    *entry);
+
+gboolean       pulse_ext_entry_update    (PulseExtEntry                    *entry,
+                                          const pa_ext_stream_restore_info *info);
+
+void           pulse_ext_entry_fill_info (PulseExtEntry                    *entry,
+                                          pa_ext_stream_restore_info       *info);
+
+G_END_DECLS
+
+#endif /* PULSE_EXT_ENTRY_H */
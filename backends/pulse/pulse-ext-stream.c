@@ -38,6 +38,12 @@ struct _PulseExtStreamPrivate
     pa_channel_map    channel_map;
     MateMixerAppInfo *app_info;
     PulseConnection  *connection;
+    gboolean          volume_pending;
+    gboolean          volume_queued;
+    pa_cvolume        queued_cvolume;
+    gchar            *device;
+    guint32           fingerprint;
+    gboolean          fingerprint_valid;
 };
 
 enum {
@@ -82,6 +88,9 @@ static gboolean                 pulse_ext_stream_set_volume           (MateMixer
 
 static guint                    pulse_ext_stream_get_channel_volume   (MateMixerStreamControl  *mmsc,
                                                                        guint                    channel);
+static void                     pulse_ext_stream_get_channel_volumes  (MateMixerStreamControl  *mmsc,
+                                                                       guint                   *volumes,
+                                                                       guint                    n_volumes);
 static gboolean                 pulse_ext_stream_set_channel_volume   (MateMixerStreamControl  *mmsc,
                                                                        guint                    channel,
                                                                        guint                    volume);
@@ -110,6 +119,16 @@ static gboolean                 write_cvolume                         (PulseExtS
 static void                     store_cvolume                         (PulseExtStream             *ext,
                                                                        const pa_cvolume           *cvolume);
 
+static void                     on_volume_written                     (gboolean                    success,
+                                                                       gpointer                    user_data);
+
+static MateMixerStreamControlFlags get_info_flags (const pa_ext_stream_restore_info *info);
+
+static guint32                  get_info_fingerprint                  (const pa_ext_stream_restore_info *info);
+static guint32                  fingerprint_data                      (guint32                     hash,
+                                                                       gconstpointer               data,
+                                                                       gsize                       size);
+
 static void
 pulse_ext_stream_class_init (PulseExtStreamClass *klass)
 {
@@ -130,6 +149,7 @@ pulse_ext_stream_class_init (PulseExtStreamClass *klass)
     control_class->get_volume           = pulse_ext_stream_get_volume;
     control_class->set_volume           = pulse_ext_stream_set_volume;
     control_class->get_channel_volume   = pulse_ext_stream_get_channel_volume;
+    control_class->get_channel_volumes  = pulse_ext_stream_get_channel_volumes;
     control_class->set_channel_volume   = pulse_ext_stream_set_channel_volume;
     control_class->get_channel_position = pulse_ext_stream_get_channel_position;
     control_class->has_channel_position = pulse_ext_stream_has_channel_position;
@@ -241,6 +261,8 @@ pulse_ext_stream_finalize (GObject *object)
     if (ext->priv->app_info != NULL)
         _mate_mixer_app_info_free (ext->priv->app_info);
 
+    g_free (ext->priv->device);
+
     G_OBJECT_CLASS (pulse_ext_stream_parent_class)->finalize (object);
 }
 
@@ -250,20 +272,72 @@ pulse_ext_stream_new (PulseConnection                  *connection,
                       PulseStream                      *parent)
 {
     PulseExtStream                 *ext;
-    gchar                          *suffix;
+    const gchar                    *app_id;
+    const gchar                    *app_name;
     MateMixerAppInfo               *app_info = NULL;
     MateMixerDirection              direction;
-    MateMixerStreamControlFlags     flags = MATE_MIXER_STREAM_CONTROL_MUTE_READABLE |
-                                            MATE_MIXER_STREAM_CONTROL_MUTE_WRITABLE |
-                                            MATE_MIXER_STREAM_CONTROL_MOVABLE |
-                                            MATE_MIXER_STREAM_CONTROL_STORED;
-    MateMixerStreamControlRole      role  = MATE_MIXER_STREAM_CONTROL_ROLE_UNKNOWN;
-    MateMixerStreamControlMediaRole media_role =
-                                            MATE_MIXER_STREAM_CONTROL_MEDIA_ROLE_UNKNOWN;
+    MateMixerStreamControlRole      role;
+    MateMixerStreamControlMediaRole media_role;
 
     g_return_val_if_fail (PULSE_IS_CONNECTION (connection), NULL);
     g_return_val_if_fail (info != NULL, NULL);
 
+    pulse_ext_stream_parse_name (info->name,
+                                 &direction,
+                                 &role,
+                                 &media_role,
+                                 &app_id,
+                                 &app_name);
+
+    /* Make sure an application ext-stream always has a MateMixerAppInfo
+     * structure available, even in the case no application info is
+     * available */
+    if (role == MATE_MIXER_STREAM_CONTROL_ROLE_APPLICATION) {
+        app_info = _mate_mixer_app_info_new ();
+
+        if (app_id != NULL)
+            _mate_mixer_app_info_set_id (app_info, app_id);
+        if (app_name != NULL)
+            _mate_mixer_app_info_set_name (app_info, app_name);
+    }
+
+    ext = g_object_new (PULSE_TYPE_EXT_STREAM,
+                        "flags", get_info_flags (info),
+                        "role", role,
+                        "media-role", media_role,
+                        "name", info->name,
+                        "direction", direction,
+                        "stream", parent,
+                        "connection", connection,
+                        "app-info", app_info,
+                        NULL);
+
+    if (app_info != NULL)
+        _mate_mixer_app_info_free (app_info);
+
+    /* Store values which are expected to be changed */
+    pulse_ext_stream_update (ext, info, parent);
+
+    return ext;
+}
+
+void
+pulse_ext_stream_parse_name (const gchar                      *name,
+                             MateMixerDirection               *direction,
+                             MateMixerStreamControlRole       *role,
+                             MateMixerStreamControlMediaRole  *media_role,
+                             const gchar                     **app_id,
+                             const gchar                     **app_name)
+{
+    const gchar *suffix;
+
+    g_return_if_fail (name != NULL);
+
+    *role       = MATE_MIXER_STREAM_CONTROL_ROLE_UNKNOWN;
+    *media_role = MATE_MIXER_STREAM_CONTROL_MEDIA_ROLE_UNKNOWN;
+    *app_id     = NULL;
+    *app_name   = NULL;
+
     /* The name of an ext-stream is in one of the following formats:
      *  sink-input-by-media-role: ...
      *  sink-input-by-application-name: ...
@@ -274,64 +348,80 @@ pulse_ext_stream_new (PulseConnection                  *connection,
      *  source-output-by-application-id: ...
      *  source-output-by-media-name: ...
      */
-    if (g_str_has_prefix (info->name, "sink-input"))
-        direction = MATE_MIXER_DIRECTION_OUTPUT;
-    else if (g_str_has_prefix (info->name, "source-output"))
-        direction = MATE_MIXER_DIRECTION_INPUT;
+    if (g_str_has_prefix (name, "sink-input"))
+        *direction = MATE_MIXER_DIRECTION_OUTPUT;
+    else if (g_str_has_prefix (name, "source-output"))
+        *direction = MATE_MIXER_DIRECTION_INPUT;
     else
-        direction = MATE_MIXER_DIRECTION_UNKNOWN;
+        *direction = MATE_MIXER_DIRECTION_UNKNOWN;
 
-    suffix = strchr (info->name, ':');
+    suffix = strchr (name, ':');
     if (suffix != NULL)
         suffix++;
 
-    if (strstr (info->name, "-by-media-role:")) {
+    if (strstr (name, "-by-media-role:")) {
         if G_LIKELY (suffix != NULL)
-            media_role = pulse_convert_media_role_name (suffix);
+            *media_role = pulse_convert_media_role_name (suffix);
     }
-    else if (strstr (info->name, "-by-application-name:")) {
-        role = MATE_MIXER_STREAM_CONTROL_ROLE_APPLICATION;
-
-        /* Make sure an application ext-stream always has a MateMixerAppInfo
-         * structure available, even in the case no application info is
-         * available */
-        if (app_info == NULL)
-            app_info = _mate_mixer_app_info_new ();
-
-        if G_LIKELY (suffix != NULL)
-            _mate_mixer_app_info_set_name (app_info, suffix);
+    else if (strstr (name, "-by-application-name:")) {
+        *role     = MATE_MIXER_STREAM_CONTROL_ROLE_APPLICATION;
+        *app_name = suffix;
     }
-    else if (strstr (info->name, "-by-application-id:")) {
-        role = MATE_MIXER_STREAM_CONTROL_ROLE_APPLICATION;
-
-        /* Make sure an application ext-stream always has a MateMixerAppInfo
-         * structure available, even in the case no application info is
-         * available */
-        if (app_info == NULL)
-            app_info = _mate_mixer_app_info_new ();
-
-        if G_LIKELY (suffix != NULL)
-            _mate_mixer_app_info_set_id (app_info, suffix);
+    else if (strstr (name, "-by-application-id:")) {
+        *role   = MATE_MIXER_STREAM_CONTROL_ROLE_APPLICATION;
+        *app_id = suffix;
     }
+}
 
-    ext = g_object_new (PULSE_TYPE_EXT_STREAM,
-                        "flags", flags,
-                        "role", role,
-                        "media-role", media_role,
-                        "name", info->name,
-                        "direction", direction,
-                        "stream", parent,
-                        "connection", connection,
-                        "app-info", app_info,
-                        NULL);
-
-    if (app_info != NULL)
-        _mate_mixer_app_info_free (app_info);
+void
+pulse_ext_stream_fill_state (const pa_ext_stream_restore_info *info,
+                             MateMixerControlState            *state,
+                             GArray                           *volumes)
+{
+    guint *values;
+    guint  i;
 
-    /* Store values which are expected to be changed */
-    pulse_ext_stream_update (ext, info, parent);
+    g_return_if_fail (info != NULL);
+    g_return_if_fail (state != NULL);
+    g_return_if_fail (volumes != NULL);
+
+    /* Describe the entry the same way as an ext-stream created from it,
+     * there is no object and nothing has changed yet */
+    state->control    = NULL;
+    state->name       = info->name;
+    state->label      = NULL;
+    state->flags      = get_info_flags (info);
+    state->generation = 0;
+    state->mute       = info->mute ? TRUE : FALSE;
+    state->balance    = (state->flags & MATE_MIXER_STREAM_CONTROL_CAN_BALANCE)
+                        ? pa_cvolume_get_balance (&info->volume, &info->channel_map)
+                        : 0.0f;
+    state->fade       = (state->flags & MATE_MIXER_STREAM_CONTROL_CAN_FADE)
+                        ? pa_cvolume_get_fade (&info->volume, &info->channel_map)
+                        : 0.0f;
+
+    state->first_channel = volumes->len;
+    state->n_channels    = (pa_channel_map_valid (&info->channel_map) != 0)
+                           ? info->channel_map.channels
+                           : 0;
+
+    g_array_set_size (volumes, volumes->len + state->n_channels);
+
+    values = &g_array_index (volumes, guint, state->first_channel);
+
+    if (state->flags & MATE_MIXER_STREAM_CONTROL_VOLUME_READABLE) {
+        state->volume = (guint) pa_cvolume_max (&info->volume);
+
+        for (i = 0; i < state->n_channels; i++)
+            values[i] = (i < info->volume.channels)
+                        ? (guint) info->volume.values[i]
+                        : (guint) PA_VOLUME_MUTED;
+    } else {
+        state->volume = (guint) PA_VOLUME_MUTED;
 
-    return ext;
+        for (i = 0; i < state->n_channels; i++)
+            values[i] = state->volume;
+    }
 }
 
 void
@@ -339,8 +429,7 @@ pulse_ext_stream_update (PulseExtStream                   *ext,
                          const pa_ext_stream_restore_info *info,
                          PulseStream                      *parent)
 {
-    MateMixerStreamControlFlags flags;
-    gboolean                    volume_changed = FALSE;
+    gboolean volume_changed;
 
     g_return_if_fail (PULSE_IS_EXT_STREAM (ext));
     g_return_if_fail (info != NULL);
@@ -351,46 +440,29 @@ pulse_ext_stream_update (PulseExtStream                   *ext,
     _mate_mixer_stream_control_set_mute (MATE_MIXER_STREAM_CONTROL (ext),
                                          info->mute ? TRUE : FALSE);
 
-    flags = mate_mixer_stream_control_get_flags (MATE_MIXER_STREAM_CONTROL (ext));
-
     if (pa_channel_map_valid (&info->channel_map) != 0) {
-        if (pa_channel_map_can_balance (&info->channel_map) != 0)
-            flags |= MATE_MIXER_STREAM_CONTROL_CAN_BALANCE;
-        else
-            flags &= ~MATE_MIXER_STREAM_CONTROL_CAN_BALANCE;
-
-        if (pa_channel_map_can_fade (&info->channel_map) != 0)
-            flags |= MATE_MIXER_STREAM_CONTROL_CAN_FADE;
-        else
-            flags &= ~MATE_MIXER_STREAM_CONTROL_CAN_FADE;
-
         ext->priv->channel_map = info->channel_map;
     } else {
-        flags &= ~(MATE_MIXER_STREAM_CONTROL_CAN_BALANCE | MATE_MIXER_STREAM_CONTROL_CAN_FADE);
-
         /* If the channel map is not valid, create an empty channel map, which
          * also won't validate, but at least we know what it is */
         pa_channel_map_init (&ext->priv->channel_map);
     }
 
-    if (pa_cvolume_valid (&info->volume) != 0) {
-        flags |= MATE_MIXER_STREAM_CONTROL_VOLUME_READABLE |
-                 MATE_MIXER_STREAM_CONTROL_VOLUME_WRITABLE;
-
-        if (pa_cvolume_equal (&ext->priv->cvolume, &info->volume) == 0)
-            volume_changed = TRUE;
-    } else {
-        flags &= ~(MATE_MIXER_STREAM_CONTROL_VOLUME_READABLE |
-                   MATE_MIXER_STREAM_CONTROL_VOLUME_WRITABLE);
+    /* Each write makes the server reload the database, keep the locally set
+     * volume while our own volume change is being processed as the entry may
+     * still contain an older value, the entry is reloaded if the write fails */
+    if (ext->priv->volume_pending == FALSE) {
+        if (pa_cvolume_valid (&info->volume) != 0)
+            volume_changed = pa_cvolume_equal (&ext->priv->cvolume, &info->volume) == 0;
+        else
+            volume_changed = ext->priv->volume != (guint) PA_VOLUME_MUTED;
 
-        if (ext->priv->volume != (guint) PA_VOLUME_MUTED)
-            volume_changed = TRUE;
+        if (volume_changed == TRUE)
+            store_cvolume (ext, &info->volume);
     }
 
-    if (volume_changed == TRUE)
-        store_cvolume (ext, &info->volume);
-
-    _mate_mixer_stream_control_set_flags (MATE_MIXER_STREAM_CONTROL (ext), flags);
+    _mate_mixer_stream_control_set_flags (MATE_MIXER_STREAM_CONTROL (ext),
+                                          get_info_flags (info));
 
     /* Also set initially, but may change at any time */
     if (parent != NULL)
@@ -400,9 +472,44 @@ pulse_ext_stream_update (PulseExtStream                   *ext,
         _mate_mixer_stream_control_set_stream (MATE_MIXER_STREAM_CONTROL (ext),
                                                NULL);
 
+    /* Keep the device name of the entry, the parent stream might not exist */
+    if (g_strcmp0 (ext->priv->device, info->device) != 0) {
+        g_free (ext->priv->device);
+        ext->priv->device = g_strdup (info->device);
+    }
+
+    ext->priv->fingerprint       = get_info_fingerprint (info);
+    ext->priv->fingerprint_valid = TRUE;
+
     g_object_thaw_notify (G_OBJECT (ext));
 }
 
+gboolean
+pulse_ext_stream_is_current (PulseExtStream                   *ext,
+                             const pa_ext_stream_restore_info *info)
+{
+    g_return_val_if_fail (PULSE_IS_EXT_STREAM (ext), FALSE);
+    g_return_val_if_fail (info != NULL, FALSE);
+
+    if (ext->priv->fingerprint_valid == FALSE)
+        return FALSE;
+
+    /* The fingerprint quickly rules out most of the changed entries, but
+     * a matching one might be a collision, so compare the entry as well */
+    if (ext->priv->fingerprint != get_info_fingerprint (info))
+        return FALSE;
+
+    if (mate_mixer_stream_control_get_mute (MATE_MIXER_STREAM_CONTROL (ext)) !=
+        (info->mute ? TRUE : FALSE))
+        return FALSE;
+
+    if (pa_cvolume_equal (&ext->priv->cvolume, &info->volume) == 0 ||
+        pa_channel_map_equal (&ext->priv->channel_map, &info->channel_map) == 0)
+        return FALSE;
+
+    return g_strcmp0 (ext->priv->device, info->device) == 0;
+}
+
 static MateMixerAppInfo *
 pulse_ext_stream_get_app_info (MateMixerStreamControl *mmsc)
 {
@@ -428,7 +535,7 @@ pulse_ext_stream_set_stream (MateMixerStreamControl *mmsc, MateMixerStream *mms)
     else
         info.device = NULL;
 
-    return pulse_connection_write_ext_stream (ext->priv->connection, &info);
+    return pulse_connection_write_ext_stream (ext->priv->connection, &info, NULL, NULL);
 }
 
 static gboolean
@@ -444,7 +551,7 @@ pulse_ext_stream_set_mute (MateMixerStreamControl *mmsc, gboolean mute)
     fill_ext_stream_restore_info (ext, &info);
     info.mute = mute;
 
-    return pulse_connection_write_ext_stream (ext->priv->connection, &info);
+    return pulse_connection_write_ext_stream (ext->priv->connection, &info, NULL, NULL);
 }
 
 static guint
@@ -496,6 +603,24 @@ pulse_ext_stream_get_channel_volume (MateMixerStreamControl *mmsc, guint channel
     return (guint) ext->priv->cvolume.values[channel];
 }
 
+static void
+pulse_ext_stream_get_channel_volumes (MateMixerStreamControl *mmsc, guint *volumes, guint n_volumes)
+{
+    PulseExtStream *ext;
+    guint           i;
+
+    g_return_if_fail (PULSE_IS_EXT_STREAM (mmsc));
+
+    ext = PULSE_EXT_STREAM (mmsc);
+
+    for (i = 0; i < n_volumes; i++) {
+        if (i < ext->priv->cvolume.channels)
+            volumes[i] = (guint) ext->priv->cvolume.values[i];
+        else
+            volumes[i] = (guint) PA_VOLUME_MUTED;
+    }
+}
+
 static gboolean
 pulse_ext_stream_set_channel_volume (MateMixerStreamControl *mmsc, guint channel, guint volume)
 {
@@ -655,13 +780,30 @@ write_cvolume (PulseExtStream *ext, const pa_cvolume *cvolume)
     if (pa_cvolume_equal (cvolume, &ext->priv->cvolume) != 0)
         return TRUE;
 
-    fill_ext_stream_restore_info (ext, &info);
-    info.volume = *cvolume;
-
-    if (pulse_connection_write_ext_stream (ext->priv->connection, &info) == FALSE)
-        return FALSE;
+    if (ext->priv->volume_pending == TRUE) {
+        /* Only keep the latest value while a write is in flight, it will be
+         * sent as soon as the server acknowledges the previous one */
+        ext->priv->queued_cvolume = *cvolume;
+        ext->priv->volume_queued  = TRUE;
+    } else {
+        fill_ext_stream_restore_info (ext, &info);
+        info.volume = *cvolume;
+
+        if (pulse_connection_write_ext_stream (ext->priv->connection,
+                                               &info,
+                                               on_volume_written,
+                                               g_object_ref (ext)) == FALSE) {
+            g_object_unref (ext);
+            return FALSE;
+        }
+        ext->priv->volume_pending = TRUE;
+    }
 
     store_cvolume (ext, cvolume);
+
+    /* The stored volume no longer matches the last database entry, make sure
+     * the next entry is applied even if the write is reverted */
+    ext->priv->fingerprint_valid = FALSE;
     return TRUE;
 }
 
@@ -689,3 +831,106 @@ store_cvolume (PulseExtStream *ext, const pa_cvolume *cvolume)
 
     _mate_mixer_stream_control_set_fade (MATE_MIXER_STREAM_CONTROL (ext), value);
 }
+
+static void
+on_volume_written (gboolean success, gpointer user_data)
+{
+    PulseExtStream *ext = PULSE_EXT_STREAM (user_data);
+
+    ext->priv->volume_pending = FALSE;
+
+    if (ext->priv->volume_queued == TRUE) {
+        pa_ext_stream_restore_info info;
+
+        ext->priv->volume_queued = FALSE;
+
+        /* The queued volume has already been stored locally */
+        if (success == TRUE) {
+            fill_ext_stream_restore_info (ext, &info);
+            info.volume = ext->priv->queued_cvolume;
+
+            if (pulse_connection_write_ext_stream (ext->priv->connection,
+                                                   &info,
+                                                   on_volume_written,
+                                                   g_object_ref (ext)) == TRUE) {
+                ext->priv->volume_pending = TRUE;
+            } else {
+                g_object_unref (ext);
+                success = FALSE;
+            }
+        }
+    }
+
+    /* The server has not accepted a volume which has already been reported
+     * locally, reload the database to get back to the stored volume, the
+     * fingerprint has been invalidated when the volume was written, so the
+     * entry is going to be applied */
+    if (success == FALSE)
+        pulse_connection_load_ext_stream_info (ext->priv->connection);
+
+    g_object_unref (ext);
+}
+
+static MateMixerStreamControlFlags
+get_info_flags (const pa_ext_stream_restore_info *info)
+{
+    MateMixerStreamControlFlags flags = MATE_MIXER_STREAM_CONTROL_MUTE_READABLE |
+                                        MATE_MIXER_STREAM_CONTROL_MUTE_WRITABLE |
+                                        MATE_MIXER_STREAM_CONTROL_MOVABLE |
+                                        MATE_MIXER_STREAM_CONTROL_STORED;
+
+    if (pa_channel_map_valid (&info->channel_map) != 0) {
+        if (pa_channel_map_can_balance (&info->channel_map) != 0)
+            flags |= MATE_MIXER_STREAM_CONTROL_CAN_BALANCE;
+        if (pa_channel_map_can_fade (&info->channel_map) != 0)
+            flags |= MATE_MIXER_STREAM_CONTROL_CAN_FADE;
+    }
+
+    if (pa_cvolume_valid (&info->volume) != 0)
+        flags |= MATE_MIXER_STREAM_CONTROL_VOLUME_READABLE |
+                 MATE_MIXER_STREAM_CONTROL_VOLUME_WRITABLE;
+
+    return flags;
+}
+
+static guint32
+get_info_fingerprint (const pa_ext_stream_restore_info *info)
+{
+    guint32 hash = 2166136261U;
+    gint    mute = info->mute ? 1 : 0;
+
+    /* Only include the used part of the volume and channel map, the rest
+     * of the arrays is not initialized */
+    hash = fingerprint_data (hash, &mute, sizeof (mute));
+    hash = fingerprint_data (hash,
+                             &info->volume.channels,
+                             sizeof (info->volume.channels));
+    hash = fingerprint_data (hash,
+                             info->volume.values,
+                             sizeof (info->volume.values[0]) * info->volume.channels);
+    hash = fingerprint_data (hash,
+                             &info->channel_map.channels,
+                             sizeof (info->channel_map.channels));
+    hash = fingerprint_data (hash,
+                             info->channel_map.map,
+                             sizeof (info->channel_map.map[0]) * info->channel_map.channels);
+
+    if (info->device != NULL)
+        hash = fingerprint_data (hash, info->device, strlen (info->device) + 1);
+
+    return hash;
+}
+
+static guint32
+fingerprint_data (guint32 hash, gconstpointer data, gsize size)
+{
+    const guint8 *bytes = data;
+    gsize         i;
+
+    /* FNV-1a */
+    for (i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619U;
+    }
+    return hash;
+}
@@ -58,15 +58,29 @@ struct _PulseExtStreamClass
     MateMixerStoredControlClass parent_class;
 };
 
-GType           pulse_ext_stream_get_type (void) G_GNUC_CONST;
+GType           pulse_ext_stream_get_type   (void) G_GNUC_CONST;
 
-PulseExtStream *pulse_ext_stream_new      (PulseConnection                  *connection,
-                                           const pa_ext_stream_restore_info *info,
-                                           PulseStream                      *parent);
+PulseExtStream *pulse_ext_stream_new        (PulseConnection                  *connection,
+                                             const pa_ext_stream_restore_info *info,
+                                             PulseStream                      *parent);
 
-void            pulse_ext_stream_update   (PulseExtStream                   *ext,
-                                           const pa_ext_stream_restore_info *info,
-                                           PulseStream                      *parent);
+void            pulse_ext_stream_update     (PulseExtStream                   *ext,
+                                             const pa_ext_stream_restore_info *info,
+                                             PulseStream                      *parent);
+
+gboolean        pulse_ext_stream_is_current (PulseExtStream                   *ext,
+                                             const pa_ext_stream_restore_info *info);
+
+void            pulse_ext_stream_parse_name (const gchar                      *name,
+                                             MateMixerDirection               *direction,
+                                             MateMixerStreamControlRole       *role,
+                                             MateMixerStreamControlMediaRole  *media_role,
+                                             const gchar                     **app_id,
+                                             const gchar                     **app_name);
+
+void            pulse_ext_stream_fill_state (const pa_ext_stream_restore_info *info,
+                                             MateMixerControlState            *state,
+                                             GArray                           *volumes);
 
 G_END_DECLS
 
@@ -15,22 +15,61 @@
  * License along with this library; if not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <math.h>
+#include <string.h>
 #include <glib.h>
 #include <glib/gi18n.h>
 #include <glib-object.h>
 
+#include <libmatemixer/matemixer.h>
+#include <libmatemixer/matemixer-private.h>
+
 #include <pulse/pulseaudio.h>
 
 #include "pulse-monitor.h"
 
+/* Sample rate of the stream used to compute RMS levels, peak levels alone
+ * are computed by the server at the update rate */
+#define RMS_SAMPLE_RATE     8000
+
+/* Number of microseconds a held peak stays before falling to the current peak */
+#define PEAK_HOLD_TIME      1500000
+
+/* Maximum number of sample frames collected by a threaded monitor before
+ * the main loop picks them up, further samples are only measured */
+#define MAX_PENDING_FRAMES  RMS_SAMPLE_RATE
+
 struct _PulseMonitorPrivate
 {
-    pa_context  *context;
-    pa_proplist *proplist;
-    pa_stream   *stream;
-    guint32      index_source;
-    guint32      index_sink_input;
-    gboolean     enabled;
+    pa_context           *context;
+    pa_threaded_mainloop *mainloop;
+    GMainContext         *main_context;
+    pa_proplist          *proplist;
+    pa_stream            *stream;
+    guint32               index_source;
+    guint32               index_sink_input;
+    gboolean              enabled;
+    guint                 rate;
+    MateMixerMonitorFlags flags;
+    pa_channel_map        channel_map;
+    guint                 n_channels;
+    gfloat                peak[PA_CHANNELS_MAX];
+    gfloat                rms[PA_CHANNELS_MAX];
+    gfloat                peak_hold[PA_CHANNELS_MAX];
+    gint64                peak_hold_time[PA_CHANNELS_MAX];
+    GPtrArray            *buffers;
+
+    /* Measurements of a threaded monitor waiting for the main loop */
+    GMutex                pending_mutex;
+    GSource              *pending_source;
+    guint                 pending_channels;
+    MateMixerMonitorFlags pending_flags;
+    guint                 pending_frames;
+    gfloat                pending_peak[PA_CHANNELS_MAX];
+    gfloat                pending_sum[PA_CHANNELS_MAX];
+    gfloat                pending_peak_hold[PA_CHANNELS_MAX];
+    GArray               *pending_samples;
+    GArray               *dispatch_samples;
 };
 
 enum {
@@ -44,7 +83,7 @@ enum {
 static GParamSpec *properties[N_PROPERTIES] = { NULL, };
 
 enum {
-    VALUE,
+    FRAME,
     N_SIGNALS
 };
 
@@ -62,15 +101,33 @@ static void pulse_monitor_set_property (GObject           *object,
                                         GParamSpec        *pspec);
 
 static void pulse_monitor_init         (PulseMonitor      *monitor);
+static void pulse_monitor_dispose      (GObject           *object);
 static void pulse_monitor_finalize     (GObject           *object);
 
 G_DEFINE_TYPE (PulseMonitor, pulse_monitor, G_TYPE_OBJECT);
 
-static gboolean stream_connect (PulseMonitor *monitor);
+static gboolean stream_connect    (PulseMonitor *monitor);
+static void     stream_disconnect (PulseMonitor *monitor);
+static gboolean stream_restart    (PulseMonitor *monitor);
+
+static void     stream_read_cb    (pa_stream    *stream,
+                                   size_t        length,
+                                   void         *userdata);
+
+static void     measure_levels    (const gfloat *samples,
+                                   guint         n_frames,
+                                   guint         n_channels,
+                                   gfloat       *peak,
+                                   gfloat       *sum);
+static void     update_peak_hold  (PulseMonitor *monitor);
 
-static void     stream_read_cb (pa_stream    *stream,
-                                size_t        length,
-                                void         *userdata);
+static void     queue_frame       (PulseMonitor          *monitor,
+                                   MateMixerMonitorFrame *frame,
+                                   const gfloat          *sum);
+static gboolean dispatch_frames   (PulseMonitor          *monitor);
+
+static void     lock_mainloop     (PulseMonitor *monitor);
+static void     unlock_mainloop   (PulseMonitor *monitor);
 
 static void
 pulse_monitor_class_init (PulseMonitorClass *klass)
@@ -78,6 +135,7 @@ pulse_monitor_class_init (PulseMonitorClass *klass)
     GObjectClass *object_class;
 
     object_class = G_OBJECT_CLASS (klass);
+    object_class->dispose      = pulse_monitor_dispose;
     object_class->finalize     = pulse_monitor_finalize;
     object_class->get_property = pulse_monitor_get_property;
     object_class->set_property = pulse_monitor_set_property;
@@ -114,17 +172,17 @@ pulse_monitor_class_init (PulseMonitorClass *klass)
 
     g_object_class_install_properties (object_class, N_PROPERTIES, properties);
 
-    signals[VALUE] =
-        g_signal_new ("value",
+    signals[FRAME] =
+        g_signal_new ("frame",
                       G_TYPE_FROM_CLASS (object_class),
                       G_SIGNAL_RUN_LAST,
-                      G_STRUCT_OFFSET (PulseMonitorClass, value),
+                      G_STRUCT_OFFSET (PulseMonitorClass, frame),
                       NULL,
                       NULL,
-                      g_cclosure_marshal_VOID__DOUBLE,
+                      g_cclosure_marshal_VOID__BOXED,
                       G_TYPE_NONE,
                       1,
-                      G_TYPE_DOUBLE);
+                      MATE_MIXER_TYPE_MONITOR_FRAME | G_SIGNAL_TYPE_STATIC_SCOPE);
 
     g_type_class_add_private (object_class, sizeof (PulseMonitorPrivate));
 }
@@ -184,32 +242,90 @@ pulse_monitor_init (PulseMonitor *monitor)
     monitor->priv = G_TYPE_INSTANCE_GET_PRIVATE (monitor,
                                                  PULSE_TYPE_MONITOR,
                                                  PulseMonitorPrivate);
+
+    monitor->priv->rate = 25;
+
+    pa_channel_map_init (&monitor->priv->channel_map);
+
+    g_mutex_init (&monitor->priv->pending_mutex);
+
+    monitor->priv->buffers =
+        g_ptr_array_new_with_free_func ((GDestroyNotify) mate_mixer_monitor_buffer_unref);
 }
 
 static void
-pulse_monitor_finalize (GObject *object)
+pulse_monitor_dispose (GObject *object)
 {
     PulseMonitor *monitor;
 
     monitor = PULSE_MONITOR (object);
 
-    /* The pulse stream may exist if the monitor is running */
+    /* The pulse stream may exist if the monitor is running, with a threaded
+     * main loop this also waits for a running read callback to finish */
     if (monitor->priv->stream != NULL) {
-        pa_stream_disconnect (monitor->priv->stream);
-        pa_stream_unref (monitor->priv->stream);
+        lock_mainloop (monitor);
+        stream_disconnect (monitor);
+        unlock_mainloop (monitor);
+    }
+
+    if (monitor->priv->pending_source != NULL) {
+        g_source_destroy (monitor->priv->pending_source);
+        g_source_unref (monitor->priv->pending_source);
+
+        monitor->priv->pending_source = NULL;
     }
 
+    G_OBJECT_CLASS (pulse_monitor_parent_class)->dispose (object);
+}
+
+static void
+pulse_monitor_finalize (GObject *object)
+{
+    PulseMonitor *monitor;
+
+    monitor = PULSE_MONITOR (object);
+
+    lock_mainloop (monitor);
     pa_context_unref (monitor->priv->context);
+    unlock_mainloop (monitor);
+
     pa_proplist_free (monitor->priv->proplist);
+    g_ptr_array_unref (monitor->priv->buffers);
+
+    if (monitor->priv->main_context != NULL)
+        g_main_context_unref (monitor->priv->main_context);
+
+    if (monitor->priv->pending_samples != NULL) {
+        g_array_unref (monitor->priv->pending_samples);
+        g_array_unref (monitor->priv->dispatch_samples);
+    }
+    g_mutex_clear (&monitor->priv->pending_mutex);
 
     G_OBJECT_CLASS (pulse_monitor_parent_class)->finalize (object);
 }
 
+/* With a threaded main loop, the stream is only touched while holding the
+ * main loop lock, the read callback is called with the lock held */
+static void
+lock_mainloop (PulseMonitor *monitor)
+{
+    if (monitor->priv->mainloop != NULL)
+        pa_threaded_mainloop_lock (monitor->priv->mainloop);
+}
+
+static void
+unlock_mainloop (PulseMonitor *monitor)
+{
+    if (monitor->priv->mainloop != NULL)
+        pa_threaded_mainloop_unlock (monitor->priv->mainloop);
+}
+
 PulseMonitor *
-pulse_monitor_new (pa_context  *context,
-                   pa_proplist *proplist,
-                   guint32      index_source,
-                   guint32      index_sink_input)
+pulse_monitor_new (pa_context           *context,
+                   pa_threaded_mainloop *mainloop,
+                   pa_proplist          *proplist,
+                   guint32               index_source,
+                   guint32               index_sink_input)
 {
     PulseMonitor *monitor;
 
@@ -224,6 +340,17 @@ pulse_monitor_new (pa_context  *context,
     monitor->priv->context  = pa_context_ref (context);
     monitor->priv->proplist = pa_proplist_copy (proplist);
 
+    /* Allow the backend to recognize and ignore our own record streams */
+    pa_proplist_sets (monitor->priv->proplist, PULSE_MONITOR_PROPERTY, "1");
+
+    if (mainloop != NULL) {
+        /* Measurements are delivered in the main loop of the creating thread */
+        monitor->priv->mainloop     = mainloop;
+        monitor->priv->main_context = g_main_context_ref_thread_default ();
+
+        monitor->priv->pending_samples  = g_array_new (FALSE, FALSE, sizeof (gfloat));
+        monitor->priv->dispatch_samples = g_array_new (FALSE, FALSE, sizeof (gfloat));
+    }
     return monitor;
 }
 
@@ -243,45 +370,169 @@ pulse_monitor_set_enabled (PulseMonitor *monitor, gboolean enabled)
     if (enabled == monitor->priv->enabled)
         return TRUE;
 
+    lock_mainloop (monitor);
+
     if (enabled) {
         monitor->priv->enabled = stream_connect (monitor);
-
-        if (monitor->priv->enabled == FALSE)
-            return FALSE;
     } else {
-        pa_stream_disconnect (monitor->priv->stream);
-        pa_stream_unref (monitor->priv->stream);
+        stream_disconnect (monitor);
 
-        monitor->priv->stream = NULL;
         monitor->priv->enabled = FALSE;
     }
+
+    unlock_mainloop (monitor);
+
+    if (enabled != monitor->priv->enabled)
+        return FALSE;
+
     g_object_notify_by_pspec (G_OBJECT (monitor), properties[PROP_ENABLED]);
 
     return TRUE;
 }
 
+/* The buffers are filled directly by the read callback, which runs in the
+ * thread of the main loop when the monitor is threaded */
+void
+pulse_monitor_add_buffer (PulseMonitor *monitor, MateMixerMonitorBuffer *buffer)
+{
+    g_return_if_fail (PULSE_IS_MONITOR (monitor));
+    g_return_if_fail (buffer != NULL);
+
+    lock_mainloop (monitor);
+    g_ptr_array_add (monitor->priv->buffers, mate_mixer_monitor_buffer_ref (buffer));
+    unlock_mainloop (monitor);
+}
+
+void
+pulse_monitor_remove_buffer (PulseMonitor *monitor, MateMixerMonitorBuffer *buffer)
+{
+    g_return_if_fail (PULSE_IS_MONITOR (monitor));
+    g_return_if_fail (buffer != NULL);
+
+    lock_mainloop (monitor);
+    g_ptr_array_remove (monitor->priv->buffers, buffer);
+    unlock_mainloop (monitor);
+}
+
+gboolean
+pulse_monitor_start_pending (PulseMonitor *monitor)
+{
+    gboolean connected;
+
+    g_return_val_if_fail (PULSE_IS_MONITOR (monitor), FALSE);
+
+    if (monitor->priv->enabled == FALSE || monitor->priv->stream != NULL)
+        return TRUE;
+
+    lock_mainloop (monitor);
+    connected = stream_connect (monitor);
+    unlock_mainloop (monitor);
+
+    if (connected == FALSE) {
+        monitor->priv->enabled = FALSE;
+
+        g_object_notify_by_pspec (G_OBJECT (monitor), properties[PROP_ENABLED]);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+gboolean
+pulse_monitor_set_options (PulseMonitor          *monitor,
+                           guint                  rate,
+                           MateMixerMonitorFlags  flags)
+{
+    g_return_val_if_fail (PULSE_IS_MONITOR (monitor), FALSE);
+    g_return_val_if_fail (rate > 0, FALSE);
+
+    if (monitor->priv->rate == rate && monitor->priv->flags == flags)
+        return TRUE;
+
+    /* The options are read by the read callback of a threaded monitor */
+    lock_mainloop (monitor);
+    monitor->priv->rate  = rate;
+    monitor->priv->flags = flags;
+    unlock_mainloop (monitor);
+
+    return stream_restart (monitor);
+}
+
+gboolean
+pulse_monitor_set_channel_map (PulseMonitor *monitor, const pa_channel_map *map)
+{
+    g_return_val_if_fail (PULSE_IS_MONITOR (monitor), FALSE);
+    g_return_val_if_fail (map != NULL, FALSE);
+
+    if (pa_channel_map_equal (&monitor->priv->channel_map, map))
+        return TRUE;
+
+    lock_mainloop (monitor);
+    monitor->priv->channel_map = *map;
+    unlock_mainloop (monitor);
+
+    /* The channel map only matters when measuring each channel */
+    if ((monitor->priv->flags & MATE_MIXER_MONITOR_PER_CHANNEL) == 0)
+        return TRUE;
+
+    return stream_restart (monitor);
+}
+
 static gboolean
 stream_connect (PulseMonitor *monitor)
 {
-    pa_sample_spec  spec;
-    pa_buffer_attr  attr;
-    gchar          *idx;
-    int             ret;
+    pa_sample_spec        spec;
+    pa_buffer_attr        attr;
+    pa_stream_flags_t     flags;
+    const pa_channel_map *map = NULL;
+    pa_context_state_t    state;
+    gchar                *idx;
+    int                   ret;
+
+    /* A threaded monitor may be enabled while its context is still being
+     * connected, the stream is connected by pulse_monitor_start_pending() */
+    state = pa_context_get_state (monitor->priv->context);
+    if (state != PA_CONTEXT_READY)
+        return PA_CONTEXT_IS_GOOD (state) ? TRUE : FALSE;
+
+    spec.channels = 1;
+    spec.format   = PA_SAMPLE_FLOAT32;
+
+    if ((monitor->priv->flags & MATE_MIXER_MONITOR_PER_CHANNEL) &&
+        pa_channel_map_valid (&monitor->priv->channel_map)) {
+        map = &monitor->priv->channel_map;
+        spec.channels = map->channels;
+    }
+    monitor->priv->n_channels = spec.channels;
 
     attr.maxlength = (guint32) -1;
     attr.tlength   = 0;
     attr.prebuf    = 0;
     attr.minreq    = 0;
-    attr.fragsize  = sizeof (gfloat);
-    spec.channels  = 1;
-    spec.format    = PA_SAMPLE_FLOAT32;
-    spec.rate      = 25;
+
+    /* The timing information is used to find out when the levels were captured */
+    flags = PA_STREAM_DONT_MOVE |
+            PA_STREAM_ADJUST_LATENCY |
+            PA_STREAM_INTERPOLATE_TIMING |
+            PA_STREAM_AUTO_TIMING_UPDATE;
+
+    if (monitor->priv->flags & MATE_MIXER_MONITOR_RMS) {
+        /* RMS needs the actual audio, read a fragment per update */
+        spec.rate = RMS_SAMPLE_RATE;
+
+        attr.fragsize = MAX (RMS_SAMPLE_RATE / monitor->priv->rate, 1) * pa_frame_size (&spec);
+    } else {
+        /* Let the server reduce the audio to one peak value per update */
+        spec.rate = monitor->priv->rate;
+
+        attr.fragsize = pa_frame_size (&spec);
+        flags |= PA_STREAM_PEAK_DETECT;
+    }
 
     monitor->priv->stream =
         pa_stream_new_with_proplist (monitor->priv->context,
                                      _("Peak detect"),
                                      &spec,
-                                     NULL,
+                                     map,
                                      monitor->priv->proplist);
 
     if (G_UNLIKELY (monitor->priv->stream == NULL)) {
@@ -304,13 +555,54 @@ stream_connect (PulseMonitor *monitor)
     ret = pa_stream_connect_record (monitor->priv->stream,
                                     idx,
                                     &attr,
-                                    PA_STREAM_DONT_MOVE |
-                                    PA_STREAM_PEAK_DETECT |
-                                    PA_STREAM_ADJUST_LATENCY);
+                                    flags);
     g_free (idx);
 
     if (ret < 0) {
         g_warning ("Failed to connect peak monitor: %s", pa_strerror (ret));
+
+        pa_stream_unref (monitor->priv->stream);
+        monitor->priv->stream = NULL;
+        return FALSE;
+    }
+
+    memset (monitor->priv->peak_hold, 0, sizeof (monitor->priv->peak_hold));
+    return TRUE;
+}
+
+static void
+stream_disconnect (PulseMonitor *monitor)
+{
+    if (monitor->priv->stream == NULL)
+        return;
+
+    pa_stream_set_read_callback (monitor->priv->stream, NULL, NULL);
+
+    pa_stream_disconnect (monitor->priv->stream);
+    pa_stream_unref (monitor->priv->stream);
+
+    monitor->priv->stream = NULL;
+}
+
+static gboolean
+stream_restart (PulseMonitor *monitor)
+{
+    gboolean connected;
+
+    if (monitor->priv->enabled == FALSE)
+        return TRUE;
+
+    lock_mainloop (monitor);
+
+    stream_disconnect (monitor);
+    connected = stream_connect (monitor);
+
+    unlock_mainloop (monitor);
+
+    if (connected == FALSE) {
+        monitor->priv->enabled = FALSE;
+
+        g_object_notify_by_pspec (G_OBJECT (monitor), properties[PROP_ENABLED]);
         return FALSE;
     }
     return TRUE;
@@ -319,7 +611,10 @@ stream_connect (PulseMonitor *monitor)
 static void
 stream_read_cb (pa_stream *stream, size_t length, void *userdata)
 {
-    const void *data;
+    PulseMonitor *monitor;
+    const void   *data;
+
+    monitor = PULSE_MONITOR (userdata);
 
     /* Read the next fragment from the buffer (for recording streams).
      *
@@ -337,12 +632,65 @@ stream_read_cb (pa_stream *stream, size_t length, void *userdata)
         return;
 
     if (data != NULL) {
-        gdouble v = ((const gfloat *) data)[length / sizeof (gfloat) - 1];
-
-        g_signal_emit (G_OBJECT (userdata),
-                       signals[VALUE],
-                       0,
-                       CLAMP (v, 0, 1));
+        MateMixerMonitorFrame frame;
+        gfloat                sum[PA_CHANNELS_MAX];
+        gint64                time;
+        pa_usec_t             latency;
+        int                   negative;
+        guint                 i;
+
+        frame.n_channels = monitor->priv->n_channels;
+        frame.n_samples  = length / (frame.n_channels * sizeof (gfloat));
+
+        if (frame.n_samples > 0) {
+            frame.samples   = (gfloat *) data;
+            frame.peak      = monitor->priv->peak;
+            frame.rms       = NULL;
+            frame.peak_hold = NULL;
+
+            measure_levels (frame.samples,
+                            frame.n_samples,
+                            frame.n_channels,
+                            monitor->priv->peak,
+                            sum);
+
+            for (i = 0; i < frame.n_channels; i++)
+                monitor->priv->peak[i] = MIN (monitor->priv->peak[i], 1.0f);
+
+            if (monitor->priv->flags & MATE_MIXER_MONITOR_RMS) {
+                for (i = 0; i < frame.n_channels; i++)
+                    monitor->priv->rms[i] =
+                        MIN (sqrtf (sum[i] / frame.n_samples), 1.0f);
+
+                frame.rms = monitor->priv->rms;
+            }
+
+            if (monitor->priv->flags & MATE_MIXER_MONITOR_PEAK_HOLD) {
+                update_peak_hold (monitor);
+
+                frame.peak_hold = monitor->priv->peak_hold;
+            }
+
+            /* The latency of a record stream is the age of the data at the
+             * read index, fall back to the time of reading it */
+            time = g_get_monotonic_time ();
+            if (pa_stream_get_latency (stream, &latency, &negative) == 0 && negative == 0)
+                time -= (gint64) latency;
+
+            for (i = 0; i < monitor->priv->buffers->len; i++)
+                _mate_mixer_monitor_buffer_push (g_ptr_array_index (monitor->priv->buffers, i),
+                                                 time,
+                                                 frame.peak,
+                                                 frame.n_channels);
+
+            if (monitor->priv->mainloop != NULL)
+                queue_frame (monitor, &frame, sum);
+            else
+                g_signal_emit (G_OBJECT (monitor),
+                               signals[FRAME],
+                               0,
+                               &frame);
+        }
     }
 
     /* pa_stream_drop() should not be called if the buffer is empty, but it
@@ -350,3 +698,161 @@ stream_read_cb (pa_stream *stream, size_t length, void *userdata)
     if (length > 0)
         pa_stream_drop (stream);
 }
+
+static void
+measure_levels (const gfloat *samples,
+                guint         n_frames,
+                guint         n_channels,
+                gfloat       *peak,
+                gfloat       *sum)
+{
+    guint c;
+
+    /* A single branch-free pass over each channel which the compiler is able
+     * to vectorize, the stride is 1 in the common mono case */
+    for (c = 0; c < n_channels; c++) {
+        const gfloat *p = samples + c;
+        gfloat        max = 0.0f;
+        gfloat        acc = 0.0f;
+        guint         i;
+
+        for (i = 0; i < n_frames; i++) {
+            gfloat v = fabsf (p[i * n_channels]);
+
+            max  = (v > max) ? v : max;
+            acc += v * v;
+        }
+        peak[c] = max;
+        sum[c]  = acc;
+    }
+}
+
+static void
+update_peak_hold (PulseMonitor *monitor)
+{
+    gint64 now;
+    guint  i;
+
+    now = g_get_monotonic_time ();
+
+    for (i = 0; i < monitor->priv->n_channels; i++) {
+        if (monitor->priv->peak[i] >= monitor->priv->peak_hold[i] ||
+            now - monitor->priv->peak_hold_time[i] > PEAK_HOLD_TIME) {
+            monitor->priv->peak_hold[i]      = monitor->priv->peak[i];
+            monitor->priv->peak_hold_time[i] = now;
+        }
+    }
+}
+
+static void
+queue_frame (PulseMonitor *monitor, MateMixerMonitorFrame *frame, const gfloat *sum)
+{
+    guint i;
+    guint n = 0;
+
+    g_mutex_lock (&monitor->priv->pending_mutex);
+
+    /* Start a new batch, the channel count may also change when the stream
+     * is restarted while a batch is pending */
+    if (monitor->priv->pending_source == NULL ||
+        monitor->priv->pending_channels != frame->n_channels) {
+        monitor->priv->pending_channels = frame->n_channels;
+        monitor->priv->pending_frames   = 0;
+
+        memset (monitor->priv->pending_peak, 0, sizeof (monitor->priv->pending_peak));
+        memset (monitor->priv->pending_sum, 0, sizeof (monitor->priv->pending_sum));
+
+        g_array_set_size (monitor->priv->pending_samples, 0);
+    }
+
+    for (i = 0; i < frame->n_channels; i++) {
+        monitor->priv->pending_peak[i] = MAX (monitor->priv->pending_peak[i], frame->peak[i]);
+        monitor->priv->pending_sum[i] += sum[i];
+    }
+    if (frame->peak_hold != NULL)
+        memcpy (monitor->priv->pending_peak_hold,
+                frame->peak_hold,
+                frame->n_channels * sizeof (gfloat));
+
+    monitor->priv->pending_frames += frame->n_samples;
+
+    /* The flags may be changed by the main loop before the batch is delivered */
+    monitor->priv->pending_flags = monitor->priv->flags;
+
+    i = monitor->priv->pending_samples->len / frame->n_channels;
+    if (i < MAX_PENDING_FRAMES)
+        n = MIN (frame->n_samples, MAX_PENDING_FRAMES - i);
+
+    if (n > 0)
+        g_array_append_vals (monitor->priv->pending_samples,
+                             frame->samples,
+                             n * frame->n_channels);
+
+    if (monitor->priv->pending_source == NULL) {
+        GSource *source = g_idle_source_new ();
+
+        /* The source is destroyed when the monitor is disposed */
+        g_source_set_callback (source,
+                               (GSourceFunc) dispatch_frames,
+                               monitor,
+                               NULL);
+        g_source_attach (source, monitor->priv->main_context);
+
+        monitor->priv->pending_source = source;
+    }
+
+    g_mutex_unlock (&monitor->priv->pending_mutex);
+}
+
+static gboolean
+dispatch_frames (PulseMonitor *monitor)
+{
+    MateMixerMonitorFrame frame;
+    gfloat                peak[PA_CHANNELS_MAX];
+    gfloat                rms[PA_CHANNELS_MAX];
+    gfloat                peak_hold[PA_CHANNELS_MAX];
+    GArray               *samples;
+    MateMixerMonitorFlags flags;
+    guint                 i;
+
+    g_mutex_lock (&monitor->priv->pending_mutex);
+
+    frame.n_channels = monitor->priv->pending_channels;
+    flags            = monitor->priv->pending_flags;
+
+    memcpy (peak, monitor->priv->pending_peak, sizeof (peak));
+    memcpy (peak_hold, monitor->priv->pending_peak_hold, sizeof (peak_hold));
+
+    for (i = 0; i < frame.n_channels; i++)
+        rms[i] = MIN (sqrtf (monitor->priv->pending_sum[i] /
+                             MAX (monitor->priv->pending_frames, 1)), 1.0f);
+
+    /* Swap the sample arrays to let the stream thread continue while the
+     * batch is being delivered */
+    samples = monitor->priv->pending_samples;
+    monitor->priv->pending_samples  = monitor->priv->dispatch_samples;
+    monitor->priv->dispatch_samples = samples;
+
+    g_source_unref (monitor->priv->pending_source);
+    monitor->priv->pending_source = NULL;
+
+    g_mutex_unlock (&monitor->priv->pending_mutex);
+
+    frame.n_samples = samples->len / MAX (frame.n_channels, 1);
+    frame.samples   = (gfloat *) samples->data;
+    frame.peak      = peak;
+    frame.rms       = NULL;
+    frame.peak_hold = NULL;
+
+    if (flags & MATE_MIXER_MONITOR_RMS)
+        frame.rms = rms;
+    if (flags & MATE_MIXER_MONITOR_PEAK_HOLD)
+        frame.peak_hold = peak_hold;
+
+    g_signal_emit (G_OBJECT (monitor),
+                   signals[FRAME],
+                   0,
+                   &frame);
+
+    return G_SOURCE_REMOVE;
+}
@@ -21,12 +21,17 @@
 #include <glib.h>
 #include <glib-object.h>
 
+#include <libmatemixer/matemixer.h>
+
 #include <pulse/pulseaudio.h>
 
 #include "pulse-types.h"
 
 G_BEGIN_DECLS
 
+/* Stream property set on all peak monitor streams of the library */
+#define PULSE_MONITOR_PROPERTY                  "libmatemixer.monitor"
+
 #define PULSE_TYPE_MONITOR                      \
         (pulse_monitor_get_type ())
 #define PULSE_MONITOR(o)                        \
@@ -56,20 +61,35 @@ struct _PulseMonitorClass
     GObjectClass parent_class;
 
     /*< private >*/
-    void (*value) (PulseMonitor *monitor,
-                   gdouble       value);
+    void (*frame) (PulseMonitor          *monitor,
+                   MateMixerMonitorFrame *frame);
 };
 
-GType         pulse_monitor_get_type     (void) G_GNUC_CONST;
+GType         pulse_monitor_get_type        (void) G_GNUC_CONST;
+
+PulseMonitor *pulse_monitor_new             (pa_context             *context,
+                                             pa_threaded_mainloop   *mainloop,
+                                             pa_proplist            *proplist,
+                                             guint32                 index_source,
+                                             guint32                 index_sink_input);
+
+gboolean      pulse_monitor_get_enabled     (PulseMonitor           *monitor);
+gboolean      pulse_monitor_set_enabled     (PulseMonitor           *monitor,
+                                             gboolean                enabled);
+
+gboolean      pulse_monitor_start_pending   (PulseMonitor           *monitor);
+
+void          pulse_monitor_add_buffer      (PulseMonitor           *monitor,
+                                             MateMixerMonitorBuffer *buffer);
+void          pulse_monitor_remove_buffer   (PulseMonitor           *monitor,
+                                             MateMixerMonitorBuffer *buffer);
 
-PulseMonitor *pulse_monitor_new          (pa_context   *context,
-                                          pa_proplist  *proplist,
-                                          guint32       index_source,
-                                          guint32       index_sink_input);
+gboolean      pulse_monitor_set_options     (PulseMonitor           *monitor,
+                                             guint                   rate,
+                                             MateMixerMonitorFlags   flags);
 
-gboolean      pulse_monitor_get_enabled  (PulseMonitor *monitor);
-gboolean      pulse_monitor_set_enabled  (PulseMonitor *monitor,
-                                          gboolean      enabled);
+gboolean      pulse_monitor_set_channel_map (PulseMonitor           *monitor,
+                                             const pa_channel_map   *map);
 
 G_END_DECLS
 
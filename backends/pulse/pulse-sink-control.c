@@ -36,8 +36,12 @@ G_DEFINE_TYPE (PulseSinkControl, pulse_sink_control, PULSE_TYPE_STREAM_CONTROL);
 static gboolean      pulse_sink_control_set_mute        (PulseStreamControl *psc,
                                                          gboolean            mute);
 static gboolean      pulse_sink_control_set_volume      (PulseStreamControl *psc,
-                                                         pa_cvolume         *cvolume);
-static PulseMonitor *pulse_sink_control_create_monitor  (PulseStreamControl *psc);
+                                                         pa_cvolume         *cvolume,
+                                                         PulseConnectionWriteFunc func,
+                                                         gpointer            user_data);
+static gboolean      pulse_sink_control_get_monitor_indexes (PulseStreamControl *psc,
+                                                             guint32            *index_source,
+                                                             guint32            *index_sink_input);
 
 static void
 pulse_sink_control_class_init (PulseSinkControlClass *klass)
@@ -45,9 +49,9 @@ pulse_sink_control_class_init (PulseSinkControlClass *klass)
     PulseStreamControlClass *control_class;
 
     control_class = PULSE_STREAM_CONTROL_CLASS (klass);
-    control_class->set_mute       = pulse_sink_control_set_mute;
-    control_class->set_volume     = pulse_sink_control_set_volume;
-    control_class->create_monitor = pulse_sink_control_create_monitor;
+    control_class->set_mute            = pulse_sink_control_set_mute;
+    control_class->set_volume          = pulse_sink_control_set_volume;
+    control_class->get_monitor_indexes = pulse_sink_control_get_monitor_indexes;
 }
 
 static void
@@ -131,23 +135,30 @@ pulse_sink_control_set_mute (PulseStreamControl *psc, gboolean mute)
 }
 
 static gboolean
-pulse_sink_control_set_volume (PulseStreamControl *psc, pa_cvolume *cvolume)
+pulse_sink_control_set_volume (PulseStreamControl       *psc,
+                               pa_cvolume               *cvolume,
+                               PulseConnectionWriteFunc  func,
+                               gpointer                  user_data)
 {
     g_return_val_if_fail (PULSE_IS_SINK_CONTROL (psc), FALSE);
     g_return_val_if_fail (cvolume != NULL, FALSE);
 
     return pulse_connection_set_sink_volume (pulse_stream_control_get_connection (psc),
                                              pulse_stream_control_get_stream_index (psc),
-                                             cvolume);
+                                             cvolume,
+                                             func,
+                                             user_data);
 }
 
-static PulseMonitor *
-pulse_sink_control_create_monitor (PulseStreamControl *psc)
+static gboolean
+pulse_sink_control_get_monitor_indexes (PulseStreamControl *psc,
+                                        guint32            *index_source,
+                                        guint32            *index_sink_input)
 {
     PulseSink *sink;
     guint32    index;
 
-    g_return_val_if_fail (PULSE_IS_SINK_CONTROL (psc), NULL);
+    g_return_val_if_fail (PULSE_IS_SINK_CONTROL (psc), FALSE);
 
     sink = PULSE_SINK (mate_mixer_stream_control_get_stream (MATE_MIXER_STREAM_CONTROL (psc)));
 
@@ -155,10 +166,10 @@ pulse_sink_control_create_monitor (PulseStreamControl *psc)
     if G_UNLIKELY (index == PA_INVALID_INDEX) {
         g_debug ("Monitor of stream control %s is not available",
                  mate_mixer_stream_control_get_name (MATE_MIXER_STREAM_CONTROL (psc)));
-        return NULL;
+        return FALSE;
     }
 
-    return pulse_connection_create_monitor (pulse_stream_control_get_connection (psc),
-                                            index,
-                                            PA_INVALID_INDEX);
+    *index_source     = index;
+    *index_sink_input = PA_INVALID_INDEX;
+    return TRUE;
 }
@@ -40,8 +40,12 @@ static guint         pulse_sink_input_get_max_volume (MateMixerStreamControl *mm
 static gboolean      pulse_sink_input_set_mute       (PulseStreamControl     *psc,
                                                       gboolean                mute);
 static gboolean      pulse_sink_input_set_volume     (PulseStreamControl     *psc,
-                                                      pa_cvolume             *cvolume);
-static PulseMonitor *pulse_sink_input_create_monitor (PulseStreamControl     *psc);
+                                                      pa_cvolume             *cvolume,
+                                                      PulseConnectionWriteFunc func,
+                                                      gpointer                user_data);
+static gboolean      pulse_sink_input_get_monitor_indexes (PulseStreamControl *psc,
+                                                           guint32            *index_source,
+                                                           guint32            *index_sink_input);
 
 static void
 pulse_sink_input_class_init (PulseSinkInputClass *klass)
@@ -53,9 +57,9 @@ pulse_sink_input_class_init (PulseSinkInputClass *klass)
     mmsc_class->get_max_volume    = pulse_sink_input_get_max_volume;
 
     control_class = PULSE_STREAM_CONTROL_CLASS (klass);
-    control_class->set_mute       = pulse_sink_input_set_mute;
-    control_class->set_volume     = pulse_sink_input_set_volume;
-    control_class->create_monitor = pulse_sink_input_create_monitor;
+    control_class->set_mute            = pulse_sink_input_set_mute;
+    control_class->set_volume          = pulse_sink_input_set_volume;
+    control_class->get_monitor_indexes = pulse_sink_input_get_monitor_indexes;
 }
 
 static void
@@ -69,7 +73,7 @@ pulse_sink_input_new (PulseConnection          *connection,
                       PulseSink                *parent)
 {
     PulseSinkInput   *input;
-    gchar            *name;
+    gchar             name[64];
     const gchar      *prop;
     const gchar      *label = NULL;
     MateMixerAppInfo *app_info = NULL;
@@ -88,8 +92,10 @@ pulse_sink_input_new (PulseConnection          *connection,
     /* Many mixer applications query the Pulse client list and use the client
      * name here, but we use the name only as an identifier, so let's avoid
      * this unnecessary overhead and use a custom name.
-     * Also make sure to make the name unique by including the PulseAudio index. */
-    name = g_strdup_printf ("pulse-output-control-%lu", (gulong) info->index);
+     * Also make sure to make the name unique by including the PulseAudio index.
+     * The control keeps a shared copy of the name, so a stack buffer is
+     * enough here. */
+    g_snprintf (name, sizeof (name), "pulse-output-control-%lu", (gulong) info->index);
 
     if (info->has_volume) {
         flags |=
@@ -148,7 +154,6 @@ pulse_sink_input_new (PulseConnection          *connection,
                           "connection", connection,
                           "index", info->index,
                           NULL);
-    g_free (name);
 
     if (app_info != NULL) {
         /* Takes ownership of app_info */
@@ -207,23 +212,30 @@ pulse_sink_input_set_mute (PulseStreamControl *psc, gboolean mute)
 }
 
 static gboolean
-pulse_sink_input_set_volume (PulseStreamControl *psc, pa_cvolume *cvolume)
+pulse_sink_input_set_volume (PulseStreamControl       *psc,
+                             pa_cvolume               *cvolume,
+                             PulseConnectionWriteFunc  func,
+                             gpointer                  user_data)
 {
     g_return_val_if_fail (PULSE_IS_SINK_INPUT (psc), FALSE);
     g_return_val_if_fail (cvolume != NULL, FALSE);
 
     return pulse_connection_set_sink_input_volume (pulse_stream_control_get_connection (psc),
                                                    pulse_stream_control_get_index (psc),
-                                                   cvolume);
+                                                   cvolume,
+                                                   func,
+                                                   user_data);
 }
 
-static PulseMonitor *
-pulse_sink_input_create_monitor (PulseStreamControl *psc)
+static gboolean
+pulse_sink_input_get_monitor_indexes (PulseStreamControl *psc,
+                                      guint32            *index_source,
+                                      guint32            *index_sink_input)
 {
     PulseSink *sink;
     guint32    index;
 
-    g_return_val_if_fail (PULSE_IS_SINK_INPUT (psc), NULL);
+    g_return_val_if_fail (PULSE_IS_SINK_INPUT (psc), FALSE);
 
     sink = PULSE_SINK (mate_mixer_stream_control_get_stream (MATE_MIXER_STREAM_CONTROL (psc)));
 
@@ -231,10 +243,10 @@ pulse_sink_input_create_monitor (PulseStreamControl *psc)
     if G_UNLIKELY (index == PA_INVALID_INDEX) {
         g_debug ("Monitor of stream control %s is not available",
                  mate_mixer_stream_control_get_name (MATE_MIXER_STREAM_CONTROL (psc)));
-        return NULL;
+        return FALSE;
     }
 
-    return pulse_connection_create_monitor (pulse_stream_control_get_connection (psc),
-                                            index,
-                                            pulse_stream_control_get_index (psc));
+    *index_source     = index;
+    *index_sink_input = pulse_stream_control_get_index (psc);
+    return TRUE;
 }
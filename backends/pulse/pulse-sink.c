@@ -36,12 +36,12 @@
 
 struct _PulseSinkPrivate
 {
-    guint32           monitor;
-    GHashTable       *inputs;
-    GList            *inputs_list;
-    PulsePortSwitch  *pswitch;
-    GList            *pswitch_list;
-    PulseSinkControl *control;
+    guint32              monitor;
+    GHashTable          *inputs;
+    MateMixerObjectList *inputs_list;
+    PulsePortSwitch     *pswitch;
+    GList               *pswitch_list;
+    PulseSinkControl    *control;
 };
 
 static void pulse_sink_class_init (PulseSinkClass *klass);
@@ -54,8 +54,6 @@ G_DEFINE_TYPE (PulseSink, pulse_sink, PULSE_TYPE_STREAM);
 static const GList *pulse_sink_list_controls (MateMixerStream *mms);
 static const GList *pulse_sink_list_switches (MateMixerStream *mms);
 
-static void         free_list_controls       (PulseSink       *sink);
-
 static void
 pulse_sink_class_init (PulseSinkClass *klass)
 {
@@ -85,6 +83,8 @@ pulse_sink_init (PulseSink *sink)
                                                 NULL,
                                                 g_object_unref);
 
+    sink->priv->inputs_list = _mate_mixer_object_list_new ();
+
     sink->priv->monitor = PA_INVALID_INDEX;
 }
 
@@ -100,7 +100,7 @@ pulse_sink_dispose (GObject *object)
     g_clear_object (&sink->priv->control);
     g_clear_object (&sink->priv->pswitch);
 
-    free_list_controls (sink);
+    _mate_mixer_object_list_clear (sink->priv->inputs_list);
 
     if (sink->priv->pswitch_list != NULL) {
         g_list_free (sink->priv->pswitch_list);
@@ -118,6 +118,8 @@ pulse_sink_finalize (GObject *object)
 
     g_hash_table_unref (sink->priv->inputs);
 
+    _mate_mixer_object_list_free (sink->priv->inputs_list);
+
     G_OBJECT_CLASS (pulse_sink_parent_class)->finalize (object);
 }
 
@@ -143,6 +145,9 @@ pulse_sink_new (PulseConnection    *connection,
 
     sink->priv->control = pulse_sink_control_new (connection, info, sink);
 
+    /* The sink control is always the first one in the list of controls */
+    _mate_mixer_object_list_prepend (sink->priv->inputs_list, sink->priv->control);
+
     if (info->n_ports > 0) {
         pa_sink_port_info **ports = info->ports;
 
@@ -208,7 +213,10 @@ pulse_sink_add_input (PulseSink *sink, const pa_sink_input_info *info)
                              GUINT_TO_POINTER (info->index),
                              input);
 
-        free_list_controls (sink);
+        _mate_mixer_object_list_append (sink->priv->inputs_list, input);
+
+        _mate_mixer_stream_index_control (MATE_MIXER_STREAM (sink),
+                                          MATE_MIXER_STREAM_CONTROL (input));
 
         name = mate_mixer_stream_control_get_name (MATE_MIXER_STREAM_CONTROL (input));
         g_signal_emit_by_name (G_OBJECT (sink),
@@ -225,7 +233,6 @@ void
 pulse_sink_remove_input (PulseSink *sink, guint32 index)
 {
     PulseSinkInput *input;
-    gchar          *name;
 
     g_return_if_fail (PULSE_IS_SINK (sink));
 
@@ -233,15 +240,16 @@ pulse_sink_remove_input (PulseSink *sink, guint32 index)
     if G_UNLIKELY (input == NULL)
         return;
 
-    name = g_strdup (mate_mixer_stream_control_get_name (MATE_MIXER_STREAM_CONTROL (input)));
+    g_object_ref (input);
+
+    _mate_mixer_object_list_remove (sink->priv->inputs_list, input);
 
     g_hash_table_remove (sink->priv->inputs, GUINT_TO_POINTER (index));
 
-    free_list_controls (sink);
     g_signal_emit_by_name (G_OBJECT (sink),
                            "control-removed",
-                           name);
-    g_free (name);
+                           mate_mixer_stream_control_get_name (MATE_MIXER_STREAM_CONTROL (input)));
+    g_object_unref (input);
 }
 
 void
@@ -278,15 +286,7 @@ pulse_sink_list_controls (MateMixerStream *mms)
 
     sink = PULSE_SINK (mms);
 
-    if (sink->priv->inputs_list == NULL) {
-        sink->priv->inputs_list = g_hash_table_get_values (sink->priv->inputs);
-        if (sink->priv->inputs_list != NULL)
-            g_list_foreach (sink->priv->inputs_list, (GFunc) g_object_ref, NULL);
-
-        sink->priv->inputs_list = g_list_prepend (sink->priv->inputs_list,
-                                                  g_object_ref (sink->priv->control));
-    }
-    return sink->priv->inputs_list;
+    return _mate_mixer_object_list_peek (sink->priv->inputs_list);
 }
 
 static const GList *
@@ -296,14 +296,3 @@ pulse_sink_list_switches (MateMixerStream *mms)
 
     return PULSE_SINK (mms)->priv->pswitch_list;
 }
-
-static void
-free_list_controls (PulseSink *sink)
-{
-    if (sink->priv->inputs_list == NULL)
-        return;
-
-    g_list_free_full (sink->priv->inputs_list, g_object_unref);
-
-    sink->priv->inputs_list = NULL;
-}
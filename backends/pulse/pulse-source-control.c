@@ -36,8 +36,12 @@ G_DEFINE_TYPE (PulseSourceControl, pulse_source_control, PULSE_TYPE_STREAM_CONTR
 static gboolean      pulse_source_control_set_mute        (PulseStreamControl *psc,
                                                            gboolean            mute);
 static gboolean      pulse_source_control_set_volume      (PulseStreamControl *psc,
-                                                           pa_cvolume         *cvolume);
-static PulseMonitor *pulse_source_control_create_monitor  (PulseStreamControl *psc);
+                                                           pa_cvolume         *cvolume,
+                                                           PulseConnectionWriteFunc func,
+                                                           gpointer            user_data);
+static gboolean      pulse_source_control_get_monitor_indexes (PulseStreamControl *psc,
+                                                               guint32            *index_source,
+                                                               guint32            *index_sink_input);
 
 static void
 pulse_source_control_class_init (PulseSourceControlClass *klass)
@@ -45,9 +49,9 @@ pulse_source_control_class_init (PulseSourceControlClass *klass)
     PulseStreamControlClass *control_class;
 
     control_class = PULSE_STREAM_CONTROL_CLASS (klass);
-    control_class->set_mute       = pulse_source_control_set_mute;
-    control_class->set_volume     = pulse_source_control_set_volume;
-    control_class->create_monitor = pulse_source_control_create_monitor;
+    control_class->set_mute            = pulse_source_control_set_mute;
+    control_class->set_volume          = pulse_source_control_set_volume;
+    control_class->get_monitor_indexes = pulse_source_control_get_monitor_indexes;
 }
 
 static void
@@ -127,31 +131,38 @@ pulse_source_control_set_mute (PulseStreamControl *psc, gboolean mute)
 }
 
 static gboolean
-pulse_source_control_set_volume (PulseStreamControl *psc, pa_cvolume *cvolume)
+pulse_source_control_set_volume (PulseStreamControl       *psc,
+                                 pa_cvolume               *cvolume,
+                                 PulseConnectionWriteFunc  func,
+                                 gpointer                  user_data)
 {
     g_return_val_if_fail (PULSE_IS_SOURCE_CONTROL (psc), FALSE);
     g_return_val_if_fail (cvolume != NULL, FALSE);
 
     return pulse_connection_set_source_volume (pulse_stream_control_get_connection (psc),
                                                pulse_stream_control_get_stream_index (psc),
-                                               cvolume);
+                                               cvolume,
+                                               func,
+                                               user_data);
 }
 
-static PulseMonitor *
-pulse_source_control_create_monitor (PulseStreamControl *psc)
+static gboolean
+pulse_source_control_get_monitor_indexes (PulseStreamControl *psc,
+                                          guint32            *index_source,
+                                          guint32            *index_sink_input)
 {
     guint32 index;
 
-    g_return_val_if_fail (PULSE_IS_SOURCE_CONTROL (psc), NULL);
+    g_return_val_if_fail (PULSE_IS_SOURCE_CONTROL (psc), FALSE);
 
     index = pulse_stream_control_get_stream_index (psc);
     if G_UNLIKELY (index == PA_INVALID_INDEX) {
         g_debug ("Monitor of stream control %s is not available",
                  mate_mixer_stream_control_get_name (MATE_MIXER_STREAM_CONTROL (psc)));
-        return NULL;
+        return FALSE;
     }
 
-    return pulse_connection_create_monitor (pulse_stream_control_get_connection (psc),
-                                            index,
-                                            PA_INVALID_INDEX);
+    *index_source     = index;
+    *index_sink_input = PA_INVALID_INDEX;
+    return TRUE;
 }
@@ -40,8 +40,12 @@ static guint         pulse_source_output_get_max_volume (MateMixerStreamControl
 static gboolean      pulse_source_output_set_mute       (PulseStreamControl     *psc,
                                                          gboolean                mute);
 static gboolean      pulse_source_output_set_volume     (PulseStreamControl     *psc,
-                                                         pa_cvolume             *cvolume);
-static PulseMonitor *pulse_source_output_create_monitor (PulseStreamControl     *psc);
+                                                         pa_cvolume             *cvolume,
+                                                         PulseConnectionWriteFunc func,
+                                                         gpointer                user_data);
+static gboolean      pulse_source_output_get_monitor_indexes (PulseStreamControl *psc,
+                                                              guint32            *index_source,
+                                                              guint32            *index_sink_input);
 
 static void
 pulse_source_output_class_init (PulseSourceOutputClass *klass)
@@ -53,9 +57,9 @@ pulse_source_output_class_init (PulseSourceOutputClass *klass)
     mmsc_class->get_max_volume    = pulse_source_output_get_max_volume;
 
     control_class = PULSE_STREAM_CONTROL_CLASS (klass);
-    control_class->set_mute       = pulse_source_output_set_mute;
-    control_class->set_volume     = pulse_source_output_set_volume;
-    control_class->create_monitor = pulse_source_output_create_monitor;
+    control_class->set_mute            = pulse_source_output_set_mute;
+    control_class->set_volume          = pulse_source_output_set_volume;
+    control_class->get_monitor_indexes = pulse_source_output_get_monitor_indexes;
 }
 
 static void
@@ -69,7 +73,7 @@ pulse_source_output_new (PulseConnection             *connection,
                          PulseSource                 *parent)
 {
     PulseSourceOutput *output;
-    gchar             *name;
+    gchar              name[64];
     const gchar       *prop;
     MateMixerAppInfo  *app_info = NULL;
 
@@ -87,8 +91,10 @@ pulse_source_output_new (PulseConnection             *connection,
     /* Many mixer applications query the Pulse client list and use the client
      * name here, but we use the name only as an identifier, so let's avoid
      * this unnecessary overhead and use a custom name.
-     * Also make sure to make the name unique by including the PulseAudio index. */
-    name = g_strdup_printf ("pulse-input-control-%lu", (gulong) info->index);
+     * Also make sure to make the name unique by including the PulseAudio index.
+     * The control keeps a shared copy of the name, so a stack buffer is
+     * enough here. */
+    g_snprintf (name, sizeof (name), "pulse-input-control-%lu", (gulong) info->index);
 
     if (info->has_volume) {
         flags |=
@@ -135,7 +141,6 @@ pulse_source_output_new (PulseConnection             *connection,
                           "connection", connection,
                           "index", info->index,
                           NULL);
-    g_free (name);
 
     if (app_info != NULL) {
         /* Takes ownership of app_info */
@@ -195,22 +200,30 @@ pulse_source_output_set_mute (PulseStreamControl *psc, gboolean mute)
 }
 
 static gboolean
-pulse_source_output_set_volume (PulseStreamControl *psc, pa_cvolume *cvolume)
+pulse_source_output_set_volume (PulseStreamControl       *psc,
+                                pa_cvolume               *cvolume,
+                                PulseConnectionWriteFunc  func,
+                                gpointer                  user_data)
 {
     g_return_val_if_fail (PULSE_IS_SOURCE_OUTPUT (psc), FALSE);
     g_return_val_if_fail (cvolume != NULL, FALSE);
 
     return pulse_connection_set_source_output_volume (pulse_stream_control_get_connection (psc),
                                                       pulse_stream_control_get_index (psc),
-                                                      cvolume);
+                                                      cvolume,
+                                                      func,
+                                                      user_data);
 }
 
-static PulseMonitor *
-pulse_source_output_create_monitor (PulseStreamControl *psc)
+static gboolean
+pulse_source_output_get_monitor_indexes (PulseStreamControl *psc,
+                                         guint32            *index_source,
+                                         guint32            *index_sink_input)
 {
-    g_return_val_if_fail (PULSE_IS_SOURCE_OUTPUT (psc), NULL);
+    g_return_val_if_fail (PULSE_IS_SOURCE_OUTPUT (psc), FALSE);
+
+    *index_source     = pulse_stream_control_get_stream_index (psc);
+    *index_sink_input = PA_INVALID_INDEX;
 
-    return pulse_connection_create_monitor (pulse_stream_control_get_connection (psc),
-                                            pulse_stream_control_get_stream_index (psc),
-                                            PA_INVALID_INDEX);
+    return *index_source != PA_INVALID_INDEX;
 }
@@ -36,11 +36,11 @@
 
 struct _PulseSourcePrivate
 {
-    GHashTable         *outputs;
-    GList              *outputs_list;
-    PulsePortSwitch    *pswitch;
-    GList              *pswitch_list;
-    PulseSourceControl *control;
+    GHashTable          *outputs;
+    MateMixerObjectList *outputs_list;
+    PulsePortSwitch     *pswitch;
+    GList               *pswitch_list;
+    PulseSourceControl  *control;
 };
 
 static void pulse_source_class_init (PulseSourceClass *klass);
@@ -53,8 +53,6 @@ G_DEFINE_TYPE (PulseSource, pulse_source, PULSE_TYPE_STREAM);
 static const GList *pulse_source_list_controls (MateMixerStream *mms);
 static const GList *pulse_source_list_switches (MateMixerStream *mms);
 
-static void         free_list_controls         (PulseSource     *source);
-
 static void
 pulse_source_class_init (PulseSourceClass *klass)
 {
@@ -83,6 +81,8 @@ pulse_source_init (PulseSource *source)
                                                    g_direct_equal,
                                                    NULL,
                                                    g_object_unref);
+
+    source->priv->outputs_list = _mate_mixer_object_list_new ();
 }
 
 static void
@@ -97,7 +97,7 @@ pulse_source_dispose (GObject *object)
     g_clear_object (&source->priv->control);
     g_clear_object (&source->priv->pswitch);
 
-    free_list_controls (source);
+    _mate_mixer_object_list_clear (source->priv->outputs_list);
 
     if (source->priv->pswitch_list != NULL) {
         g_list_free (source->priv->pswitch_list);
@@ -115,6 +115,8 @@ pulse_source_finalize (GObject *object)
 
     g_hash_table_unref (source->priv->outputs);
 
+    _mate_mixer_object_list_free (source->priv->outputs_list);
+
     G_OBJECT_CLASS (pulse_source_parent_class)->finalize (object);
 }
 
@@ -140,6 +142,9 @@ pulse_source_new (PulseConnection      *connection,
 
     source->priv->control = pulse_source_control_new (connection, info, source);
 
+    /* The source control is always the first one in the list of controls */
+    _mate_mixer_object_list_prepend (source->priv->outputs_list, source->priv->control);
+
     if (info->n_ports > 0) {
         pa_source_port_info **ports = info->ports;
 
@@ -204,7 +209,10 @@ pulse_source_add_output (PulseSource *source, const pa_source_output_info *info)
                              GUINT_TO_POINTER (info->index),
                              output);
 
-        free_list_controls (source);
+        _mate_mixer_object_list_append (source->priv->outputs_list, output);
+
+        _mate_mixer_stream_index_control (MATE_MIXER_STREAM (source),
+                                          MATE_MIXER_STREAM_CONTROL (output));
 
         name = mate_mixer_stream_control_get_name (MATE_MIXER_STREAM_CONTROL (output));
         g_signal_emit_by_name (G_OBJECT (source),
@@ -221,7 +229,6 @@ void
 pulse_source_remove_output (PulseSource *source, guint32 index)
 {
     PulseSourceOutput *output;
-    gchar             *name;
 
     g_return_if_fail (PULSE_IS_SOURCE (source));
 
@@ -229,15 +236,16 @@ pulse_source_remove_output (PulseSource *source, guint32 index)
     if G_UNLIKELY (output == NULL)
         return;
 
-    name = g_strdup (mate_mixer_stream_control_get_name (MATE_MIXER_STREAM_CONTROL (output)));
+    g_object_ref (output);
+
+    _mate_mixer_object_list_remove (source->priv->outputs_list, output);
 
     g_hash_table_remove (source->priv->outputs, GUINT_TO_POINTER (index));
 
-    free_list_controls (source);
     g_signal_emit_by_name (G_OBJECT (source),
                            "control-removed",
-                           name);
-    g_free (name);
+                           mate_mixer_stream_control_get_name (MATE_MIXER_STREAM_CONTROL (output)));
+    g_object_unref (output);
 }
 
 void
@@ -265,15 +273,7 @@ pulse_source_list_controls (MateMixerStream *mms)
 
     source = PULSE_SOURCE (mms);
 
-    if (source->priv->outputs_list == NULL) {
-        source->priv->outputs_list = g_hash_table_get_values (source->priv->outputs);
-        if (source->priv->outputs_list != NULL)
-            g_list_foreach (source->priv->outputs_list, (GFunc) g_object_ref, NULL);
-
-        source->priv->outputs_list = g_list_prepend (source->priv->outputs_list,
-                                                     g_object_ref (source->priv->control));
-    }
-    return source->priv->outputs_list;
+    return _mate_mixer_object_list_peek (source->priv->outputs_list);
 }
 
 static const GList *
@@ -283,14 +283,3 @@ pulse_source_list_switches (MateMixerStream *mms)
 
     return PULSE_SOURCE (mms)->priv->pswitch_list;
 }
-
-static void
-free_list_controls (PulseSource *source)
-{
-    if (source->priv->outputs_list == NULL)
-        return;
-
-    g_list_free_full (source->priv->outputs_list, g_object_unref);
-
-    source->priv->outputs_list = NULL;
-}
@@ -30,14 +30,20 @@
 
 struct _PulseStreamControlPrivate
 {
-    guint32           index;
-    guint             volume;
-    pa_cvolume        cvolume;
-    pa_volume_t       base_volume;
-    pa_channel_map    channel_map;
-    PulseConnection  *connection;
-    PulseMonitor     *monitor;
-    MateMixerAppInfo *app_info;
+    guint32                 index;
+    guint                   volume;
+    pa_cvolume              cvolume;
+    pa_volume_t             base_volume;
+    pa_channel_map          channel_map;
+    PulseConnection        *connection;
+    PulseMonitor           *monitor;
+    MateMixerMonitorBuffer *monitor_buffer;
+    MateMixerAppInfo       *app_info;
+    gboolean                volume_pending;
+    gboolean                volume_queued;
+    pa_cvolume              queued_cvolume;
+    pa_cvolume              written_cvolume;
+    pa_cvolume              server_cvolume;
 };
 
 enum {
@@ -83,6 +89,9 @@ static gboolean                 pulse_stream_control_set_decibel          (MateM
 
 static guint                    pulse_stream_control_get_channel_volume   (MateMixerStreamControl   *mmsc,
                                                                            guint                     channel);
+static void                     pulse_stream_control_get_channel_volumes  (MateMixerStreamControl   *mmsc,
+                                                                           guint                    *volumes,
+                                                                           guint                     n_volumes);
 static gboolean                 pulse_stream_control_set_channel_volume   (MateMixerStreamControl   *mmsc,
                                                                            guint                     channel,
                                                                            guint                     volume);
@@ -107,20 +116,37 @@ static gboolean                 pulse_stream_control_set_fade             (MateM
 static gboolean                 pulse_stream_control_get_monitor_enabled  (MateMixerStreamControl   *mmsc);
 static gboolean                 pulse_stream_control_set_monitor_enabled  (MateMixerStreamControl   *mmsc,
                                                                            gboolean                  enabled);
+static gboolean                 pulse_stream_control_set_monitor_options  (MateMixerStreamControl   *mmsc,
+                                                                           guint                     rate,
+                                                                           MateMixerMonitorFlags     flags);
+static void                     pulse_stream_control_set_monitor_buffer   (MateMixerStreamControl   *mmsc,
+                                                                           MateMixerMonitorBuffer   *buffer);
 
 static guint                    pulse_stream_control_get_min_volume       (MateMixerStreamControl   *mmsc);
 static guint                    pulse_stream_control_get_max_volume       (MateMixerStreamControl   *mmsc);
 static guint                    pulse_stream_control_get_normal_volume    (MateMixerStreamControl   *mmsc);
 static guint                    pulse_stream_control_get_base_volume      (MateMixerStreamControl   *mmsc);
 
-static void                     on_monitor_value (PulseMonitor       *monitor,
-                                                  gdouble             value,
-                                                  PulseStreamControl *control);
+static void                     on_monitor_frame (PulseMonitor          *monitor,
+                                                  MateMixerMonitorFrame *frame,
+                                                  PulseStreamControl    *control);
+
+static PulseMonitor *           acquire_monitor  (PulseStreamControl    *control,
+                                                  guint                  rate,
+                                                  MateMixerMonitorFlags  flags);
+static void                     release_monitor  (PulseStreamControl    *control);
 
 static void                     set_balance_fade (PulseStreamControl *control);
 
 static gboolean                 set_cvolume      (PulseStreamControl *control,
                                                   pa_cvolume         *cvolume);
+static void                     store_cvolume    (PulseStreamControl *control,
+                                                  const pa_cvolume   *cvolume);
+static gboolean                 write_cvolume    (PulseStreamControl *control,
+                                                  pa_cvolume         *cvolume);
+
+static void                     on_volume_written (gboolean           success,
+                                                   gpointer           user_data);
 
 static void
 pulse_stream_control_class_init (PulseStreamControlClass *klass)
@@ -143,6 +169,7 @@ pulse_stream_control_class_init (PulseStreamControlClass *klass)
     control_class->get_decibel          = pulse_stream_control_get_decibel;
     control_class->set_decibel          = pulse_stream_control_set_decibel;
     control_class->get_channel_volume   = pulse_stream_control_get_channel_volume;
+    control_class->get_channel_volumes  = pulse_stream_control_get_channel_volumes;
     control_class->set_channel_volume   = pulse_stream_control_set_channel_volume;
     control_class->get_channel_decibel  = pulse_stream_control_get_channel_decibel;
     control_class->set_channel_decibel  = pulse_stream_control_set_channel_decibel;
@@ -152,6 +179,8 @@ pulse_stream_control_class_init (PulseStreamControlClass *klass)
     control_class->set_fade             = pulse_stream_control_set_fade;
     control_class->get_monitor_enabled  = pulse_stream_control_get_monitor_enabled;
     control_class->set_monitor_enabled  = pulse_stream_control_set_monitor_enabled;
+    control_class->set_monitor_options  = pulse_stream_control_set_monitor_options;
+    control_class->set_monitor_buffer   = pulse_stream_control_set_monitor_buffer;
     control_class->get_min_volume       = pulse_stream_control_get_min_volume;
     control_class->get_max_volume       = pulse_stream_control_get_max_volume;
     control_class->get_normal_volume    = pulse_stream_control_get_normal_volume;
@@ -249,7 +278,8 @@ pulse_stream_control_dispose (GObject *object)
 
     control = PULSE_STREAM_CONTROL (object);
 
-    g_clear_object (&control->priv->monitor);
+    release_monitor (control);
+
     g_clear_object (&control->priv->connection);
 
     G_OBJECT_CLASS (pulse_stream_control_parent_class)->dispose (object);
@@ -342,11 +372,14 @@ void
 pulse_stream_control_set_channel_map (PulseStreamControl *control, const pa_channel_map *map)
 {
     MateMixerStreamControlFlags flags;
+    pa_channel_map              old_map;
 
     g_return_if_fail (PULSE_IS_STREAM_CONTROL (control));
 
     flags = mate_mixer_stream_control_get_flags (MATE_MIXER_STREAM_CONTROL (control));
 
+    old_map = control->priv->channel_map;
+
     if (map != NULL && pa_channel_map_valid (map)) {
         if (pa_channel_map_can_balance (map))
             flags |= MATE_MIXER_STREAM_CONTROL_CAN_BALANCE;
@@ -367,6 +400,20 @@ pulse_stream_control_set_channel_map (PulseStreamControl *control, const pa_chan
         pa_channel_map_init (&control->priv->channel_map);
     }
 
+    /* A per-channel monitor measures the channels of the old map */
+    if (control->priv->monitor != NULL &&
+        pa_channel_map_equal (&old_map, &control->priv->channel_map) == FALSE) {
+        MateMixerStreamControl *mmsc = MATE_MIXER_STREAM_CONTROL (control);
+        MateMixerMonitorFlags   monitor_flags;
+
+        monitor_flags = mate_mixer_stream_control_get_monitor_flags (mmsc);
+
+        if (monitor_flags & MATE_MIXER_MONITOR_PER_CHANNEL)
+            acquire_monitor (control,
+                             mate_mixer_stream_control_get_monitor_rate (mmsc),
+                             monitor_flags);
+    }
+
     _mate_mixer_stream_control_set_flags (MATE_MIXER_STREAM_CONTROL (control), flags);
 }
 
@@ -391,7 +438,14 @@ pulse_stream_control_set_cvolume (PulseStreamControl *control,
          * the implementation */
         flags |= MATE_MIXER_STREAM_CONTROL_VOLUME_READABLE;
 
-        if (pa_cvolume_equal (&control->priv->cvolume, cvolume) == 0) {
+        /* Remember the server volume even while our own volume change is
+         * being processed, it is restored if the change fails */
+        control->priv->server_cvolume = *cvolume;
+
+        /* Keep the locally set volume while our own volume change is being
+         * processed, the server may still report an older value */
+        if (control->priv->volume_pending == FALSE &&
+            pa_cvolume_equal (&control->priv->cvolume, cvolume) == 0) {
             control->priv->cvolume = *cvolume;
             control->priv->volume  = (guint) pa_cvolume_max (&control->priv->cvolume);
 
@@ -405,6 +459,7 @@ pulse_stream_control_set_cvolume (PulseStreamControl *control,
         /* If the cvolume is not valid, create an empty cvolume, which also
          * won't validate, but at least we know what it is */
         pa_cvolume_init (&control->priv->cvolume);
+        pa_cvolume_init (&control->priv->server_cvolume);
 
         if (control->priv->volume != (guint) PA_VOLUME_MUTED) {
             control->priv->volume = (guint) PA_VOLUME_MUTED;
@@ -421,6 +476,30 @@ pulse_stream_control_set_cvolume (PulseStreamControl *control,
     g_object_thaw_notify (G_OBJECT (control));
 }
 
+void
+pulse_stream_control_restart_monitor (PulseStreamControl *control)
+{
+    MateMixerStreamControl *mmsc;
+
+    g_return_if_fail (PULSE_IS_STREAM_CONTROL (control));
+
+    if (control->priv->monitor == NULL)
+        return;
+
+    mmsc = MATE_MIXER_STREAM_CONTROL (control);
+
+    /* The monitor stream belonged to the lost connection, replace it with one
+     * on the new connection or turn the monitoring off if that fails */
+    if (acquire_monitor (control,
+                         mate_mixer_stream_control_get_monitor_rate (mmsc),
+                         mate_mixer_stream_control_get_monitor_flags (mmsc)) == NULL) {
+        g_debug ("Failed to restart the monitor of %s",
+                 mate_mixer_stream_control_get_name (mmsc));
+
+        release_monitor (control);
+    }
+}
+
 static MateMixerAppInfo *
 pulse_stream_control_get_app_info (MateMixerStreamControl *mmsc)
 {
@@ -507,6 +586,24 @@ pulse_stream_control_get_channel_volume (MateMixerStreamControl *mmsc, guint cha
     return (guint) control->priv->cvolume.values[channel];
 }
 
+static void
+pulse_stream_control_get_channel_volumes (MateMixerStreamControl *mmsc, guint *volumes, guint n_volumes)
+{
+    PulseStreamControl *control;
+    guint               i;
+
+    g_return_if_fail (PULSE_IS_STREAM_CONTROL (mmsc));
+
+    control = PULSE_STREAM_CONTROL (mmsc);
+
+    for (i = 0; i < n_volumes; i++) {
+        if (i < control->priv->cvolume.channels)
+            volumes[i] = (guint) control->priv->cvolume.values[i];
+        else
+            volumes[i] = (guint) PA_VOLUME_MUTED;
+    }
+}
+
 static gboolean
 pulse_stream_control_set_channel_volume (MateMixerStreamControl *mmsc, guint channel, guint volume)
 {
@@ -640,14 +737,35 @@ pulse_stream_control_get_monitor_enabled (MateMixerStreamControl *mmsc)
 
     control = PULSE_STREAM_CONTROL (mmsc);
 
+    return control->priv->monitor != NULL;
+}
+
+static gboolean
+pulse_stream_control_set_monitor_enabled (MateMixerStreamControl *mmsc, gboolean enabled)
+{
+    PulseStreamControl *control;
+
+    g_return_val_if_fail (PULSE_IS_STREAM_CONTROL (mmsc), FALSE);
+
+    control = PULSE_STREAM_CONTROL (mmsc);
+
+    if (enabled == FALSE) {
+        release_monitor (control);
+        return TRUE;
+    }
+
     if (control->priv->monitor != NULL)
-        return pulse_monitor_get_enabled (control->priv->monitor);
+        return TRUE;
 
-    return FALSE;
+    return acquire_monitor (control,
+                            mate_mixer_stream_control_get_monitor_rate (mmsc),
+                            mate_mixer_stream_control_get_monitor_flags (mmsc)) != NULL;
 }
 
 static gboolean
-pulse_stream_control_set_monitor_enabled (MateMixerStreamControl *mmsc, gboolean enabled)
+pulse_stream_control_set_monitor_options (MateMixerStreamControl *mmsc,
+                                          guint                   rate,
+                                          MateMixerMonitorFlags   flags)
 {
     PulseStreamControl *control;
 
@@ -655,24 +773,29 @@ pulse_stream_control_set_monitor_enabled (MateMixerStreamControl *mmsc, gboolean
 
     control = PULSE_STREAM_CONTROL (mmsc);
 
-    if (enabled == TRUE) {
-        if (control->priv->monitor == NULL) {
-            control->priv->monitor =
-                PULSE_STREAM_CONTROL_GET_CLASS (control)->create_monitor (control);
+    /* The options are read from the control when the monitor is enabled */
+    if (control->priv->monitor == NULL)
+        return TRUE;
 
-            if G_UNLIKELY (control->priv->monitor == NULL)
-                return FALSE;
+    return acquire_monitor (control, rate, flags) != NULL;
+}
 
-            g_signal_connect (G_OBJECT (control->priv->monitor),
-                              "value",
-                              G_CALLBACK (on_monitor_value),
-                              control);
-        }
-    } else {
-        if (control->priv->monitor == NULL)
-            return FALSE;
-    }
-    return pulse_monitor_set_enabled (control->priv->monitor, enabled);
+static void
+pulse_stream_control_set_monitor_buffer (MateMixerStreamControl *mmsc,
+                                         MateMixerMonitorBuffer *buffer)
+{
+    PulseStreamControl *control;
+
+    g_return_if_fail (PULSE_IS_STREAM_CONTROL (mmsc));
+
+    control = PULSE_STREAM_CONTROL (mmsc);
+
+    /* The buffer is owned by the control, it is handed to each monitor the
+     * control acquires to be filled from the read callback of the stream */
+    control->priv->monitor_buffer = buffer;
+
+    if (control->priv->monitor != NULL)
+        pulse_monitor_add_buffer (control->priv->monitor, buffer);
 }
 
 static guint
@@ -728,11 +851,59 @@ pulse_stream_control_get_base_volume (MateMixerStreamControl *mmsc)
 }
 
 static void
-on_monitor_value (PulseMonitor *monitor, gdouble value, PulseStreamControl *control)
+on_monitor_frame (PulseMonitor *monitor, MateMixerMonitorFrame *frame, PulseStreamControl *control)
 {
-    g_signal_emit_by_name (G_OBJECT (control),
-                           "monitor-value",
-                           value);
+    _mate_mixer_stream_control_monitor_frame (MATE_MIXER_STREAM_CONTROL (control), frame);
+}
+
+static PulseMonitor *
+acquire_monitor (PulseStreamControl *control, guint rate, MateMixerMonitorFlags flags)
+{
+    PulseMonitor *monitor;
+    guint32       index_source;
+    guint32       index_sink_input;
+
+    if (PULSE_STREAM_CONTROL_GET_CLASS (control)->get_monitor_indexes (control,
+                                                                       &index_source,
+                                                                       &index_sink_input) == FALSE)
+        return NULL;
+
+    /* The monitor may be shared with other controls of the connection, it
+     * is replaced rather than reconfigured when the options change */
+    monitor = pulse_connection_get_monitor (control->priv->connection,
+                                            index_source,
+                                            index_sink_input,
+                                            rate,
+                                            flags,
+                                            &control->priv->channel_map);
+    if G_UNLIKELY (monitor == NULL)
+        return NULL;
+
+    release_monitor (control);
+
+    if (control->priv->monitor_buffer != NULL)
+        pulse_monitor_add_buffer (monitor, control->priv->monitor_buffer);
+
+    g_signal_connect (G_OBJECT (monitor),
+                      "frame",
+                      G_CALLBACK (on_monitor_frame),
+                      control);
+
+    control->priv->monitor = monitor;
+    return monitor;
+}
+
+static void
+release_monitor (PulseStreamControl *control)
+{
+    if (control->priv->monitor == NULL)
+        return;
+
+    if (control->priv->monitor_buffer != NULL)
+        pulse_monitor_remove_buffer (control->priv->monitor, control->priv->monitor_buffer);
+
+    g_signal_handlers_disconnect_by_data (G_OBJECT (control->priv->monitor), control);
+    g_clear_object (&control->priv->monitor);
 }
 
 static void
@@ -756,17 +927,30 @@ set_balance_fade (PulseStreamControl *control)
 static gboolean
 set_cvolume (PulseStreamControl *control, pa_cvolume *cvolume)
 {
-    PulseStreamControlClass *klass;
-
     if (pa_cvolume_valid (cvolume) == 0)
         return FALSE;
     if (pa_cvolume_equal (cvolume, &control->priv->cvolume) != 0)
         return TRUE;
 
-    klass = PULSE_STREAM_CONTROL_GET_CLASS (control);
+    if (control->priv->volume_pending == TRUE) {
+        /* A volume change is already on its way to the server, keep only the
+         * most recent value and send it once the pending request completes */
+        control->priv->queued_cvolume = *cvolume;
+        control->priv->volume_queued  = TRUE;
+    } else {
+        if (write_cvolume (control, cvolume) == FALSE)
+            return FALSE;
+    }
 
-    if (klass->set_volume (control, cvolume) == FALSE)
-        return FALSE;
+    store_cvolume (control, cvolume);
+    return TRUE;
+}
+
+static void
+store_cvolume (PulseStreamControl *control, const pa_cvolume *cvolume)
+{
+    /* Deliver the volume, balance and fade notifications together */
+    g_object_freeze_notify (G_OBJECT (control));
 
     control->priv->cvolume = *cvolume;
     control->priv->volume  = (guint) pa_cvolume_max (cvolume);
@@ -775,5 +959,58 @@ set_cvolume (PulseStreamControl *control, pa_cvolume *cvolume)
 
     /* Changing volume may change the balance and fade values as well */
     set_balance_fade (control);
+
+    g_object_thaw_notify (G_OBJECT (control));
+}
+
+static gboolean
+write_cvolume (PulseStreamControl *control, pa_cvolume *cvolume)
+{
+    PulseStreamControlClass *klass;
+
+    klass = PULSE_STREAM_CONTROL_GET_CLASS (control);
+
+    if (klass->set_volume (control,
+                           cvolume,
+                           on_volume_written,
+                           g_object_ref (control)) == FALSE) {
+        g_object_unref (control);
+        return FALSE;
+    }
+
+    control->priv->written_cvolume = *cvolume;
+    control->priv->volume_pending  = TRUE;
     return TRUE;
 }
+
+static void
+on_volume_written (gboolean success, gpointer user_data)
+{
+    PulseStreamControl *control = PULSE_STREAM_CONTROL (user_data);
+
+    control->priv->volume_pending = FALSE;
+
+    if (success == TRUE) {
+        control->priv->server_cvolume = control->priv->written_cvolume;
+
+        if (control->priv->volume_queued == TRUE) {
+            control->priv->volume_queued = FALSE;
+
+            /* The queued volume has already been reported locally */
+            if (write_cvolume (control, &control->priv->queued_cvolume) == FALSE)
+                success = FALSE;
+        }
+    } else
+        control->priv->volume_queued = FALSE;
+
+    if (success == FALSE) {
+        /* The server has not accepted a volume, which has already been
+         * reported locally, so go back to the last volume known to be set
+         * on the server, including a volume which has arrived while the
+         * write was in progress */
+        if (pa_cvolume_valid (&control->priv->server_cvolume) != 0 &&
+            pa_cvolume_equal (&control->priv->server_cvolume, &control->priv->cvolume) == 0)
+            store_cvolume (control, &control->priv->server_cvolume);
+    }
+    g_object_unref (control);
+}
@@ -24,6 +24,7 @@
 
 #include <pulse/pulseaudio.h>
 
+#include "pulse-connection.h"
 #include "pulse-types.h"
 
 G_BEGIN_DECLS
@@ -57,12 +58,16 @@ struct _PulseStreamControlClass
     MateMixerStreamControlClass parent_class;
 
     /*< private >*/
-    gboolean      (*set_mute)        (PulseStreamControl *control,
-                                      gboolean            mute);
-    gboolean      (*set_volume)      (PulseStreamControl *control,
-                                      pa_cvolume         *volume);
-
-    PulseMonitor *(*create_monitor)  (PulseStreamControl *control);
+    gboolean      (*set_mute)        (PulseStreamControl       *control,
+                                      gboolean                  mute);
+    gboolean      (*set_volume)      (PulseStreamControl       *control,
+                                      pa_cvolume               *volume,
+                                      PulseConnectionWriteFunc  func,
+                                      gpointer                  user_data);
+
+    gboolean      (*get_monitor_indexes) (PulseStreamControl *control,
+                                          guint32            *index_source,
+                                          guint32            *index_sink_input);
 };
 
 GType                 pulse_stream_control_get_type         (void) G_GNUC_CONST;
@@ -86,6 +91,8 @@ void                  pulse_stream_control_set_cvolume      (PulseStreamControl
                                                              const pa_cvolume     *cvolume,
                                                              pa_volume_t           base_volume);
 
+void                  pulse_stream_control_restart_monitor  (PulseStreamControl   *control);
+
 G_END_DECLS
 
 #endif /* PULSE_STREAM_CONTROL_H */
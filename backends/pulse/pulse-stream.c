@@ -169,6 +169,14 @@ pulse_stream_get_index (PulseStream *stream)
     return stream->priv->index;
 }
 
+void
+pulse_stream_set_index (PulseStream *stream, guint32 index)
+{
+    g_return_if_fail (PULSE_IS_STREAM (stream));
+
+    stream->priv->index = index;
+}
+
 PulseConnection *
 pulse_stream_get_connection (PulseStream *stream)
 {
@@ -60,6 +60,9 @@ struct _PulseStreamClass
 GType            pulse_stream_get_type        (void) G_GNUC_CONST;
 
 guint32          pulse_stream_get_index       (PulseStream *stream);
+void             pulse_stream_set_index       (PulseStream *stream,
+                                               guint32      index);
+
 PulseConnection *pulse_stream_get_connection  (PulseStream *stream);
 
 PulseDevice *    pulse_stream_get_device      (PulseStream *stream);
@@ -25,6 +25,7 @@ typedef struct _PulseConnection         PulseConnection;
 typedef struct _PulseDevice             PulseDevice;
 typedef struct _PulseDeviceProfile      PulseDeviceProfile;
 typedef struct _PulseDeviceSwitch       PulseDeviceSwitch;
+typedef struct _PulseExtEntry           PulseExtEntry;
 typedef struct _PulseExtStream          PulseExtStream;
 typedef struct _PulseMonitor            PulseMonitor;
 typedef struct _PulsePort               PulsePort;
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MATEMIXER_ARRAY_CACHE_PRIVATE_H
+#define MATEMIXER_ARRAY_CACHE_PRIVATE_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Cached GPtrArray copy of a list of objects, used to implement the dup_*
+ * functions.
+ *
+ * The array is built from the GList on first use and is owned by the cache.
+ * It is handed out to all callers without a reference, so neither the owner
+ * nor the callers may modify it. When the list changes, the owner invalidates
+ * the cache, which drops the array and bumps the generation, the next call
+ * then builds a new array. Callers which keep the array past that point take
+ * their own reference.
+ */
+typedef struct _MateMixerArrayCache  MateMixerArrayCache;
+
+struct _MateMixerArrayCache
+{
+    GPtrArray *array;
+    guint      generation;
+};
+
+void       _mate_mixer_array_cache_init       (MateMixerArrayCache *cache);
+void       _mate_mixer_array_cache_clear      (MateMixerArrayCache *cache);
+void       _mate_mixer_array_cache_invalidate (MateMixerArrayCache *cache);
+
+GPtrArray *_mate_mixer_array_cache_get        (MateMixerArrayCache *cache,
+                                               const GList         *list,
+                                               guint               *generation);
+
+G_END_DECLS
+
+#endif /* MATEMIXER_ARRAY_CACHE_PRIVATE_H */
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include "matemixer-array-cache-private.h"
+
+void
+_mate_mixer_array_cache_init (MateMixerArrayCache *cache)
+{
+    g_return_if_fail (cache != NULL);
+
+    cache->array = NULL;
+
+    /* Start at 1 so that 0 may be used by callers as "never seen" */
+    cache->generation = 1;
+}
+
+void
+_mate_mixer_array_cache_clear (MateMixerArrayCache *cache)
+{
+    g_return_if_fail (cache != NULL);
+
+    if (cache->array != NULL) {
+        g_ptr_array_unref (cache->array);
+        cache->array = NULL;
+    }
+}
+
+void
+_mate_mixer_array_cache_invalidate (MateMixerArrayCache *cache)
+{
+    g_return_if_fail (cache != NULL);
+
+    _mate_mixer_array_cache_clear (cache);
+
+    cache->generation++;
+}
+
+GPtrArray *
+_mate_mixer_array_cache_get (MateMixerArrayCache *cache,
+                             const GList         *list,
+                             guint               *generation)
+{
+    g_return_val_if_fail (cache != NULL, NULL);
+
+    if (cache->array == NULL) {
+        cache->array = g_ptr_array_new_full (g_list_length ((GList *) list),
+                                             g_object_unref);
+        while (list != NULL) {
+            g_ptr_array_add (cache->array, g_object_ref (list->data));
+            list = list->next;
+        }
+    }
+
+    if (generation != NULL)
+        *generation = cache->generation;
+
+    return cache->array;
+}
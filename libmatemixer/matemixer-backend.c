@@ -20,20 +20,37 @@
 #include <glib-object.h>
 
 #include "matemixer-backend.h"
+#include "matemixer-change-set.h"
+#include "matemixer-change-set-private.h"
 #include "matemixer-device.h"
 #include "matemixer-enums.h"
 #include "matemixer-enum-types.h"
 #include "matemixer-stream.h"
 #include "matemixer-stream-control.h"
 #include "matemixer-stored-control.h"
+#include "matemixer-array-cache-private.h"
+#include "matemixer-control-index-private.h"
 
 struct _MateMixerBackendPrivate
 {
     GHashTable           *devices;
+    GHashTable           *streams;
+    GHashTable           *stored_controls;
+    MateMixerControlIndex *controls_index;
+    MateMixerArrayCache   devices_array;
+    MateMixerArrayCache   streams_array;
+    MateMixerArrayCache   stored_controls_array;
+    guint                 topology_depth;
+    guint                 topology_tag;
+    MateMixerChangeSet   *topology;
     MateMixerStream      *default_input;
     MateMixerStream      *default_output;
     MateMixerState        state;
     MateMixerBackendFlags flags;
+    MateMixerTrackFlags   loading;
+    gboolean              stored_controls_unindexed;
+    guint                 generation;
+    gchar                *server_name;
 };
 
 enum {
@@ -53,6 +70,8 @@ enum {
     STREAM_REMOVED,
     STORED_CONTROL_ADDED,
     STORED_CONTROL_REMOVED,
+    TOPOLOGY_CHANGED,
+    LOADED,
     N_SIGNALS
 };
 
@@ -76,15 +95,72 @@ static void mate_mixer_backend_finalize     (GObject               *object);
 
 G_DEFINE_ABSTRACT_TYPE (MateMixerBackend, mate_mixer_backend, G_TYPE_OBJECT)
 
-static void device_added          (MateMixerBackend *backend,
-                                   const gchar      *name);
-static void device_removed        (MateMixerBackend *backend,
-                                   const gchar      *name);
-
-static void device_stream_added   (MateMixerBackend *backend,
-                                   const gchar      *name);
-static void device_stream_removed (MateMixerBackend *backend,
-                                   const gchar      *name);
+static void device_added           (MateMixerBackend *backend,
+                                    const gchar      *name);
+static void device_removed         (MateMixerBackend *backend,
+                                    const gchar      *name);
+
+static void device_stream_added    (MateMixerBackend *backend,
+                                    const gchar      *name);
+static void device_stream_removed  (MateMixerBackend *backend,
+                                    const gchar      *name);
+
+static void stream_added           (MateMixerBackend *backend,
+                                    const gchar      *name);
+static void stream_removed         (MateMixerBackend *backend,
+                                    const gchar      *name);
+
+static void stored_control_added   (MateMixerBackend *backend,
+                                    const gchar      *name);
+static void stored_control_removed (MateMixerBackend *backend,
+                                    const gchar      *name);
+
+static void stream_control_added    (MateMixerStream  *stream,
+                                    const gchar      *name,
+                                    MateMixerBackend *backend);
+static void stream_control_removed  (MateMixerStream  *stream,
+                                    const gchar      *name,
+                                    MateMixerBackend *backend);
+
+static void stream_children_changed (MateMixerStream  *stream,
+                                     const gchar      *name,
+                                     MateMixerBackend *backend);
+
+static void object_notify          (GObject          *object,
+                                    GParamSpec       *pspec,
+                                    MateMixerBackend *backend);
+
+static void remove_stream          (MateMixerBackend *backend,
+                                    const gchar      *name);
+static void release_stream         (gpointer          stream);
+
+static void clear_indexes          (MateMixerBackend       *backend);
+static void index_stored_control   (MateMixerBackend       *backend,
+                                    MateMixerStoredControl *control);
+static void index_stored_controls  (MateMixerBackend       *backend);
+
+static void create_stored_controls (MateMixerBackend      *backend,
+                                    MateMixerBackendMatch  match,
+                                    guint                  value,
+                                    const gchar           *string);
+
+static void     record_topology_change   (MateMixerBackend     *backend,
+                                          gpointer              object,
+                                          MateMixerChangeFlags  flags);
+static void     record_topology_name     (MateMixerBackend     *backend,
+                                          GType                 type,
+                                          const gchar          *name,
+                                          MateMixerChangeFlags  flags);
+static void     schedule_topology_change (MateMixerBackend     *backend);
+static gboolean dispatch_topology_change (MateMixerBackend     *backend);
+static void     discard_topology_change  (MateMixerBackend     *backend);
+
+static MateMixerDevice *       find_device         (MateMixerBackend *backend,
+                                                    const gchar      *name);
+static MateMixerStream *       find_stream         (MateMixerBackend *backend,
+                                                    const gchar      *name);
+static MateMixerStoredControl *find_stored_control (MateMixerBackend *backend,
+                                                    const gchar      *name);
 
 static void
 mate_mixer_backend_class_init (MateMixerBackendClass *klass)
@@ -196,6 +272,30 @@ mate_mixer_backend_class_init (MateMixerBackendClass *klass)
                       1,
                       G_TYPE_STRING);
 
+    signals[TOPOLOGY_CHANGED] =
+        g_signal_new ("topology-changed",
+                      G_TYPE_FROM_CLASS (object_class),
+                      G_SIGNAL_RUN_FIRST,
+                      G_STRUCT_OFFSET (MateMixerBackendClass, topology_changed),
+                      NULL,
+                      NULL,
+                      g_cclosure_marshal_VOID__BOXED,
+                      G_TYPE_NONE,
+                      1,
+                      MATE_MIXER_TYPE_CHANGE_SET);
+
+    signals[LOADED] =
+        g_signal_new ("loaded",
+                      G_TYPE_FROM_CLASS (object_class),
+                      G_SIGNAL_RUN_FIRST,
+                      G_STRUCT_OFFSET (MateMixerBackendClass, loaded),
+                      NULL,
+                      NULL,
+                      g_cclosure_marshal_VOID__FLAGS,
+                      G_TYPE_NONE,
+                      1,
+                      MATE_MIXER_TYPE_TRACK_FLAGS);
+
     g_type_class_add_private (object_class, sizeof (MateMixerBackendPrivate));
 }
 
@@ -257,11 +357,32 @@ mate_mixer_backend_init (MateMixerBackend *backend)
                                                  MATE_MIXER_TYPE_BACKEND,
                                                  MateMixerBackendPrivate);
 
+    /* Keys are the shared names owned by the objects */
     backend->priv->devices = g_hash_table_new_full (g_str_hash,
                                                     g_str_equal,
-                                                    g_free,
+                                                    NULL,
                                                     g_object_unref);
 
+    /* Name indexes of streams and stored controls, these are updated from
+     * the added and removed signals */
+    backend->priv->streams = g_hash_table_new_full (g_str_hash,
+                                                    g_str_equal,
+                                                    NULL,
+                                                    release_stream);
+
+    backend->priv->stored_controls = g_hash_table_new_full (g_str_hash,
+                                                            g_str_equal,
+                                                            NULL,
+                                                            g_object_unref);
+
+    /* Controls of all streams and stored controls by role, media role and
+     * application */
+    backend->priv->controls_index = _mate_mixer_control_index_new ();
+
+    _mate_mixer_array_cache_init (&backend->priv->devices_array);
+    _mate_mixer_array_cache_init (&backend->priv->streams_array);
+    _mate_mixer_array_cache_init (&backend->priv->stored_controls_array);
+
     g_signal_connect (G_OBJECT (backend),
                       "device-added",
                       G_CALLBACK (device_added),
@@ -271,6 +392,26 @@ mate_mixer_backend_init (MateMixerBackend *backend)
                       "device-removed",
                       G_CALLBACK (device_removed),
                       NULL);
+
+    g_signal_connect (G_OBJECT (backend),
+                      "stream-added",
+                      G_CALLBACK (stream_added),
+                      NULL);
+
+    g_signal_connect (G_OBJECT (backend),
+                      "stream-removed",
+                      G_CALLBACK (stream_removed),
+                      NULL);
+
+    g_signal_connect (G_OBJECT (backend),
+                      "stored-control-added",
+                      G_CALLBACK (stored_control_added),
+                      NULL);
+
+    g_signal_connect (G_OBJECT (backend),
+                      "stored-control-removed",
+                      G_CALLBACK (stored_control_removed),
+                      NULL);
 }
 
 static void
@@ -283,7 +424,8 @@ mate_mixer_backend_dispose (GObject *object)
     g_clear_object (&backend->priv->default_input);
     g_clear_object (&backend->priv->default_output);
 
-    g_hash_table_remove_all (backend->priv->devices);
+    clear_indexes (backend);
+    discard_topology_change (backend);
 
     G_OBJECT_CLASS (mate_mixer_backend_parent_class)->dispose (object);
 }
@@ -296,6 +438,16 @@ mate_mixer_backend_finalize (GObject *object)
     backend = MATE_MIXER_BACKEND (object);
 
     g_hash_table_unref (backend->priv->devices);
+    g_hash_table_unref (backend->priv->streams);
+    g_hash_table_unref (backend->priv->stored_controls);
+
+    _mate_mixer_control_index_free (backend->priv->controls_index);
+
+    _mate_mixer_array_cache_clear (&backend->priv->devices_array);
+    _mate_mixer_array_cache_clear (&backend->priv->streams_array);
+    _mate_mixer_array_cache_clear (&backend->priv->stored_controls_array);
+
+    g_free (backend->priv->server_name);
 
     G_OBJECT_CLASS (mate_mixer_backend_parent_class)->finalize (object);
 }
@@ -326,6 +478,62 @@ mate_mixer_backend_set_server_address (MateMixerBackend *backend, const gchar *a
         klass->set_server_address (backend, address);
 }
 
+void
+mate_mixer_backend_set_track_flags (MateMixerBackend *backend, MateMixerTrackFlags flags)
+{
+    MateMixerBackendClass *klass;
+
+    g_return_if_fail (MATE_MIXER_IS_BACKEND (backend));
+
+    klass = MATE_MIXER_BACKEND_GET_CLASS (backend);
+
+    if (klass->set_track_flags != NULL)
+        klass->set_track_flags (backend, flags);
+}
+
+MateMixerTrackFlags
+mate_mixer_backend_get_loading_flags (MateMixerBackend *backend)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_BACKEND (backend), MATE_MIXER_TRACK_NONE);
+
+    return backend->priv->loading;
+}
+
+/**
+ * mate_mixer_backend_get_server_name:
+ * @backend: a #MateMixerBackend
+ *
+ * Gets a name which identifies the sound server the backend is connected to,
+ * backends which do not connect to a server return %NULL.
+ *
+ * Returns: the name of the sound server or %NULL.
+ */
+const gchar *
+mate_mixer_backend_get_server_name (MateMixerBackend *backend)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_BACKEND (backend), NULL);
+
+    return backend->priv->server_name;
+}
+
+/**
+ * mate_mixer_backend_get_generation:
+ * @backend: a #MateMixerBackend
+ *
+ * Gets a number which is incremented each time a device, stream or control
+ * of the backend is added, removed or changes a property.
+ *
+ * Returns: the generation number of the backend.
+ */
+guint
+mate_mixer_backend_get_generation (MateMixerBackend *backend)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_BACKEND (backend), 0);
+
+    return backend->priv->generation +
+           _mate_mixer_control_index_get_generation (backend->priv->controls_index);
+}
+
 gboolean
 mate_mixer_backend_open (MateMixerBackend *backend)
 {
@@ -359,61 +567,53 @@ mate_mixer_backend_get_state (MateMixerBackend *backend)
 MateMixerDevice *
 mate_mixer_backend_get_device (MateMixerBackend *backend, const gchar *name)
 {
-    const GList *list;
+    MateMixerDevice *device;
 
     g_return_val_if_fail (MATE_MIXER_IS_BACKEND (backend), NULL);
     g_return_val_if_fail (name != NULL, NULL);
 
-    list = mate_mixer_backend_list_devices (backend);
-    while (list != NULL) {
-        MateMixerDevice *device = MATE_MIXER_DEVICE (list->data);
-
-        if (strcmp (name, mate_mixer_device_get_name (device)) == 0)
-            return device;
+    device = g_hash_table_lookup (backend->priv->devices, name);
+    if G_LIKELY (device != NULL)
+        return device;
 
-        list = list->next;
-    }
-    return NULL;
+    return find_device (backend, name);
 }
 
 MateMixerStream *
 mate_mixer_backend_get_stream (MateMixerBackend *backend, const gchar *name)
 {
-    const GList *list;
+    MateMixerStream *stream;
 
     g_return_val_if_fail (MATE_MIXER_IS_BACKEND (backend), NULL);
     g_return_val_if_fail (name != NULL, NULL);
 
-    list = mate_mixer_backend_list_streams (backend);
-    while (list != NULL) {
-        MateMixerStream *stream = MATE_MIXER_STREAM (list->data);
+    stream = g_hash_table_lookup (backend->priv->streams, name);
+    if G_LIKELY (stream != NULL)
+        return stream;
 
-        if (strcmp (name, mate_mixer_stream_get_name (stream)) == 0)
-            return stream;
-
-        list = list->next;
-    }
-    return NULL;
+    /* The index is filled from the stream-added signal */
+    return find_stream (backend, name);
 }
 
 MateMixerStoredControl *
 mate_mixer_backend_get_stored_control (MateMixerBackend *backend, const gchar *name)
 {
-    const GList *list;
+    MateMixerStoredControl *control;
 
     g_return_val_if_fail (MATE_MIXER_IS_BACKEND (backend), NULL);
     g_return_val_if_fail (name != NULL, NULL);
 
-    list = mate_mixer_backend_list_stored_controls (backend);
-    while (list != NULL) {
-        MateMixerStreamControl *control = MATE_MIXER_STREAM_CONTROL (list->data);
+    control = g_hash_table_lookup (backend->priv->stored_controls, name);
+    if G_LIKELY (control != NULL)
+        return control;
 
-        if (strcmp (name, mate_mixer_stream_control_get_name (control)) == 0)
-            return MATE_MIXER_STORED_CONTROL (control);
+    /* Stored controls announced while loading the initial list are only
+     * created by the backend when asked for, index them once they exist */
+    control = find_stored_control (backend, name);
+    if (control != NULL)
+        index_stored_control (backend, control);
 
-        list = list->next;
-    }
-    return NULL;
+    return control;
 }
 
 const GList *
@@ -461,6 +661,131 @@ mate_mixer_backend_list_stored_controls (MateMixerBackend *backend)
     return NULL;
 }
 
+/**
+ * mate_mixer_backend_list_created_stored_controls:
+ * @backend: a #MateMixerBackend
+ *
+ * Gets the stored controls which have been requested from the backend and
+ * therefore exist as objects, without creating the remaining ones.
+ *
+ * Returns: a newly allocated #GList of stored controls, the list should be
+ * released using g_list_free().
+ */
+GList *
+mate_mixer_backend_list_created_stored_controls (MateMixerBackend *backend)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_BACKEND (backend), NULL);
+
+    return g_hash_table_get_values (backend->priv->stored_controls);
+}
+
+/**
+ * mate_mixer_backend_get_stored_control_states:
+ * @backend: a #MateMixerBackend
+ * @states: a #GArray of #MateMixerControlState
+ * @volumes: a #GArray of channel volumes
+ *
+ * Appends the state of each stored control to @states without creating the
+ * stored controls which have not been requested yet, the @control field of
+ * their states is %NULL. The @name and @label strings of such states are only
+ * valid until the backend changes.
+ *
+ * Returns: %TRUE on success or %FALSE if the backend cannot describe stored
+ * controls without creating them.
+ */
+gboolean
+mate_mixer_backend_get_stored_control_states (MateMixerBackend *backend,
+                                              GArray           *states,
+                                              GArray           *volumes)
+{
+    MateMixerBackendClass *klass;
+
+    g_return_val_if_fail (MATE_MIXER_IS_BACKEND (backend), FALSE);
+    g_return_val_if_fail (states != NULL, FALSE);
+    g_return_val_if_fail (volumes != NULL, FALSE);
+
+    klass = MATE_MIXER_BACKEND_GET_CLASS (backend);
+
+    if (klass->get_stored_control_states != NULL)
+        return klass->get_stored_control_states (backend, states, volumes);
+
+    return FALSE;
+}
+
+GPtrArray *
+mate_mixer_backend_dup_devices (MateMixerBackend *backend, guint *generation)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_BACKEND (backend), NULL);
+
+    return _mate_mixer_array_cache_get (&backend->priv->devices_array,
+                                        mate_mixer_backend_list_devices (backend),
+                                        generation);
+}
+
+GPtrArray *
+mate_mixer_backend_dup_streams (MateMixerBackend *backend, guint *generation)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_BACKEND (backend), NULL);
+
+    return _mate_mixer_array_cache_get (&backend->priv->streams_array,
+                                        mate_mixer_backend_list_streams (backend),
+                                        generation);
+}
+
+GPtrArray *
+mate_mixer_backend_dup_stored_controls (MateMixerBackend *backend, guint *generation)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_BACKEND (backend), NULL);
+
+    return _mate_mixer_array_cache_get (&backend->priv->stored_controls_array,
+                                        mate_mixer_backend_list_stored_controls (backend),
+                                        generation);
+}
+
+GPtrArray *
+mate_mixer_backend_find_role_controls (MateMixerBackend           *backend,
+                                       MateMixerStreamControlRole  role)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_BACKEND (backend), NULL);
+
+    create_stored_controls (backend, MATE_MIXER_BACKEND_MATCH_ROLE, role, NULL);
+
+    return _mate_mixer_control_index_find_role (backend->priv->controls_index, role);
+}
+
+GPtrArray *
+mate_mixer_backend_find_media_role_controls (MateMixerBackend                *backend,
+                                             MateMixerStreamControlMediaRole  media_role)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_BACKEND (backend), NULL);
+
+    create_stored_controls (backend, MATE_MIXER_BACKEND_MATCH_MEDIA_ROLE, media_role, NULL);
+
+    return _mate_mixer_control_index_find_media_role (backend->priv->controls_index, media_role);
+}
+
+GPtrArray *
+mate_mixer_backend_find_app_id_controls (MateMixerBackend *backend, const gchar *app_id)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_BACKEND (backend), NULL);
+    g_return_val_if_fail (app_id != NULL, NULL);
+
+    create_stored_controls (backend, MATE_MIXER_BACKEND_MATCH_APP_ID, 0, app_id);
+
+    return _mate_mixer_control_index_find_app_id (backend->priv->controls_index, app_id);
+}
+
+GPtrArray *
+mate_mixer_backend_find_app_name_controls (MateMixerBackend *backend, const gchar *app_name)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_BACKEND (backend), NULL);
+    g_return_val_if_fail (app_name != NULL, NULL);
+
+    create_stored_controls (backend, MATE_MIXER_BACKEND_MATCH_APP_NAME, 0, app_name);
+
+    return _mate_mixer_control_index_find_app_name (backend->priv->controls_index, app_name);
+}
+
 MateMixerStream *
 mate_mixer_backend_get_default_input_stream (MateMixerBackend *backend)
 {
@@ -536,17 +861,20 @@ device_added (MateMixerBackend *backend, const gchar *name)
 {
     MateMixerDevice *device;
 
-    device = mate_mixer_backend_get_device (backend, name);
+    device = find_device (backend, name);
     if G_UNLIKELY (device == NULL) {
         g_warn_if_reached ();
         return;
     }
 
     /* Keep the device in a hash table as it won't be possible to retrieve
-     * it when the remove signal is received */
-    g_hash_table_insert (backend->priv->devices,
-                         g_strdup (name),
-                         g_object_ref (device));
+     * it when the remove signal is received, the table also serves as the
+     * name index used by mate_mixer_backend_get_device() */
+    g_hash_table_replace (backend->priv->devices,
+                          (gpointer) mate_mixer_device_get_name (device),
+                          g_object_ref (device));
+
+    _mate_mixer_array_cache_invalidate (&backend->priv->devices_array);
 
     /* Connect to the stream signals from devices so we can forward them on
      * the backend */
@@ -558,12 +886,20 @@ device_added (MateMixerBackend *backend, const gchar *name)
                               "stream-removed",
                               G_CALLBACK (device_stream_removed),
                               backend);
+    g_signal_connect (G_OBJECT (device),
+                      "notify",
+                      G_CALLBACK (object_notify),
+                      backend);
+
+    record_topology_change (backend, device, MATE_MIXER_CHANGE_ADDED);
 }
 
 static void
 device_removed (MateMixerBackend *backend, const gchar *name)
 {
     MateMixerDevice *device;
+    GHashTableIter   iter;
+    gpointer         stream;
 
     device = g_hash_table_lookup (backend->priv->devices, name);
     if G_UNLIKELY (device == NULL) {
@@ -577,8 +913,27 @@ device_removed (MateMixerBackend *backend, const gchar *name)
     g_signal_handlers_disconnect_by_func (G_OBJECT (device),
                                           G_CALLBACK (device_stream_removed),
                                           backend);
+    g_signal_handlers_disconnect_by_func (G_OBJECT (device),
+                                          G_CALLBACK (object_notify),
+                                          backend);
+
+    /* Backends are expected to remove the device streams before the device
+     * itself, but make sure no stale stream of the device stays indexed */
+    g_hash_table_iter_init (&iter, backend->priv->streams);
+
+    while (g_hash_table_iter_next (&iter, NULL, &stream) == TRUE) {
+        if (mate_mixer_stream_get_device (MATE_MIXER_STREAM (stream)) == device) {
+            _mate_mixer_control_index_remove_stream (backend->priv->controls_index,
+                                                     MATE_MIXER_STREAM (stream));
+            g_hash_table_iter_remove (&iter);
+        }
+    }
 
     g_hash_table_remove (backend->priv->devices, name);
+
+    _mate_mixer_array_cache_invalidate (&backend->priv->devices_array);
+
+    record_topology_name (backend, MATE_MIXER_TYPE_DEVICE, name, MATE_MIXER_CHANGE_REMOVED);
 }
 
 static void
@@ -599,7 +954,468 @@ device_stream_removed (MateMixerBackend *backend, const gchar *name)
                    name);
 }
 
+static void
+stream_added (MateMixerBackend *backend, const gchar *name)
+{
+    MateMixerStream *stream;
+    const GList     *list;
+
+    /* Make sure a stale stream with the same name cannot be returned */
+    remove_stream (backend, name);
+
+    _mate_mixer_array_cache_invalidate (&backend->priv->streams_array);
+
+    stream = find_stream (backend, name);
+    if G_UNLIKELY (stream == NULL) {
+        g_warn_if_reached ();
+        return;
+    }
+
+    /* Keep the stream in the name index, it is also needed to follow its
+     * controls and switches as a part of the topology */
+    g_hash_table_replace (backend->priv->streams,
+                          (gpointer) mate_mixer_stream_get_name (stream),
+                          g_object_ref (stream));
+
+    g_signal_connect (G_OBJECT (stream),
+                      "control-added",
+                      G_CALLBACK (stream_control_added),
+                      backend);
+    g_signal_connect (G_OBJECT (stream),
+                      "control-removed",
+                      G_CALLBACK (stream_control_removed),
+                      backend);
+    g_signal_connect (G_OBJECT (stream),
+                      "control-added",
+                      G_CALLBACK (stream_children_changed),
+                      backend);
+    g_signal_connect (G_OBJECT (stream),
+                      "control-removed",
+                      G_CALLBACK (stream_children_changed),
+                      backend);
+    g_signal_connect (G_OBJECT (stream),
+                      "switch-added",
+                      G_CALLBACK (stream_children_changed),
+                      backend);
+    g_signal_connect (G_OBJECT (stream),
+                      "switch-removed",
+                      G_CALLBACK (stream_children_changed),
+                      backend);
+    g_signal_connect (G_OBJECT (stream),
+                      "notify",
+                      G_CALLBACK (object_notify),
+                      backend);
+
+    list = mate_mixer_stream_list_controls (stream);
+    while (list != NULL) {
+        _mate_mixer_control_index_add (backend->priv->controls_index,
+                                       stream,
+                                       MATE_MIXER_STREAM_CONTROL (list->data));
+        list = list->next;
+    }
+
+    record_topology_change (backend, stream, MATE_MIXER_CHANGE_ADDED);
+}
+
+static void
+stream_removed (MateMixerBackend *backend, const gchar *name)
+{
+    remove_stream (backend, name);
+
+    _mate_mixer_array_cache_invalidate (&backend->priv->streams_array);
+
+    record_topology_name (backend, MATE_MIXER_TYPE_STREAM, name, MATE_MIXER_CHANGE_REMOVED);
+}
+
+static void
+stream_control_added (MateMixerStream  *stream,
+                      const gchar      *name,
+                      MateMixerBackend *backend)
+{
+    MateMixerStreamControl *control;
+
+    control = mate_mixer_stream_get_control (stream, name);
+    if G_UNLIKELY (control == NULL) {
+        g_warn_if_reached ();
+        return;
+    }
+
+    _mate_mixer_control_index_add (backend->priv->controls_index, stream, control);
+
+    record_topology_change (backend, control, MATE_MIXER_CHANGE_ADDED);
+}
+
+static void
+stream_control_removed (MateMixerStream  *stream,
+                        const gchar      *name,
+                        MateMixerBackend *backend)
+{
+    _mate_mixer_control_index_remove (backend->priv->controls_index, stream, name);
+
+    record_topology_name (backend, MATE_MIXER_TYPE_STREAM_CONTROL, name, MATE_MIXER_CHANGE_REMOVED);
+}
+
+static void
+stream_children_changed (MateMixerStream  *stream,
+                         const gchar      *name,
+                         MateMixerBackend *backend)
+{
+    record_topology_change (backend, stream, MATE_MIXER_CHANGE_CHILDREN);
+}
+
+static void
+object_notify (GObject          *object,
+               GParamSpec       *pspec,
+               MateMixerBackend *backend)
+{
+    backend->priv->generation++;
+}
+
+static void
+remove_stream (MateMixerBackend *backend, const gchar *name)
+{
+    MateMixerStream *stream;
+
+    stream = g_hash_table_lookup (backend->priv->streams, name);
+    if (stream == NULL)
+        return;
+
+    _mate_mixer_control_index_remove_stream (backend->priv->controls_index, stream);
+
+    g_hash_table_remove (backend->priv->streams, name);
+}
+
+static void
+release_stream (gpointer stream)
+{
+    g_signal_handlers_disconnect_matched (G_OBJECT (stream),
+                                          G_SIGNAL_MATCH_FUNC,
+                                          0, 0,
+                                          NULL,
+                                          G_CALLBACK (stream_control_added),
+                                          NULL);
+    g_signal_handlers_disconnect_matched (G_OBJECT (stream),
+                                          G_SIGNAL_MATCH_FUNC,
+                                          0, 0,
+                                          NULL,
+                                          G_CALLBACK (stream_control_removed),
+                                          NULL);
+    g_signal_handlers_disconnect_matched (G_OBJECT (stream),
+                                          G_SIGNAL_MATCH_FUNC,
+                                          0, 0,
+                                          NULL,
+                                          G_CALLBACK (stream_children_changed),
+                                          NULL);
+    g_signal_handlers_disconnect_matched (G_OBJECT (stream),
+                                          G_SIGNAL_MATCH_FUNC,
+                                          0, 0,
+                                          NULL,
+                                          G_CALLBACK (object_notify),
+                                          NULL);
+    g_object_unref (stream);
+}
+
+static void
+stored_control_added (MateMixerBackend *backend, const gchar *name)
+{
+    MateMixerStoredControl *control;
+
+    g_hash_table_remove (backend->priv->stored_controls, name);
+
+    _mate_mixer_array_cache_invalidate (&backend->priv->stored_controls_array);
+
+    /* The stored controls which arrive with the initial list are only
+     * created by the backend when asked for, record them by name */
+    if (backend->priv->loading & MATE_MIXER_TRACK_STORED_CONTROLS) {
+        backend->priv->stored_controls_unindexed = TRUE;
+
+        record_topology_name (backend,
+                              MATE_MIXER_TYPE_STORED_CONTROL,
+                              name,
+                              MATE_MIXER_CHANGE_ADDED);
+        return;
+    }
+
+    control = find_stored_control (backend, name);
+    if G_UNLIKELY (control == NULL) {
+        g_warn_if_reached ();
+        return;
+    }
+
+    index_stored_control (backend, control);
+
+    record_topology_change (backend, control, MATE_MIXER_CHANGE_ADDED);
+}
+
+static void
+stored_control_removed (MateMixerBackend *backend, const gchar *name)
+{
+    g_hash_table_remove (backend->priv->stored_controls, name);
+
+    _mate_mixer_control_index_remove (backend->priv->controls_index, NULL, name);
+
+    _mate_mixer_array_cache_invalidate (&backend->priv->stored_controls_array);
+
+    record_topology_name (backend, MATE_MIXER_TYPE_STORED_CONTROL, name, MATE_MIXER_CHANGE_REMOVED);
+}
+
+static void
+record_topology_change (MateMixerBackend     *backend,
+                        gpointer              object,
+                        MateMixerChangeFlags  flags)
+{
+    backend->priv->generation++;
+
+    if (backend->priv->topology == NULL)
+        backend->priv->topology = _mate_mixer_change_set_new ();
+
+    _mate_mixer_change_set_add_object (backend->priv->topology,
+                                       G_OBJECT (object),
+                                       flags);
+
+    schedule_topology_change (backend);
+}
+
+static void
+record_topology_name (MateMixerBackend     *backend,
+                      GType                 type,
+                      const gchar          *name,
+                      MateMixerChangeFlags  flags)
+{
+    backend->priv->generation++;
+
+    if (backend->priv->topology == NULL)
+        backend->priv->topology = _mate_mixer_change_set_new ();
+
+    _mate_mixer_change_set_add_name (backend->priv->topology, type, name, flags);
+
+    schedule_topology_change (backend);
+}
+
+static void
+schedule_topology_change (MateMixerBackend *backend)
+{
+    GSource *source;
+
+    /* Nothing is emitted while a transaction is open, the change will be
+     * scheduled when the outermost transaction ends */
+    if (backend->priv->topology_depth > 0 || backend->priv->topology_tag != 0)
+        return;
+
+    /* Hotplugging a device usually results in a burst of additions and
+     * removals, wait until the burst is over and report it at once */
+    source = g_idle_source_new ();
+    g_source_set_callback (source,
+                           (GSourceFunc) dispatch_topology_change,
+                           backend,
+                           NULL);
+
+    backend->priv->topology_tag = g_source_attach (source, g_main_context_get_thread_default ());
+    g_source_unref (source);
+}
+
+static gboolean
+dispatch_topology_change (MateMixerBackend *backend)
+{
+    MateMixerChangeSet *changes;
+
+    backend->priv->topology_tag = 0;
+
+    if (backend->priv->topology_depth > 0 || backend->priv->topology == NULL)
+        return G_SOURCE_REMOVE;
+
+    changes = backend->priv->topology;
+    backend->priv->topology = NULL;
+
+    if (_mate_mixer_change_set_is_empty (changes) == FALSE)
+        g_signal_emit (G_OBJECT (backend),
+                       signals[TOPOLOGY_CHANGED],
+                       0,
+                       changes);
+
+    mate_mixer_change_set_unref (changes);
+    return G_SOURCE_REMOVE;
+}
+
+static void
+discard_topology_change (MateMixerBackend *backend)
+{
+    if (backend->priv->topology_tag != 0) {
+        g_source_remove (backend->priv->topology_tag);
+        backend->priv->topology_tag = 0;
+    }
+
+    if (backend->priv->topology != NULL) {
+        mate_mixer_change_set_unref (backend->priv->topology);
+        backend->priv->topology = NULL;
+    }
+}
+
+static void
+clear_indexes (MateMixerBackend *backend)
+{
+    GHashTableIter iter;
+    gpointer       device;
+
+    g_hash_table_iter_init (&iter, backend->priv->devices);
+
+    while (g_hash_table_iter_next (&iter, NULL, &device) == TRUE) {
+        g_signal_handlers_disconnect_by_data (G_OBJECT (device), backend);
+        g_hash_table_iter_remove (&iter);
+    }
+
+    g_hash_table_remove_all (backend->priv->streams);
+    g_hash_table_remove_all (backend->priv->stored_controls);
+
+    _mate_mixer_control_index_clear (backend->priv->controls_index);
+
+    /* The lists are going away with the connection, make sure holders of the
+     * old arrays notice the change */
+    _mate_mixer_array_cache_invalidate (&backend->priv->devices_array);
+    _mate_mixer_array_cache_invalidate (&backend->priv->streams_array);
+    _mate_mixer_array_cache_invalidate (&backend->priv->stored_controls_array);
+}
+
+static MateMixerDevice *
+find_device (MateMixerBackend *backend, const gchar *name)
+{
+    MateMixerBackendClass *klass;
+    const GList           *list;
+
+    klass = MATE_MIXER_BACKEND_GET_CLASS (backend);
+
+    /* Prefer the name lookup of the backend over walking through the list */
+    if (klass->get_device != NULL)
+        return klass->get_device (backend, name);
+
+    list = mate_mixer_backend_list_devices (backend);
+    while (list != NULL) {
+        MateMixerDevice *device = MATE_MIXER_DEVICE (list->data);
+
+        if (strcmp (name, mate_mixer_device_get_name (device)) == 0)
+            return device;
+
+        list = list->next;
+    }
+    return NULL;
+}
+
+static MateMixerStream *
+find_stream (MateMixerBackend *backend, const gchar *name)
+{
+    MateMixerBackendClass *klass;
+    const GList           *list;
+
+    klass = MATE_MIXER_BACKEND_GET_CLASS (backend);
+
+    if (klass->get_stream != NULL)
+        return klass->get_stream (backend, name);
+
+    list = mate_mixer_backend_list_streams (backend);
+    while (list != NULL) {
+        MateMixerStream *stream = MATE_MIXER_STREAM (list->data);
+
+        if (strcmp (name, mate_mixer_stream_get_name (stream)) == 0)
+            return stream;
+
+        list = list->next;
+    }
+    return NULL;
+}
+
+static void
+index_stored_controls (MateMixerBackend *backend)
+{
+    const GList *list;
+
+    if (backend->priv->stored_controls_unindexed == FALSE)
+        return;
+
+    backend->priv->stored_controls_unindexed = FALSE;
+
+    /* Listing the stored controls makes the backend create all of them */
+    list = mate_mixer_backend_list_stored_controls (backend);
+    while (list != NULL) {
+        index_stored_control (backend, MATE_MIXER_STORED_CONTROL (list->data));
+        list = list->next;
+    }
+}
+
+static void
+index_stored_control (MateMixerBackend *backend, MateMixerStoredControl *control)
+{
+    MateMixerStreamControl *stream_control = MATE_MIXER_STREAM_CONTROL (control);
+
+    g_hash_table_replace (backend->priv->stored_controls,
+                          (gpointer) mate_mixer_stream_control_get_name (stream_control),
+                          g_object_ref (control));
+
+    _mate_mixer_control_index_add (backend->priv->controls_index, NULL, stream_control);
+}
+
+static void
+create_stored_controls (MateMixerBackend      *backend,
+                        MateMixerBackendMatch  match,
+                        guint                  value,
+                        const gchar           *string)
+{
+    MateMixerBackendClass *klass;
+    GPtrArray             *names;
+    guint                  i;
+
+    klass = MATE_MIXER_BACKEND_GET_CLASS (backend);
+
+    if (klass->match_stored_controls == NULL) {
+        index_stored_controls (backend);
+        return;
+    }
+
+    /* Only create and index the stored controls the query is going to return,
+     * the names are owned by the backend */
+    names = klass->match_stored_controls (backend, match, value, string);
+    if (names == NULL)
+        return;
+
+    for (i = 0; i < names->len; i++)
+        mate_mixer_backend_get_stored_control (backend, g_ptr_array_index (names, i));
+
+    g_ptr_array_unref (names);
+}
+
+static MateMixerStoredControl *
+find_stored_control (MateMixerBackend *backend, const gchar *name)
+{
+    MateMixerBackendClass *klass;
+    const GList           *list;
+
+    klass = MATE_MIXER_BACKEND_GET_CLASS (backend);
+
+    if (klass->get_stored_control != NULL)
+        return klass->get_stored_control (backend, name);
+
+    list = mate_mixer_backend_list_stored_controls (backend);
+    while (list != NULL) {
+        MateMixerStreamControl *control = MATE_MIXER_STREAM_CONTROL (list->data);
+
+        if (strcmp (name, mate_mixer_stream_control_get_name (control)) == 0)
+            return MATE_MIXER_STORED_CONTROL (control);
+
+        list = list->next;
+    }
+    return NULL;
+}
+
 /* Protected functions */
+void
+_mate_mixer_backend_set_server_name (MateMixerBackend *backend, const gchar *name)
+{
+    g_return_if_fail (MATE_MIXER_IS_BACKEND (backend));
+
+    g_free (backend->priv->server_name);
+
+    backend->priv->server_name = g_strdup (name);
+}
+
 void
 _mate_mixer_backend_set_state (MateMixerBackend *backend, MateMixerState state)
 {
@@ -608,11 +1424,80 @@ _mate_mixer_backend_set_state (MateMixerBackend *backend, MateMixerState state)
     if (backend->priv->state == state)
         return;
 
+    /* Everything that appears while connecting is reported in a single
+     * topology change once the connection is established */
+    if (state == MATE_MIXER_STATE_CONNECTING)
+        _mate_mixer_backend_begin_topology_change (backend);
+    else if (backend->priv->state == MATE_MIXER_STATE_CONNECTING)
+        _mate_mixer_backend_end_topology_change (backend);
+
     backend->priv->state = state;
 
+    /* Backends drop their objects without emitting the removed signals
+     * when closed, so drop the indexed references as well */
+    if (state == MATE_MIXER_STATE_IDLE) {
+        clear_indexes (backend);
+        discard_topology_change (backend);
+
+        backend->priv->loading = MATE_MIXER_TRACK_NONE;
+        backend->priv->stored_controls_unindexed = FALSE;
+    }
+
     g_object_notify_by_pspec (G_OBJECT (backend), properties[PROP_STATE]);
 }
 
+void
+_mate_mixer_backend_begin_topology_change (MateMixerBackend *backend)
+{
+    g_return_if_fail (MATE_MIXER_IS_BACKEND (backend));
+
+    backend->priv->topology_depth++;
+}
+
+void
+_mate_mixer_backend_end_topology_change (MateMixerBackend *backend)
+{
+    g_return_if_fail (MATE_MIXER_IS_BACKEND (backend));
+    g_return_if_fail (backend->priv->topology_depth > 0);
+
+    backend->priv->topology_depth--;
+
+    if (backend->priv->topology_depth == 0 && backend->priv->topology != NULL)
+        schedule_topology_change (backend);
+}
+
+gboolean
+_mate_mixer_backend_has_topology_change (MateMixerBackend *backend)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_BACKEND (backend), FALSE);
+
+    /* A topology-changed signal is going to be emitted */
+    return backend->priv->topology_depth > 0 || backend->priv->topology != NULL;
+}
+
+void
+_mate_mixer_backend_begin_loading (MateMixerBackend *backend, MateMixerTrackFlags flags)
+{
+    g_return_if_fail (MATE_MIXER_IS_BACKEND (backend));
+
+    backend->priv->loading |= flags;
+}
+
+void
+_mate_mixer_backend_end_loading (MateMixerBackend *backend, MateMixerTrackFlags flags)
+{
+    g_return_if_fail (MATE_MIXER_IS_BACKEND (backend));
+
+    /* Only report the kinds of objects which were still pending */
+    flags &= backend->priv->loading;
+    if (flags == MATE_MIXER_TRACK_NONE)
+        return;
+
+    backend->priv->loading &= ~flags;
+
+    g_signal_emit (G_OBJECT (backend), signals[LOADED], 0, flags);
+}
+
 void
 _mate_mixer_backend_set_default_input_stream (MateMixerBackend *backend,
                                               MateMixerStream  *stream)
@@ -634,6 +1519,9 @@ _mate_mixer_backend_set_default_input_stream (MateMixerBackend *backend,
     g_debug ("Default input stream changed to %s",
              (stream != NULL) ? mate_mixer_stream_get_name (stream) : "none");
 
+    if (stream != NULL)
+        record_topology_change (backend, stream, MATE_MIXER_CHANGE_DEFAULT_INPUT_STREAM);
+
     g_object_notify_by_pspec (G_OBJECT (backend),
                               properties[PROP_DEFAULT_INPUT_STREAM]);
 }
@@ -659,6 +1547,9 @@ _mate_mixer_backend_set_default_output_stream (MateMixerBackend *backend,
     g_debug ("Default output stream changed to %s",
              (stream != NULL) ? mate_mixer_stream_get_name (stream) : "none");
 
+    if (stream != NULL)
+        record_topology_change (backend, stream, MATE_MIXER_CHANGE_DEFAULT_OUTPUT_STREAM);
+
     g_object_notify_by_pspec (G_OBJECT (backend),
                               properties[PROP_DEFAULT_OUTPUT_STREAM]);
 }
@@ -39,6 +39,15 @@ G_BEGIN_DECLS
 #define MATE_MIXER_BACKEND_GET_CLASS(o)         \
         (G_TYPE_INSTANCE_GET_CLASS ((o), MATE_MIXER_TYPE_BACKEND, MateMixerBackendClass))
 
+/* The kind of value a stored control is matched by when looking up stored
+ * controls which the backend has not created yet */
+typedef enum {
+    MATE_MIXER_BACKEND_MATCH_ROLE,
+    MATE_MIXER_BACKEND_MATCH_MEDIA_ROLE,
+    MATE_MIXER_BACKEND_MATCH_APP_ID,
+    MATE_MIXER_BACKEND_MATCH_APP_NAME
+} MateMixerBackendMatch;
+
 typedef struct _MateMixerBackend         MateMixerBackend;
 typedef struct _MateMixerBackendClass    MateMixerBackendClass;
 typedef struct _MateMixerBackendPrivate  MateMixerBackendPrivate;
@@ -60,6 +69,8 @@ struct _MateMixerBackendClass
                                                MateMixerAppInfo *info);
     void         (*set_server_address)        (MateMixerBackend *backend,
                                                const gchar      *address);
+    void         (*set_track_flags)           (MateMixerBackend    *backend,
+                                               MateMixerTrackFlags  flags);
 
     gboolean     (*open)                      (MateMixerBackend *backend);
     void         (*close)                     (MateMixerBackend *backend);
@@ -68,6 +79,21 @@ struct _MateMixerBackendClass
     const GList *(*list_streams)              (MateMixerBackend *backend);
     const GList *(*list_stored_controls)      (MateMixerBackend *backend);
 
+    MateMixerDevice        *(*get_device)         (MateMixerBackend *backend,
+                                                   const gchar      *name);
+    MateMixerStream        *(*get_stream)         (MateMixerBackend *backend,
+                                                   const gchar      *name);
+    MateMixerStoredControl *(*get_stored_control) (MateMixerBackend *backend,
+                                                   const gchar      *name);
+
+    GPtrArray   *(*match_stored_controls)     (MateMixerBackend      *backend,
+                                               MateMixerBackendMatch  match,
+                                               guint                  value,
+                                               const gchar           *string);
+    gboolean     (*get_stored_control_states) (MateMixerBackend *backend,
+                                               GArray           *states,
+                                               GArray           *volumes);
+
     gboolean     (*set_default_input_stream)  (MateMixerBackend *backend,
                                                MateMixerStream  *stream);
     gboolean     (*set_default_output_stream) (MateMixerBackend *backend,
@@ -86,6 +112,10 @@ struct _MateMixerBackendClass
                                                const gchar      *name);
     void         (*stored_control_removed)    (MateMixerBackend *backend,
                                                const gchar      *name);
+    void         (*topology_changed)          (MateMixerBackend   *backend,
+                                               MateMixerChangeSet *changes);
+    void         (*loaded)                    (MateMixerBackend    *backend,
+                                               MateMixerTrackFlags  flags);
 };
 
 GType                   mate_mixer_backend_get_type                  (void) G_GNUC_CONST;
@@ -94,6 +124,11 @@ void                    mate_mixer_backend_set_app_info              (MateMixerB
                                                                       MateMixerAppInfo *info);
 void                    mate_mixer_backend_set_server_address        (MateMixerBackend *backend,
                                                                       const gchar      *address);
+void                    mate_mixer_backend_set_track_flags           (MateMixerBackend *backend,
+                                                                      MateMixerTrackFlags flags);
+MateMixerTrackFlags     mate_mixer_backend_get_loading_flags         (MateMixerBackend *backend);
+guint                   mate_mixer_backend_get_generation            (MateMixerBackend *backend);
+const gchar *           mate_mixer_backend_get_server_name           (MateMixerBackend *backend);
 
 gboolean                mate_mixer_backend_open                      (MateMixerBackend *backend);
 void                    mate_mixer_backend_close                     (MateMixerBackend *backend);
@@ -111,6 +146,27 @@ const GList *           mate_mixer_backend_list_devices              (MateMixerB
 const GList *           mate_mixer_backend_list_streams              (MateMixerBackend *backend);
 const GList *           mate_mixer_backend_list_stored_controls      (MateMixerBackend *backend);
 
+GList *                 mate_mixer_backend_list_created_stored_controls (MateMixerBackend *backend);
+gboolean                mate_mixer_backend_get_stored_control_states    (MateMixerBackend *backend,
+                                                                         GArray           *states,
+                                                                         GArray           *volumes);
+
+GPtrArray *             mate_mixer_backend_dup_devices               (MateMixerBackend *backend,
+                                                                      guint            *generation);
+GPtrArray *             mate_mixer_backend_dup_streams               (MateMixerBackend *backend,
+                                                                      guint            *generation);
+GPtrArray *             mate_mixer_backend_dup_stored_controls       (MateMixerBackend *backend,
+                                                                      guint            *generation);
+
+GPtrArray *             mate_mixer_backend_find_role_controls        (MateMixerBackend *backend,
+                                                                      MateMixerStreamControlRole role);
+GPtrArray *             mate_mixer_backend_find_media_role_controls  (MateMixerBackend *backend,
+                                                                      MateMixerStreamControlMediaRole media_role);
+GPtrArray *             mate_mixer_backend_find_app_id_controls      (MateMixerBackend *backend,
+                                                                      const gchar      *app_id);
+GPtrArray *             mate_mixer_backend_find_app_name_controls    (MateMixerBackend *backend,
+                                                                      const gchar      *app_name);
+
 MateMixerStream *       mate_mixer_backend_get_default_input_stream  (MateMixerBackend *backend);
 gboolean                mate_mixer_backend_set_default_input_stream  (MateMixerBackend *backend,
                                                                       MateMixerStream  *stream);
@@ -120,6 +176,9 @@ gboolean                mate_mixer_backend_set_default_output_stream (MateMixerB
                                                                       MateMixerStream  *stream);
 
 /* Protected functions */
+void                   _mate_mixer_backend_set_server_name           (MateMixerBackend *backend,
+                                                                      const gchar      *name);
+
 void                   _mate_mixer_backend_set_state                 (MateMixerBackend *backend,
                                                                       MateMixerState    state);
 
@@ -129,6 +188,15 @@ void                   _mate_mixer_backend_set_default_input_stream  (MateMixerB
 void                   _mate_mixer_backend_set_default_output_stream (MateMixerBackend *backend,
                                                                       MateMixerStream  *stream);
 
+void                   _mate_mixer_backend_begin_topology_change     (MateMixerBackend *backend);
+void                   _mate_mixer_backend_end_topology_change       (MateMixerBackend *backend);
+gboolean               _mate_mixer_backend_has_topology_change       (MateMixerBackend *backend);
+
+void                   _mate_mixer_backend_begin_loading             (MateMixerBackend *backend,
+                                                                      MateMixerTrackFlags flags);
+void                   _mate_mixer_backend_end_loading               (MateMixerBackend *backend,
+                                                                      MateMixerTrackFlags flags);
+
 G_END_DECLS
 
 #endif /* MATEMIXER_BACKEND_H */
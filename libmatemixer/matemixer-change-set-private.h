@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MATEMIXER_CHANGE_SET_PRIVATE_H
+#define MATEMIXER_CHANGE_SET_PRIVATE_H
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include "matemixer-enums.h"
+#include "matemixer-types.h"
+
+G_BEGIN_DECLS
+
+MateMixerChangeSet * _mate_mixer_change_set_new          (void);
+
+gboolean             _mate_mixer_change_set_is_empty     (MateMixerChangeSet   *set);
+
+void                 _mate_mixer_change_set_add_object   (MateMixerChangeSet   *set,
+                                                          GObject              *object,
+                                                          MateMixerChangeFlags  flags);
+void                 _mate_mixer_change_set_add_name     (MateMixerChangeSet   *set,
+                                                          GType                 type,
+                                                          const gchar          *name,
+                                                          MateMixerChangeFlags  flags);
+
+MateMixerChangeFlags _mate_mixer_change_flags_from_pspec (GParamSpec           *pspec);
+
+G_END_DECLS
+
+#endif /* MATEMIXER_CHANGE_SET_PRIVATE_H */
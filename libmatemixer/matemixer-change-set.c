@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <glib.h>
+#include <glib-object.h>
+
+#include "matemixer-change-set.h"
+#include "matemixer-change-set-private.h"
+#include "matemixer-context.h"
+#include "matemixer-device.h"
+#include "matemixer-enums.h"
+#include "matemixer-name-private.h"
+#include "matemixer-stored-control.h"
+#include "matemixer-stream.h"
+#include "matemixer-stream-control.h"
+#include "matemixer-switch.h"
+
+/**
+ * SECTION:matemixer-change-set
+ * @short_description: Coalesced list of changes
+ * @include: libmatemixer/matemixer.h
+ * @see_also: #MateMixerContext
+ *
+ * The #MateMixerChangeSet structure describes all the changes that happened
+ * in a #MateMixerContext since the last #MateMixerContext::changed signal.
+ *
+ * Each object appears in the set at most once with all its changes merged
+ * into the flags of a single #MateMixerChange, removals of devices, streams
+ * and stored controls are listed by name. Stored controls which the backend
+ * has not created yet are listed by name as well.
+ */
+
+struct _MateMixerChangeSet
+{
+    volatile gint  ref_count;
+    GArray        *changes;
+    GHashTable    *indexes;
+};
+
+/**
+ * MateMixerChangeSet:
+ *
+ * The #MateMixerChangeSet structure contains only private data and should only
+ * be accessed using the provided API.
+ */
+G_DEFINE_BOXED_TYPE (MateMixerChangeSet, mate_mixer_change_set,
+                     mate_mixer_change_set_ref,
+                     mate_mixer_change_set_unref)
+
+static void describe_object (GObject      *object,
+                             GType        *type,
+                             const gchar **name);
+
+/**
+ * mate_mixer_change_set_ref:
+ * @set: a #MateMixerChangeSet
+ *
+ * Increases the reference count of @set.
+ *
+ * Returns: the @set.
+ */
+MateMixerChangeSet *
+mate_mixer_change_set_ref (MateMixerChangeSet *set)
+{
+    g_return_val_if_fail (set != NULL, NULL);
+
+    g_atomic_int_inc (&set->ref_count);
+    return set;
+}
+
+/**
+ * mate_mixer_change_set_unref:
+ * @set: a #MateMixerChangeSet
+ *
+ * Decreases the reference count of @set. When the reference count drops to
+ * zero, the set and the references to the objects it contains are released.
+ */
+void
+mate_mixer_change_set_unref (MateMixerChangeSet *set)
+{
+    guint i;
+
+    g_return_if_fail (set != NULL);
+
+    if (g_atomic_int_dec_and_test (&set->ref_count) == FALSE)
+        return;
+
+    for (i = 0; i < set->changes->len; i++) {
+        MateMixerChange *change = &g_array_index (set->changes, MateMixerChange, i);
+
+        if (change->object != NULL)
+            g_object_unref (change->object);
+        else
+            _mate_mixer_name_unref (change->name);
+    }
+
+    g_array_free (set->changes, TRUE);
+    g_hash_table_unref (set->indexes);
+
+    g_slice_free (MateMixerChangeSet, set);
+}
+
+/**
+ * mate_mixer_change_set_get_changes:
+ * @set: a #MateMixerChangeSet
+ * @n_changes: (out): return location for the number of changes
+ *
+ * Gets the changes contained in @set, ordered by the time of the first change
+ * of each object.
+ *
+ * Returns: (array length=n_changes) (transfer none): an array of changes owned
+ * by @set.
+ */
+const MateMixerChange *
+mate_mixer_change_set_get_changes (MateMixerChangeSet *set, guint *n_changes)
+{
+    g_return_val_if_fail (set != NULL, NULL);
+    g_return_val_if_fail (n_changes != NULL, NULL);
+
+    *n_changes = set->changes->len;
+
+    return (const MateMixerChange *) set->changes->data;
+}
+
+MateMixerChangeSet *
+_mate_mixer_change_set_new (void)
+{
+    MateMixerChangeSet *set;
+
+    set = g_slice_new (MateMixerChangeSet);
+    set->ref_count = 1;
+    set->changes   = g_array_new (FALSE, FALSE, sizeof (MateMixerChange));
+
+    /* Maps each object to its position in the array plus one */
+    set->indexes = g_hash_table_new (g_direct_hash, g_direct_equal);
+    return set;
+}
+
+gboolean
+_mate_mixer_change_set_is_empty (MateMixerChangeSet *set)
+{
+    g_return_val_if_fail (set != NULL, TRUE);
+
+    return set->changes->len == 0;
+}
+
+void
+_mate_mixer_change_set_add_object (MateMixerChangeSet   *set,
+                                   GObject              *object,
+                                   MateMixerChangeFlags  flags)
+{
+    MateMixerChange change;
+    guint           index;
+
+    g_return_if_fail (set != NULL);
+    g_return_if_fail (G_IS_OBJECT (object));
+
+    index = GPOINTER_TO_UINT (g_hash_table_lookup (set->indexes, object));
+    if (index > 0) {
+        g_array_index (set->changes, MateMixerChange, index - 1).flags |= flags;
+        return;
+    }
+
+    describe_object (object, &change.type, &change.name);
+
+    change.object = g_object_ref (object);
+    change.flags  = flags;
+
+    g_array_append_val (set->changes, change);
+
+    g_hash_table_insert (set->indexes,
+                         object,
+                         GUINT_TO_POINTER (set->changes->len));
+}
+
+void
+_mate_mixer_change_set_add_name (MateMixerChangeSet   *set,
+                                 GType                 type,
+                                 const gchar          *name,
+                                 MateMixerChangeFlags  flags)
+{
+    MateMixerChange change;
+
+    g_return_if_fail (set != NULL);
+    g_return_if_fail (name != NULL);
+
+    /* There is no object to merge the entry with, either because it is
+     * already gone or because the backend has not created it yet */
+    change.type   = type;
+    change.object = NULL;
+    change.name   = _mate_mixer_name_ref (name);
+    change.flags  = flags;
+
+    g_array_append_val (set->changes, change);
+}
+
+MateMixerChangeFlags
+_mate_mixer_change_flags_from_pspec (GParamSpec *pspec)
+{
+    g_return_val_if_fail (G_IS_PARAM_SPEC (pspec), MATE_MIXER_CHANGE_NONE);
+
+    if (strcmp (pspec->name, "volume") == 0)
+        return MATE_MIXER_CHANGE_VOLUME;
+    if (strcmp (pspec->name, "mute") == 0)
+        return MATE_MIXER_CHANGE_MUTE;
+    if (strcmp (pspec->name, "balance") == 0)
+        return MATE_MIXER_CHANGE_BALANCE;
+    if (strcmp (pspec->name, "fade") == 0)
+        return MATE_MIXER_CHANGE_FADE;
+    if (strcmp (pspec->name, "label") == 0)
+        return MATE_MIXER_CHANGE_LABEL;
+    if (strcmp (pspec->name, "active-option") == 0)
+        return MATE_MIXER_CHANGE_ACTIVE_OPTION;
+
+    return MATE_MIXER_CHANGE_OTHER;
+}
+
+static void
+describe_object (GObject *object, GType *type, const gchar **name)
+{
+    /* Stored controls are stream controls as well, so check them first */
+    if (MATE_MIXER_IS_STORED_CONTROL (object)) {
+        *type = MATE_MIXER_TYPE_STORED_CONTROL;
+        *name = mate_mixer_stream_control_get_name (MATE_MIXER_STREAM_CONTROL (object));
+    } else if (MATE_MIXER_IS_STREAM_CONTROL (object)) {
+        *type = MATE_MIXER_TYPE_STREAM_CONTROL;
+        *name = mate_mixer_stream_control_get_name (MATE_MIXER_STREAM_CONTROL (object));
+    } else if (MATE_MIXER_IS_STREAM (object)) {
+        *type = MATE_MIXER_TYPE_STREAM;
+        *name = mate_mixer_stream_get_name (MATE_MIXER_STREAM (object));
+    } else if (MATE_MIXER_IS_DEVICE (object)) {
+        *type = MATE_MIXER_TYPE_DEVICE;
+        *name = mate_mixer_device_get_name (MATE_MIXER_DEVICE (object));
+    } else if (MATE_MIXER_IS_SWITCH (object)) {
+        *type = MATE_MIXER_TYPE_SWITCH;
+        *name = mate_mixer_switch_get_name (MATE_MIXER_SWITCH (object));
+    } else {
+        *type = G_OBJECT_TYPE (object);
+        *name = NULL;
+    }
+}
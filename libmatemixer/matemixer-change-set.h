@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MATEMIXER_CHANGE_SET_H
+#define MATEMIXER_CHANGE_SET_H
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include "matemixer-enums.h"
+#include "matemixer-types.h"
+
+G_BEGIN_DECLS
+
+#define MATE_MIXER_TYPE_CHANGE_SET (mate_mixer_change_set_get_type ())
+
+/**
+ * MateMixerChange:
+ * @type: the base type of the changed object, one of %MATE_MIXER_TYPE_CONTEXT,
+ * %MATE_MIXER_TYPE_DEVICE, %MATE_MIXER_TYPE_STREAM, %MATE_MIXER_TYPE_STREAM_CONTROL,
+ * %MATE_MIXER_TYPE_STORED_CONTROL or %MATE_MIXER_TYPE_SWITCH
+ * @object: the changed object or %NULL if the object has been removed or if
+ * it is a stored control which has not been created yet
+ * @name: the name of the changed object or %NULL for the context
+ * @flags: what has changed
+ *
+ * A single entry of a #MateMixerChangeSet.
+ */
+struct _MateMixerChange
+{
+    GType                 type;
+    GObject              *object;
+    const gchar          *name;
+    MateMixerChangeFlags  flags;
+};
+
+GType                  mate_mixer_change_set_get_type    (void) G_GNUC_CONST;
+
+MateMixerChangeSet *   mate_mixer_change_set_ref         (MateMixerChangeSet *set);
+void                   mate_mixer_change_set_unref       (MateMixerChangeSet *set);
+
+const MateMixerChange *mate_mixer_change_set_get_changes (MateMixerChangeSet *set,
+                                                          guint              *n_changes);
+
+G_END_DECLS
+
+#endif /* MATEMIXER_CHANGE_SET_H */
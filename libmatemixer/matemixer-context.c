@@ -21,6 +21,7 @@
 #include "matemixer.h"
 #include "matemixer-backend.h"
 #include "matemixer-backend-module.h"
+#include "matemixer-change-set.h"
 #include "matemixer-context.h"
 #include "matemixer-enums.h"
 #include "matemixer-enum-types.h"
@@ -74,11 +75,21 @@ struct _MateMixerContextPrivate
 {
     gboolean                backend_chosen;
     gchar                  *server_address;
+    MateMixerTrackFlags     track_flags;
     MateMixerState          state;
     MateMixerBackend       *backend;
     MateMixerAppInfo       *app_info;
     MateMixerBackendType    backend_type;
     MateMixerBackendModule *module;
+    guint                   generation;
+    gboolean                coalesce_changes;
+    guint                   freeze_count;
+    guint                   changes_tag;
+    MateMixerChangeSet     *changes;
+    GHashTable             *tracked;
+    gboolean                cache_enabled;
+    guint                   cache_tag;
+    MateMixerSnapshot      *cache;
 };
 
 enum {
@@ -103,6 +114,9 @@ enum {
     STREAM_REMOVED,
     STORED_CONTROL_ADDED,
     STORED_CONTROL_REMOVED,
+    CHANGED,
+    TOPOLOGY_CHANGED,
+    LOADED,
     N_SIGNALS
 };
 
@@ -150,6 +164,14 @@ static void     on_backend_stored_control_removed       (MateMixerBackend *backe
                                                          const gchar      *name,
                                                          MateMixerContext *context);
 
+static void     on_backend_topology_changed             (MateMixerBackend   *backend,
+                                                         MateMixerChangeSet *changes,
+                                                         MateMixerContext   *context);
+
+static void     on_backend_loaded                       (MateMixerBackend    *backend,
+                                                         MateMixerTrackFlags  flags,
+                                                         MateMixerContext    *context);
+
 static void     on_backend_default_input_stream_notify  (MateMixerBackend *backend,
                                                          GParamSpec       *pspec,
                                                          MateMixerContext *context);
@@ -157,6 +179,29 @@ static void     on_backend_default_output_stream_notify (MateMixerBackend *backe
                                                          GParamSpec       *pspec,
                                                          MateMixerContext *context);
 
+static void     on_tracked_object_notify                (GObject          *object,
+                                                         GParamSpec       *pspec,
+                                                         MateMixerContext *context);
+static void     on_tracked_object_finalized             (MateMixerContext *context,
+                                                         GObject          *object);
+
+static void     on_tracked_children_changed             (GObject          *object,
+                                                         const gchar      *name,
+                                                         MateMixerContext *context);
+
+static void     on_device_switch_added                  (MateMixerDevice  *device,
+                                                         const gchar      *name,
+                                                         MateMixerContext *context);
+static void     on_stream_control_added                 (MateMixerStream  *stream,
+                                                         const gchar      *name,
+                                                         MateMixerContext *context);
+static void     on_stream_control_removed               (MateMixerStream  *stream,
+                                                         const gchar      *name,
+                                                         MateMixerContext *context);
+static void     on_stream_switch_added                  (MateMixerStream  *stream,
+                                                         const gchar      *name,
+                                                         MateMixerContext *context);
+
 static gboolean try_next_backend                        (MateMixerContext *context);
 
 static void     change_state                            (MateMixerContext *context,
@@ -164,6 +209,44 @@ static void     change_state                            (MateMixerContext *conte
 
 static void     close_context                           (MateMixerContext *context);
 
+static guint    get_generation                          (MateMixerContext *context);
+
+static gchar *  get_cache_filename                      (MateMixerContext *context);
+static gchar *  get_cache_source                        (MateMixerContext *context);
+static void     load_cache                              (MateMixerContext *context);
+static void     save_cache                              (MateMixerContext *context);
+static void     schedule_cache_save                     (MateMixerContext *context);
+static gboolean dispatch_cache_save                     (MateMixerContext *context);
+static void     reconcile_cache                         (MateMixerContext *context);
+
+static gboolean track_object                            (MateMixerContext *context,
+                                                         gpointer          object);
+static void     track_device                            (MateMixerContext *context,
+                                                         MateMixerDevice  *device);
+static void     track_stream                            (MateMixerContext *context,
+                                                         MateMixerStream  *stream);
+
+static void     track_stored_control                    (MateMixerContext *context,
+                                                         gpointer          control);
+static void     track_stored_controls                   (MateMixerContext *context,
+                                                         GPtrArray        *controls);
+
+static void     start_tracking                          (MateMixerContext *context);
+static void     stop_tracking                           (MateMixerContext *context);
+
+static void     queue_change                            (MateMixerContext     *context,
+                                                         gpointer              object,
+                                                         MateMixerChangeFlags  flags);
+static void     queue_name                              (MateMixerContext     *context,
+                                                         GType                 type,
+                                                         const gchar          *name,
+                                                         MateMixerChangeFlags  flags);
+
+static void     schedule_changes                        (MateMixerContext *context);
+static gboolean dispatch_changes                        (MateMixerContext *context);
+static void     emit_changes                            (MateMixerContext *context);
+static void     discard_changes                         (MateMixerContext *context);
+
 static void
 mate_mixer_context_class_init (MateMixerContextClass *klass)
 {
@@ -394,6 +477,11 @@ mate_mixer_context_class_init (MateMixerContextClass *klass)
      * The signal is emitted each time a stored control is added.
      *
      * Use mate_mixer_context_get_stored_control() to get the #MateMixerStoredControl.
+     *
+     * Stored controls added while %MATE_MIXER_TRACK_STORED_CONTROLS is being loaded
+     * are included in #MateMixerContext::topology-changed by name only, as they
+     * are not created until they are requested. The #MateMixerContext::loaded
+     * signal reports the list as complete.
      */
     signals[STORED_CONTROL_ADDED] =
         g_signal_new ("stored-control-added",
@@ -431,6 +519,89 @@ mate_mixer_context_class_init (MateMixerContextClass *klass)
                       1,
                       G_TYPE_STRING);
 
+    /**
+     * MateMixerContext::changed:
+     * @context: a #MateMixerContext
+     * @changes: a #MateMixerChangeSet describing the changes
+     *
+     * The signal is emitted once per main loop iteration with all the changes
+     * that happened in the context since the previous emission, it is only
+     * emitted after enabling it with mate_mixer_context_set_coalesce_changes().
+     *
+     * The individual signals and property notifications are emitted as usual,
+     * an application which connects to this signal will usually not need them.
+     */
+    signals[CHANGED] =
+        g_signal_new ("changed",
+                      G_TYPE_FROM_CLASS (object_class),
+                      G_SIGNAL_RUN_FIRST,
+                      G_STRUCT_OFFSET (MateMixerContextClass, changed),
+                      NULL,
+                      NULL,
+                      g_cclosure_marshal_VOID__BOXED,
+                      G_TYPE_NONE,
+                      1,
+                      MATE_MIXER_TYPE_CHANGE_SET);
+
+    /**
+     * MateMixerContext::topology-changed:
+     * @context: a #MateMixerContext
+     * @changes: a #MateMixerChangeSet describing the changes
+     *
+     * The signal is emitted after devices, streams or stored controls have been
+     * added or removed, or when the default streams have changed.
+     *
+     * Plugging in or removing a device usually adds or removes several objects
+     * at once, the signal is only emitted after the whole operation has
+     * finished and @changes includes all the additions and removals. Stream
+     * controls which have been added or removed are included as well, their
+     * streams are included with the %MATE_MIXER_CHANGE_CHILDREN flag together
+     * with the streams whose switches have changed.
+     *
+     * The individual signals are emitted as usual as the objects are added
+     * and removed.
+     */
+    signals[TOPOLOGY_CHANGED] =
+        g_signal_new ("topology-changed",
+                      G_TYPE_FROM_CLASS (object_class),
+                      G_SIGNAL_RUN_FIRST,
+                      G_STRUCT_OFFSET (MateMixerContextClass, topology_changed),
+                      NULL,
+                      NULL,
+                      g_cclosure_marshal_VOID__BOXED,
+                      G_TYPE_NONE,
+                      1,
+                      MATE_MIXER_TYPE_CHANGE_SET);
+
+    /**
+     * MateMixerContext::loaded:
+     * @context: a #MateMixerContext
+     * @flags: the kinds of objects which have finished loading
+     *
+     * The signal is emitted when the objects which were still being loaded
+     * when the context has reached the %MATE_MIXER_STATE_READY state become
+     * available.
+     *
+     * Some backends report the ready state as soon as the devices and streams
+     * are known and load the remaining objects, such as the application
+     * controls, afterwards. The objects are announced using the usual signals
+     * and this signal follows once all the objects of the kinds included in
+     * @flags are present.
+     *
+     * See mate_mixer_context_get_loading_flags().
+     */
+    signals[LOADED] =
+        g_signal_new ("loaded",
+                      G_TYPE_FROM_CLASS (object_class),
+                      G_SIGNAL_RUN_FIRST,
+                      G_STRUCT_OFFSET (MateMixerContextClass, loaded),
+                      NULL,
+                      NULL,
+                      g_cclosure_marshal_VOID__FLAGS,
+                      G_TYPE_NONE,
+                      1,
+                      MATE_MIXER_TYPE_TRACK_FLAGS);
+
     g_type_class_add_private (object_class, sizeof (MateMixerContextPrivate));
 }
 
@@ -523,6 +694,10 @@ mate_mixer_context_init (MateMixerContext *context)
                                                  MateMixerContextPrivate);
 
     context->priv->app_info = _mate_mixer_app_info_new ();
+    context->priv->track_flags = MATE_MIXER_TRACK_ALL;
+
+    /* Objects whose notifications are collected for the changed signal */
+    context->priv->tracked = g_hash_table_new (g_direct_hash, g_direct_equal);
 }
 
 static void
@@ -533,6 +708,7 @@ mate_mixer_context_dispose (GObject *object)
     context = MATE_MIXER_CONTEXT (object);
 
     close_context (context);
+    discard_changes (context);
 
     G_OBJECT_CLASS (mate_mixer_context_parent_class)->dispose (object);
 }
@@ -548,6 +724,11 @@ mate_mixer_context_finalize (GObject *object)
 
     g_free (context->priv->server_address);
 
+    g_hash_table_unref (context->priv->tracked);
+
+    if (context->priv->cache != NULL)
+        mate_mixer_snapshot_unref (context->priv->cache);
+
     G_OBJECT_CLASS (mate_mixer_context_parent_class)->finalize (object);
 }
 
@@ -769,6 +950,137 @@ mate_mixer_context_set_server_address (MateMixerContext *context, const gchar *a
     return TRUE;
 }
 
+/**
+ * mate_mixer_context_set_track_flags:
+ * @context: a #MateMixerContext
+ * @flags: the kinds of objects to keep track of
+ *
+ * Selects the kinds of objects the @context keeps track of. Objects which are
+ * not selected are neither downloaded from the sound system nor updated, so an
+ * application which only needs a small part of the sound system can save the
+ * cost of tracking the rest. By default, all objects are tracked.
+ *
+ * An application which only controls the default streams, such as a volume key
+ * handler, may use %MATE_MIXER_TRACK_DEFAULT_STREAMS instead of the stream flags
+ * to keep the cost of the context small regardless of the number of streams
+ * present in the system.
+ *
+ * The flags are fully supported by the PulseAudio backend. The ALSA and OSS
+ * backends only recognize %MATE_MIXER_TRACK_DEFAULT_STREAMS, with which they
+ * only open the default sound card.
+ *
+ * This function must be used before opening a connection to a sound system with
+ * mate_mixer_context_open(), otherwise it will fail.
+ *
+ * Returns: %TRUE on success or %FALSE on failure.
+ */
+gboolean
+mate_mixer_context_set_track_flags (MateMixerContext *context, MateMixerTrackFlags flags)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), FALSE);
+
+    if (context->priv->state == MATE_MIXER_STATE_CONNECTING ||
+        context->priv->state == MATE_MIXER_STATE_READY)
+        return FALSE;
+
+    context->priv->track_flags = flags;
+    return TRUE;
+}
+
+/**
+ * mate_mixer_context_get_track_flags:
+ * @context: a #MateMixerContext
+ *
+ * Gets the kinds of objects the @context keeps track of, see
+ * mate_mixer_context_set_track_flags().
+ *
+ * Returns: the track flags.
+ */
+MateMixerTrackFlags
+mate_mixer_context_get_track_flags (MateMixerContext *context)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), MATE_MIXER_TRACK_NONE);
+
+    return context->priv->track_flags;
+}
+
+/**
+ * mate_mixer_context_set_cache_enabled:
+ * @context: a #MateMixerContext
+ * @enabled: whether to use the topology cache
+ *
+ * Enables or disables the topology cache of the @context.
+ *
+ * With the cache enabled, the state of all streams and controls is saved to a
+ * file in the user's cache directory and loaded again when the context is
+ * opened. The saved state is available with
+ * mate_mixer_context_get_cached_snapshot() while the context is connecting,
+ * which allows an application to present the last known state without
+ * waiting for the sound system.
+ *
+ * When the connection is established, the #MateMixerContext::topology-changed
+ * signal reports the differences between the saved and the current state
+ * instead of reporting all the streams and controls as added. A state saved
+ * for a different sound system or sound server is ignored at this point.
+ *
+ * This function must be used before opening a connection to a sound system with
+ * mate_mixer_context_open(), otherwise it will fail.
+ *
+ * Returns: %TRUE on success or %FALSE on failure.
+ */
+gboolean
+mate_mixer_context_set_cache_enabled (MateMixerContext *context, gboolean enabled)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), FALSE);
+
+    if (context->priv->state == MATE_MIXER_STATE_CONNECTING ||
+        context->priv->state == MATE_MIXER_STATE_READY)
+        return FALSE;
+
+    context->priv->cache_enabled = enabled;
+    return TRUE;
+}
+
+/**
+ * mate_mixer_context_get_cache_enabled:
+ * @context: a #MateMixerContext
+ *
+ * Gets whether the topology cache is enabled, see
+ * mate_mixer_context_set_cache_enabled().
+ *
+ * Returns: %TRUE if the cache is enabled or %FALSE otherwise.
+ */
+gboolean
+mate_mixer_context_get_cache_enabled (MateMixerContext *context)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), FALSE);
+
+    return context->priv->cache_enabled;
+}
+
+/**
+ * mate_mixer_context_get_cached_snapshot:
+ * @context: a #MateMixerContext
+ *
+ * Gets the state of streams and controls saved by a previous session. The
+ * snapshot contains names, labels and volumes, but no objects, the @stream
+ * and @control fields of its entries are %NULL.
+ *
+ * The snapshot is available after opening the @context until the differences
+ * from the current state have been reported by the
+ * #MateMixerContext::topology-changed signal.
+ *
+ * Returns: (transfer none): a #MateMixerSnapshot or %NULL if the cache is not
+ * enabled or not available.
+ */
+MateMixerSnapshot *
+mate_mixer_context_get_cached_snapshot (MateMixerContext *context)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), NULL);
+
+    return context->priv->cache;
+}
+
 /**
  * mate_mixer_context_open:
  * @context: a #MateMixerContext
@@ -815,6 +1127,9 @@ mate_mixer_context_open (MateMixerContext *context)
         context->priv->state == MATE_MIXER_STATE_READY)
         return FALSE;
 
+    if (context->priv->cache_enabled == TRUE && context->priv->cache == NULL)
+        load_cache (context);
+
     /* We are going to choose the first backend to try. It will be either the one
      * selected by the application or the one with the highest priority */
     modules = _mate_mixer_list_modules ();
@@ -850,6 +1165,7 @@ mate_mixer_context_open (MateMixerContext *context)
 
     mate_mixer_backend_set_app_info (context->priv->backend, context->priv->app_info);
     mate_mixer_backend_set_server_address (context->priv->backend, context->priv->server_address);
+    mate_mixer_backend_set_track_flags (context->priv->backend, context->priv->track_flags);
 
     g_debug ("Trying to open backend %s", info->name);
 
@@ -908,6 +1224,12 @@ mate_mixer_context_close (MateMixerContext *context)
     g_return_if_fail (MATE_MIXER_IS_CONTEXT (context));
 
     close_context (context);
+
+    if (context->priv->cache != NULL) {
+        mate_mixer_snapshot_unref (context->priv->cache);
+        context->priv->cache = NULL;
+    }
+
     change_state (context, MATE_MIXER_STATE_IDLE);
 }
 
@@ -927,6 +1249,60 @@ mate_mixer_context_get_state (MateMixerContext *context)
     return context->priv->state;
 }
 
+/**
+ * mate_mixer_context_get_generation:
+ * @context: a #MateMixerContext
+ *
+ * Gets the change counter of the context. The number is incremented each time
+ * the state of the context changes, when a device, stream or control is added
+ * or removed, when the default input or output stream changes and when
+ * a property of a device, stream or control changes.
+ *
+ * An application may store the number and compare it later to find out
+ * whether anything has changed in the meantime without walking through the
+ * lists of devices and streams. Changes of the individual devices, streams
+ * and controls are tracked by mate_mixer_device_get_generation(),
+ * mate_mixer_stream_get_generation() and
+ * mate_mixer_stream_control_get_generation().
+ *
+ * The number is never decremented, not even when the context is closed and
+ * opened again.
+ *
+ * Returns: the current generation number of the context.
+ */
+guint
+mate_mixer_context_get_generation (MateMixerContext *context)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), 0);
+
+    return get_generation (context);
+}
+
+/**
+ * mate_mixer_context_get_loading_flags:
+ * @context: a #MateMixerContext
+ *
+ * Gets the kinds of objects which are still being loaded after the @context
+ * has reached the %MATE_MIXER_STATE_READY state.
+ *
+ * The lists returned by the context may be incomplete for the included kinds
+ * of objects, the #MateMixerContext::loaded signal is emitted when they are
+ * finished.
+ *
+ * Returns: the loading flags or %MATE_MIXER_TRACK_NONE if everything has
+ * been loaded or the @context is not ready.
+ */
+MateMixerTrackFlags
+mate_mixer_context_get_loading_flags (MateMixerContext *context)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), MATE_MIXER_TRACK_NONE);
+
+    if (context->priv->state != MATE_MIXER_STATE_READY)
+        return MATE_MIXER_TRACK_NONE;
+
+    return mate_mixer_backend_get_loading_flags (context->priv->backend);
+}
+
 /**
  * mate_mixer_context_get_device:
  * @context: a #MateMixerContext
@@ -976,18 +1352,27 @@ mate_mixer_context_get_stream (MateMixerContext *context, const gchar *name)
  *
  * Gets the stored control with the given name.
  *
+ * Backends with a large database of stored controls may only create the
+ * #MateMixerStoredControl when it is requested for the first time.
+ *
  * Returns: a #MateMixerStoredControl or %NULL if there is no such stored control.
  */
 MateMixerStoredControl *
 mate_mixer_context_get_stored_control (MateMixerContext *context, const gchar *name)
 {
+    MateMixerStoredControl *control;
+
     g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), NULL);
     g_return_val_if_fail (name != NULL, NULL);
 
     if (context->priv->state != MATE_MIXER_STATE_READY)
         return NULL;
 
-    return mate_mixer_backend_get_stored_control (MATE_MIXER_BACKEND (context->priv->backend), name);
+    control = mate_mixer_backend_get_stored_control (MATE_MIXER_BACKEND (context->priv->backend), name);
+    if (control != NULL)
+        track_stored_control (context, control);
+
+    return control;
 }
 
 /**
@@ -1054,158 +1439,421 @@ mate_mixer_context_list_streams (MateMixerContext *context)
 const GList *
 mate_mixer_context_list_stored_controls (MateMixerContext *context)
 {
+    const GList *list;
+
     g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), NULL);
 
     if (context->priv->state != MATE_MIXER_STATE_READY)
         return NULL;
 
-    return mate_mixer_backend_list_stored_controls (MATE_MIXER_BACKEND (context->priv->backend));
+    list = mate_mixer_backend_list_stored_controls (MATE_MIXER_BACKEND (context->priv->backend));
+
+    if (context->priv->coalesce_changes == TRUE) {
+        const GList *item;
+
+        for (item = list; item != NULL; item = item->next)
+            track_stored_control (context, item->data);
+    }
+    return list;
 }
 
 /**
- * mate_mixer_context_get_default_input_stream:
+ * mate_mixer_context_dup_devices:
  * @context: a #MateMixerContext
- *
- * Gets the default input stream. The returned stream is where sound input
- * most likely comes from by default.
- *
- * Returns: a #MateMixerStream or %NULL if there is no default input stream.
+ * @generation: (out) (allow-none): return location for the generation number
+ * of the returned array
+ *
+ * Gets an array of devices. The content is the same as the list returned by
+ * mate_mixer_context_list_devices(), the array holds a reference to each of
+ * the devices.
+ *
+ * The @generation number changes each time a device is added or removed, an
+ * application may compare it with the value from a previous call to find out
+ * whether anything has changed. Repeated calls without such a change return
+ * the same array, which is shared by all the callers and must not be modified.
+ * The array is owned by the library and released when the generation changes,
+ * use g_ptr_array_ref() to keep it for longer.
+ *
+ * Returns: (transfer none) (element-type MateMixerDevice): a read-only
+ * #GPtrArray of devices or %NULL if you are not connected to a sound system.
  */
-MateMixerStream *
-mate_mixer_context_get_default_input_stream (MateMixerContext *context)
+GPtrArray *
+mate_mixer_context_dup_devices (MateMixerContext *context, guint *generation)
 {
     g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), NULL);
 
     if (context->priv->state != MATE_MIXER_STATE_READY)
         return NULL;
 
-    return mate_mixer_backend_get_default_input_stream (context->priv->backend);
+    return mate_mixer_backend_dup_devices (MATE_MIXER_BACKEND (context->priv->backend),
+                                           generation);
 }
 
 /**
- * mate_mixer_context_set_default_input_stream:
+ * mate_mixer_context_dup_streams:
  * @context: a #MateMixerContext
- * @stream: a #MateMixerStream to set as the default input stream
+ * @generation: (out) (allow-none): return location for the generation number
+ * of the returned array
  *
- * Changes the default input stream. The given @stream must be an input stream.
- *
- * Changing the default input stream may not be supported by the sound system.
- * Use mate_mixer_context_get_backend_flags() to find out.
+ * Gets an array of streams, the content is the same as the list returned by
+ * mate_mixer_context_list_streams(). See mate_mixer_context_dup_devices() for
+ * the meaning of @generation and the lifetime of the array.
  *
- * Returns: %TRUE on success or %FALSE on failure.
+ * Returns: (transfer none) (element-type MateMixerStream): a read-only
+ * #GPtrArray of streams or %NULL if you are not connected to a sound system.
  */
-gboolean
-mate_mixer_context_set_default_input_stream (MateMixerContext *context,
-                                             MateMixerStream  *stream)
+GPtrArray *
+mate_mixer_context_dup_streams (MateMixerContext *context, guint *generation)
 {
-    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), FALSE);
-    g_return_val_if_fail (MATE_MIXER_IS_STREAM (stream), FALSE);
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), NULL);
 
     if (context->priv->state != MATE_MIXER_STATE_READY)
-        return FALSE;
+        return NULL;
 
-    return mate_mixer_backend_set_default_input_stream (context->priv->backend, stream);
+    return mate_mixer_backend_dup_streams (MATE_MIXER_BACKEND (context->priv->backend),
+                                           generation);
 }
 
 /**
- * mate_mixer_context_get_default_output_stream:
+ * mate_mixer_context_dup_stored_controls:
  * @context: a #MateMixerContext
+ * @generation: (out) (allow-none): return location for the generation number
+ * of the returned array
  *
- * Gets the default output stream. The returned stream is where sound output is
- * most likely directed to by default.
+ * Gets an array of stored controls, the content is the same as the list
+ * returned by mate_mixer_context_list_stored_controls(). See
+ * mate_mixer_context_dup_devices() for the meaning of @generation and the
+ * lifetime of the array.
  *
- * Returns: a #MateMixerStream or %NULL if there are no output streams in
- * the system.
+ * Returns: (transfer none) (element-type MateMixerStoredControl): a read-only
+ * #GPtrArray of stored controls or %NULL if you are not connected to a sound
+ * system.
  */
-MateMixerStream *
-mate_mixer_context_get_default_output_stream (MateMixerContext *context)
+GPtrArray *
+mate_mixer_context_dup_stored_controls (MateMixerContext *context, guint *generation)
 {
+    GPtrArray *controls;
+
     g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), NULL);
 
     if (context->priv->state != MATE_MIXER_STATE_READY)
         return NULL;
 
-    return mate_mixer_backend_get_default_output_stream (context->priv->backend);
+    controls = mate_mixer_backend_dup_stored_controls (MATE_MIXER_BACKEND (context->priv->backend),
+                                                       generation);
+    if (controls != NULL)
+        track_stored_controls (context, controls);
+
+    return controls;
 }
 
 /**
- * mate_mixer_context_set_default_output_stream:
+ * mate_mixer_context_find_role_controls:
  * @context: a #MateMixerContext
- * @stream: a #MateMixerStream to set as the default output stream
+ * @role: a #MateMixerStreamControlRole
  *
- * Changes the default output stream. The given @stream must be an output stream.
+ * Gets all stream controls and stored controls with the given role, for
+ * example the master controls of all streams.
  *
- * Changing the default output stream may not be supported by the sound system.
- * Use mate_mixer_context_get_backend_flags() to find out.
+ * The controls are looked up in an index which is kept up to date as controls
+ * are added and removed, so the cost of the call only depends on the number
+ * of returned controls. The order of the controls is undefined.
  *
- * Returns: %TRUE on success or %FALSE on failure.
+ * Returns: (transfer full) (element-type MateMixerStreamControl): a #GPtrArray
+ * of stream controls or %NULL if you are not connected to a sound system. The
+ * array should be released using g_ptr_array_unref() when no longer needed.
  */
-gboolean
-mate_mixer_context_set_default_output_stream (MateMixerContext *context,
-                                              MateMixerStream *stream)
+GPtrArray *
+mate_mixer_context_find_role_controls (MateMixerContext          *context,
+                                       MateMixerStreamControlRole role)
 {
-    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), FALSE);
-    g_return_val_if_fail (MATE_MIXER_IS_STREAM (stream), FALSE);
+    GPtrArray *controls;
+
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), NULL);
 
     if (context->priv->state != MATE_MIXER_STATE_READY)
-        return FALSE;
+        return NULL;
 
-    return mate_mixer_backend_set_default_output_stream (context->priv->backend, stream);
+    controls = mate_mixer_backend_find_role_controls (MATE_MIXER_BACKEND (context->priv->backend),
+                                                      role);
+    if (controls != NULL)
+        track_stored_controls (context, controls);
+
+    return controls;
 }
 
 /**
- * mate_mixer_context_get_backend_name:
+ * mate_mixer_context_find_media_role_controls:
  * @context: a #MateMixerContext
+ * @media_role: a #MateMixerStreamControlMediaRole
  *
- * Gets the name of the currently used sound system backend.
- *
- * This function will not work until the @context is connected to a sound system.
+ * Gets all stream controls and stored controls with the given media role.
+ * See mate_mixer_context_find_role_controls() for details.
  *
- * Returns: the name or %NULL on error.
+ * Returns: (transfer full) (element-type MateMixerStreamControl): a #GPtrArray
+ * of stream controls or %NULL if you are not connected to a sound system. The
+ * array should be released using g_ptr_array_unref() when no longer needed.
  */
-const gchar *
-mate_mixer_context_get_backend_name (MateMixerContext *context)
+GPtrArray *
+mate_mixer_context_find_media_role_controls (MateMixerContext               *context,
+                                             MateMixerStreamControlMediaRole media_role)
 {
+    GPtrArray *controls;
+
     g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), NULL);
 
-    if (context->priv->backend_chosen == FALSE)
+    if (context->priv->state != MATE_MIXER_STATE_READY)
         return NULL;
 
-    return mate_mixer_backend_module_get_info (context->priv->module)->name;
+    controls = mate_mixer_backend_find_media_role_controls (MATE_MIXER_BACKEND (context->priv->backend),
+                                                            media_role);
+    if (controls != NULL)
+        track_stored_controls (context, controls);
+
+    return controls;
 }
 
 /**
- * mate_mixer_context_get_backend_type:
+ * mate_mixer_context_find_app_id_controls:
  * @context: a #MateMixerContext
+ * @app_id: an application identifier
  *
- * Gets the type of the currently used sound system backend.
- *
- * This function will not work until the @context is connected to a sound system.
+ * Gets all stream controls which belong to the application with the given
+ * identifier, as returned by mate_mixer_app_info_get_id(). See
+ * mate_mixer_context_find_role_controls() for details.
  *
- * Returns: the backend type or %MATE_MIXER_BACKEND_UNKNOWN on error.
+ * Returns: (transfer full) (element-type MateMixerStreamControl): a #GPtrArray
+ * of stream controls or %NULL if you are not connected to a sound system. The
+ * array should be released using g_ptr_array_unref() when no longer needed.
  */
-MateMixerBackendType
-mate_mixer_context_get_backend_type (MateMixerContext *context)
+GPtrArray *
+mate_mixer_context_find_app_id_controls (MateMixerContext *context, const gchar *app_id)
 {
-    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), MATE_MIXER_BACKEND_UNKNOWN);
+    GPtrArray *controls;
 
-    if (context->priv->backend_chosen == FALSE)
-        return MATE_MIXER_BACKEND_UNKNOWN;
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), NULL);
+    g_return_val_if_fail (app_id != NULL, NULL);
 
-    return mate_mixer_backend_module_get_info (context->priv->module)->backend_type;
+    if (context->priv->state != MATE_MIXER_STATE_READY)
+        return NULL;
+
+    controls = mate_mixer_backend_find_app_id_controls (MATE_MIXER_BACKEND (context->priv->backend),
+                                                        app_id);
+    if (controls != NULL)
+        track_stored_controls (context, controls);
+
+    return controls;
 }
 
 /**
- * mate_mixer_context_get_backend_flags:
+ * mate_mixer_context_find_app_name_controls:
  * @context: a #MateMixerContext
+ * @app_name: an application name
  *
- * Gets the capability flags of the currently used sound system backend.
- *
- * This function will not work until the @context is connected to a sound system.
+ * Gets all stream controls which belong to the application with the given
+ * name, as returned by mate_mixer_app_info_get_name(). See
+ * mate_mixer_context_find_role_controls() for details.
  *
- * Returns: the capability flags.
+ * Returns: (transfer full) (element-type MateMixerStreamControl): a #GPtrArray
+ * of stream controls or %NULL if you are not connected to a sound system. The
+ * array should be released using g_ptr_array_unref() when no longer needed.
  */
-MateMixerBackendFlags
+GPtrArray *
+mate_mixer_context_find_app_name_controls (MateMixerContext *context, const gchar *app_name)
+{
+    GPtrArray *controls;
+
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), NULL);
+    g_return_val_if_fail (app_name != NULL, NULL);
+
+    if (context->priv->state != MATE_MIXER_STATE_READY)
+        return NULL;
+
+    controls = mate_mixer_backend_find_app_name_controls (MATE_MIXER_BACKEND (context->priv->backend),
+                                                          app_name);
+    if (controls != NULL)
+        track_stored_controls (context, controls);
+
+    return controls;
+}
+
+/**
+ * mate_mixer_context_fill_snapshot:
+ * @context: a #MateMixerContext
+ * @snapshot: a #MateMixerSnapshot
+ *
+ * Fills @snapshot with the current state of all streams, stream controls and
+ * stored controls, replacing its previous content.
+ *
+ * The same snapshot may be filled repeatedly, its memory is reused so that
+ * refreshing the state of the whole mixer does not allocate memory unless
+ * the number of streams, controls or channels grows. Use
+ * mate_mixer_context_get_generation() to find out whether a refresh is needed.
+ *
+ * Returns: %TRUE on success or %FALSE if you are not connected to a sound
+ * system, in which case @snapshot is left empty.
+ */
+gboolean
+mate_mixer_context_fill_snapshot (MateMixerContext *context, MateMixerSnapshot *snapshot)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), FALSE);
+    g_return_val_if_fail (snapshot != NULL, FALSE);
+
+    if (context->priv->state != MATE_MIXER_STATE_READY) {
+        _mate_mixer_snapshot_clear (snapshot);
+        return FALSE;
+    }
+
+    _mate_mixer_snapshot_fill (snapshot,
+                               MATE_MIXER_BACKEND (context->priv->backend),
+                               get_generation (context));
+    return TRUE;
+}
+
+/**
+ * mate_mixer_context_get_default_input_stream:
+ * @context: a #MateMixerContext
+ *
+ * Gets the default input stream. The returned stream is where sound input
+ * most likely comes from by default.
+ *
+ * Returns: a #MateMixerStream or %NULL if there is no default input stream.
+ */
+MateMixerStream *
+mate_mixer_context_get_default_input_stream (MateMixerContext *context)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), NULL);
+
+    if (context->priv->state != MATE_MIXER_STATE_READY)
+        return NULL;
+
+    return mate_mixer_backend_get_default_input_stream (context->priv->backend);
+}
+
+/**
+ * mate_mixer_context_set_default_input_stream:
+ * @context: a #MateMixerContext
+ * @stream: a #MateMixerStream to set as the default input stream
+ *
+ * Changes the default input stream. The given @stream must be an input stream.
+ *
+ * Changing the default input stream may not be supported by the sound system.
+ * Use mate_mixer_context_get_backend_flags() to find out.
+ *
+ * Returns: %TRUE on success or %FALSE on failure.
+ */
+gboolean
+mate_mixer_context_set_default_input_stream (MateMixerContext *context,
+                                             MateMixerStream  *stream)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), FALSE);
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM (stream), FALSE);
+
+    if (context->priv->state != MATE_MIXER_STATE_READY)
+        return FALSE;
+
+    return mate_mixer_backend_set_default_input_stream (context->priv->backend, stream);
+}
+
+/**
+ * mate_mixer_context_get_default_output_stream:
+ * @context: a #MateMixerContext
+ *
+ * Gets the default output stream. The returned stream is where sound output is
+ * most likely directed to by default.
+ *
+ * Returns: a #MateMixerStream or %NULL if there are no output streams in
+ * the system.
+ */
+MateMixerStream *
+mate_mixer_context_get_default_output_stream (MateMixerContext *context)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), NULL);
+
+    if (context->priv->state != MATE_MIXER_STATE_READY)
+        return NULL;
+
+    return mate_mixer_backend_get_default_output_stream (context->priv->backend);
+}
+
+/**
+ * mate_mixer_context_set_default_output_stream:
+ * @context: a #MateMixerContext
+ * @stream: a #MateMixerStream to set as the default output stream
+ *
+ * Changes the default output stream. The given @stream must be an output stream.
+ *
+ * Changing the default output stream may not be supported by the sound system.
+ * Use mate_mixer_context_get_backend_flags() to find out.
+ *
+ * Returns: %TRUE on success or %FALSE on failure.
+ */
+gboolean
+mate_mixer_context_set_default_output_stream (MateMixerContext *context,
+                                              MateMixerStream *stream)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), FALSE);
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM (stream), FALSE);
+
+    if (context->priv->state != MATE_MIXER_STATE_READY)
+        return FALSE;
+
+    return mate_mixer_backend_set_default_output_stream (context->priv->backend, stream);
+}
+
+/**
+ * mate_mixer_context_get_backend_name:
+ * @context: a #MateMixerContext
+ *
+ * Gets the name of the currently used sound system backend.
+ *
+ * This function will not work until the @context is connected to a sound system.
+ *
+ * Returns: the name or %NULL on error.
+ */
+const gchar *
+mate_mixer_context_get_backend_name (MateMixerContext *context)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), NULL);
+
+    if (context->priv->backend_chosen == FALSE)
+        return NULL;
+
+    return mate_mixer_backend_module_get_info (context->priv->module)->name;
+}
+
+/**
+ * mate_mixer_context_get_backend_type:
+ * @context: a #MateMixerContext
+ *
+ * Gets the type of the currently used sound system backend.
+ *
+ * This function will not work until the @context is connected to a sound system.
+ *
+ * Returns: the backend type or %MATE_MIXER_BACKEND_UNKNOWN on error.
+ */
+MateMixerBackendType
+mate_mixer_context_get_backend_type (MateMixerContext *context)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), MATE_MIXER_BACKEND_UNKNOWN);
+
+    if (context->priv->backend_chosen == FALSE)
+        return MATE_MIXER_BACKEND_UNKNOWN;
+
+    return mate_mixer_backend_module_get_info (context->priv->module)->backend_type;
+}
+
+/**
+ * mate_mixer_context_get_backend_flags:
+ * @context: a #MateMixerContext
+ *
+ * Gets the capability flags of the currently used sound system backend.
+ *
+ * This function will not work until the @context is connected to a sound system.
+ *
+ * Returns: the capability flags.
+ */
+MateMixerBackendFlags
 mate_mixer_context_get_backend_flags (MateMixerContext *context)
 {
     g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), MATE_MIXER_BACKEND_NO_FLAGS);
@@ -1216,6 +1864,106 @@ mate_mixer_context_get_backend_flags (MateMixerContext *context)
     return mate_mixer_backend_module_get_info (context->priv->module)->backend_flags;
 }
 
+/**
+ * mate_mixer_context_set_coalesce_changes:
+ * @context: a #MateMixerContext
+ * @coalesce: whether to enable the #MateMixerContext::changed signal
+ *
+ * Enables or disables collecting of changes for the #MateMixerContext::changed
+ * signal.
+ *
+ * When enabled, the context watches all the devices, streams, controls and
+ * switches and accumulates their changes, together with additions, removals
+ * and changes of the context itself, into a #MateMixerChangeSet which is
+ * delivered by a single #MateMixerContext::changed signal when the main loop
+ * becomes idle. A user interface may then redraw once per burst of changes
+ * instead of once per property change.
+ *
+ * The function may be called at any time, changes which are still pending
+ * when collecting is disabled are discarded.
+ */
+void
+mate_mixer_context_set_coalesce_changes (MateMixerContext *context, gboolean coalesce)
+{
+    g_return_if_fail (MATE_MIXER_IS_CONTEXT (context));
+
+    coalesce = !!coalesce;
+
+    if (context->priv->coalesce_changes == coalesce)
+        return;
+
+    context->priv->coalesce_changes = coalesce;
+
+    if (coalesce == TRUE) {
+        if (context->priv->backend_chosen == TRUE)
+            start_tracking (context);
+    } else {
+        stop_tracking (context);
+        discard_changes (context);
+    }
+}
+
+/**
+ * mate_mixer_context_get_coalesce_changes:
+ * @context: a #MateMixerContext
+ *
+ * Gets whether changes are collected for the #MateMixerContext::changed signal.
+ *
+ * Returns: %TRUE if the #MateMixerContext::changed signal is enabled or %FALSE
+ * otherwise.
+ */
+gboolean
+mate_mixer_context_get_coalesce_changes (MateMixerContext *context)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_CONTEXT (context), FALSE);
+
+    return context->priv->coalesce_changes;
+}
+
+/**
+ * mate_mixer_context_freeze_changes:
+ * @context: a #MateMixerContext
+ *
+ * Holds back the #MateMixerContext::changed signal until
+ * mate_mixer_context_thaw_changes() is called, the changes keep being collected
+ * in the meantime.
+ *
+ * This is useful when an application makes several changes at once and wants
+ * to receive them in a single signal. Calls to this function may be nested.
+ */
+void
+mate_mixer_context_freeze_changes (MateMixerContext *context)
+{
+    g_return_if_fail (MATE_MIXER_IS_CONTEXT (context));
+
+    context->priv->freeze_count++;
+}
+
+/**
+ * mate_mixer_context_thaw_changes:
+ * @context: a #MateMixerContext
+ *
+ * Reverts the effect of a previous call to mate_mixer_context_freeze_changes().
+ *
+ * When the freeze count drops to zero, the changes collected in the meantime
+ * are delivered immediately.
+ */
+void
+mate_mixer_context_thaw_changes (MateMixerContext *context)
+{
+    g_return_if_fail (MATE_MIXER_IS_CONTEXT (context));
+    g_return_if_fail (context->priv->freeze_count > 0);
+
+    if (--context->priv->freeze_count > 0)
+        return;
+
+    if (context->priv->changes_tag != 0) {
+        g_source_remove (context->priv->changes_tag);
+        context->priv->changes_tag = 0;
+    }
+    emit_changes (context);
+}
+
 static void
 on_backend_state_notify (MateMixerBackend *backend,
                          GParamSpec       *pspec,
@@ -1262,6 +2010,18 @@ on_backend_device_added (MateMixerBackend *backend,
                          const gchar      *name,
                          MateMixerContext *context)
 {
+    context->priv->generation++;
+
+    if (context->priv->coalesce_changes == TRUE) {
+        MateMixerDevice *device;
+
+        device = mate_mixer_backend_get_device (backend, name);
+        if G_LIKELY (device != NULL) {
+            track_device (context, device);
+            queue_change (context, device, MATE_MIXER_CHANGE_ADDED);
+        }
+    }
+
     g_signal_emit (G_OBJECT (context),
                    signals[DEVICE_ADDED],
                    0,
@@ -1273,6 +2033,10 @@ on_backend_device_removed (MateMixerBackend *backend,
                            const gchar      *name,
                            MateMixerContext *context)
 {
+    context->priv->generation++;
+
+    queue_name (context, MATE_MIXER_TYPE_DEVICE, name, MATE_MIXER_CHANGE_REMOVED);
+
     g_signal_emit (G_OBJECT (context),
                    signals[DEVICE_REMOVED],
                    0,
@@ -1284,6 +2048,18 @@ on_backend_stream_added (MateMixerBackend *backend,
                          const gchar      *name,
                          MateMixerContext *context)
 {
+    context->priv->generation++;
+
+    if (context->priv->coalesce_changes == TRUE) {
+        MateMixerStream *stream;
+
+        stream = mate_mixer_backend_get_stream (backend, name);
+        if G_LIKELY (stream != NULL) {
+            track_stream (context, stream);
+            queue_change (context, stream, MATE_MIXER_CHANGE_ADDED);
+        }
+    }
+
     g_signal_emit (G_OBJECT (context),
                    signals[STREAM_ADDED],
                    0,
@@ -1295,6 +2071,10 @@ on_backend_stream_removed (MateMixerBackend *backend,
                            const gchar      *name,
                            MateMixerContext *context)
 {
+    context->priv->generation++;
+
+    queue_name (context, MATE_MIXER_TYPE_STREAM, name, MATE_MIXER_CHANGE_REMOVED);
+
     g_signal_emit (G_OBJECT (context),
                    signals[STREAM_REMOVED],
                    0,
@@ -1306,6 +2086,22 @@ on_backend_stored_control_added (MateMixerBackend *backend,
                                  const gchar      *name,
                                  MateMixerContext *context)
 {
+    context->priv->generation++;
+
+    /* Avoid creating the stored controls of the initial list, which the
+     * backend creates when they are first requested */
+    if (mate_mixer_backend_get_loading_flags (backend) & MATE_MIXER_TRACK_STORED_CONTROLS) {
+        queue_name (context, MATE_MIXER_TYPE_STORED_CONTROL, name, MATE_MIXER_CHANGE_ADDED);
+    } else if (context->priv->coalesce_changes == TRUE) {
+        MateMixerStoredControl *control;
+
+        control = mate_mixer_backend_get_stored_control (backend, name);
+        if G_LIKELY (control != NULL) {
+            track_object (context, control);
+            queue_change (context, control, MATE_MIXER_CHANGE_ADDED);
+        }
+    }
+
     g_signal_emit (G_OBJECT (context),
                    signals[STORED_CONTROL_ADDED],
                    0,
@@ -1317,17 +2113,57 @@ on_backend_stored_control_removed (MateMixerBackend *backend,
                                    const gchar      *name,
                                    MateMixerContext *context)
 {
+    context->priv->generation++;
+
+    queue_name (context, MATE_MIXER_TYPE_STORED_CONTROL, name, MATE_MIXER_CHANGE_REMOVED);
+
     g_signal_emit (G_OBJECT (context),
                    signals[STORED_CONTROL_REMOVED],
                    0,
                    name);
 }
 
+static void
+on_backend_topology_changed (MateMixerBackend   *backend,
+                             MateMixerChangeSet *changes,
+                             MateMixerContext   *context)
+{
+    /* The first change after connecting reports everything as added, replace
+     * it with the differences from the cached state */
+    if (context->priv->cache != NULL) {
+        reconcile_cache (context);
+        return;
+    }
+
+    g_signal_emit (G_OBJECT (context),
+                   signals[TOPOLOGY_CHANGED],
+                   0,
+                   changes);
+
+    if (context->priv->cache_enabled == TRUE)
+        schedule_cache_save (context);
+}
+
+static void
+on_backend_loaded (MateMixerBackend    *backend,
+                   MateMixerTrackFlags  flags,
+                   MateMixerContext    *context)
+{
+    g_signal_emit (G_OBJECT (context),
+                   signals[LOADED],
+                   0,
+                   flags);
+}
+
 static void
 on_backend_default_input_stream_notify (MateMixerBackend *backend,
                                         GParamSpec       *pspec,
                                         MateMixerContext *context)
 {
+    context->priv->generation++;
+
+    queue_change (context, context, MATE_MIXER_CHANGE_DEFAULT_INPUT_STREAM);
+
     g_object_notify_by_pspec (G_OBJECT (context), properties[PROP_DEFAULT_INPUT_STREAM]);
 }
 
@@ -1336,6 +2172,10 @@ on_backend_default_output_stream_notify (MateMixerBackend *backend,
                                          GParamSpec       *pspec,
                                          MateMixerContext *context)
 {
+    context->priv->generation++;
+
+    queue_change (context, context, MATE_MIXER_CHANGE_DEFAULT_OUTPUT_STREAM);
+
     g_object_notify_by_pspec (G_OBJECT (context), properties[PROP_DEFAULT_OUTPUT_STREAM]);
 }
 
@@ -1374,6 +2214,7 @@ try_next_backend (MateMixerContext *context)
 
     mate_mixer_backend_set_app_info (context->priv->backend, context->priv->app_info);
     mate_mixer_backend_set_server_address (context->priv->backend, context->priv->server_address);
+    mate_mixer_backend_set_track_flags (context->priv->backend, context->priv->track_flags);
 
     g_debug ("Trying to open backend %s", info->name);
 
@@ -1408,6 +2249,7 @@ change_state (MateMixerContext *context, MateMixerState state)
         return;
 
     context->priv->state = state;
+    context->priv->generation++;
 
     if (state == MATE_MIXER_STATE_READY && context->priv->backend_chosen == FALSE) {
         /* It is safe to connect to the backend signals after reaching the READY
@@ -1438,6 +2280,14 @@ change_state (MateMixerContext *context, MateMixerState state)
                           "stored-control-removed",
                           G_CALLBACK (on_backend_stored_control_removed),
                           context);
+        g_signal_connect (G_OBJECT (context->priv->backend),
+                          "topology-changed",
+                          G_CALLBACK (on_backend_topology_changed),
+                          context);
+        g_signal_connect (G_OBJECT (context->priv->backend),
+                          "loaded",
+                          G_CALLBACK (on_backend_loaded),
+                          context);
 
         g_signal_connect (G_OBJECT (context->priv->backend),
                           "notify::default-input-stream",
@@ -1449,18 +2299,44 @@ change_state (MateMixerContext *context, MateMixerState state)
                           context);
 
         context->priv->backend_chosen = TRUE;
+
+        if (context->priv->coalesce_changes == TRUE)
+            start_tracking (context);
+
+        /* Without a pending topology change there is nothing to wait for */
+        if (context->priv->cache != NULL &&
+            _mate_mixer_backend_has_topology_change (context->priv->backend) == FALSE)
+            reconcile_cache (context);
     }
 
+    queue_change (context, context, MATE_MIXER_CHANGE_STATE);
+
     g_object_notify_by_pspec (G_OBJECT (context), properties[PROP_STATE]);
 }
 
 static void
 close_context (MateMixerContext *context)
 {
+    stop_tracking (context);
+
+    if (context->priv->cache_tag != 0) {
+        g_source_remove (context->priv->cache_tag);
+        context->priv->cache_tag = 0;
+    }
+
+    /* Save the final volumes, they are not saved as they change */
+    if (context->priv->cache_enabled == TRUE && context->priv->cache == NULL &&
+        context->priv->state == MATE_MIXER_STATE_READY)
+        save_cache (context);
+
     if (context->priv->backend != NULL) {
         g_signal_handlers_disconnect_by_data (G_OBJECT (context->priv->backend),
                                               context);
 
+        /* Keep the changes counted by the backend as the number must never
+         * go back */
+        context->priv->generation = get_generation (context);
+
         mate_mixer_backend_close (context->priv->backend);
         g_clear_object (&context->priv->backend);
     }
@@ -1469,3 +2345,489 @@ close_context (MateMixerContext *context)
 
     context->priv->backend_chosen = FALSE;
 }
+
+static guint
+get_generation (MateMixerContext *context)
+{
+    if (context->priv->backend == NULL)
+        return context->priv->generation;
+
+    return context->priv->generation +
+           mate_mixer_backend_get_generation (context->priv->backend);
+}
+
+static gchar *
+get_cache_filename (MateMixerContext *context)
+{
+    gchar *name;
+    gchar *filename;
+
+    /* Contexts tracking different kinds of objects would keep replacing
+     * each other's state, so each set of track flags has its own file */
+    name = g_strdup_printf ("topology-%02x.cache", context->priv->track_flags);
+
+    filename = g_build_filename (g_get_user_cache_dir (), "libmatemixer", name, NULL);
+    g_free (name);
+    return filename;
+}
+
+static void
+load_cache (MateMixerContext *context)
+{
+    gchar *filename;
+
+    filename = get_cache_filename (context);
+
+    context->priv->cache = _mate_mixer_snapshot_new_from_file (filename);
+    g_free (filename);
+}
+
+static void
+save_cache (MateMixerContext *context)
+{
+    MateMixerSnapshot *snapshot;
+    gchar             *filename;
+    gchar             *dirname;
+
+    filename = get_cache_filename (context);
+    dirname  = g_path_get_dirname (filename);
+
+    if (g_mkdir_with_parents (dirname, 0700) == 0) {
+        gchar *source = get_cache_source (context);
+
+        snapshot = mate_mixer_snapshot_new ();
+
+        _mate_mixer_snapshot_fill (snapshot,
+                                   context->priv->backend,
+                                   get_generation (context));
+        _mate_mixer_snapshot_set_source (snapshot, source);
+        _mate_mixer_snapshot_save (snapshot, filename);
+
+        mate_mixer_snapshot_unref (snapshot);
+        g_free (source);
+    } else
+        g_debug ("Failed to create cache directory %s", dirname);
+
+    g_free (dirname);
+    g_free (filename);
+}
+
+static void
+schedule_cache_save (MateMixerContext *context)
+{
+    GSource *source;
+
+    if (context->priv->cache_tag != 0)
+        return;
+
+    /* Hotplugging and applications starting and stopping their playback cause
+     * frequent changes, save the state once things have calmed down */
+    source = g_timeout_source_new_seconds (5);
+    g_source_set_callback (source,
+                           (GSourceFunc) dispatch_cache_save,
+                           context,
+                           NULL);
+
+    context->priv->cache_tag =
+        g_source_attach (source, g_main_context_get_thread_default ());
+
+    g_source_unref (source);
+}
+
+static gboolean
+dispatch_cache_save (MateMixerContext *context)
+{
+    context->priv->cache_tag = 0;
+
+    save_cache (context);
+    return G_SOURCE_REMOVE;
+}
+
+static gchar *
+get_cache_source (MateMixerContext *context)
+{
+    const MateMixerBackendInfo *info;
+    const gchar                *server;
+
+    info   = mate_mixer_backend_module_get_info (context->priv->module);
+    server = mate_mixer_backend_get_server_name (context->priv->backend);
+
+    return g_strdup_printf ("%s:%s", info->name, (server != NULL) ? server : "");
+}
+
+static void
+reconcile_cache (MateMixerContext *context)
+{
+    MateMixerSnapshot  *snapshot;
+    MateMixerChangeSet *changes;
+    gchar              *source;
+
+    snapshot = mate_mixer_snapshot_new ();
+    changes  = _mate_mixer_change_set_new ();
+    source   = get_cache_source (context);
+
+    /* A cache written for a different sound system or server has nothing in
+     * common with the current state, report everything as added instead */
+    if (g_strcmp0 (source, _mate_mixer_snapshot_get_source (context->priv->cache)) != 0) {
+        g_debug ("Discarding cache of a different sound server");
+
+        mate_mixer_snapshot_unref (context->priv->cache);
+        context->priv->cache = mate_mixer_snapshot_new ();
+    }
+
+    _mate_mixer_snapshot_fill (snapshot,
+                               context->priv->backend,
+                               get_generation (context));
+    _mate_mixer_snapshot_compare (snapshot, context->priv->cache, changes);
+
+    mate_mixer_snapshot_unref (context->priv->cache);
+    context->priv->cache = NULL;
+
+    g_free (source);
+
+    if (_mate_mixer_change_set_is_empty (changes) == FALSE)
+        g_signal_emit (G_OBJECT (context),
+                       signals[TOPOLOGY_CHANGED],
+                       0,
+                       changes);
+
+    mate_mixer_change_set_unref (changes);
+    mate_mixer_snapshot_unref (snapshot);
+
+    schedule_cache_save (context);
+}
+
+static void
+on_tracked_object_notify (GObject          *object,
+                          GParamSpec       *pspec,
+                          MateMixerContext *context)
+{
+    queue_change (context, object, _mate_mixer_change_flags_from_pspec (pspec));
+}
+
+static void
+on_tracked_object_finalized (MateMixerContext *context, GObject *object)
+{
+    g_hash_table_remove (context->priv->tracked, object);
+}
+
+static void
+on_tracked_children_changed (GObject          *object,
+                             const gchar      *name,
+                             MateMixerContext *context)
+{
+    queue_change (context, object, MATE_MIXER_CHANGE_CHILDREN);
+}
+
+static void
+on_device_switch_added (MateMixerDevice  *device,
+                        const gchar      *name,
+                        MateMixerContext *context)
+{
+    MateMixerDeviceSwitch *swtch;
+
+    swtch = mate_mixer_device_get_switch (device, name);
+    if G_LIKELY (swtch != NULL)
+        track_object (context, swtch);
+
+    queue_change (context, device, MATE_MIXER_CHANGE_CHILDREN);
+}
+
+static void
+on_stream_control_added (MateMixerStream  *stream,
+                         const gchar      *name,
+                         MateMixerContext *context)
+{
+    MateMixerStreamControl *control;
+
+    control = mate_mixer_stream_get_control (stream, name);
+    if G_LIKELY (control != NULL) {
+        track_object (context, control);
+
+        queue_change (context, control, MATE_MIXER_CHANGE_ADDED);
+    }
+
+    queue_change (context, stream, MATE_MIXER_CHANGE_CHILDREN);
+}
+
+static void
+on_stream_control_removed (MateMixerStream  *stream,
+                           const gchar      *name,
+                           MateMixerContext *context)
+{
+    queue_name (context, MATE_MIXER_TYPE_STREAM_CONTROL, name, MATE_MIXER_CHANGE_REMOVED);
+
+    queue_change (context, stream, MATE_MIXER_CHANGE_CHILDREN);
+}
+
+static void
+on_stream_switch_added (MateMixerStream  *stream,
+                        const gchar      *name,
+                        MateMixerContext *context)
+{
+    MateMixerStreamSwitch *swtch;
+
+    swtch = mate_mixer_stream_get_switch (stream, name);
+    if G_LIKELY (swtch != NULL)
+        track_object (context, swtch);
+
+    queue_change (context, stream, MATE_MIXER_CHANGE_CHILDREN);
+}
+
+static gboolean
+track_object (MateMixerContext *context, gpointer object)
+{
+    if (g_hash_table_contains (context->priv->tracked, object) == TRUE)
+        return FALSE;
+
+    g_hash_table_add (context->priv->tracked, object);
+
+    /* Objects are not referenced, the weak reference removes the object from
+     * the table when it is finalized */
+    g_object_weak_ref (G_OBJECT (object),
+                       (GWeakNotify) on_tracked_object_finalized,
+                       context);
+
+    g_signal_connect (G_OBJECT (object),
+                      "notify",
+                      G_CALLBACK (on_tracked_object_notify),
+                      context);
+    return TRUE;
+}
+
+static void
+track_device (MateMixerContext *context, MateMixerDevice *device)
+{
+    const GList *list;
+
+    if (track_object (context, device) == FALSE)
+        return;
+
+    /* Streams of the device are tracked through the context signals */
+    g_signal_connect (G_OBJECT (device),
+                      "stream-added",
+                      G_CALLBACK (on_tracked_children_changed),
+                      context);
+    g_signal_connect (G_OBJECT (device),
+                      "stream-removed",
+                      G_CALLBACK (on_tracked_children_changed),
+                      context);
+    g_signal_connect (G_OBJECT (device),
+                      "switch-added",
+                      G_CALLBACK (on_device_switch_added),
+                      context);
+    g_signal_connect (G_OBJECT (device),
+                      "switch-removed",
+                      G_CALLBACK (on_tracked_children_changed),
+                      context);
+
+    list = mate_mixer_device_list_switches (device);
+    while (list != NULL) {
+        track_object (context, list->data);
+        list = list->next;
+    }
+}
+
+static void
+track_stream (MateMixerContext *context, MateMixerStream *stream)
+{
+    const GList *list;
+
+    if (track_object (context, stream) == FALSE)
+        return;
+
+    g_signal_connect (G_OBJECT (stream),
+                      "control-added",
+                      G_CALLBACK (on_stream_control_added),
+                      context);
+    g_signal_connect (G_OBJECT (stream),
+                      "control-removed",
+                      G_CALLBACK (on_stream_control_removed),
+                      context);
+    g_signal_connect (G_OBJECT (stream),
+                      "switch-added",
+                      G_CALLBACK (on_stream_switch_added),
+                      context);
+    g_signal_connect (G_OBJECT (stream),
+                      "switch-removed",
+                      G_CALLBACK (on_tracked_children_changed),
+                      context);
+
+    list = mate_mixer_stream_list_controls (stream);
+    while (list != NULL) {
+        track_object (context, list->data);
+        list = list->next;
+    }
+
+    list = mate_mixer_stream_list_switches (stream);
+    while (list != NULL) {
+        track_object (context, list->data);
+        list = list->next;
+    }
+}
+
+static void
+track_stored_control (MateMixerContext *context, gpointer control)
+{
+    /* Stored controls are only created when they are requested, start tracking
+     * them once they are handed out */
+    if (context->priv->coalesce_changes == TRUE && MATE_MIXER_IS_STORED_CONTROL (control))
+        track_object (context, control);
+}
+
+static void
+track_stored_controls (MateMixerContext *context, GPtrArray *controls)
+{
+    guint i;
+
+    if (context->priv->coalesce_changes == FALSE)
+        return;
+
+    for (i = 0; i < controls->len; i++)
+        track_stored_control (context, g_ptr_array_index (controls, i));
+}
+
+static void
+start_tracking (MateMixerContext *context)
+{
+    const GList *list;
+    GList       *created;
+    GList       *item;
+
+    list = mate_mixer_backend_list_devices (context->priv->backend);
+    while (list != NULL) {
+        track_device (context, MATE_MIXER_DEVICE (list->data));
+        list = list->next;
+    }
+
+    list = mate_mixer_backend_list_streams (context->priv->backend);
+    while (list != NULL) {
+        track_stream (context, MATE_MIXER_STREAM (list->data));
+        list = list->next;
+    }
+
+    /* Listing the stored controls would make the backend create all of them,
+     * the rest is tracked when handed out */
+    created = mate_mixer_backend_list_created_stored_controls (context->priv->backend);
+    for (item = created; item != NULL; item = item->next)
+        track_object (context, item->data);
+
+    g_list_free (created);
+}
+
+static void
+stop_tracking (MateMixerContext *context)
+{
+    GHashTableIter iter;
+    gpointer       object;
+
+    g_hash_table_iter_init (&iter, context->priv->tracked);
+
+    while (g_hash_table_iter_next (&iter, &object, NULL) == TRUE) {
+        g_signal_handlers_disconnect_by_data (G_OBJECT (object), context);
+        g_object_weak_unref (G_OBJECT (object),
+                             (GWeakNotify) on_tracked_object_finalized,
+                             context);
+
+        g_hash_table_iter_remove (&iter);
+    }
+}
+
+static void
+queue_change (MateMixerContext     *context,
+              gpointer              object,
+              MateMixerChangeFlags  flags)
+{
+    if (context->priv->coalesce_changes == FALSE)
+        return;
+
+    if (context->priv->changes == NULL)
+        context->priv->changes = _mate_mixer_change_set_new ();
+
+    _mate_mixer_change_set_add_object (context->priv->changes, G_OBJECT (object), flags);
+
+    schedule_changes (context);
+}
+
+static void
+queue_name (MateMixerContext     *context,
+            GType                 type,
+            const gchar          *name,
+            MateMixerChangeFlags  flags)
+{
+    if (context->priv->coalesce_changes == FALSE)
+        return;
+
+    if (context->priv->changes == NULL)
+        context->priv->changes = _mate_mixer_change_set_new ();
+
+    _mate_mixer_change_set_add_name (context->priv->changes, type, name, flags);
+
+    schedule_changes (context);
+}
+
+static void
+schedule_changes (MateMixerContext *context)
+{
+    GSource *source;
+
+    if (context->priv->freeze_count > 0 || context->priv->changes_tag != 0)
+        return;
+
+    /* Deliver the changes when the main loop has no other events to process,
+     * this merges everything the sound system sends in a burst */
+    source = g_idle_source_new ();
+    g_source_set_callback (source,
+                           (GSourceFunc) dispatch_changes,
+                           context,
+                           NULL);
+
+    context->priv->changes_tag =
+        g_source_attach (source, g_main_context_get_thread_default ());
+
+    g_source_unref (source);
+}
+
+static gboolean
+dispatch_changes (MateMixerContext *context)
+{
+    context->priv->changes_tag = 0;
+
+    emit_changes (context);
+    return G_SOURCE_REMOVE;
+}
+
+static void
+emit_changes (MateMixerContext *context)
+{
+    MateMixerChangeSet *changes;
+
+    if (context->priv->changes == NULL)
+        return;
+
+    /* Detach the set first, handlers may cause further changes */
+    changes = context->priv->changes;
+    context->priv->changes = NULL;
+
+    if (_mate_mixer_change_set_is_empty (changes) == FALSE)
+        g_signal_emit (G_OBJECT (context),
+                       signals[CHANGED],
+                       0,
+                       changes);
+
+    mate_mixer_change_set_unref (changes);
+}
+
+static void
+discard_changes (MateMixerContext *context)
+{
+    if (context->priv->changes_tag != 0) {
+        g_source_remove (context->priv->changes_tag);
+        context->priv->changes_tag = 0;
+    }
+
+    if (context->priv->changes != NULL) {
+        mate_mixer_change_set_unref (context->priv->changes);
+        context->priv->changes = NULL;
+    }
+}
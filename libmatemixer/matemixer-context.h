@@ -67,18 +67,24 @@ struct _MateMixerContextClass
     GObjectClass parent_class;
 
     /*< private >*/
-    void (*device_added)           (MateMixerContext *context,
-                                    const gchar      *name);
-    void (*device_removed)         (MateMixerContext *context,
-                                    const gchar      *name);
-    void (*stream_added)           (MateMixerContext *context,
-                                    const gchar      *name);
-    void (*stream_removed)         (MateMixerContext *context,
-                                    const gchar      *name);
-    void (*stored_control_added)   (MateMixerContext *context,
-                                    const gchar      *name);
-    void (*stored_control_removed) (MateMixerContext *context,
-                                    const gchar      *name);
+    void (*device_added)           (MateMixerContext   *context,
+                                    const gchar        *name);
+    void (*device_removed)         (MateMixerContext   *context,
+                                    const gchar        *name);
+    void (*stream_added)           (MateMixerContext   *context,
+                                    const gchar        *name);
+    void (*stream_removed)         (MateMixerContext   *context,
+                                    const gchar        *name);
+    void (*stored_control_added)   (MateMixerContext   *context,
+                                    const gchar        *name);
+    void (*stored_control_removed) (MateMixerContext   *context,
+                                    const gchar        *name);
+    void (*changed)                (MateMixerContext   *context,
+                                    MateMixerChangeSet *changes);
+    void (*topology_changed)       (MateMixerContext   *context,
+                                    MateMixerChangeSet *changes);
+    void (*loaded)                 (MateMixerContext    *context,
+                                    MateMixerTrackFlags  flags);
 };
 
 GType                   mate_mixer_context_get_type                  (void) G_GNUC_CONST;
@@ -98,10 +104,21 @@ gboolean                mate_mixer_context_set_app_icon              (MateMixerC
 gboolean                mate_mixer_context_set_server_address        (MateMixerContext     *context,
                                                                       const gchar          *address);
 
+gboolean                mate_mixer_context_set_track_flags           (MateMixerContext     *context,
+                                                                      MateMixerTrackFlags   flags);
+MateMixerTrackFlags     mate_mixer_context_get_track_flags           (MateMixerContext     *context);
+
+gboolean                mate_mixer_context_set_cache_enabled         (MateMixerContext     *context,
+                                                                      gboolean              enabled);
+gboolean                mate_mixer_context_get_cache_enabled         (MateMixerContext     *context);
+MateMixerSnapshot *     mate_mixer_context_get_cached_snapshot       (MateMixerContext     *context);
+
 gboolean                mate_mixer_context_open                      (MateMixerContext     *context);
 void                    mate_mixer_context_close                     (MateMixerContext     *context);
 
 MateMixerState          mate_mixer_context_get_state                 (MateMixerContext     *context);
+guint                   mate_mixer_context_get_generation            (MateMixerContext     *context);
+MateMixerTrackFlags     mate_mixer_context_get_loading_flags         (MateMixerContext     *context);
 
 MateMixerDevice *       mate_mixer_context_get_device                (MateMixerContext     *context,
                                                                       const gchar          *name);
@@ -114,6 +131,25 @@ const GList *           mate_mixer_context_list_devices              (MateMixerC
 const GList *           mate_mixer_context_list_streams              (MateMixerContext     *context);
 const GList *           mate_mixer_context_list_stored_controls      (MateMixerContext     *context);
 
+GPtrArray *             mate_mixer_context_dup_devices               (MateMixerContext     *context,
+                                                                      guint                *generation);
+GPtrArray *             mate_mixer_context_dup_streams               (MateMixerContext     *context,
+                                                                      guint                *generation);
+GPtrArray *             mate_mixer_context_dup_stored_controls       (MateMixerContext     *context,
+                                                                      guint                *generation);
+
+GPtrArray *             mate_mixer_context_find_role_controls        (MateMixerContext     *context,
+                                                                      MateMixerStreamControlRole role);
+GPtrArray *             mate_mixer_context_find_media_role_controls  (MateMixerContext     *context,
+                                                                      MateMixerStreamControlMediaRole media_role);
+GPtrArray *             mate_mixer_context_find_app_id_controls      (MateMixerContext     *context,
+                                                                      const gchar          *app_id);
+GPtrArray *             mate_mixer_context_find_app_name_controls    (MateMixerContext     *context,
+                                                                      const gchar          *app_name);
+
+gboolean                mate_mixer_context_fill_snapshot             (MateMixerContext     *context,
+                                                                      MateMixerSnapshot    *snapshot);
+
 MateMixerStream *       mate_mixer_context_get_default_input_stream  (MateMixerContext     *context);
 gboolean                mate_mixer_context_set_default_input_stream  (MateMixerContext     *context,
                                                                       MateMixerStream      *stream);
@@ -126,6 +162,13 @@ const gchar *           mate_mixer_context_get_backend_name          (MateMixerC
 MateMixerBackendType    mate_mixer_context_get_backend_type          (MateMixerContext     *context);
 MateMixerBackendFlags   mate_mixer_context_get_backend_flags         (MateMixerContext     *context);
 
+void                    mate_mixer_context_set_coalesce_changes      (MateMixerContext     *context,
+                                                                      gboolean              coalesce);
+gboolean                mate_mixer_context_get_coalesce_changes      (MateMixerContext     *context);
+
+void                    mate_mixer_context_freeze_changes            (MateMixerContext     *context);
+void                    mate_mixer_context_thaw_changes              (MateMixerContext     *context);
+
 G_END_DECLS
 
 #endif /* MATEMIXER_CONTEXT_H */
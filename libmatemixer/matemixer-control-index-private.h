@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef MATEMIXER_CONTROL_INDEX_PRIVATE_H
+#define MATEMIXER_CONTROL_INDEX_PRIVATE_H
+
+#include <glib.h>
+
+#include "matemixer-enums.h"
+#include "matemixer-types.h"
+
+G_BEGIN_DECLS
+
+/*
+ * Secondary indexes of stream controls keyed by role, media role and the
+ * identifier and name of the owning application.
+ *
+ * Controls are identified by the stream they belong to and their name, which
+ * allows removing a control after the stream has already forgotten it. The
+ * stream is NULL for stored controls.
+ *
+ * The generation number of the index is incremented each time a property of
+ * any of the indexed controls changes.
+ */
+typedef struct _MateMixerControlIndex  MateMixerControlIndex;
+
+MateMixerControlIndex *_mate_mixer_control_index_new              (void);
+void                   _mate_mixer_control_index_free             (MateMixerControlIndex          *index);
+
+void                   _mate_mixer_control_index_add              (MateMixerControlIndex          *index,
+                                                                   MateMixerStream                *stream,
+                                                                   MateMixerStreamControl         *control);
+void                   _mate_mixer_control_index_remove           (MateMixerControlIndex          *index,
+                                                                   MateMixerStream                *stream,
+                                                                   const gchar                    *name);
+void                   _mate_mixer_control_index_remove_stream    (MateMixerControlIndex          *index,
+                                                                   MateMixerStream                *stream);
+void                   _mate_mixer_control_index_clear            (MateMixerControlIndex          *index);
+
+guint                  _mate_mixer_control_index_get_generation   (MateMixerControlIndex          *index);
+
+GPtrArray *            _mate_mixer_control_index_find_role        (MateMixerControlIndex          *index,
+                                                                   MateMixerStreamControlRole      role);
+GPtrArray *            _mate_mixer_control_index_find_media_role  (MateMixerControlIndex          *index,
+                                                                   MateMixerStreamControlMediaRole media_role);
+GPtrArray *            _mate_mixer_control_index_find_app_id      (MateMixerControlIndex          *index,
+                                                                   const gchar                    *app_id);
+GPtrArray *            _mate_mixer_control_index_find_app_name    (MateMixerControlIndex          *index,
+                                                                   const gchar                    *app_name);
+
+G_END_DECLS
+
+#endif /* MATEMIXER_CONTROL_INDEX_PRIVATE_H */
@@ -0,0 +1,383 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include "matemixer-app-info.h"
+#include "matemixer-control-index-private.h"
+#include "matemixer-enums.h"
+#include "matemixer-stream-control.h"
+
+typedef struct
+{
+    MateMixerStreamControl         *control;
+    MateMixerStream                *stream;
+    const gchar                    *name;
+    MateMixerStreamControlRole      role;
+    MateMixerStreamControlMediaRole media_role;
+    const gchar                    *app_id;
+    const gchar                    *app_name;
+    gulong                          notify_id;
+} ControlEntry;
+
+struct _MateMixerControlIndex
+{
+    GHashTable *entries;
+    GHashTable *names;
+    GHashTable *roles;
+    GHashTable *media_roles;
+    GHashTable *app_ids;
+    GHashTable *app_names;
+    guint       generation;
+};
+
+static void         free_entry        (ControlEntry          *entry);
+
+static void         on_control_notify (MateMixerStreamControl *control,
+                                       GParamSpec            *pspec,
+                                       MateMixerControlIndex  *index);
+
+static GHashTable * new_bucket_table  (GHashFunc              hash_func,
+                                       GEqualFunc             key_equal_func,
+                                       GDestroyNotify         key_destroy_func);
+
+static void         bucket_add        (GHashTable            *table,
+                                       gconstpointer          key,
+                                       ControlEntry          *entry);
+static const gchar *bucket_add_string (GHashTable            *table,
+                                       const gchar           *key,
+                                       ControlEntry          *entry);
+static void         bucket_remove     (GHashTable            *table,
+                                       gconstpointer          key,
+                                       ControlEntry          *entry);
+static GPtrArray *  bucket_dup        (GHashTable            *table,
+                                       gconstpointer          key);
+
+static void         remove_entry      (ControlEntry          *entry,
+                                       MateMixerControlIndex  *index);
+
+MateMixerControlIndex *
+_mate_mixer_control_index_new (void)
+{
+    MateMixerControlIndex *index;
+
+    index = g_slice_new (MateMixerControlIndex);
+
+    /* The entries table owns the entries, each of the other tables maps a key
+     * to a set of entries; the string keys are owned by the tables and shared
+     * with the entries in the set */
+    index->entries     = g_hash_table_new_full (g_direct_hash,
+                                                g_direct_equal,
+                                                NULL,
+                                                (GDestroyNotify) free_entry);
+    index->names       = new_bucket_table (g_str_hash, g_str_equal, g_free);
+    index->roles       = new_bucket_table (g_direct_hash, g_direct_equal, NULL);
+    index->media_roles = new_bucket_table (g_direct_hash, g_direct_equal, NULL);
+    index->app_ids     = new_bucket_table (g_str_hash, g_str_equal, g_free);
+    index->app_names   = new_bucket_table (g_str_hash, g_str_equal, g_free);
+    index->generation  = 0;
+    return index;
+}
+
+void
+_mate_mixer_control_index_free (MateMixerControlIndex *index)
+{
+    if (index == NULL)
+        return;
+
+    _mate_mixer_control_index_clear (index);
+
+    g_hash_table_unref (index->entries);
+    g_hash_table_unref (index->names);
+    g_hash_table_unref (index->roles);
+    g_hash_table_unref (index->media_roles);
+    g_hash_table_unref (index->app_ids);
+    g_hash_table_unref (index->app_names);
+
+    g_slice_free (MateMixerControlIndex, index);
+}
+
+void
+_mate_mixer_control_index_add (MateMixerControlIndex  *index,
+                               MateMixerStream        *stream,
+                               MateMixerStreamControl *control)
+{
+    ControlEntry     *entry;
+    MateMixerAppInfo *info;
+
+    g_return_if_fail (index != NULL);
+    g_return_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control));
+
+    if (g_hash_table_contains (index->entries, control) == TRUE)
+        return;
+
+    entry = g_slice_new0 (ControlEntry);
+    entry->control    = g_object_ref (control);
+    entry->stream     = stream;
+    entry->role       = mate_mixer_stream_control_get_role (control);
+    entry->media_role = mate_mixer_stream_control_get_media_role (control);
+
+    /* Count the state changes of all the indexed controls */
+    entry->notify_id = g_signal_connect (G_OBJECT (control),
+                                         "notify",
+                                         G_CALLBACK (on_control_notify),
+                                         index);
+
+    g_hash_table_insert (index->entries, control, entry);
+
+    entry->name = bucket_add_string (index->names,
+                                     mate_mixer_stream_control_get_name (control),
+                                     entry);
+
+    bucket_add (index->roles, GINT_TO_POINTER (entry->role), entry);
+    bucket_add (index->media_roles, GINT_TO_POINTER (entry->media_role), entry);
+
+    info = mate_mixer_stream_control_get_app_info (control);
+    if (info != NULL) {
+        const gchar *app_id   = mate_mixer_app_info_get_id (info);
+        const gchar *app_name = mate_mixer_app_info_get_name (info);
+
+        if (app_id != NULL)
+            entry->app_id = bucket_add_string (index->app_ids, app_id, entry);
+        if (app_name != NULL)
+            entry->app_name = bucket_add_string (index->app_names, app_name, entry);
+    }
+}
+
+void
+_mate_mixer_control_index_remove (MateMixerControlIndex *index,
+                                  MateMixerStream       *stream,
+                                  const gchar           *name)
+{
+    GHashTable     *bucket;
+    GHashTableIter  iter;
+    gpointer        entry;
+
+    g_return_if_fail (index != NULL);
+    g_return_if_fail (name != NULL);
+
+    bucket = g_hash_table_lookup (index->names, name);
+    if (bucket == NULL)
+        return;
+
+    /* The same name is only shared by controls of different streams */
+    g_hash_table_iter_init (&iter, bucket);
+
+    while (g_hash_table_iter_next (&iter, &entry, NULL) == TRUE) {
+        if (((ControlEntry *) entry)->stream == stream) {
+            remove_entry (entry, index);
+            break;
+        }
+    }
+}
+
+void
+_mate_mixer_control_index_remove_stream (MateMixerControlIndex *index,
+                                         MateMixerStream       *stream)
+{
+    GHashTableIter  iter;
+    gpointer        entry;
+    GSList         *removed = NULL;
+
+    g_return_if_fail (index != NULL);
+    g_return_if_fail (stream != NULL);
+
+    g_hash_table_iter_init (&iter, index->entries);
+
+    while (g_hash_table_iter_next (&iter, NULL, &entry) == TRUE) {
+        if (((ControlEntry *) entry)->stream == stream)
+            removed = g_slist_prepend (removed, entry);
+    }
+
+    g_slist_foreach (removed, (GFunc) remove_entry, index);
+    g_slist_free (removed);
+}
+
+void
+_mate_mixer_control_index_clear (MateMixerControlIndex *index)
+{
+    g_return_if_fail (index != NULL);
+
+    g_hash_table_remove_all (index->names);
+    g_hash_table_remove_all (index->roles);
+    g_hash_table_remove_all (index->media_roles);
+    g_hash_table_remove_all (index->app_ids);
+    g_hash_table_remove_all (index->app_names);
+
+    g_hash_table_remove_all (index->entries);
+}
+
+guint
+_mate_mixer_control_index_get_generation (MateMixerControlIndex *index)
+{
+    g_return_val_if_fail (index != NULL, 0);
+
+    return index->generation;
+}
+
+GPtrArray *
+_mate_mixer_control_index_find_role (MateMixerControlIndex     *index,
+                                     MateMixerStreamControlRole role)
+{
+    g_return_val_if_fail (index != NULL, NULL);
+
+    return bucket_dup (index->roles, GINT_TO_POINTER (role));
+}
+
+GPtrArray *
+_mate_mixer_control_index_find_media_role (MateMixerControlIndex          *index,
+                                           MateMixerStreamControlMediaRole media_role)
+{
+    g_return_val_if_fail (index != NULL, NULL);
+
+    return bucket_dup (index->media_roles, GINT_TO_POINTER (media_role));
+}
+
+GPtrArray *
+_mate_mixer_control_index_find_app_id (MateMixerControlIndex *index,
+                                       const gchar           *app_id)
+{
+    g_return_val_if_fail (index != NULL, NULL);
+    g_return_val_if_fail (app_id != NULL, NULL);
+
+    return bucket_dup (index->app_ids, app_id);
+}
+
+GPtrArray *
+_mate_mixer_control_index_find_app_name (MateMixerControlIndex *index,
+                                         const gchar           *app_name)
+{
+    g_return_val_if_fail (index != NULL, NULL);
+    g_return_val_if_fail (app_name != NULL, NULL);
+
+    return bucket_dup (index->app_names, app_name);
+}
+
+static void
+free_entry (ControlEntry *entry)
+{
+    g_signal_handler_disconnect (G_OBJECT (entry->control), entry->notify_id);
+
+    g_object_unref (entry->control);
+    g_slice_free (ControlEntry, entry);
+}
+
+static void
+on_control_notify (MateMixerStreamControl *control,
+                   GParamSpec             *pspec,
+                   MateMixerControlIndex  *index)
+{
+    index->generation++;
+}
+
+static GHashTable *
+new_bucket_table (GHashFunc      hash_func,
+                  GEqualFunc     key_equal_func,
+                  GDestroyNotify key_destroy_func)
+{
+    return g_hash_table_new_full (hash_func,
+                                  key_equal_func,
+                                  key_destroy_func,
+                                  (GDestroyNotify) g_hash_table_unref);
+}
+
+static void
+bucket_add (GHashTable *table, gconstpointer key, ControlEntry *entry)
+{
+    GHashTable *bucket;
+
+    bucket = g_hash_table_lookup (table, key);
+    if (bucket == NULL) {
+        bucket = g_hash_table_new (g_direct_hash, g_direct_equal);
+        g_hash_table_insert (table, (gpointer) key, bucket);
+    }
+    g_hash_table_add (bucket, entry);
+}
+
+static const gchar *
+bucket_add_string (GHashTable *table, const gchar *key, ControlEntry *entry)
+{
+    GHashTable *bucket;
+    gpointer    stored;
+
+    /* Return the copy of the key owned by the table, it stays valid while
+     * the entry is in the bucket */
+    if (g_hash_table_lookup_extended (table, key, &stored, (gpointer *) &bucket) == FALSE) {
+        bucket = g_hash_table_new (g_direct_hash, g_direct_equal);
+        stored = g_strdup (key);
+
+        g_hash_table_insert (table, stored, bucket);
+    }
+    g_hash_table_add (bucket, entry);
+
+    return stored;
+}
+
+static void
+bucket_remove (GHashTable *table, gconstpointer key, ControlEntry *entry)
+{
+    GHashTable *bucket;
+
+    bucket = g_hash_table_lookup (table, key);
+    if G_UNLIKELY (bucket == NULL)
+        return;
+
+    g_hash_table_remove (bucket, entry);
+
+    if (g_hash_table_size (bucket) == 0)
+        g_hash_table_remove (table, key);
+}
+
+static GPtrArray *
+bucket_dup (GHashTable *table, gconstpointer key)
+{
+    GHashTable     *bucket;
+    GHashTableIter  iter;
+    GPtrArray      *array;
+    gpointer        entry;
+
+    bucket = g_hash_table_lookup (table, key);
+    if (bucket == NULL)
+        return g_ptr_array_new_with_free_func (g_object_unref);
+
+    array = g_ptr_array_new_full (g_hash_table_size (bucket), g_object_unref);
+
+    g_hash_table_iter_init (&iter, bucket);
+
+    while (g_hash_table_iter_next (&iter, &entry, NULL) == TRUE)
+        g_ptr_array_add (array, g_object_ref (((ControlEntry *) entry)->control));
+
+    return array;
+}
+
+static void
+remove_entry (ControlEntry *entry, MateMixerControlIndex *index)
+{
+    bucket_remove (index->names, entry->name, entry);
+    bucket_remove (index->roles, GINT_TO_POINTER (entry->role), entry);
+    bucket_remove (index->media_roles, GINT_TO_POINTER (entry->media_role), entry);
+
+    if (entry->app_id != NULL)
+        bucket_remove (index->app_ids, entry->app_id, entry);
+    if (entry->app_name != NULL)
+        bucket_remove (index->app_names, entry->app_name, entry);
+
+    /* Frees the entry */
+    g_hash_table_remove (index->entries, entry->control);
+}
@@ -15,12 +15,15 @@
  * License along with this library; if not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <string.h>
 #include <glib.h>
 #include <glib-object.h>
 
 #include "matemixer-device.h"
+#include "matemixer-device-private.h"
 #include "matemixer-device-switch.h"
+#include "matemixer-array-cache-private.h"
+#include "matemixer-index-private.h"
+#include "matemixer-name-private.h"
 #include "matemixer-stream.h"
 #include "matemixer-switch.h"
 
@@ -36,9 +39,14 @@
 
 struct _MateMixerDevicePrivate
 {
-    gchar *name;
-    gchar *label;
-    gchar *icon;
+    const gchar         *name;
+    gchar               *label;
+    gchar               *icon;
+    MateMixerIndex      *streams;
+    MateMixerIndex      *switches;
+    MateMixerArrayCache  streams_array;
+    MateMixerArrayCache  switches_array;
+    guint                generation;
 };
 
 enum {
@@ -73,15 +81,25 @@ static void mate_mixer_device_set_property (GObject              *object,
                                             GParamSpec           *pspec);
 
 static void mate_mixer_device_init         (MateMixerDevice      *device);
+static void mate_mixer_device_dispose      (GObject              *object);
 static void mate_mixer_device_finalize     (GObject              *object);
 
 G_DEFINE_ABSTRACT_TYPE (MateMixerDevice, mate_mixer_device, G_TYPE_OBJECT)
 
+static void mate_mixer_device_dispatch_properties_changed (GObject     *object,
+                                                           guint        n_pspecs,
+                                                           GParamSpec **pspecs);
+
 static MateMixerStream *      mate_mixer_device_real_get_stream (MateMixerDevice *device,
                                                                  const gchar     *name);
 static MateMixerDeviceSwitch *mate_mixer_device_real_get_switch (MateMixerDevice *device,
                                                                  const gchar     *name);
 
+static void stream_added   (MateMixerDevice *device, const gchar *name);
+static void stream_removed (MateMixerDevice *device, const gchar *name);
+static void switch_added   (MateMixerDevice *device, const gchar *name);
+static void switch_removed (MateMixerDevice *device, const gchar *name);
+
 static void
 mate_mixer_device_class_init (MateMixerDeviceClass *klass)
 {
@@ -91,9 +109,11 @@ mate_mixer_device_class_init (MateMixerDeviceClass *klass)
     klass->get_switch = mate_mixer_device_real_get_switch;
 
     object_class = G_OBJECT_CLASS (klass);
-    object_class->finalize     = mate_mixer_device_finalize;
-    object_class->get_property = mate_mixer_device_get_property;
-    object_class->set_property = mate_mixer_device_set_property;
+    object_class->dispose                     = mate_mixer_device_dispose;
+    object_class->finalize                    = mate_mixer_device_finalize;
+    object_class->get_property                = mate_mixer_device_get_property;
+    object_class->set_property                = mate_mixer_device_set_property;
+    object_class->dispatch_properties_changed = mate_mixer_device_dispatch_properties_changed;
 
     /**
      * MateMixerDevice:name:
@@ -272,8 +292,8 @@ mate_mixer_device_set_property (GObject      *object,
 
     switch (param_id) {
     case PROP_NAME:
-        /* Construct-only string */
-        device->priv->name = g_value_dup_string (value);
+        /* Construct-only shared name */
+        device->priv->name = _mate_mixer_name_ref (g_value_get_string (value));
         break;
     case PROP_LABEL:
         /* Construct-only string */
@@ -296,6 +316,49 @@ mate_mixer_device_init (MateMixerDevice *device)
     device->priv = G_TYPE_INSTANCE_GET_PRIVATE (device,
                                                 MATE_MIXER_TYPE_DEVICE,
                                                 MateMixerDevicePrivate);
+
+    device->priv->streams =
+        _mate_mixer_index_new ((MateMixerIndexNameFunc) mate_mixer_stream_get_name);
+    device->priv->switches =
+        _mate_mixer_index_new ((MateMixerIndexNameFunc) mate_mixer_switch_get_name);
+
+    _mate_mixer_array_cache_init (&device->priv->streams_array);
+    _mate_mixer_array_cache_init (&device->priv->switches_array);
+
+    /* Keep the indexes and arrays in sync with the changes announced by
+     * the backend */
+    g_signal_connect (G_OBJECT (device),
+                      "stream-added",
+                      G_CALLBACK (stream_added),
+                      NULL);
+    g_signal_connect (G_OBJECT (device),
+                      "stream-removed",
+                      G_CALLBACK (stream_removed),
+                      NULL);
+    g_signal_connect (G_OBJECT (device),
+                      "switch-added",
+                      G_CALLBACK (switch_added),
+                      NULL);
+    g_signal_connect (G_OBJECT (device),
+                      "switch-removed",
+                      G_CALLBACK (switch_removed),
+                      NULL);
+}
+
+static void
+mate_mixer_device_dispose (GObject *object)
+{
+    MateMixerDevice *device;
+
+    device = MATE_MIXER_DEVICE (object);
+
+    _mate_mixer_index_clear (device->priv->streams);
+    _mate_mixer_index_clear (device->priv->switches);
+
+    _mate_mixer_array_cache_clear (&device->priv->streams_array);
+    _mate_mixer_array_cache_clear (&device->priv->switches_array);
+
+    G_OBJECT_CLASS (mate_mixer_device_parent_class)->dispose (object);
 }
 
 static void
@@ -305,13 +368,26 @@ mate_mixer_device_finalize (GObject *object)
 
     device = MATE_MIXER_DEVICE (object);
 
-    g_free (device->priv->name);
+    _mate_mixer_name_unref (device->priv->name);
     g_free (device->priv->label);
     g_free (device->priv->icon);
 
+    _mate_mixer_index_free (device->priv->streams);
+    _mate_mixer_index_free (device->priv->switches);
+
     G_OBJECT_CLASS (mate_mixer_device_parent_class)->finalize (object);
 }
 
+static void
+mate_mixer_device_dispatch_properties_changed (GObject     *object,
+                                               guint        n_pspecs,
+                                               GParamSpec **pspecs)
+{
+    MATE_MIXER_DEVICE (object)->priv->generation++;
+
+    G_OBJECT_CLASS (mate_mixer_device_parent_class)->dispatch_properties_changed (object, n_pspecs, pspecs);
+}
+
 /**
  * mate_mixer_device_get_name:
  * @device: a #MateMixerDevice
@@ -325,6 +401,9 @@ mate_mixer_device_finalize (GObject *object)
  * and may be used to get the #MateMixerDevice using
  * mate_mixer_context_get_device().
  *
+ * The name is shared with other objects of the same name and it may be
+ * compared by pointer with the names of other objects of the library.
+ *
  * Returns: the name of the device.
  */
 const gchar *
@@ -370,6 +449,27 @@ mate_mixer_device_get_icon (MateMixerDevice *device)
     return device->priv->icon;
 }
 
+/**
+ * mate_mixer_device_get_generation:
+ * @device: a #MateMixerDevice
+ *
+ * Gets the change counter of the device. The number is incremented each time
+ * a property of the device changes and each time a stream or a switch is added
+ * to or removed from the device.
+ *
+ * Comparing the number with a value stored earlier tells whether the device
+ * needs to be examined again.
+ *
+ * Returns: the current generation number of the device.
+ */
+guint
+mate_mixer_device_get_generation (MateMixerDevice *device)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_DEVICE (device), 0);
+
+    return device->priv->generation;
+}
+
 /**
  * mate_mixer_device_get_stream:
  * @device: a #MateMixerDevice
@@ -474,42 +574,135 @@ mate_mixer_device_list_switches (MateMixerDevice *device)
     return NULL;
 }
 
-static MateMixerStream *
-mate_mixer_device_real_get_stream (MateMixerDevice *device, const gchar *name)
+/**
+ * mate_mixer_device_dup_streams:
+ * @device: a #MateMixerDevice
+ * @generation: (out) (allow-none): return location for the generation number
+ * of the returned array
+ *
+ * Gets an array of streams that belong to the device. The content is the same
+ * as the list returned by mate_mixer_device_list_streams(), the array holds a
+ * reference to each stream.
+ *
+ * The @generation number changes whenever a stream is added to or removed from
+ * the device. Until then the same array is returned to all callers, so it must
+ * not be modified. The array is owned by the device and released when the
+ * generation changes, use g_ptr_array_ref() to keep it for longer.
+ *
+ * Returns: (transfer none) (element-type MateMixerStream): a read-only
+ * #GPtrArray of the device streams.
+ */
+GPtrArray *
+mate_mixer_device_dup_streams (MateMixerDevice *device, guint *generation)
 {
-    const GList *list;
+    g_return_val_if_fail (MATE_MIXER_IS_DEVICE (device), NULL);
+
+    return _mate_mixer_array_cache_get (&device->priv->streams_array,
+                                        mate_mixer_device_list_streams (device),
+                                        generation);
+}
 
+/**
+ * mate_mixer_device_dup_switches:
+ * @device: a #MateMixerDevice
+ * @generation: (out) (allow-none): return location for the generation number
+ * of the returned array
+ *
+ * Gets an array of switches that belong to the device, the content is the same
+ * as the list returned by mate_mixer_device_list_switches(). See
+ * mate_mixer_device_dup_streams() for the meaning of @generation and the
+ * lifetime of the array.
+ *
+ * Returns: (transfer none) (element-type MateMixerDeviceSwitch): a read-only
+ * #GPtrArray of the device switches.
+ */
+GPtrArray *
+mate_mixer_device_dup_switches (MateMixerDevice *device, guint *generation)
+{
     g_return_val_if_fail (MATE_MIXER_IS_DEVICE (device), NULL);
-    g_return_val_if_fail (name != NULL, NULL);
 
-    list = mate_mixer_device_list_streams (device);
-    while (list != NULL) {
-        MateMixerStream *stream = MATE_MIXER_STREAM (list->data);
+    return _mate_mixer_array_cache_get (&device->priv->switches_array,
+                                        mate_mixer_device_list_switches (device),
+                                        generation);
+}
 
-        if (strcmp (name, mate_mixer_stream_get_name (stream)) == 0)
-            return stream;
+static MateMixerStream *
+mate_mixer_device_real_get_stream (MateMixerDevice *device, const gchar *name)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_DEVICE (device), NULL);
+    g_return_val_if_fail (name != NULL, NULL);
 
-        list = list->next;
-    }
-    return NULL;
+    return _mate_mixer_index_lookup (device->priv->streams,
+                                     name,
+                                     mate_mixer_device_list_streams (device));
 }
 
 static MateMixerDeviceSwitch *
 mate_mixer_device_real_get_switch (MateMixerDevice *device, const gchar *name)
 {
-    const GList *list;
-
     g_return_val_if_fail (MATE_MIXER_IS_DEVICE (device), NULL);
     g_return_val_if_fail (name != NULL, NULL);
 
-    list = mate_mixer_device_list_switches (device);
-    while (list != NULL) {
-        MateMixerSwitch *swtch = MATE_MIXER_SWITCH (list->data);
+    return _mate_mixer_index_lookup (device->priv->switches,
+                                     name,
+                                     mate_mixer_device_list_switches (device));
+}
 
-        if (strcmp (name, mate_mixer_switch_get_name (swtch)) == 0)
-            return MATE_MIXER_DEVICE_SWITCH (swtch);
+static void
+stream_added (MateMixerDevice *device, const gchar *name)
+{
+    _mate_mixer_index_added (device->priv->streams, name);
 
-        list = list->next;
-    }
-    return NULL;
+    _mate_mixer_array_cache_invalidate (&device->priv->streams_array);
+    device->priv->generation++;
+}
+
+static void
+stream_removed (MateMixerDevice *device, const gchar *name)
+{
+    _mate_mixer_index_remove (device->priv->streams, name);
+
+    _mate_mixer_array_cache_invalidate (&device->priv->streams_array);
+    device->priv->generation++;
+}
+
+static void
+switch_added (MateMixerDevice *device, const gchar *name)
+{
+    _mate_mixer_index_added (device->priv->switches, name);
+
+    _mate_mixer_array_cache_invalidate (&device->priv->switches_array);
+    device->priv->generation++;
+}
+
+static void
+switch_removed (MateMixerDevice *device, const gchar *name)
+{
+    _mate_mixer_index_remove (device->priv->switches, name);
+
+    _mate_mixer_array_cache_invalidate (&device->priv->switches_array);
+    device->priv->generation++;
+}
+
+void
+_mate_mixer_device_index_stream (MateMixerDevice *device, MateMixerStream *stream)
+{
+    g_return_if_fail (MATE_MIXER_IS_DEVICE (device));
+    g_return_if_fail (MATE_MIXER_IS_STREAM (stream));
+
+    _mate_mixer_index_add (device->priv->streams, stream);
+}
+
+void
+_mate_mixer_device_index_switch (MateMixerDevice       *device,
+                                 MateMixerDeviceSwitch *swtch)
+{
+    g_return_if_fail (MATE_MIXER_IS_DEVICE (device));
+    g_return_if_fail (MATE_MIXER_IS_DEVICE_SWITCH (swtch));
+
+    _mate_mixer_index_add (device->priv->switches, swtch);
+
+    /* Some switches are created without the added signal */
+    _mate_mixer_array_cache_invalidate (&device->priv->switches_array);
+    device->priv->generation++;
 }
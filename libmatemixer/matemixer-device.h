@@ -85,20 +85,26 @@ struct _MateMixerDeviceClass
                             const gchar     *name);
 };
 
-GType                  mate_mixer_device_get_type      (void) G_GNUC_CONST;
+GType                  mate_mixer_device_get_type       (void) G_GNUC_CONST;
 
-const gchar *          mate_mixer_device_get_name      (MateMixerDevice *device);
-const gchar *          mate_mixer_device_get_label     (MateMixerDevice *device);
-const gchar *          mate_mixer_device_get_icon      (MateMixerDevice *device);
+const gchar *          mate_mixer_device_get_name       (MateMixerDevice *device);
+const gchar *          mate_mixer_device_get_label      (MateMixerDevice *device);
+const gchar *          mate_mixer_device_get_icon       (MateMixerDevice *device);
+guint                  mate_mixer_device_get_generation (MateMixerDevice *device);
 
-MateMixerStream *      mate_mixer_device_get_stream    (MateMixerDevice *device,
-                                                        const gchar     *name);
+MateMixerStream *      mate_mixer_device_get_stream     (MateMixerDevice *device,
+                                                         const gchar     *name);
 
-MateMixerDeviceSwitch *mate_mixer_device_get_switch    (MateMixerDevice *device,
-                                                        const gchar     *name);
+MateMixerDeviceSwitch *mate_mixer_device_get_switch     (MateMixerDevice *device,
+                                                         const gchar     *name);
 
-const GList *          mate_mixer_device_list_streams  (MateMixerDevice *device);
-const GList *          mate_mixer_device_list_switches (MateMixerDevice *device);
+const GList *          mate_mixer_device_list_streams   (MateMixerDevice *device);
+const GList *          mate_mixer_device_list_switches  (MateMixerDevice *device);
+
+GPtrArray *            mate_mixer_device_dup_streams    (MateMixerDevice *device,
+                                                         guint           *generation);
+GPtrArray *            mate_mixer_device_dup_switches   (MateMixerDevice *device,
+                                                         guint           *generation);
 
 G_END_DECLS
 
@@ -86,6 +86,31 @@ mate_mixer_backend_flags_get_type (void)
     return etype;
 }
 
+GType
+mate_mixer_track_flags_get_type (void)
+{
+    static GType etype = 0;
+
+    if (etype == 0) {
+        static const GFlagsValue values[] = {
+            { MATE_MIXER_TRACK_NONE, "MATE_MIXER_TRACK_NONE", "none" },
+            { MATE_MIXER_TRACK_DEVICES, "MATE_MIXER_TRACK_DEVICES", "devices" },
+            { MATE_MIXER_TRACK_INPUT_STREAMS, "MATE_MIXER_TRACK_INPUT_STREAMS", "input-streams" },
+            { MATE_MIXER_TRACK_OUTPUT_STREAMS, "MATE_MIXER_TRACK_OUTPUT_STREAMS", "output-streams" },
+            { MATE_MIXER_TRACK_INPUT_APPLICATIONS, "MATE_MIXER_TRACK_INPUT_APPLICATIONS", "input-applications" },
+            { MATE_MIXER_TRACK_OUTPUT_APPLICATIONS, "MATE_MIXER_TRACK_OUTPUT_APPLICATIONS", "output-applications" },
+            { MATE_MIXER_TRACK_STORED_CONTROLS, "MATE_MIXER_TRACK_STORED_CONTROLS", "stored-controls" },
+            { MATE_MIXER_TRACK_DEFAULT_STREAMS, "MATE_MIXER_TRACK_DEFAULT_STREAMS", "default-streams" },
+            { MATE_MIXER_TRACK_ALL, "MATE_MIXER_TRACK_ALL", "all" },
+            { 0, NULL, NULL }
+        };
+        etype = g_flags_register_static (
+            g_intern_static_string ("MateMixerTrackFlags"),
+            values);
+    }
+    return etype;
+}
+
 GType
 mate_mixer_direction_get_type (void)
 {
@@ -189,6 +214,27 @@ mate_mixer_stream_control_media_role_get_type (void)
     return etype;
 }
 
+GType
+mate_mixer_monitor_flags_get_type (void)
+{
+    static GType etype = 0;
+
+    if (etype == 0) {
+        static const GFlagsValue values[] = {
+            { MATE_MIXER_MONITOR_NONE, "MATE_MIXER_MONITOR_NONE", "none" },
+            { MATE_MIXER_MONITOR_PER_CHANNEL, "MATE_MIXER_MONITOR_PER_CHANNEL", "per-channel" },
+            { MATE_MIXER_MONITOR_RMS, "MATE_MIXER_MONITOR_RMS", "rms" },
+            { MATE_MIXER_MONITOR_PEAK_HOLD, "MATE_MIXER_MONITOR_PEAK_HOLD", "peak-hold" },
+            { MATE_MIXER_MONITOR_THREADED, "MATE_MIXER_MONITOR_THREADED", "threaded" },
+            { 0, NULL, NULL }
+        };
+        etype = g_flags_register_static (
+            g_intern_static_string ("MateMixerMonitorFlags"),
+            values);
+    }
+    return etype;
+}
+
 GType
 mate_mixer_device_switch_role_get_type (void)
 {
@@ -280,3 +326,33 @@ mate_mixer_channel_position_get_type (void)
     }
     return etype;
 }
+
+GType
+mate_mixer_change_flags_get_type (void)
+{
+    static GType etype = 0;
+
+    if (etype == 0) {
+        static const GFlagsValue values[] = {
+            { MATE_MIXER_CHANGE_NONE, "MATE_MIXER_CHANGE_NONE", "none" },
+            { MATE_MIXER_CHANGE_ADDED, "MATE_MIXER_CHANGE_ADDED", "added" },
+            { MATE_MIXER_CHANGE_REMOVED, "MATE_MIXER_CHANGE_REMOVED", "removed" },
+            { MATE_MIXER_CHANGE_STATE, "MATE_MIXER_CHANGE_STATE", "state" },
+            { MATE_MIXER_CHANGE_DEFAULT_INPUT_STREAM, "MATE_MIXER_CHANGE_DEFAULT_INPUT_STREAM", "default-input-stream" },
+            { MATE_MIXER_CHANGE_DEFAULT_OUTPUT_STREAM, "MATE_MIXER_CHANGE_DEFAULT_OUTPUT_STREAM", "default-output-stream" },
+            { MATE_MIXER_CHANGE_LABEL, "MATE_MIXER_CHANGE_LABEL", "label" },
+            { MATE_MIXER_CHANGE_VOLUME, "MATE_MIXER_CHANGE_VOLUME", "volume" },
+            { MATE_MIXER_CHANGE_MUTE, "MATE_MIXER_CHANGE_MUTE", "mute" },
+            { MATE_MIXER_CHANGE_BALANCE, "MATE_MIXER_CHANGE_BALANCE", "balance" },
+            { MATE_MIXER_CHANGE_FADE, "MATE_MIXER_CHANGE_FADE", "fade" },
+            { MATE_MIXER_CHANGE_ACTIVE_OPTION, "MATE_MIXER_CHANGE_ACTIVE_OPTION", "active-option" },
+            { MATE_MIXER_CHANGE_CHILDREN, "MATE_MIXER_CHANGE_CHILDREN", "children" },
+            { MATE_MIXER_CHANGE_OTHER, "MATE_MIXER_CHANGE_OTHER", "other" },
+            { 0, NULL, NULL }
+        };
+        etype = g_flags_register_static (
+            g_intern_static_string ("MateMixerChangeFlags"),
+            values);
+    }
+    return etype;
+}
@@ -37,6 +37,9 @@ GType mate_mixer_backend_type_get_type (void) G_GNUC_CONST;
 #define MATE_MIXER_TYPE_BACKEND_FLAGS (mate_mixer_backend_flags_get_type ())
 GType mate_mixer_backend_flags_get_type (void) G_GNUC_CONST;
 
+#define MATE_MIXER_TYPE_TRACK_FLAGS (mate_mixer_track_flags_get_type ())
+GType mate_mixer_track_flags_get_type (void) G_GNUC_CONST;
+
 #define MATE_MIXER_TYPE_DIRECTION (mate_mixer_direction_get_type ())
 GType mate_mixer_direction_get_type (void) G_GNUC_CONST;
 
@@ -49,6 +52,9 @@ GType mate_mixer_stream_control_role_get_type (void) G_GNUC_CONST;
 #define MATE_MIXER_TYPE_STREAM_CONTROL_MEDIA_ROLE (mate_mixer_stream_control_media_role_get_type ())
 GType mate_mixer_stream_control_media_role_get_type (void) G_GNUC_CONST;
 
+#define MATE_MIXER_TYPE_MONITOR_FLAGS (mate_mixer_monitor_flags_get_type ())
+GType mate_mixer_monitor_flags_get_type (void) G_GNUC_CONST;
+
 #define MATE_MIXER_TYPE_DEVICE_SWITCH_ROLE (mate_mixer_device_switch_role_get_type ())
 GType mate_mixer_device_switch_role_get_type (void) G_GNUC_CONST;
 
@@ -61,6 +67,9 @@ GType mate_mixer_stream_switch_role_get_type (void) G_GNUC_CONST;
 #define MATE_MIXER_TYPE_CHANNEL_POSITION (mate_mixer_channel_position_get_type ())
 GType mate_mixer_channel_position_get_type (void) G_GNUC_CONST;
 
+#define MATE_MIXER_TYPE_CHANGE_FLAGS (mate_mixer_change_flags_get_type ())
+GType mate_mixer_change_flags_get_type (void) G_GNUC_CONST;
+
 G_END_DECLS
 
 #endif /* MATEMIXER_ENUM_TYPES_H */
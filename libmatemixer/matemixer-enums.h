@@ -103,6 +103,47 @@ typedef enum { /*< flags >*/
     MATE_MIXER_BACKEND_CAN_SET_DEFAULT_OUTPUT_STREAM = 1 << 3
 } MateMixerBackendFlags;
 
+/**
+ * MateMixerTrackFlags:
+ * @MATE_MIXER_TRACK_NONE:
+ *     Do not track any objects.
+ * @MATE_MIXER_TRACK_DEVICES:
+ *     Track devices.
+ * @MATE_MIXER_TRACK_INPUT_STREAMS:
+ *     Track input streams.
+ * @MATE_MIXER_TRACK_OUTPUT_STREAMS:
+ *     Track output streams.
+ * @MATE_MIXER_TRACK_INPUT_APPLICATIONS:
+ *     Track application controls of recording applications. Each control belongs
+ *     to an input stream, so input streams should usually be tracked as well.
+ * @MATE_MIXER_TRACK_OUTPUT_APPLICATIONS:
+ *     Track application controls of playback applications. Each control belongs
+ *     to an output stream, so output streams should usually be tracked as well.
+ * @MATE_MIXER_TRACK_STORED_CONTROLS:
+ *     Track stored controls.
+ * @MATE_MIXER_TRACK_DEFAULT_STREAMS:
+ *     Track the default input and output streams. This flag only has an effect
+ *     when %MATE_MIXER_TRACK_INPUT_STREAMS or %MATE_MIXER_TRACK_OUTPUT_STREAMS is
+ *     not set, in which case only the current default stream is tracked in the
+ *     given direction. Other streams are dropped when the default stream changes.
+ * @MATE_MIXER_TRACK_ALL:
+ *     Track all the objects provided by the sound system. This is the default.
+ *
+ * Flags selecting the kinds of objects a #MateMixerContext keeps track of, see
+ * mate_mixer_context_set_track_flags().
+ */
+typedef enum { /*< flags >*/
+    MATE_MIXER_TRACK_NONE                = 0,
+    MATE_MIXER_TRACK_DEVICES             = 1 << 0,
+    MATE_MIXER_TRACK_INPUT_STREAMS       = 1 << 1,
+    MATE_MIXER_TRACK_OUTPUT_STREAMS      = 1 << 2,
+    MATE_MIXER_TRACK_INPUT_APPLICATIONS  = 1 << 3,
+    MATE_MIXER_TRACK_OUTPUT_APPLICATIONS = 1 << 4,
+    MATE_MIXER_TRACK_STORED_CONTROLS     = 1 << 5,
+    MATE_MIXER_TRACK_DEFAULT_STREAMS     = 1 << 6,
+    MATE_MIXER_TRACK_ALL                 = 0x3f
+} MateMixerTrackFlags;
+
 /**
  * MateMixerDirection:
  * @MATE_MIXER_DIRECTION_UNKNOWN:
@@ -258,6 +299,35 @@ typedef enum {
     MATE_MIXER_STREAM_CONTROL_MEDIA_ROLE_FILTER
 } MateMixerStreamControlMediaRole;
 
+/**
+ * MateMixerMonitorFlags:
+ * @MATE_MIXER_MONITOR_NONE:
+ *     Only the overall peak level is measured.
+ * @MATE_MIXER_MONITOR_PER_CHANNEL:
+ *     Measure each channel of the stream control separately instead of a
+ *     single down-mixed channel.
+ * @MATE_MIXER_MONITOR_RMS:
+ *     Also compute the RMS level of each update. This requires reading the
+ *     actual audio rather than peak values and is therefore more expensive.
+ * @MATE_MIXER_MONITOR_PEAK_HOLD:
+ *     Keep the highest recent peak of each channel for a short time.
+ * @MATE_MIXER_MONITOR_THREADED:
+ *     Read the audio in a separate thread when supported by the backend. The
+ *     main loop only receives one aggregated update for all the measurements
+ *     made since it last ran, so a busy main loop does not delay or drop the
+ *     measurements themselves.
+ *
+ * Flags selecting what is measured by a stream control monitor, see
+ * mate_mixer_stream_control_set_monitor_flags().
+ */
+typedef enum { /*< flags >*/
+    MATE_MIXER_MONITOR_NONE        = 0,
+    MATE_MIXER_MONITOR_PER_CHANNEL = 1 << 0,
+    MATE_MIXER_MONITOR_RMS         = 1 << 1,
+    MATE_MIXER_MONITOR_PEAK_HOLD   = 1 << 2,
+    MATE_MIXER_MONITOR_THREADED    = 1 << 3
+} MateMixerMonitorFlags;
+
 /**
  * MateMixerDeviceSwitchRole:
  * @MATE_MIXER_DEVICE_SWITCH_ROLE_UNKNOWN:
@@ -365,4 +435,55 @@ typedef enum {
     MATE_MIXER_CHANNEL_MAX
 } MateMixerChannelPosition;
 
+/**
+ * MateMixerChangeFlags:
+ * @MATE_MIXER_CHANGE_NONE:
+ *     No change.
+ * @MATE_MIXER_CHANGE_ADDED:
+ *     The object has been added.
+ * @MATE_MIXER_CHANGE_REMOVED:
+ *     The object has been removed.
+ * @MATE_MIXER_CHANGE_STATE:
+ *     The state of the context has changed.
+ * @MATE_MIXER_CHANGE_DEFAULT_INPUT_STREAM:
+ *     The default input stream of the context has changed.
+ * @MATE_MIXER_CHANGE_DEFAULT_OUTPUT_STREAM:
+ *     The default output stream of the context has changed.
+ * @MATE_MIXER_CHANGE_LABEL:
+ *     The label of the object has changed.
+ * @MATE_MIXER_CHANGE_VOLUME:
+ *     The volume of the control has changed.
+ * @MATE_MIXER_CHANGE_MUTE:
+ *     The mute state of the control has changed.
+ * @MATE_MIXER_CHANGE_BALANCE:
+ *     The balance of the control has changed.
+ * @MATE_MIXER_CHANGE_FADE:
+ *     The fade of the control has changed.
+ * @MATE_MIXER_CHANGE_ACTIVE_OPTION:
+ *     The active option of the switch has changed.
+ * @MATE_MIXER_CHANGE_CHILDREN:
+ *     A stream, control or switch has been added to or removed from the
+ *     device or stream.
+ * @MATE_MIXER_CHANGE_OTHER:
+ *     Another property of the object has changed.
+ *
+ * Flags describing what has changed in an object, see #MateMixerChange.
+ */
+typedef enum { /*< flags >*/
+    MATE_MIXER_CHANGE_NONE                  = 0,
+    MATE_MIXER_CHANGE_ADDED                 = 1 << 0,
+    MATE_MIXER_CHANGE_REMOVED               = 1 << 1,
+    MATE_MIXER_CHANGE_STATE                 = 1 << 2,
+    MATE_MIXER_CHANGE_DEFAULT_INPUT_STREAM  = 1 << 3,
+    MATE_MIXER_CHANGE_DEFAULT_OUTPUT_STREAM = 1 << 4,
+    MATE_MIXER_CHANGE_LABEL                 = 1 << 5,
+    MATE_MIXER_CHANGE_VOLUME                = 1 << 6,
+    MATE_MIXER_CHANGE_MUTE                  = 1 << 7,
+    MATE_MIXER_CHANGE_BALANCE               = 1 << 8,
+    MATE_MIXER_CHANGE_FADE                  = 1 << 9,
+    MATE_MIXER_CHANGE_ACTIVE_OPTION         = 1 << 10,
+    MATE_MIXER_CHANGE_CHILDREN              = 1 << 11,
+    MATE_MIXER_CHANGE_OTHER                 = 1 << 12
+} MateMixerChangeFlags;
+
 #endif /* MATEMIXER_ENUMS_H */
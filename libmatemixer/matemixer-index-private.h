@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MATEMIXER_INDEX_PRIVATE_H
+#define MATEMIXER_INDEX_PRIVATE_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/*
+ * A keyed index of child objects, such as the controls of a stream or the
+ * streams of a device.
+ *
+ * The index maps the name of each child to a reference to the child. The key
+ * is owned by the child itself, so the name must not change while the child
+ * is indexed. Children may be added to the index eagerly by the owner. The
+ * first lookup indexes all children of the given list at once, from then on
+ * the index is complete and a lookup which misses returns NULL. Children which
+ * are announced without being indexed make the index incomplete again.
+ */
+typedef struct _MateMixerIndex  MateMixerIndex;
+
+typedef const gchar *(*MateMixerIndexNameFunc) (gpointer object);
+
+MateMixerIndex *_mate_mixer_index_new    (MateMixerIndexNameFunc  name_func);
+void            _mate_mixer_index_free   (MateMixerIndex         *index);
+
+void            _mate_mixer_index_add    (MateMixerIndex         *index,
+                                          gpointer                object);
+void            _mate_mixer_index_remove (MateMixerIndex         *index,
+                                          const gchar            *name);
+void            _mate_mixer_index_clear  (MateMixerIndex         *index);
+
+void            _mate_mixer_index_added  (MateMixerIndex         *index,
+                                          const gchar            *name);
+
+gpointer        _mate_mixer_index_lookup (MateMixerIndex         *index,
+                                          const gchar            *name,
+                                          const GList            *list);
+
+G_END_DECLS
+
+#endif /* MATEMIXER_INDEX_PRIVATE_H */
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include "matemixer-index-private.h"
+
+struct _MateMixerIndex
+{
+    GHashTable             *table;
+    MateMixerIndexNameFunc  name_func;
+    gboolean                complete;
+};
+
+MateMixerIndex *
+_mate_mixer_index_new (MateMixerIndexNameFunc name_func)
+{
+    MateMixerIndex *index;
+
+    g_return_val_if_fail (name_func != NULL, NULL);
+
+    index = g_slice_new (MateMixerIndex);
+    index->name_func = name_func;
+    index->complete  = FALSE;
+
+    /* Keys are owned by the indexed objects */
+    index->table = g_hash_table_new_full (g_str_hash,
+                                          g_str_equal,
+                                          NULL,
+                                          g_object_unref);
+    return index;
+}
+
+void
+_mate_mixer_index_free (MateMixerIndex *index)
+{
+    if (index == NULL)
+        return;
+
+    g_hash_table_destroy (index->table);
+    g_slice_free (MateMixerIndex, index);
+}
+
+void
+_mate_mixer_index_add (MateMixerIndex *index, gpointer object)
+{
+    const gchar *name;
+
+    g_return_if_fail (index != NULL);
+    g_return_if_fail (G_IS_OBJECT (object));
+
+    name = index->name_func (object);
+    if G_UNLIKELY (name == NULL)
+        return;
+
+    /* Replacing the value keeps the old key, which may belong to the object
+     * being replaced, so remove the old entry first */
+    g_hash_table_remove (index->table, name);
+    g_hash_table_insert (index->table,
+                         (gpointer) name,
+                         g_object_ref (object));
+}
+
+void
+_mate_mixer_index_remove (MateMixerIndex *index, const gchar *name)
+{
+    g_return_if_fail (index != NULL);
+    g_return_if_fail (name != NULL);
+
+    g_hash_table_remove (index->table, name);
+}
+
+void
+_mate_mixer_index_clear (MateMixerIndex *index)
+{
+    g_return_if_fail (index != NULL);
+
+    g_hash_table_remove_all (index->table);
+
+    index->complete = FALSE;
+}
+
+void
+_mate_mixer_index_added (MateMixerIndex *index, const gchar *name)
+{
+    g_return_if_fail (index != NULL);
+    g_return_if_fail (name != NULL);
+
+    /* The owner announced a child which it has not indexed, it will be picked
+     * up from the list by the next lookup */
+    if (g_hash_table_contains (index->table, name) == FALSE)
+        index->complete = FALSE;
+}
+
+gpointer
+_mate_mixer_index_lookup (MateMixerIndex *index,
+                          const gchar    *name,
+                          const GList    *list)
+{
+    gpointer object;
+
+    g_return_val_if_fail (index != NULL, NULL);
+    g_return_val_if_fail (name != NULL, NULL);
+
+    object = g_hash_table_lookup (index->table, name);
+    if (object != NULL || index->complete == TRUE)
+        return object;
+
+    /* Index all the children at once, the index is authoritative afterwards */
+    while (list != NULL) {
+        _mate_mixer_index_add (index, list->data);
+        list = list->next;
+    }
+    index->complete = TRUE;
+
+    return g_hash_table_lookup (index->table, name);
+}
@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string.h>
+#include <glib.h>
+#include <glib-object.h>
+
+#include "matemixer-monitor-buffer.h"
+#include "matemixer-monitor-buffer-private.h"
+
+/**
+ * SECTION:matemixer-monitor-buffer
+ * @short_description: Lock-free queue of monitor readings
+ * @include: libmatemixer/matemixer.h
+ * @see_also: #MateMixerStreamControl
+ *
+ * The #MateMixerMonitorBuffer is a fixed size queue of the peak levels
+ * measured by the monitor of a stream control, see
+ * mate_mixer_stream_control_get_monitor_buffer().
+ *
+ * The buffer allows reading the levels at any pace and from any thread, for
+ * example from a frame clock callback, without waiting for the monitor
+ * signals to be dispatched. There may only be a single consumer of each
+ * buffer. When the consumer falls behind, new readings are dropped until
+ * there is room in the buffer again.
+ */
+
+struct _MateMixerMonitorBuffer
+{
+    volatile gint            ref_count;
+    guint                    mask;
+    MateMixerMonitorReading *readings;
+
+    /* The head is only written by the producer and the tail only by the
+     * consumer, both are free-running and wrap around */
+    volatile gint            head;
+    volatile gint            tail;
+    volatile gint            dropped;
+};
+
+/**
+ * MateMixerMonitorBuffer:
+ *
+ * The #MateMixerMonitorBuffer structure contains only private data and should
+ * only be accessed using the provided API.
+ */
+G_DEFINE_BOXED_TYPE (MateMixerMonitorBuffer, mate_mixer_monitor_buffer,
+                     mate_mixer_monitor_buffer_ref,
+                     mate_mixer_monitor_buffer_unref)
+
+/**
+ * mate_mixer_monitor_buffer_ref:
+ * @buffer: a #MateMixerMonitorBuffer
+ *
+ * Increases the reference count of @buffer.
+ *
+ * Returns: the @buffer.
+ */
+MateMixerMonitorBuffer *
+mate_mixer_monitor_buffer_ref (MateMixerMonitorBuffer *buffer)
+{
+    g_return_val_if_fail (buffer != NULL, NULL);
+
+    g_atomic_int_inc (&buffer->ref_count);
+    return buffer;
+}
+
+/**
+ * mate_mixer_monitor_buffer_unref:
+ * @buffer: a #MateMixerMonitorBuffer
+ *
+ * Decreases the reference count of @buffer. When the reference count drops
+ * to zero, the buffer is freed.
+ */
+void
+mate_mixer_monitor_buffer_unref (MateMixerMonitorBuffer *buffer)
+{
+    g_return_if_fail (buffer != NULL);
+
+    if (g_atomic_int_dec_and_test (&buffer->ref_count) == FALSE)
+        return;
+
+    g_free (buffer->readings);
+    g_slice_free (MateMixerMonitorBuffer, buffer);
+}
+
+/**
+ * mate_mixer_monitor_buffer_pop:
+ * @buffer: a #MateMixerMonitorBuffer
+ * @reading: (out caller-allocates): return location for the reading
+ *
+ * Removes the oldest reading from @buffer and stores it in @reading.
+ *
+ * Returns: %TRUE on success or %FALSE if the buffer is empty.
+ */
+gboolean
+mate_mixer_monitor_buffer_pop (MateMixerMonitorBuffer  *buffer,
+                               MateMixerMonitorReading *reading)
+{
+    guint head;
+    guint tail;
+
+    g_return_val_if_fail (buffer != NULL, FALSE);
+    g_return_val_if_fail (reading != NULL, FALSE);
+
+    tail = (guint) buffer->tail;
+    head = (guint) g_atomic_int_get (&buffer->head);
+    if (head == tail)
+        return FALSE;
+
+    *reading = buffer->readings[tail & buffer->mask];
+
+    /* Only release the slot once the reading has been copied */
+    g_atomic_int_set (&buffer->tail, (gint) (tail + 1));
+    return TRUE;
+}
+
+/**
+ * mate_mixer_monitor_buffer_get_dropped:
+ * @buffer: a #MateMixerMonitorBuffer
+ *
+ * Gets the number of readings which have been dropped because the buffer
+ * was full.
+ *
+ * Returns: the number of dropped readings.
+ */
+guint
+mate_mixer_monitor_buffer_get_dropped (MateMixerMonitorBuffer *buffer)
+{
+    g_return_val_if_fail (buffer != NULL, 0);
+
+    return (guint) g_atomic_int_get (&buffer->dropped);
+}
+
+MateMixerMonitorBuffer *
+_mate_mixer_monitor_buffer_new (guint size)
+{
+    MateMixerMonitorBuffer *buffer;
+    guint                   n = 1;
+
+    g_return_val_if_fail (size > 0, NULL);
+
+    /* Use a power of two size to be able to mask the free-running indexes */
+    while (n < size)
+        n <<= 1;
+
+    buffer = g_slice_new0 (MateMixerMonitorBuffer);
+    buffer->ref_count = 1;
+    buffer->mask      = n - 1;
+    buffer->readings  = g_new0 (MateMixerMonitorReading, n);
+
+    return buffer;
+}
+
+void
+_mate_mixer_monitor_buffer_push (MateMixerMonitorBuffer *buffer,
+                                 gint64                  time,
+                                 const gfloat           *peak,
+                                 guint                   n_channels)
+{
+    MateMixerMonitorReading *reading;
+    guint                    head;
+    guint                    tail;
+
+    g_return_if_fail (buffer != NULL);
+    g_return_if_fail (peak != NULL);
+
+    head = (guint) buffer->head;
+    tail = (guint) g_atomic_int_get (&buffer->tail);
+
+    if (head - tail > buffer->mask) {
+        g_atomic_int_inc (&buffer->dropped);
+        return;
+    }
+
+    n_channels = MIN (n_channels, MATE_MIXER_MONITOR_MAX_CHANNELS);
+
+    reading = &buffer->readings[head & buffer->mask];
+    reading->time       = time;
+    reading->n_channels = n_channels;
+    memcpy (reading->peak, peak, n_channels * sizeof (gfloat));
+
+    /* Publish the reading only after it has been written */
+    g_atomic_int_set (&buffer->head, (gint) (head + 1));
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MATEMIXER_MONITOR_BUFFER_H
+#define MATEMIXER_MONITOR_BUFFER_H
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include "matemixer-types.h"
+
+G_BEGIN_DECLS
+
+#define MATE_MIXER_TYPE_MONITOR_BUFFER (mate_mixer_monitor_buffer_get_type ())
+
+/**
+ * MATE_MIXER_MONITOR_MAX_CHANNELS:
+ *
+ * The maximum number of channels of a #MateMixerMonitorReading.
+ */
+#define MATE_MIXER_MONITOR_MAX_CHANNELS 32
+
+/**
+ * MateMixerMonitorReading:
+ * @time: the monotonic time at which the levels were captured in
+ * microseconds, see g_get_monotonic_time()
+ * @n_channels: the number of valid values in @peak
+ * @peak: the peak level of each channel in the range from 0.0 to 1.0
+ *
+ * A single reading of a #MateMixerMonitorBuffer.
+ */
+struct _MateMixerMonitorReading
+{
+    gint64 time;
+    guint  n_channels;
+    gfloat peak[MATE_MIXER_MONITOR_MAX_CHANNELS];
+};
+
+GType                   mate_mixer_monitor_buffer_get_type    (void) G_GNUC_CONST;
+
+MateMixerMonitorBuffer *mate_mixer_monitor_buffer_ref         (MateMixerMonitorBuffer  *buffer);
+void                    mate_mixer_monitor_buffer_unref       (MateMixerMonitorBuffer  *buffer);
+
+gboolean                mate_mixer_monitor_buffer_pop         (MateMixerMonitorBuffer  *buffer,
+                                                               MateMixerMonitorReading *reading);
+
+guint                   mate_mixer_monitor_buffer_get_dropped (MateMixerMonitorBuffer  *buffer);
+
+G_END_DECLS
+
+#endif /* MATEMIXER_MONITOR_BUFFER_H */
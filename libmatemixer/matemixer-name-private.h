@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MATEMIXER_NAME_PRIVATE_H
+#define MATEMIXER_NAME_PRIVATE_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Shared object names.
+ *
+ * Names of devices, streams, controls, switches and options are kept in a
+ * table of the library, so all the objects with the same name share a single
+ * string and names of objects may be compared by pointer. Unlike interned
+ * strings, the names are reference counted and a name is freed as soon as the
+ * last object using it is gone, so per-instance names such as those of sink
+ * inputs do not accumulate over the lifetime of the process.
+ */
+const gchar *_mate_mixer_name_ref   (const gchar *name);
+void         _mate_mixer_name_unref (const gchar *name);
+
+G_END_DECLS
+
+#endif /* MATEMIXER_NAME_PRIVATE_H */
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string.h>
+#include <glib.h>
+
+#include "matemixer-name-private.h"
+
+typedef struct
+{
+    gint  ref_count;
+    gchar name[1];
+} MateMixerName;
+
+#define NAME_ENTRY(n) \
+        ((MateMixerName *) ((n) - G_STRUCT_OFFSET (MateMixerName, name)))
+
+/* Objects may be finalized in other threads than the one they were created
+ * in, so the table is protected by a lock */
+G_LOCK_DEFINE_STATIC (names);
+
+static GHashTable *names = NULL;
+
+/* Returns the shared copy of the name with an extra reference, which must be
+ * released using _mate_mixer_name_unref() */
+const gchar *
+_mate_mixer_name_ref (const gchar *name)
+{
+    MateMixerName *entry;
+
+    if (name == NULL)
+        return NULL;
+
+    G_LOCK (names);
+
+    /* Keys are owned by the entries */
+    if G_UNLIKELY (names == NULL)
+        names = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, g_free);
+
+    entry = g_hash_table_lookup (names, name);
+    if (entry == NULL) {
+        gsize length = strlen (name);
+
+        entry = g_malloc (G_STRUCT_OFFSET (MateMixerName, name) + length + 1);
+        entry->ref_count = 0;
+        memcpy (entry->name, name, length + 1);
+
+        g_hash_table_insert (names, entry->name, entry);
+    }
+    entry->ref_count++;
+
+    G_UNLOCK (names);
+
+    return entry->name;
+}
+
+/* The name must have been returned by _mate_mixer_name_ref() */
+void
+_mate_mixer_name_unref (const gchar *name)
+{
+    MateMixerName *entry;
+
+    if (name == NULL)
+        return;
+
+    entry = NAME_ENTRY (name);
+
+    G_LOCK (names);
+
+    if (--entry->ref_count == 0)
+        g_hash_table_remove (names, entry->name);
+
+    G_UNLOCK (names);
+}
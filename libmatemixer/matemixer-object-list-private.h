@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MATEMIXER_OBJECT_LIST_PRIVATE_H
+#define MATEMIXER_OBJECT_LIST_PRIVATE_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/*
+ * A list of referenced objects which is updated in place as objects come and
+ * go, meant to back the list_* functions of backends.
+ *
+ * Adding and removing an object are constant-time operations and the GList
+ * returned by _mate_mixer_object_list_peek() stays valid until the next
+ * change, so there is no need to rebuild the list from a hash table after
+ * each change.
+ *
+ * The objects are also indexed by their "name" property, which must not
+ * change while the object is in the list.
+ */
+typedef struct _MateMixerObjectList  MateMixerObjectList;
+
+MateMixerObjectList *_mate_mixer_object_list_new     (void);
+void                 _mate_mixer_object_list_free    (MateMixerObjectList *list);
+
+void                 _mate_mixer_object_list_append  (MateMixerObjectList *list,
+                                                      gpointer             object);
+void                 _mate_mixer_object_list_prepend (MateMixerObjectList *list,
+                                                      gpointer             object);
+gboolean             _mate_mixer_object_list_remove  (MateMixerObjectList *list,
+                                                      gpointer             object);
+void                 _mate_mixer_object_list_clear   (MateMixerObjectList *list);
+
+const GList *        _mate_mixer_object_list_peek    (MateMixerObjectList *list);
+
+gpointer             _mate_mixer_object_list_lookup  (MateMixerObjectList *list,
+                                                      const gchar         *name);
+
+G_END_DECLS
+
+#endif /* MATEMIXER_OBJECT_LIST_PRIVATE_H */
@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include "matemixer-name-private.h"
+#include "matemixer-object-list-private.h"
+
+struct _MateMixerObjectList
+{
+    GQueue      queue;
+    GHashTable *links;
+    GHashTable *names;
+};
+
+static void add_name    (MateMixerObjectList *list,
+                         gpointer             object);
+static void remove_name (MateMixerObjectList *list,
+                         gpointer             object);
+
+MateMixerObjectList *
+_mate_mixer_object_list_new (void)
+{
+    MateMixerObjectList *list;
+
+    list = g_slice_new (MateMixerObjectList);
+    g_queue_init (&list->queue);
+
+    /* Maps each object to its link in the queue */
+    list->links = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+    /* Maps the shared name of each object to the object */
+    list->names = g_hash_table_new_full (g_str_hash,
+                                         g_str_equal,
+                                         (GDestroyNotify) _mate_mixer_name_unref,
+                                         NULL);
+    return list;
+}
+
+void
+_mate_mixer_object_list_free (MateMixerObjectList *list)
+{
+    if (list == NULL)
+        return;
+
+    _mate_mixer_object_list_clear (list);
+
+    g_hash_table_destroy (list->links);
+    g_hash_table_destroy (list->names);
+    g_slice_free (MateMixerObjectList, list);
+}
+
+void
+_mate_mixer_object_list_append (MateMixerObjectList *list, gpointer object)
+{
+    g_return_if_fail (list != NULL);
+    g_return_if_fail (G_IS_OBJECT (object));
+
+    if G_UNLIKELY (g_hash_table_contains (list->links, object) == TRUE)
+        return;
+
+    g_queue_push_tail (&list->queue, g_object_ref (object));
+    g_hash_table_insert (list->links, object, list->queue.tail);
+
+    add_name (list, object);
+}
+
+void
+_mate_mixer_object_list_prepend (MateMixerObjectList *list, gpointer object)
+{
+    g_return_if_fail (list != NULL);
+    g_return_if_fail (G_IS_OBJECT (object));
+
+    if G_UNLIKELY (g_hash_table_contains (list->links, object) == TRUE)
+        return;
+
+    g_queue_push_head (&list->queue, g_object_ref (object));
+    g_hash_table_insert (list->links, object, list->queue.head);
+
+    add_name (list, object);
+}
+
+gboolean
+_mate_mixer_object_list_remove (MateMixerObjectList *list, gpointer object)
+{
+    GList *link;
+
+    g_return_val_if_fail (list != NULL, FALSE);
+    g_return_val_if_fail (object != NULL, FALSE);
+
+    link = g_hash_table_lookup (list->links, object);
+    if (link == NULL)
+        return FALSE;
+
+    g_hash_table_remove (list->links, object);
+    g_queue_delete_link (&list->queue, link);
+
+    remove_name (list, object);
+
+    g_object_unref (object);
+    return TRUE;
+}
+
+void
+_mate_mixer_object_list_clear (MateMixerObjectList *list)
+{
+    g_return_if_fail (list != NULL);
+
+    g_hash_table_remove_all (list->links);
+    g_hash_table_remove_all (list->names);
+
+    g_queue_foreach (&list->queue, (GFunc) g_object_unref, NULL);
+    g_queue_clear (&list->queue);
+}
+
+const GList *
+_mate_mixer_object_list_peek (MateMixerObjectList *list)
+{
+    g_return_val_if_fail (list != NULL, NULL);
+
+    return list->queue.head;
+}
+
+gpointer
+_mate_mixer_object_list_lookup (MateMixerObjectList *list, const gchar *name)
+{
+    g_return_val_if_fail (list != NULL, NULL);
+    g_return_val_if_fail (name != NULL, NULL);
+
+    return g_hash_table_lookup (list->names, name);
+}
+
+static void
+add_name (MateMixerObjectList *list, gpointer object)
+{
+    gchar *name = NULL;
+
+    g_object_get (G_OBJECT (object), "name", &name, NULL);
+    if G_UNLIKELY (name == NULL)
+        return;
+
+    g_hash_table_replace (list->names, (gpointer) _mate_mixer_name_ref (name), object);
+    g_free (name);
+}
+
+static void
+remove_name (MateMixerObjectList *list, gpointer object)
+{
+    gchar *name = NULL;
+
+    g_object_get (G_OBJECT (object), "name", &name, NULL);
+    if G_UNLIKELY (name == NULL)
+        return;
+
+    /* Another object with the same name might have replaced this one */
+    if (g_hash_table_lookup (list->names, name) == object)
+        g_hash_table_remove (list->names, name);
+
+    g_free (name);
+}
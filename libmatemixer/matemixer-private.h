@@ -23,8 +23,17 @@
 #include "matemixer-enums.h"
 
 #include "matemixer-app-info-private.h"
+#include "matemixer-array-cache-private.h"
 #include "matemixer-backend.h"
 #include "matemixer-backend-module.h"
+#include "matemixer-change-set-private.h"
+#include "matemixer-control-index-private.h"
+#include "matemixer-device-private.h"
+#include "matemixer-index-private.h"
+#include "matemixer-monitor-buffer-private.h"
+#include "matemixer-name-private.h"
+#include "matemixer-object-list-private.h"
+#include "matemixer-snapshot-private.h"
 #include "matemixer-stream-private.h"
 #include "matemixer-stream-control-private.h"
 #include "matemixer-switch-private.h"
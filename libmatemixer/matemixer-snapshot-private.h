@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef MATEMIXER_SNAPSHOT_PRIVATE_H
+#define MATEMIXER_SNAPSHOT_PRIVATE_H
+
+#include <glib.h>
+
+#include "matemixer-backend.h"
+#include "matemixer-change-set.h"
+#include "matemixer-types.h"
+
+G_BEGIN_DECLS
+
+void               _mate_mixer_snapshot_clear         (MateMixerSnapshot  *snapshot);
+
+void               _mate_mixer_snapshot_fill          (MateMixerSnapshot  *snapshot,
+                                                       MateMixerBackend   *backend,
+                                                       guint               generation);
+
+void               _mate_mixer_snapshot_set_source    (MateMixerSnapshot  *snapshot,
+                                                       const gchar        *source);
+const gchar *      _mate_mixer_snapshot_get_source    (MateMixerSnapshot  *snapshot);
+
+MateMixerSnapshot *_mate_mixer_snapshot_new_from_file (const gchar        *filename);
+
+gboolean           _mate_mixer_snapshot_save          (MateMixerSnapshot  *snapshot,
+                                                       const gchar        *filename);
+
+void               _mate_mixer_snapshot_compare       (MateMixerSnapshot  *snapshot,
+                                                       MateMixerSnapshot  *cached,
+                                                       MateMixerChangeSet *changes);
+
+G_END_DECLS
+
+#endif /* MATEMIXER_SNAPSHOT_PRIVATE_H */
@@ -0,0 +1,886 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <glib.h>
+#include <glib-object.h>
+
+#include "matemixer-backend.h"
+#include "matemixer-change-set.h"
+#include "matemixer-change-set-private.h"
+#include "matemixer-snapshot.h"
+#include "matemixer-snapshot-private.h"
+#include "matemixer-stored-control.h"
+#include "matemixer-stream.h"
+#include "matemixer-stream-control.h"
+#include "matemixer-stream-control-private.h"
+
+/**
+ * SECTION:matemixer-snapshot
+ * @short_description: State of all streams and controls
+ * @include: libmatemixer/matemixer.h
+ * @see_also: #MateMixerContext
+ *
+ * The #MateMixerSnapshot structure holds the state of all streams and stream
+ * controls of a #MateMixerContext in flat arrays, it is filled by
+ * mate_mixer_context_fill_snapshot().
+ *
+ * The arrays are kept when the snapshot is filled again, so refreshing a
+ * snapshot only allocates memory when the number of streams, controls or
+ * channels grows.
+ *
+ * A snapshot saved by a previous session is provided by
+ * mate_mixer_context_get_cached_snapshot() while the context is connecting,
+ * such a snapshot contains no objects.
+ */
+
+struct _MateMixerSnapshot
+{
+    volatile gint  ref_count;
+    guint          generation;
+    GArray        *streams;
+    GArray        *controls;
+    GArray        *volumes;
+    GMappedFile   *file;
+    GStringChunk  *strings;
+    gchar         *source;
+};
+
+/* The cache file contains a header followed by the stream records, the control
+ * records, the channel volumes and a table of nul-terminated strings, which
+ * the records refer to by offsets. Everything is stored in the native byte
+ * order as the file is only read on the machine where it was written.
+ * A loaded snapshot keeps the file mapped and uses the strings in place.
+ * The header also refers to a string which identifies the sound system the
+ * snapshot was taken from */
+#define SNAPSHOT_FILE_MAGIC      0x584d4d4c
+#define SNAPSHOT_FILE_VERSION    2
+#define SNAPSHOT_FILE_NO_STRING  G_MAXUINT32
+
+typedef struct
+{
+    guint32 magic;
+    guint32 version;
+    guint32 n_streams;
+    guint32 n_controls;
+    guint32 n_volumes;
+    guint32 strings_size;
+    guint32 source;
+} SnapshotFileHeader;
+
+typedef struct
+{
+    guint32 name;
+    guint32 label;
+    guint32 direction;
+    guint32 is_default;
+    guint32 first_control;
+    guint32 n_controls;
+} SnapshotFileStream;
+
+typedef struct
+{
+    guint32 name;
+    guint32 label;
+    guint32 stream_index;
+    guint32 flags;
+    guint32 is_default;
+    guint32 mute;
+    guint32 volume;
+    gfloat  balance;
+    gfloat  fade;
+    guint32 first_channel;
+    guint32 n_channels;
+} SnapshotFileControl;
+
+/**
+ * MateMixerSnapshot:
+ *
+ * The #MateMixerSnapshot structure contains only private data and should only
+ * be accessed using the provided API.
+ */
+G_DEFINE_BOXED_TYPE (MateMixerSnapshot, mate_mixer_snapshot,
+                     mate_mixer_snapshot_ref,
+                     mate_mixer_snapshot_unref)
+
+static void                 add_control     (MateMixerSnapshot           *snapshot,
+                                             MateMixerStreamControl      *control,
+                                             guint                        stream_index,
+                                             gboolean                     is_default);
+
+static guint32              add_string      (GString                     *strings,
+                                             const gchar                 *str);
+static gboolean             lookup_string   (const gchar                 *strings,
+                                             guint32                      size,
+                                             guint32                      offset,
+                                             const gchar                **str);
+
+static MateMixerChangeFlags compare_control (MateMixerSnapshot           *snapshot,
+                                             const MateMixerControlState *state,
+                                             MateMixerSnapshot           *cached,
+                                             const MateMixerControlState *cached_state);
+
+/**
+ * mate_mixer_snapshot_new:
+ *
+ * Creates a new empty snapshot.
+ *
+ * Returns: a new #MateMixerSnapshot. Use mate_mixer_snapshot_unref() to
+ * release it.
+ */
+MateMixerSnapshot *
+mate_mixer_snapshot_new (void)
+{
+    MateMixerSnapshot *snapshot;
+
+    snapshot = g_slice_new (MateMixerSnapshot);
+    snapshot->ref_count  = 1;
+    snapshot->generation = 0;
+    snapshot->streams    = g_array_new (FALSE, FALSE, sizeof (MateMixerStreamState));
+    snapshot->controls   = g_array_new (FALSE, FALSE, sizeof (MateMixerControlState));
+    snapshot->volumes    = g_array_new (FALSE, FALSE, sizeof (guint));
+    snapshot->file       = NULL;
+    snapshot->strings    = NULL;
+    snapshot->source     = NULL;
+    return snapshot;
+}
+
+/**
+ * mate_mixer_snapshot_ref:
+ * @snapshot: a #MateMixerSnapshot
+ *
+ * Increases the reference count of @snapshot.
+ *
+ * Returns: the @snapshot.
+ */
+MateMixerSnapshot *
+mate_mixer_snapshot_ref (MateMixerSnapshot *snapshot)
+{
+    g_return_val_if_fail (snapshot != NULL, NULL);
+
+    g_atomic_int_inc (&snapshot->ref_count);
+    return snapshot;
+}
+
+/**
+ * mate_mixer_snapshot_unref:
+ * @snapshot: a #MateMixerSnapshot
+ *
+ * Decreases the reference count of @snapshot. When the reference count drops
+ * to zero, the snapshot and the references to the objects it contains are
+ * released.
+ */
+void
+mate_mixer_snapshot_unref (MateMixerSnapshot *snapshot)
+{
+    g_return_if_fail (snapshot != NULL);
+
+    if (g_atomic_int_dec_and_test (&snapshot->ref_count) == FALSE)
+        return;
+
+    _mate_mixer_snapshot_clear (snapshot);
+
+    g_array_free (snapshot->streams, TRUE);
+    g_array_free (snapshot->controls, TRUE);
+    g_array_free (snapshot->volumes, TRUE);
+
+    if (snapshot->strings != NULL)
+        g_string_chunk_free (snapshot->strings);
+
+    g_free (snapshot->source);
+    g_slice_free (MateMixerSnapshot, snapshot);
+}
+
+/**
+ * mate_mixer_snapshot_get_generation:
+ * @snapshot: a #MateMixerSnapshot
+ *
+ * Gets the generation number of the context at the time the snapshot was
+ * filled, see mate_mixer_context_get_generation().
+ *
+ * Returns: the generation number.
+ */
+guint
+mate_mixer_snapshot_get_generation (MateMixerSnapshot *snapshot)
+{
+    g_return_val_if_fail (snapshot != NULL, 0);
+
+    return snapshot->generation;
+}
+
+/**
+ * mate_mixer_snapshot_get_streams:
+ * @snapshot: a #MateMixerSnapshot
+ * @n_streams: (out): return location for the number of streams
+ *
+ * Gets the state of all streams in the snapshot.
+ *
+ * Returns: (array length=n_streams) (transfer none): an array of stream
+ * states owned by @snapshot.
+ */
+const MateMixerStreamState *
+mate_mixer_snapshot_get_streams (MateMixerSnapshot *snapshot, guint *n_streams)
+{
+    g_return_val_if_fail (snapshot != NULL, NULL);
+    g_return_val_if_fail (n_streams != NULL, NULL);
+
+    *n_streams = snapshot->streams->len;
+
+    return (const MateMixerStreamState *) snapshot->streams->data;
+}
+
+/**
+ * mate_mixer_snapshot_get_controls:
+ * @snapshot: a #MateMixerSnapshot
+ * @n_controls: (out): return location for the number of controls
+ *
+ * Gets the state of all stream controls in the snapshot. The controls of each
+ * stream are stored next to each other, followed by the stored controls.
+ *
+ * Returns: (array length=n_controls) (transfer none): an array of control
+ * states owned by @snapshot.
+ */
+const MateMixerControlState *
+mate_mixer_snapshot_get_controls (MateMixerSnapshot *snapshot, guint *n_controls)
+{
+    g_return_val_if_fail (snapshot != NULL, NULL);
+    g_return_val_if_fail (n_controls != NULL, NULL);
+
+    *n_controls = snapshot->controls->len;
+
+    return (const MateMixerControlState *) snapshot->controls->data;
+}
+
+/**
+ * mate_mixer_snapshot_get_channel_volumes:
+ * @snapshot: a #MateMixerSnapshot
+ * @n_volumes: (out): return location for the number of volumes
+ *
+ * Gets the channel volumes of all controls in the snapshot, the volumes of
+ * a control start at the @first_channel index of its #MateMixerControlState.
+ *
+ * Returns: (array length=n_volumes) (transfer none): an array of volumes
+ * owned by @snapshot.
+ */
+const guint *
+mate_mixer_snapshot_get_channel_volumes (MateMixerSnapshot *snapshot, guint *n_volumes)
+{
+    g_return_val_if_fail (snapshot != NULL, NULL);
+    g_return_val_if_fail (n_volumes != NULL, NULL);
+
+    *n_volumes = snapshot->volumes->len;
+
+    return (const guint *) snapshot->volumes->data;
+}
+
+void
+_mate_mixer_snapshot_clear (MateMixerSnapshot *snapshot)
+{
+    guint i;
+
+    g_return_if_fail (snapshot != NULL);
+
+    for (i = 0; i < snapshot->streams->len; i++) {
+        MateMixerStream *stream = g_array_index (snapshot->streams, MateMixerStreamState, i).stream;
+
+        if (stream != NULL)
+            g_object_unref (stream);
+    }
+
+    for (i = 0; i < snapshot->controls->len; i++) {
+        MateMixerStreamControl *control = g_array_index (snapshot->controls, MateMixerControlState, i).control;
+
+        if (control != NULL)
+            g_object_unref (control);
+    }
+
+    /* Only reset the lengths, the allocated memory is reused */
+    g_array_set_size (snapshot->streams, 0);
+    g_array_set_size (snapshot->controls, 0);
+    g_array_set_size (snapshot->volumes, 0);
+
+    snapshot->generation = 0;
+
+    /* The strings of a loaded snapshot point into the mapped file */
+    if (snapshot->file != NULL) {
+        g_mapped_file_unref (snapshot->file);
+        snapshot->file = NULL;
+    }
+
+    if (snapshot->strings != NULL)
+        g_string_chunk_clear (snapshot->strings);
+}
+
+void
+_mate_mixer_snapshot_fill (MateMixerSnapshot *snapshot,
+                           MateMixerBackend  *backend,
+                           guint              generation)
+{
+    MateMixerStream *default_input;
+    MateMixerStream *default_output;
+    const GList     *list;
+    guint            first_stored;
+
+    g_return_if_fail (snapshot != NULL);
+    g_return_if_fail (MATE_MIXER_IS_BACKEND (backend));
+
+    _mate_mixer_snapshot_clear (snapshot);
+
+    snapshot->generation = generation;
+
+    default_input  = mate_mixer_backend_get_default_input_stream (backend);
+    default_output = mate_mixer_backend_get_default_output_stream (backend);
+
+    list = mate_mixer_backend_list_streams (backend);
+    while (list != NULL) {
+        MateMixerStream        *stream = MATE_MIXER_STREAM (list->data);
+        MateMixerStreamControl *default_control;
+        MateMixerStreamState    state;
+        const GList            *controls;
+
+        state.stream        = g_object_ref (stream);
+        state.name          = mate_mixer_stream_get_name (stream);
+        state.label         = mate_mixer_stream_get_label (stream);
+        state.direction     = mate_mixer_stream_get_direction (stream);
+        state.generation    = mate_mixer_stream_get_generation (stream);
+        state.is_default    = (stream == default_input || stream == default_output);
+        state.first_control = snapshot->controls->len;
+        state.n_controls    = 0;
+
+        default_control = mate_mixer_stream_get_default_control (stream);
+
+        controls = mate_mixer_stream_list_controls (stream);
+        while (controls != NULL) {
+            MateMixerStreamControl *control = MATE_MIXER_STREAM_CONTROL (controls->data);
+
+            add_control (snapshot,
+                         control,
+                         snapshot->streams->len,
+                         control == default_control);
+
+            state.n_controls++;
+            controls = controls->next;
+        }
+
+        g_array_append_val (snapshot->streams, state);
+
+        list = list->next;
+    }
+
+    first_stored = snapshot->controls->len;
+
+    /* Listing the stored controls would make the backend create all of them,
+     * prefer reading the state of those which do not exist yet directly */
+    if (mate_mixer_backend_get_stored_control_states (backend,
+                                                      snapshot->controls,
+                                                      snapshot->volumes) == TRUE) {
+        guint i;
+
+        /* Without an object keeping them alive, the strings belong to the
+         * backend and might go away with the next change */
+        for (i = first_stored; i < snapshot->controls->len; i++) {
+            MateMixerControlState *state = &g_array_index (snapshot->controls, MateMixerControlState, i);
+
+            if (state->control != NULL)
+                continue;
+
+            if (snapshot->strings == NULL)
+                snapshot->strings = g_string_chunk_new (1024);
+
+            state->name = g_string_chunk_insert_const (snapshot->strings, state->name);
+
+            if (state->label != NULL)
+                state->label = g_string_chunk_insert_const (snapshot->strings, state->label);
+        }
+        return;
+    }
+
+    list = mate_mixer_backend_list_stored_controls (backend);
+    while (list != NULL) {
+        add_control (snapshot,
+                     MATE_MIXER_STREAM_CONTROL (list->data),
+                     MATE_MIXER_SNAPSHOT_NO_STREAM,
+                     FALSE);
+
+        list = list->next;
+    }
+}
+
+void
+_mate_mixer_snapshot_set_source (MateMixerSnapshot *snapshot, const gchar *source)
+{
+    g_return_if_fail (snapshot != NULL);
+
+    g_free (snapshot->source);
+
+    snapshot->source = g_strdup (source);
+}
+
+const gchar *
+_mate_mixer_snapshot_get_source (MateMixerSnapshot *snapshot)
+{
+    g_return_val_if_fail (snapshot != NULL, NULL);
+
+    return snapshot->source;
+}
+
+MateMixerSnapshot *
+_mate_mixer_snapshot_new_from_file (const gchar *filename)
+{
+    MateMixerSnapshot         *snapshot;
+    GMappedFile               *file;
+    const SnapshotFileHeader  *header;
+    const SnapshotFileStream  *streams;
+    const SnapshotFileControl *controls;
+    const guint32             *volumes;
+    const gchar               *strings;
+    const gchar               *source;
+    guint64                    length;
+    guint                      i;
+
+    g_return_val_if_fail (filename != NULL, NULL);
+
+    file = g_mapped_file_new (filename, FALSE, NULL);
+    if (file == NULL)
+        return NULL;
+
+    header = (const SnapshotFileHeader *) g_mapped_file_get_contents (file);
+    length = g_mapped_file_get_length (file);
+
+    if (length < sizeof (SnapshotFileHeader) ||
+        header->magic != SNAPSHOT_FILE_MAGIC ||
+        header->version != SNAPSHOT_FILE_VERSION)
+        goto invalid;
+
+    if (length != sizeof (SnapshotFileHeader) +
+                  (guint64) header->n_streams * sizeof (SnapshotFileStream) +
+                  (guint64) header->n_controls * sizeof (SnapshotFileControl) +
+                  (guint64) header->n_volumes * sizeof (guint32) +
+                  (guint64) header->strings_size)
+        goto invalid;
+
+    streams  = (const SnapshotFileStream *) (header + 1);
+    controls = (const SnapshotFileControl *) (streams + header->n_streams);
+    volumes  = (const guint32 *) (controls + header->n_controls);
+    strings  = (const gchar *) (volumes + header->n_volumes);
+
+    /* The last string must be terminated to be usable in place */
+    if (header->strings_size > 0 && strings[header->strings_size - 1] != '\0')
+        goto invalid;
+
+    if (lookup_string (strings, header->strings_size, header->source, &source) == FALSE)
+        goto invalid;
+
+    snapshot = mate_mixer_snapshot_new ();
+    snapshot->file   = file;
+    snapshot->source = g_strdup (source);
+
+    for (i = 0; i < header->n_streams; i++) {
+        MateMixerStreamState state;
+
+        if (streams[i].first_control > header->n_controls ||
+            streams[i].n_controls > header->n_controls - streams[i].first_control)
+            goto invalid_snapshot;
+
+        if (lookup_string (strings, header->strings_size, streams[i].name, &state.name) == FALSE ||
+            lookup_string (strings, header->strings_size, streams[i].label, &state.label) == FALSE ||
+            state.name == NULL)
+            goto invalid_snapshot;
+
+        state.stream        = NULL;
+        state.direction     = streams[i].direction;
+        state.generation    = 0;
+        state.is_default    = streams[i].is_default;
+        state.first_control = streams[i].first_control;
+        state.n_controls    = streams[i].n_controls;
+
+        g_array_append_val (snapshot->streams, state);
+    }
+
+    for (i = 0; i < header->n_controls; i++) {
+        MateMixerControlState state;
+
+        if (controls[i].stream_index >= header->n_streams &&
+            controls[i].stream_index != MATE_MIXER_SNAPSHOT_NO_STREAM)
+            goto invalid_snapshot;
+
+        if (controls[i].first_channel > header->n_volumes ||
+            controls[i].n_channels > header->n_volumes - controls[i].first_channel)
+            goto invalid_snapshot;
+
+        if (lookup_string (strings, header->strings_size, controls[i].name, &state.name) == FALSE ||
+            lookup_string (strings, header->strings_size, controls[i].label, &state.label) == FALSE ||
+            state.name == NULL)
+            goto invalid_snapshot;
+
+        state.control       = NULL;
+        state.stream_index  = controls[i].stream_index;
+        state.flags         = controls[i].flags;
+        state.generation    = 0;
+        state.is_default    = controls[i].is_default;
+        state.mute          = controls[i].mute;
+        state.volume        = controls[i].volume;
+        state.balance       = controls[i].balance;
+        state.fade          = controls[i].fade;
+        state.first_channel = controls[i].first_channel;
+        state.n_channels    = controls[i].n_channels;
+
+        g_array_append_val (snapshot->controls, state);
+    }
+
+    g_array_append_vals (snapshot->volumes, volumes, header->n_volumes);
+    return snapshot;
+
+invalid_snapshot:
+    /* This also releases the file */
+    mate_mixer_snapshot_unref (snapshot);
+
+    g_debug ("Ignoring invalid cache file %s", filename);
+    return NULL;
+
+invalid:
+    g_mapped_file_unref (file);
+
+    g_debug ("Ignoring invalid cache file %s", filename);
+    return NULL;
+}
+
+gboolean
+_mate_mixer_snapshot_save (MateMixerSnapshot *snapshot, const gchar *filename)
+{
+    SnapshotFileHeader  header;
+    GByteArray         *data;
+    GString            *strings;
+    GError             *error = NULL;
+    gboolean            ret;
+    guint               i;
+
+    g_return_val_if_fail (snapshot != NULL, FALSE);
+    g_return_val_if_fail (filename != NULL, FALSE);
+
+    data    = g_byte_array_new ();
+    strings = g_string_new (NULL);
+
+    /* Leave space for the header, which is only complete when the size of
+     * the string table is known */
+    g_byte_array_set_size (data, sizeof (SnapshotFileHeader));
+
+    for (i = 0; i < snapshot->streams->len; i++) {
+        MateMixerStreamState *state = &g_array_index (snapshot->streams, MateMixerStreamState, i);
+        SnapshotFileStream    record;
+
+        record.name          = add_string (strings, state->name);
+        record.label         = add_string (strings, state->label);
+        record.direction     = state->direction;
+        record.is_default    = state->is_default;
+        record.first_control = state->first_control;
+        record.n_controls    = state->n_controls;
+
+        g_byte_array_append (data, (const guint8 *) &record, sizeof (record));
+    }
+
+    for (i = 0; i < snapshot->controls->len; i++) {
+        MateMixerControlState *state = &g_array_index (snapshot->controls, MateMixerControlState, i);
+        SnapshotFileControl    record;
+
+        record.name          = add_string (strings, state->name);
+        record.label         = add_string (strings, state->label);
+        record.stream_index  = state->stream_index;
+        record.flags         = state->flags;
+        record.is_default    = state->is_default;
+        record.mute          = state->mute;
+        record.volume        = state->volume;
+        record.balance       = state->balance;
+        record.fade          = state->fade;
+        record.first_channel = state->first_channel;
+        record.n_channels    = state->n_channels;
+
+        g_byte_array_append (data, (const guint8 *) &record, sizeof (record));
+    }
+
+    g_byte_array_append (data,
+                         (const guint8 *) snapshot->volumes->data,
+                         snapshot->volumes->len * sizeof (guint32));
+
+    header.source = add_string (strings, snapshot->source);
+
+    g_byte_array_append (data,
+                         (const guint8 *) strings->str,
+                         strings->len);
+
+    header.magic        = SNAPSHOT_FILE_MAGIC;
+    header.version      = SNAPSHOT_FILE_VERSION;
+    header.n_streams    = snapshot->streams->len;
+    header.n_controls   = snapshot->controls->len;
+    header.n_volumes    = snapshot->volumes->len;
+    header.strings_size = strings->len;
+
+    memcpy (data->data, &header, sizeof (header));
+
+    /* The file is replaced atomically, so other processes sharing the cache
+     * never read a partially written file */
+    ret = g_file_set_contents (filename, (const gchar *) data->data, data->len, &error);
+    if (ret == FALSE) {
+        g_debug ("Failed to save cache file %s: %s", filename, error->message);
+        g_error_free (error);
+    }
+
+    g_string_free (strings, TRUE);
+    g_byte_array_unref (data);
+    return ret;
+}
+
+void
+_mate_mixer_snapshot_compare (MateMixerSnapshot  *snapshot,
+                              MateMixerSnapshot  *cached,
+                              MateMixerChangeSet *changes)
+{
+    GHashTable *streams;
+    GHashTable *stored_controls;
+    gboolean   *hanging_streams;
+    gboolean   *hanging_controls;
+    guint       i, j, k;
+
+    g_return_if_fail (snapshot != NULL);
+    g_return_if_fail (cached != NULL);
+    g_return_if_fail (changes != NULL);
+
+    streams         = g_hash_table_new (g_str_hash, g_str_equal);
+    stored_controls = g_hash_table_new (g_str_hash, g_str_equal);
+
+    /* Mark everything in the cached snapshot as hanging, whatever is still
+     * hanging after walking through the current state has been removed */
+    hanging_streams  = g_new (gboolean, cached->streams->len + 1);
+    hanging_controls = g_new (gboolean, cached->controls->len + 1);
+
+    for (i = 0; i < cached->streams->len; i++) {
+        MateMixerStreamState *state = &g_array_index (cached->streams, MateMixerStreamState, i);
+
+        g_hash_table_insert (streams, (gpointer) state->name, GUINT_TO_POINTER (i + 1));
+        hanging_streams[i] = TRUE;
+    }
+
+    for (i = 0; i < cached->controls->len; i++) {
+        MateMixerControlState *state = &g_array_index (cached->controls, MateMixerControlState, i);
+
+        if (state->stream_index == MATE_MIXER_SNAPSHOT_NO_STREAM)
+            g_hash_table_insert (stored_controls,
+                                 (gpointer) state->name,
+                                 GUINT_TO_POINTER (i + 1));
+
+        hanging_controls[i] = TRUE;
+    }
+
+    for (i = 0; i < snapshot->streams->len; i++) {
+        MateMixerStreamState *state = &g_array_index (snapshot->streams, MateMixerStreamState, i);
+        MateMixerStreamState *cached_state;
+        MateMixerChangeFlags  flags = MATE_MIXER_CHANGE_NONE;
+        guint                 index;
+
+        index = GPOINTER_TO_UINT (g_hash_table_lookup (streams, state->name));
+        if (index == 0) {
+            _mate_mixer_change_set_add_object (changes,
+                                               G_OBJECT (state->stream),
+                                               MATE_MIXER_CHANGE_ADDED);
+            continue;
+        }
+
+        cached_state = &g_array_index (cached->streams, MateMixerStreamState, index - 1);
+        hanging_streams[index - 1] = FALSE;
+
+        if (g_strcmp0 (state->label, cached_state->label) != 0)
+            flags |= MATE_MIXER_CHANGE_LABEL;
+
+        if (state->is_default == TRUE && cached_state->is_default == FALSE) {
+            if (state->direction == MATE_MIXER_DIRECTION_INPUT)
+                flags |= MATE_MIXER_CHANGE_DEFAULT_INPUT_STREAM;
+            else
+                flags |= MATE_MIXER_CHANGE_DEFAULT_OUTPUT_STREAM;
+        }
+
+        /* Streams only contain a few controls, match them by walking through
+         * the controls of the cached stream */
+        for (j = state->first_control; j < state->first_control + state->n_controls; j++) {
+            MateMixerControlState *control = &g_array_index (snapshot->controls, MateMixerControlState, j);
+            MateMixerChangeFlags   control_flags;
+
+            for (k = cached_state->first_control; k < cached_state->first_control + cached_state->n_controls; k++) {
+                if (hanging_controls[k] == TRUE &&
+                    strcmp (control->name, g_array_index (cached->controls, MateMixerControlState, k).name) == 0)
+                    break;
+            }
+
+            if (k == cached_state->first_control + cached_state->n_controls) {
+                flags |= MATE_MIXER_CHANGE_CHILDREN;
+                continue;
+            }
+
+            hanging_controls[k] = FALSE;
+
+            control_flags = compare_control (snapshot,
+                                             control,
+                                             cached,
+                                             &g_array_index (cached->controls, MateMixerControlState, k));
+            if (control_flags != MATE_MIXER_CHANGE_NONE)
+                _mate_mixer_change_set_add_object (changes,
+                                                   G_OBJECT (control->control),
+                                                   control_flags);
+        }
+
+        for (k = cached_state->first_control; k < cached_state->first_control + cached_state->n_controls; k++) {
+            if (hanging_controls[k] == TRUE) {
+                flags |= MATE_MIXER_CHANGE_CHILDREN;
+                break;
+            }
+        }
+
+        if (flags != MATE_MIXER_CHANGE_NONE)
+            _mate_mixer_change_set_add_object (changes, G_OBJECT (state->stream), flags);
+    }
+
+    for (i = 0; i < snapshot->controls->len; i++) {
+        MateMixerControlState *state = &g_array_index (snapshot->controls, MateMixerControlState, i);
+        MateMixerChangeFlags   flags;
+        guint                  index;
+
+        if (state->stream_index != MATE_MIXER_SNAPSHOT_NO_STREAM)
+            continue;
+
+        index = GPOINTER_TO_UINT (g_hash_table_lookup (stored_controls, state->name));
+        if (index > 0) {
+            hanging_controls[index - 1] = FALSE;
+
+            flags = compare_control (snapshot,
+                                     state,
+                                     cached,
+                                     &g_array_index (cached->controls, MateMixerControlState, index - 1));
+        } else {
+            flags = MATE_MIXER_CHANGE_ADDED;
+        }
+
+        if (flags == MATE_MIXER_CHANGE_NONE)
+            continue;
+
+        /* Stored controls which have not been created are listed by name */
+        if (state->control != NULL)
+            _mate_mixer_change_set_add_object (changes, G_OBJECT (state->control), flags);
+        else
+            _mate_mixer_change_set_add_name (changes,
+                                             MATE_MIXER_TYPE_STORED_CONTROL,
+                                             state->name,
+                                             flags);
+    }
+
+    /* Controls of removed streams are not reported on their own */
+    for (i = 0; i < cached->streams->len; i++) {
+        if (hanging_streams[i] == TRUE)
+            _mate_mixer_change_set_add_name (changes,
+                                             MATE_MIXER_TYPE_STREAM,
+                                             g_array_index (cached->streams, MateMixerStreamState, i).name,
+                                             MATE_MIXER_CHANGE_REMOVED);
+    }
+
+    for (i = 0; i < cached->controls->len; i++) {
+        MateMixerControlState *state = &g_array_index (cached->controls, MateMixerControlState, i);
+
+        if (hanging_controls[i] == TRUE && state->stream_index == MATE_MIXER_SNAPSHOT_NO_STREAM)
+            _mate_mixer_change_set_add_name (changes,
+                                             MATE_MIXER_TYPE_STORED_CONTROL,
+                                             state->name,
+                                             MATE_MIXER_CHANGE_REMOVED);
+    }
+
+    g_free (hanging_streams);
+    g_free (hanging_controls);
+
+    g_hash_table_destroy (streams);
+    g_hash_table_destroy (stored_controls);
+}
+
+static void
+add_control (MateMixerSnapshot      *snapshot,
+             MateMixerStreamControl *control,
+             guint                   stream_index,
+             gboolean                is_default)
+{
+    MateMixerControlState state;
+
+    _mate_mixer_stream_control_get_state (control, &state, snapshot->volumes);
+
+    state.control      = g_object_ref (control);
+    state.stream_index = stream_index;
+    state.is_default   = is_default;
+
+    g_array_append_val (snapshot->controls, state);
+}
+
+static guint32
+add_string (GString *strings, const gchar *str)
+{
+    guint32 offset;
+
+    if (str == NULL)
+        return SNAPSHOT_FILE_NO_STRING;
+
+    offset = strings->len;
+
+    /* Include the terminating nul character */
+    g_string_append_len (strings, str, strlen (str) + 1);
+    return offset;
+}
+
+static gboolean
+lookup_string (const gchar *strings, guint32 size, guint32 offset, const gchar **str)
+{
+    if (offset == SNAPSHOT_FILE_NO_STRING) {
+        *str = NULL;
+        return TRUE;
+    }
+
+    if (offset >= size)
+        return FALSE;
+
+    *str = strings + offset;
+    return TRUE;
+}
+
+static MateMixerChangeFlags
+compare_control (MateMixerSnapshot           *snapshot,
+                 const MateMixerControlState *state,
+                 MateMixerSnapshot           *cached,
+                 const MateMixerControlState *cached_state)
+{
+    MateMixerChangeFlags flags = MATE_MIXER_CHANGE_NONE;
+
+    if (g_strcmp0 (state->label, cached_state->label) != 0)
+        flags |= MATE_MIXER_CHANGE_LABEL;
+    if (state->mute != cached_state->mute)
+        flags |= MATE_MIXER_CHANGE_MUTE;
+    if (state->balance != cached_state->balance)
+        flags |= MATE_MIXER_CHANGE_BALANCE;
+    if (state->fade != cached_state->fade)
+        flags |= MATE_MIXER_CHANGE_FADE;
+
+    if (state->volume != cached_state->volume ||
+        state->n_channels != cached_state->n_channels ||
+        memcmp (&g_array_index (snapshot->volumes, guint, state->first_channel),
+                &g_array_index (cached->volumes, guint, cached_state->first_channel),
+                state->n_channels * sizeof (guint)) != 0)
+        flags |= MATE_MIXER_CHANGE_VOLUME;
+
+    return flags;
+}
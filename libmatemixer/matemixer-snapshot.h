@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2014 Michal Ratajsky <michal.ratajsky@gmail.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the licence, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MATEMIXER_SNAPSHOT_H
+#define MATEMIXER_SNAPSHOT_H
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include "matemixer-enums.h"
+#include "matemixer-types.h"
+
+G_BEGIN_DECLS
+
+#define MATE_MIXER_TYPE_SNAPSHOT (mate_mixer_snapshot_get_type ())
+
+/**
+ * MATE_MIXER_SNAPSHOT_NO_STREAM:
+ *
+ * The value of the @stream_index field of a #MateMixerControlState which
+ * describes a stored control.
+ */
+#define MATE_MIXER_SNAPSHOT_NO_STREAM G_MAXUINT
+
+/**
+ * MateMixerStreamState:
+ * @stream: the stream or %NULL in a cached snapshot
+ * @name: the name of the stream
+ * @label: the label of the stream
+ * @direction: the direction of the stream
+ * @generation: the generation number of the stream
+ * @is_default: %TRUE if the stream is the default input or output stream
+ * @first_control: index of the first control of the stream in the control array
+ * @n_controls: number of controls of the stream
+ *
+ * The state of a single stream in a #MateMixerSnapshot.
+ */
+struct _MateMixerStreamState
+{
+    MateMixerStream    *stream;
+    const gchar        *name;
+    const gchar        *label;
+    MateMixerDirection  direction;
+    guint               generation;
+    gboolean            is_default;
+    guint               first_control;
+    guint               n_controls;
+};
+
+/**
+ * MateMixerControlState:
+ * @control: the stream control or %NULL in a cached snapshot and for stored
+ * controls which the backend has not created yet
+ * @name: the name of the control
+ * @label: the label of the control
+ * @stream_index: index of the owning stream in the stream array or
+ * %MATE_MIXER_SNAPSHOT_NO_STREAM for stored controls
+ * @flags: the control flags
+ * @generation: the generation number of the control
+ * @is_default: %TRUE if the control is the default control of its stream
+ * @mute: the mute state
+ * @volume: the volume
+ * @balance: the balance, 0.0 when the control cannot change balance
+ * @fade: the fade, 0.0 when the control cannot change fade
+ * @first_channel: index of the volume of the first channel in the channel
+ * volume array
+ * @n_channels: number of channels
+ *
+ * The state of a single stream control in a #MateMixerSnapshot.
+ */
+struct _MateMixerControlState
+{
+    MateMixerStreamControl      *control;
+    const gchar                 *name;
+    const gchar                 *label;
+    guint                        stream_index;
+    MateMixerStreamControlFlags  flags;
+    guint                        generation;
+    gboolean                     is_default;
+    gboolean                     mute;
+    guint                        volume;
+    gfloat                       balance;
+    gfloat                       fade;
+    guint                        first_channel;
+    guint                        n_channels;
+};
+
+GType                        mate_mixer_snapshot_get_type            (void) G_GNUC_CONST;
+
+MateMixerSnapshot *          mate_mixer_snapshot_new                 (void);
+
+MateMixerSnapshot *          mate_mixer_snapshot_ref                 (MateMixerSnapshot *snapshot);
+void                         mate_mixer_snapshot_unref               (MateMixerSnapshot *snapshot);
+
+guint                        mate_mixer_snapshot_get_generation      (MateMixerSnapshot *snapshot);
+
+const MateMixerStreamState * mate_mixer_snapshot_get_streams         (MateMixerSnapshot *snapshot,
+                                                                      guint             *n_streams);
+const MateMixerControlState *mate_mixer_snapshot_get_controls        (MateMixerSnapshot *snapshot,
+                                                                      guint             *n_controls);
+const guint *                mate_mixer_snapshot_get_channel_volumes (MateMixerSnapshot *snapshot,
+                                                                      guint             *n_volumes);
+
+G_END_DECLS
+
+#endif /* MATEMIXER_SNAPSHOT_H */
@@ -21,24 +21,32 @@
 #include <glib.h>
 
 #include "matemixer-enums.h"
+#include "matemixer-snapshot.h"
 #include "matemixer-types.h"
 
 G_BEGIN_DECLS
 
-void _mate_mixer_stream_control_set_flags   (MateMixerStreamControl     *control,
-                                             MateMixerStreamControlFlags flags);
+void _mate_mixer_stream_control_set_flags     (MateMixerStreamControl     *control,
+                                               MateMixerStreamControlFlags flags);
 
-void _mate_mixer_stream_control_set_stream  (MateMixerStreamControl     *control,
-                                             MateMixerStream            *stream);
+void _mate_mixer_stream_control_set_stream    (MateMixerStreamControl     *control,
+                                               MateMixerStream            *stream);
 
-void _mate_mixer_stream_control_set_mute    (MateMixerStreamControl     *control,
-                                             gboolean                    mute);
+void _mate_mixer_stream_control_set_mute      (MateMixerStreamControl     *control,
+                                               gboolean                    mute);
 
-void _mate_mixer_stream_control_set_balance (MateMixerStreamControl     *control,
-                                             gfloat                      balance);
+void _mate_mixer_stream_control_set_balance   (MateMixerStreamControl     *control,
+                                               gfloat                      balance);
 
-void _mate_mixer_stream_control_set_fade    (MateMixerStreamControl     *control,
-                                             gfloat                      fade);
+void _mate_mixer_stream_control_set_fade      (MateMixerStreamControl     *control,
+                                               gfloat                      fade);
+
+void _mate_mixer_stream_control_monitor_frame (MateMixerStreamControl     *control,
+                                               MateMixerMonitorFrame      *frame);
+
+void _mate_mixer_stream_control_get_state     (MateMixerStreamControl     *control,
+                                               MateMixerControlState      *state,
+                                               GArray                     *volumes);
 
 G_END_DECLS
 
@@ -15,11 +15,15 @@
  * License along with this library; if not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <string.h>
 #include <glib.h>
 #include <glib-object.h>
 
 #include "matemixer-enums.h"
 #include "matemixer-enum-types.h"
+#include "matemixer-monitor-buffer.h"
+#include "matemixer-monitor-buffer-private.h"
+#include "matemixer-name-private.h"
 #include "matemixer-stream.h"
 #include "matemixer-stream-control.h"
 #include "matemixer-stream-control-private.h"
@@ -29,9 +33,16 @@
  * @include: libmatemixer/matemixer.h
  */
 
+#define MONITOR_DEFAULT_RATE    25
+#define MONITOR_MAX_RATE       200
+
+/* Number of readings kept in the monitor buffer, about 2.5 seconds at the
+ * default rate */
+#define MONITOR_BUFFER_SIZE     64
+
 struct _MateMixerStreamControlPrivate
 {
-    gchar                          *name;
+    const gchar                    *name;
     gchar                          *label;
     gboolean                        mute;
     gfloat                          balance;
@@ -40,6 +51,10 @@ struct _MateMixerStreamControlPrivate
     MateMixerStreamControlFlags     flags;
     MateMixerStreamControlRole      role;
     MateMixerStreamControlMediaRole media_role;
+    guint                           generation;
+    guint                           monitor_rate;
+    MateMixerMonitorFlags           monitor_flags;
+    MateMixerMonitorBuffer         *monitor_buffer;
 };
 
 enum {
@@ -61,6 +76,7 @@ static GParamSpec *properties[N_PROPERTIES] = { NULL, };
 
 enum {
     MONITOR_VALUE,
+    MONITOR_FRAME,
     N_SIGNALS
 };
 
@@ -82,15 +98,24 @@ static void mate_mixer_stream_control_finalize     (GObject
 
 G_DEFINE_ABSTRACT_TYPE (MateMixerStreamControl, mate_mixer_stream_control, G_TYPE_OBJECT)
 
+G_DEFINE_BOXED_TYPE (MateMixerMonitorFrame, mate_mixer_monitor_frame,
+                     mate_mixer_monitor_frame_copy,
+                     mate_mixer_monitor_frame_free)
+
+static void mate_mixer_stream_control_dispatch_properties_changed (GObject     *object,
+                                                                   guint        n_pspecs,
+                                                                   GParamSpec **pspecs);
+
 static void
 mate_mixer_stream_control_class_init (MateMixerStreamControlClass *klass)
 {
     GObjectClass *object_class;
 
     object_class = G_OBJECT_CLASS (klass);
-    object_class->finalize     = mate_mixer_stream_control_finalize;
-    object_class->get_property = mate_mixer_stream_control_get_property;
-    object_class->set_property = mate_mixer_stream_control_set_property;
+    object_class->finalize                    = mate_mixer_stream_control_finalize;
+    object_class->get_property                = mate_mixer_stream_control_get_property;
+    object_class->set_property                = mate_mixer_stream_control_set_property;
+    object_class->dispatch_properties_changed = mate_mixer_stream_control_dispatch_properties_changed;
 
     properties[PROP_NAME] =
         g_param_spec_string ("name",
@@ -201,6 +226,30 @@ mate_mixer_stream_control_class_init (MateMixerStreamControlClass *klass)
                       1,
                       G_TYPE_DOUBLE);
 
+    /**
+     * MateMixerStreamControl::monitor-frame:
+     * @control: a #MateMixerStreamControl
+     * @frame: a #MateMixerMonitorFrame
+     *
+     * The signal is emitted for each update of the monitor with the levels
+     * selected by mate_mixer_stream_control_set_monitor_flags() and all the
+     * samples the levels were computed from.
+     *
+     * The @frame is only valid during the signal emission, use
+     * mate_mixer_monitor_frame_copy() to keep it.
+     */
+    signals[MONITOR_FRAME] =
+        g_signal_new ("monitor-frame",
+                      G_TYPE_FROM_CLASS (klass),
+                      G_SIGNAL_RUN_FIRST,
+                      G_STRUCT_OFFSET (MateMixerStreamControlClass, monitor_frame),
+                      NULL,
+                      NULL,
+                      g_cclosure_marshal_VOID__BOXED,
+                      G_TYPE_NONE,
+                      1,
+                      MATE_MIXER_TYPE_MONITOR_FRAME | G_SIGNAL_TYPE_STATIC_SCOPE);
+
     g_type_class_add_private (object_class, sizeof (MateMixerStreamControlPrivate));
 }
 
@@ -252,8 +301,8 @@ mate_mixer_stream_control_set_property (GObject      *object,
 
     switch (param_id) {
     case PROP_NAME:
-        /* Construct-only string */
-        control->priv->name = g_value_dup_string (value);
+        /* Construct-only shared name */
+        control->priv->name = _mate_mixer_name_ref (g_value_get_string (value));
         break;
     case PROP_LABEL:
         /* Construct-only string */
@@ -289,6 +338,8 @@ mate_mixer_stream_control_init (MateMixerStreamControl *control)
     control->priv = G_TYPE_INSTANCE_GET_PRIVATE (control,
                                                  MATE_MIXER_TYPE_STREAM_CONTROL,
                                                  MateMixerStreamControlPrivate);
+
+    control->priv->monitor_rate = MONITOR_DEFAULT_RATE;
 }
 
 static void
@@ -298,12 +349,25 @@ mate_mixer_stream_control_finalize (GObject *object)
 
     control = MATE_MIXER_STREAM_CONTROL (object);
 
-    g_free (control->priv->name);
+    _mate_mixer_name_unref (control->priv->name);
     g_free (control->priv->label);
 
+    if (control->priv->monitor_buffer != NULL)
+        mate_mixer_monitor_buffer_unref (control->priv->monitor_buffer);
+
     G_OBJECT_CLASS (mate_mixer_stream_control_parent_class)->finalize (object);
 }
 
+static void
+mate_mixer_stream_control_dispatch_properties_changed (GObject     *object,
+                                                       guint        n_pspecs,
+                                                       GParamSpec **pspecs)
+{
+    MATE_MIXER_STREAM_CONTROL (object)->priv->generation++;
+
+    G_OBJECT_CLASS (mate_mixer_stream_control_parent_class)->dispatch_properties_changed (object, n_pspecs, pspecs);
+}
+
 /**
  * mate_mixer_stream_control_get_name:
  * @control: a #MateMixerStreamControl
@@ -328,6 +392,21 @@ mate_mixer_stream_control_get_label (MateMixerStreamControl *control)
     return control->priv->label;
 }
 
+/**
+ * mate_mixer_stream_control_get_generation:
+ * @control: a #MateMixerStreamControl
+ *
+ * Gets the change counter of the control. The number is incremented each time
+ * a property of the control, such as the volume or mute state, changes.
+ */
+guint
+mate_mixer_stream_control_get_generation (MateMixerStreamControl *control)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control), 0);
+
+    return control->priv->generation;
+}
+
 /**
  * mate_mixer_stream_control_get_flags:
  * @control: a #MateMixerStreamControl
@@ -811,6 +890,224 @@ mate_mixer_stream_control_set_monitor_enabled (MateMixerStreamControl *control,
     return MATE_MIXER_STREAM_CONTROL_GET_CLASS (control)->set_monitor_enabled (control, enabled);
 }
 
+/**
+ * mate_mixer_stream_control_get_monitor_rate:
+ * @control: a #MateMixerStreamControl
+ *
+ * Gets the number of monitor updates per second.
+ *
+ * Returns: the monitor update rate.
+ */
+guint
+mate_mixer_stream_control_get_monitor_rate (MateMixerStreamControl *control)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control), 0);
+
+    return control->priv->monitor_rate;
+}
+
+/**
+ * mate_mixer_stream_control_set_monitor_rate:
+ * @control: a #MateMixerStreamControl
+ * @rate: the number of updates per second
+ *
+ * Sets the number of monitor updates per second, the default is 25. The
+ * rate must be between 1 and 200.
+ *
+ * A running monitor is restarted with the new rate.
+ *
+ * Returns: %TRUE on success or %FALSE on failure.
+ */
+gboolean
+mate_mixer_stream_control_set_monitor_rate (MateMixerStreamControl *control, guint rate)
+{
+    MateMixerStreamControlClass *klass;
+
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control), FALSE);
+    g_return_val_if_fail (rate > 0 && rate <= MONITOR_MAX_RATE, FALSE);
+
+    if ((control->priv->flags & MATE_MIXER_STREAM_CONTROL_HAS_MONITOR) == 0)
+        return FALSE;
+
+    if (control->priv->monitor_rate == rate)
+        return TRUE;
+
+    klass = MATE_MIXER_STREAM_CONTROL_GET_CLASS (control);
+
+    if (klass->set_monitor_options != NULL &&
+        klass->set_monitor_options (control, rate, control->priv->monitor_flags) == FALSE)
+        return FALSE;
+
+    control->priv->monitor_rate = rate;
+    return TRUE;
+}
+
+/**
+ * mate_mixer_stream_control_get_monitor_flags:
+ * @control: a #MateMixerStreamControl
+ *
+ * Gets the flags selecting what the monitor measures.
+ *
+ * Returns: the monitor flags.
+ */
+MateMixerMonitorFlags
+mate_mixer_stream_control_get_monitor_flags (MateMixerStreamControl *control)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control), MATE_MIXER_MONITOR_NONE);
+
+    return control->priv->monitor_flags;
+}
+
+/**
+ * mate_mixer_stream_control_set_monitor_flags:
+ * @control: a #MateMixerStreamControl
+ * @flags: the #MateMixerMonitorFlags
+ *
+ * Selects what the monitor measures, see #MateMixerMonitorFlags. The results
+ * are delivered by the #MateMixerStreamControl::monitor-frame signal, the
+ * #MateMixerStreamControl::monitor-value signal always carries the highest
+ * peak level of all channels.
+ *
+ * A running monitor is restarted with the new flags.
+ *
+ * Returns: %TRUE on success or %FALSE on failure.
+ */
+gboolean
+mate_mixer_stream_control_set_monitor_flags (MateMixerStreamControl *control,
+                                             MateMixerMonitorFlags   flags)
+{
+    MateMixerStreamControlClass *klass;
+
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control), FALSE);
+
+    if ((control->priv->flags & MATE_MIXER_STREAM_CONTROL_HAS_MONITOR) == 0)
+        return FALSE;
+
+    if (control->priv->monitor_flags == flags)
+        return TRUE;
+
+    klass = MATE_MIXER_STREAM_CONTROL_GET_CLASS (control);
+
+    if (klass->set_monitor_options != NULL &&
+        klass->set_monitor_options (control, control->priv->monitor_rate, flags) == FALSE)
+        return FALSE;
+
+    control->priv->monitor_flags = flags;
+    return TRUE;
+}
+
+/**
+ * mate_mixer_stream_control_get_monitor_buffer:
+ * @control: a #MateMixerStreamControl
+ *
+ * Gets a buffer which receives the peak levels of each monitor update in
+ * addition to the #MateMixerStreamControl::monitor-frame signal. The buffer
+ * can be read from any thread at any pace, see #MateMixerMonitorBuffer.
+ *
+ * Where the backend supports it, the readings are added as soon as they are
+ * captured, without waiting for the main loop to deliver the signal.
+ *
+ * The buffer is created by the first call of this function, which must be
+ * made from the thread running the main loop of the #MateMixerContext.
+ * The monitor still has to be enabled using
+ * mate_mixer_stream_control_set_monitor_enabled().
+ *
+ * Returns: (transfer none): a #MateMixerMonitorBuffer or %NULL if the control
+ * does not support monitoring.
+ */
+MateMixerMonitorBuffer *
+mate_mixer_stream_control_get_monitor_buffer (MateMixerStreamControl *control)
+{
+    MateMixerMonitorBuffer *buffer;
+
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control), NULL);
+
+    if ((control->priv->flags & MATE_MIXER_STREAM_CONTROL_HAS_MONITOR) == 0)
+        return NULL;
+
+    buffer = g_atomic_pointer_get (&control->priv->monitor_buffer);
+    if (buffer == NULL) {
+        MateMixerStreamControlClass *klass;
+
+        buffer = _mate_mixer_monitor_buffer_new (MONITOR_BUFFER_SIZE);
+
+        g_atomic_pointer_set (&control->priv->monitor_buffer, buffer);
+
+        /* Let the backend fill the buffer as soon as the levels are measured */
+        klass = MATE_MIXER_STREAM_CONTROL_GET_CLASS (control);
+        if (klass->set_monitor_buffer != NULL)
+            klass->set_monitor_buffer (control, buffer);
+    }
+    return buffer;
+}
+
+/**
+ * mate_mixer_monitor_frame_copy:
+ * @frame: a #MateMixerMonitorFrame
+ *
+ * Makes a copy of @frame including all its values and samples.
+ *
+ * Returns: a newly allocated #MateMixerMonitorFrame, free it with
+ * mate_mixer_monitor_frame_free().
+ */
+MateMixerMonitorFrame *
+mate_mixer_monitor_frame_copy (MateMixerMonitorFrame *frame)
+{
+    MateMixerMonitorFrame *copy;
+    gfloat                *data;
+    gsize                  n;
+
+    g_return_val_if_fail (frame != NULL, NULL);
+
+    /* Keep the structure and all the arrays in a single allocation */
+    n = frame->n_channels * (1 + frame->n_samples);
+    if (frame->rms != NULL)
+        n += frame->n_channels;
+    if (frame->peak_hold != NULL)
+        n += frame->n_channels;
+
+    copy = g_malloc (sizeof (MateMixerMonitorFrame) + n * sizeof (gfloat));
+    data = (gfloat *) (copy + 1);
+
+    copy->n_channels = frame->n_channels;
+    copy->n_samples  = frame->n_samples;
+
+    copy->peak = data;
+    memcpy (data, frame->peak, frame->n_channels * sizeof (gfloat));
+    data += frame->n_channels;
+
+    copy->rms = NULL;
+    if (frame->rms != NULL) {
+        copy->rms = data;
+        memcpy (data, frame->rms, frame->n_channels * sizeof (gfloat));
+        data += frame->n_channels;
+    }
+
+    copy->peak_hold = NULL;
+    if (frame->peak_hold != NULL) {
+        copy->peak_hold = data;
+        memcpy (data, frame->peak_hold, frame->n_channels * sizeof (gfloat));
+        data += frame->n_channels;
+    }
+
+    copy->samples = data;
+    memcpy (data, frame->samples, frame->n_channels * frame->n_samples * sizeof (gfloat));
+
+    return copy;
+}
+
+/**
+ * mate_mixer_monitor_frame_free:
+ * @frame: a #MateMixerMonitorFrame
+ *
+ * Frees a #MateMixerMonitorFrame returned by mate_mixer_monitor_frame_copy().
+ */
+void
+mate_mixer_monitor_frame_free (MateMixerMonitorFrame *frame)
+{
+    g_free (frame);
+}
+
 /**
  * mate_mixer_stream_control_get_min_volume:
  * @control: a #MateMixerStreamControl
@@ -940,3 +1237,86 @@ _mate_mixer_stream_control_set_fade (MateMixerStreamControl *control, gfloat fad
 
     g_object_notify_by_pspec (G_OBJECT (control), properties[PROP_FADE]);
 }
+
+void
+_mate_mixer_stream_control_monitor_frame (MateMixerStreamControl *control,
+                                          MateMixerMonitorFrame  *frame)
+{
+    MateMixerMonitorBuffer *buffer;
+    gfloat                  value = 0.0f;
+    guint                   i;
+
+    g_return_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control));
+    g_return_if_fail (frame != NULL);
+
+    for (i = 0; i < frame->n_channels; i++)
+        if (frame->peak[i] > value)
+            value = frame->peak[i];
+
+    /* Backends which fill the buffer themselves do it with the capture time
+     * of the levels, this signal may be delivered much later */
+    buffer = g_atomic_pointer_get (&control->priv->monitor_buffer);
+    if (buffer != NULL &&
+        MATE_MIXER_STREAM_CONTROL_GET_CLASS (control)->set_monitor_buffer == NULL)
+        _mate_mixer_monitor_buffer_push (buffer,
+                                         g_get_monotonic_time (),
+                                         frame->peak,
+                                         frame->n_channels);
+
+    g_signal_emit (G_OBJECT (control), signals[MONITOR_FRAME], 0, frame);
+    g_signal_emit (G_OBJECT (control), signals[MONITOR_VALUE], 0, (gdouble) value);
+}
+
+void
+_mate_mixer_stream_control_get_state (MateMixerStreamControl *control,
+                                      MateMixerControlState  *state,
+                                      GArray                 *volumes)
+{
+    MateMixerStreamControlClass *klass;
+    guint                       *values;
+    guint                        i;
+
+    g_return_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control));
+    g_return_if_fail (state != NULL);
+    g_return_if_fail (volumes != NULL);
+
+    klass = MATE_MIXER_STREAM_CONTROL_GET_CLASS (control);
+
+    /* Read everything directly to avoid going through the checks of
+     * the public getters for each value */
+    state->name       = control->priv->name;
+    state->label      = control->priv->label;
+    state->flags      = control->priv->flags;
+    state->generation = control->priv->generation;
+    state->mute       = control->priv->mute;
+    state->balance    = (control->priv->flags & MATE_MIXER_STREAM_CONTROL_CAN_BALANCE)
+                        ? control->priv->balance
+                        : 0.0f;
+    state->fade       = (control->priv->flags & MATE_MIXER_STREAM_CONTROL_CAN_FADE)
+                        ? control->priv->fade
+                        : 0.0f;
+
+    state->first_channel = volumes->len;
+    state->n_channels    = (klass->get_num_channels != NULL)
+                           ? klass->get_num_channels (control)
+                           : 0;
+
+    g_array_set_size (volumes, volumes->len + state->n_channels);
+
+    values = &g_array_index (volumes, guint, state->first_channel);
+
+    if (control->priv->flags & MATE_MIXER_STREAM_CONTROL_VOLUME_READABLE) {
+        state->volume = klass->get_volume (control);
+
+        if (klass->get_channel_volumes != NULL)
+            klass->get_channel_volumes (control, values, state->n_channels);
+        else
+            for (i = 0; i < state->n_channels; i++)
+                values[i] = klass->get_channel_volume (control, i);
+    } else {
+        state->volume = klass->get_min_volume (control);
+
+        for (i = 0; i < state->n_channels; i++)
+            values[i] = state->volume;
+    }
+}
@@ -46,6 +46,9 @@ G_BEGIN_DECLS
 #define MATE_MIXER_STREAM_CONTROL_GET_CLASS(o)  \
         (G_TYPE_INSTANCE_GET_CLASS ((o), MATE_MIXER_TYPE_STREAM_CONTROL, MateMixerStreamControlClass))
 
+#define MATE_MIXER_TYPE_MONITOR_FRAME           \
+        (mate_mixer_monitor_frame_get_type ())
+
 typedef struct _MateMixerStreamControlClass    MateMixerStreamControlClass;
 typedef struct _MateMixerStreamControlPrivate  MateMixerStreamControlPrivate;
 
@@ -63,6 +66,30 @@ struct _MateMixerStreamControl
     MateMixerStreamControlPrivate *priv;
 };
 
+/**
+ * MateMixerMonitorFrame:
+ * @n_channels: the number of measured channels
+ * @n_samples: the number of sample frames in @samples
+ * @peak: the peak level of each channel in the range from 0.0 to 1.0
+ * @rms: the RMS level of each channel or %NULL unless %MATE_MIXER_MONITOR_RMS
+ * is enabled
+ * @peak_hold: the held peak level of each channel or %NULL unless
+ * %MATE_MIXER_MONITOR_PEAK_HOLD is enabled
+ * @samples: all the samples read since the last frame, interleaved by channel
+ *
+ * A single update of a stream control monitor, see the
+ * #MateMixerStreamControl::monitor-frame signal.
+ */
+struct _MateMixerMonitorFrame
+{
+    guint   n_channels;
+    guint   n_samples;
+    gfloat *peak;
+    gfloat *rms;
+    gfloat *peak_hold;
+    gfloat *samples;
+};
+
 /**
  * MateMixerStreamControlClass:
  * @parent_class: The parent class.
@@ -99,6 +126,9 @@ struct _MateMixerStreamControlClass
 
     guint                    (*get_channel_volume)   (MateMixerStreamControl  *control,
                                                       guint                    channel);
+    void                     (*get_channel_volumes)  (MateMixerStreamControl  *control,
+                                                      guint                   *volumes,
+                                                      guint                    n_volumes);
     gboolean                 (*set_channel_volume)   (MateMixerStreamControl  *control,
                                                       guint                    channel,
                                                       guint                    volume);
@@ -118,6 +148,11 @@ struct _MateMixerStreamControlClass
     gboolean                 (*get_monitor_enabled)  (MateMixerStreamControl  *control);
     gboolean                 (*set_monitor_enabled)  (MateMixerStreamControl  *control,
                                                       gboolean                 enabled);
+    gboolean                 (*set_monitor_options)  (MateMixerStreamControl  *control,
+                                                      guint                    rate,
+                                                      MateMixerMonitorFlags    flags);
+    void                     (*set_monitor_buffer)   (MateMixerStreamControl  *control,
+                                                      MateMixerMonitorBuffer  *buffer);
 
     guint                    (*get_min_volume)       (MateMixerStreamControl  *control);
     guint                    (*get_max_volume)       (MateMixerStreamControl  *control);
@@ -126,12 +161,19 @@ struct _MateMixerStreamControlClass
 
     /* Signals */
     void (*monitor_value) (MateMixerStreamControl *control, gdouble value);
+    void (*monitor_frame) (MateMixerStreamControl *control, MateMixerMonitorFrame *frame);
 };
 
+GType                           mate_mixer_monitor_frame_get_type              (void) G_GNUC_CONST;
+
+MateMixerMonitorFrame *         mate_mixer_monitor_frame_copy                  (MateMixerMonitorFrame   *frame);
+void                            mate_mixer_monitor_frame_free                  (MateMixerMonitorFrame   *frame);
+
 GType                           mate_mixer_stream_control_get_type             (void) G_GNUC_CONST;
 
 const gchar *                   mate_mixer_stream_control_get_name             (MateMixerStreamControl  *control);
 const gchar *                   mate_mixer_stream_control_get_label            (MateMixerStreamControl  *control);
+guint                           mate_mixer_stream_control_get_generation       (MateMixerStreamControl  *control);
 MateMixerStreamControlFlags     mate_mixer_stream_control_get_flags            (MateMixerStreamControl  *control);
 MateMixerStreamControlRole      mate_mixer_stream_control_get_role             (MateMixerStreamControl  *control);
 MateMixerStreamControlMediaRole mate_mixer_stream_control_get_media_role       (MateMixerStreamControl  *control);
@@ -185,6 +227,16 @@ gboolean                        mate_mixer_stream_control_get_monitor_enabled  (
 gboolean                        mate_mixer_stream_control_set_monitor_enabled  (MateMixerStreamControl  *control,
                                                                                 gboolean                 enabled);
 
+guint                           mate_mixer_stream_control_get_monitor_rate     (MateMixerStreamControl  *control);
+gboolean                        mate_mixer_stream_control_set_monitor_rate     (MateMixerStreamControl  *control,
+                                                                                guint                    rate);
+
+MateMixerMonitorFlags           mate_mixer_stream_control_get_monitor_flags    (MateMixerStreamControl  *control);
+gboolean                        mate_mixer_stream_control_set_monitor_flags    (MateMixerStreamControl  *control,
+                                                                                MateMixerMonitorFlags    flags);
+
+MateMixerMonitorBuffer *        mate_mixer_stream_control_get_monitor_buffer   (MateMixerStreamControl  *control);
+
 guint                           mate_mixer_stream_control_get_min_volume       (MateMixerStreamControl  *control);
 guint                           mate_mixer_stream_control_get_max_volume       (MateMixerStreamControl  *control);
 guint                           mate_mixer_stream_control_get_normal_volume    (MateMixerStreamControl  *control);
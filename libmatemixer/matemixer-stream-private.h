@@ -27,6 +27,13 @@ G_BEGIN_DECLS
 void _mate_mixer_stream_set_default_control (MateMixerStream        *stream,
                                              MateMixerStreamControl *control);
 
+/* Children are removed from the index automatically when the stream emits
+ * the control-removed or switch-removed signal */
+void _mate_mixer_stream_index_control       (MateMixerStream        *stream,
+                                             MateMixerStreamControl *control);
+void _mate_mixer_stream_index_switch        (MateMixerStream        *stream,
+                                             MateMixerStreamSwitch  *swtch);
+
 G_END_DECLS
 
 #endif /* MATEMIXER_STREAM_PRIVATE_H */
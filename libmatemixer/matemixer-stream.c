@@ -15,13 +15,15 @@
  * License along with this library; if not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <string.h>
 #include <glib.h>
 #include <glib-object.h>
 
+#include "matemixer-array-cache-private.h"
 #include "matemixer-device.h"
 #include "matemixer-enums.h"
 #include "matemixer-enum-types.h"
+#include "matemixer-index-private.h"
+#include "matemixer-name-private.h"
 #include "matemixer-stream.h"
 #include "matemixer-stream-control.h"
 #include "matemixer-stream-private.h"
@@ -35,11 +37,16 @@
 
 struct _MateMixerStreamPrivate
 {
-    gchar                  *name;
+    const gchar            *name;
     gchar                  *label;
     MateMixerDirection      direction;
     MateMixerDevice        *device;
     MateMixerStreamControl *control;
+    MateMixerIndex         *controls;
+    MateMixerIndex         *switches;
+    MateMixerArrayCache     controls_array;
+    MateMixerArrayCache     switches_array;
+    guint                   generation;
 };
 
 enum {
@@ -81,11 +88,20 @@ static void mate_mixer_stream_finalize     (GObject              *object);
 
 G_DEFINE_ABSTRACT_TYPE (MateMixerStream, mate_mixer_stream, G_TYPE_OBJECT)
 
+static void mate_mixer_stream_dispatch_properties_changed (GObject     *object,
+                                                           guint        n_pspecs,
+                                                           GParamSpec **pspecs);
+
 static MateMixerStreamControl *mate_mixer_stream_real_get_control (MateMixerStream *stream,
                                                                    const gchar     *name);
 static MateMixerStreamSwitch * mate_mixer_stream_real_get_switch  (MateMixerStream *stream,
                                                                    const gchar     *name);
 
+static void control_added   (MateMixerStream *stream, const gchar *name);
+static void control_removed (MateMixerStream *stream, const gchar *name);
+static void switch_added    (MateMixerStream *stream, const gchar *name);
+static void switch_removed  (MateMixerStream *stream, const gchar *name);
+
 static void
 mate_mixer_stream_class_init (MateMixerStreamClass *klass)
 {
@@ -95,10 +111,11 @@ mate_mixer_stream_class_init (MateMixerStreamClass *klass)
     klass->get_switch  = mate_mixer_stream_real_get_switch;
 
     object_class = G_OBJECT_CLASS (klass);
-    object_class->dispose      = mate_mixer_stream_dispose;
-    object_class->finalize     = mate_mixer_stream_finalize;
-    object_class->get_property = mate_mixer_stream_get_property;
-    object_class->set_property = mate_mixer_stream_set_property;
+    object_class->dispose                     = mate_mixer_stream_dispose;
+    object_class->finalize                    = mate_mixer_stream_finalize;
+    object_class->get_property                = mate_mixer_stream_get_property;
+    object_class->set_property                = mate_mixer_stream_set_property;
+    object_class->dispatch_properties_changed = mate_mixer_stream_dispatch_properties_changed;
 
     properties[PROP_NAME] =
         g_param_spec_string ("name",
@@ -244,8 +261,8 @@ mate_mixer_stream_set_property (GObject      *object,
 
     switch (param_id) {
     case PROP_NAME:
-        /* Construct-only string */
-        stream->priv->name = g_value_dup_string (value);
+        /* Construct-only shared name */
+        stream->priv->name = _mate_mixer_name_ref (g_value_get_string (value));
         break;
     case PROP_LABEL:
         /* Construct-only string */
@@ -279,6 +296,33 @@ mate_mixer_stream_init (MateMixerStream *stream)
     stream->priv = G_TYPE_INSTANCE_GET_PRIVATE (stream,
                                                 MATE_MIXER_TYPE_STREAM,
                                                 MateMixerStreamPrivate);
+
+    stream->priv->controls =
+        _mate_mixer_index_new ((MateMixerIndexNameFunc) mate_mixer_stream_control_get_name);
+    stream->priv->switches =
+        _mate_mixer_index_new ((MateMixerIndexNameFunc) mate_mixer_switch_get_name);
+
+    _mate_mixer_array_cache_init (&stream->priv->controls_array);
+    _mate_mixer_array_cache_init (&stream->priv->switches_array);
+
+    /* Keep the indexes and arrays in sync with the changes announced by
+     * the backend */
+    g_signal_connect (G_OBJECT (stream),
+                      "control-added",
+                      G_CALLBACK (control_added),
+                      NULL);
+    g_signal_connect (G_OBJECT (stream),
+                      "control-removed",
+                      G_CALLBACK (control_removed),
+                      NULL);
+    g_signal_connect (G_OBJECT (stream),
+                      "switch-added",
+                      G_CALLBACK (switch_added),
+                      NULL);
+    g_signal_connect (G_OBJECT (stream),
+                      "switch-removed",
+                      G_CALLBACK (switch_removed),
+                      NULL);
 }
 
 static void
@@ -288,6 +332,12 @@ mate_mixer_stream_dispose (GObject *object)
 
     stream = MATE_MIXER_STREAM (object);
 
+    _mate_mixer_index_clear (stream->priv->controls);
+    _mate_mixer_index_clear (stream->priv->switches);
+
+    _mate_mixer_array_cache_clear (&stream->priv->controls_array);
+    _mate_mixer_array_cache_clear (&stream->priv->switches_array);
+
     g_clear_object (&stream->priv->control);
 
     G_OBJECT_CLASS (mate_mixer_stream_parent_class)->dispose (object);
@@ -300,12 +350,25 @@ mate_mixer_stream_finalize (GObject *object)
 
     stream = MATE_MIXER_STREAM (object);
 
-    g_free (stream->priv->name);
+    _mate_mixer_name_unref (stream->priv->name);
     g_free (stream->priv->label);
 
+    _mate_mixer_index_free (stream->priv->controls);
+    _mate_mixer_index_free (stream->priv->switches);
+
     G_OBJECT_CLASS (mate_mixer_stream_parent_class)->finalize (object);
 }
 
+static void
+mate_mixer_stream_dispatch_properties_changed (GObject     *object,
+                                               guint        n_pspecs,
+                                               GParamSpec **pspecs)
+{
+    MATE_MIXER_STREAM (object)->priv->generation++;
+
+    G_OBJECT_CLASS (mate_mixer_stream_parent_class)->dispatch_properties_changed (object, n_pspecs, pspecs);
+}
+
 /**
  * mate_mixer_stream_get_name:
  * @stream: a #MateMixerStream
@@ -330,6 +393,22 @@ mate_mixer_stream_get_label (MateMixerStream *stream)
     return stream->priv->label;
 }
 
+/**
+ * mate_mixer_stream_get_generation:
+ * @stream: a #MateMixerStream
+ *
+ * Gets the change counter of the stream. The number is incremented each time
+ * a property of the stream changes and each time a control or a switch is added
+ * to or removed from the stream.
+ */
+guint
+mate_mixer_stream_get_generation (MateMixerStream *stream)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM (stream), 0);
+
+    return stream->priv->generation;
+}
+
 /**
  * mate_mixer_stream_get_direction:
  * @stream: a #MateMixerStream
@@ -446,44 +525,112 @@ mate_mixer_stream_list_switches (MateMixerStream *stream)
     return NULL;
 }
 
-static MateMixerStreamControl *
-mate_mixer_stream_real_get_control (MateMixerStream *stream, const gchar *name)
+/**
+ * mate_mixer_stream_dup_controls:
+ * @stream: a #MateMixerStream
+ * @generation: (out) (allow-none): return location for the generation number
+ * of the returned array
+ *
+ * Gets an array of the stream controls. The @generation number changes
+ * whenever a control is added to or removed from the stream. The array is
+ * shared with other callers and must not be modified. It is owned by the
+ * stream and released when the generation changes, use g_ptr_array_ref() to
+ * keep it for longer.
+ *
+ * Returns: (transfer none) (element-type MateMixerStreamControl): a read-only
+ * #GPtrArray of the stream controls.
+ */
+GPtrArray *
+mate_mixer_stream_dup_controls (MateMixerStream *stream, guint *generation)
 {
-    const GList *list;
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM (stream), NULL);
 
+    return _mate_mixer_array_cache_get (&stream->priv->controls_array,
+                                        mate_mixer_stream_list_controls (stream),
+                                        generation);
+}
+
+/**
+ * mate_mixer_stream_dup_switches:
+ * @stream: a #MateMixerStream
+ * @generation: (out) (allow-none): return location for the generation number
+ * of the returned array
+ *
+ * Gets an array of the stream switches. The @generation number changes
+ * whenever a switch is added to or removed from the stream. The array is shared
+ * with other callers and must not be modified. It is owned by the stream and
+ * released when the generation changes, use g_ptr_array_ref() to keep it for
+ * longer.
+ *
+ * Returns: (transfer none) (element-type MateMixerStreamSwitch): a read-only
+ * #GPtrArray of the stream switches.
+ */
+GPtrArray *
+mate_mixer_stream_dup_switches (MateMixerStream *stream, guint *generation)
+{
     g_return_val_if_fail (MATE_MIXER_IS_STREAM (stream), NULL);
-    g_return_val_if_fail (name != NULL, NULL);
 
-    list = mate_mixer_stream_list_controls (stream);
-    while (list != NULL) {
-        MateMixerStreamControl *control = MATE_MIXER_STREAM_CONTROL (list->data);
+    return _mate_mixer_array_cache_get (&stream->priv->switches_array,
+                                        mate_mixer_stream_list_switches (stream),
+                                        generation);
+}
 
-        if (strcmp (name, mate_mixer_stream_control_get_name (control)) == 0)
-            return control;
+static MateMixerStreamControl *
+mate_mixer_stream_real_get_control (MateMixerStream *stream, const gchar *name)
+{
+    g_return_val_if_fail (MATE_MIXER_IS_STREAM (stream), NULL);
+    g_return_val_if_fail (name != NULL, NULL);
 
-        list = list->next;
-    }
-    return NULL;
+    return _mate_mixer_index_lookup (stream->priv->controls,
+                                     name,
+                                     mate_mixer_stream_list_controls (stream));
 }
 
 static MateMixerStreamSwitch *
 mate_mixer_stream_real_get_switch (MateMixerStream *stream, const gchar *name)
 {
-    const GList *list;
-
     g_return_val_if_fail (MATE_MIXER_IS_STREAM (stream), NULL);
     g_return_val_if_fail (name != NULL, NULL);
 
-    list = mate_mixer_stream_list_switches (stream);
-    while (list != NULL) {
-        MateMixerSwitch *swtch = MATE_MIXER_SWITCH (list->data);
+    return _mate_mixer_index_lookup (stream->priv->switches,
+                                     name,
+                                     mate_mixer_stream_list_switches (stream));
+}
 
-        if (strcmp (name, mate_mixer_switch_get_name (swtch)) == 0)
-            return MATE_MIXER_STREAM_SWITCH (swtch);
+static void
+control_added (MateMixerStream *stream, const gchar *name)
+{
+    _mate_mixer_index_added (stream->priv->controls, name);
 
-        list = list->next;
-    }
-    return NULL;
+    _mate_mixer_array_cache_invalidate (&stream->priv->controls_array);
+    stream->priv->generation++;
+}
+
+static void
+control_removed (MateMixerStream *stream, const gchar *name)
+{
+    _mate_mixer_index_remove (stream->priv->controls, name);
+
+    _mate_mixer_array_cache_invalidate (&stream->priv->controls_array);
+    stream->priv->generation++;
+}
+
+static void
+switch_added (MateMixerStream *stream, const gchar *name)
+{
+    _mate_mixer_index_added (stream->priv->switches, name);
+
+    _mate_mixer_array_cache_invalidate (&stream->priv->switches_array);
+    stream->priv->generation++;
+}
+
+static void
+switch_removed (MateMixerStream *stream, const gchar *name)
+{
+    _mate_mixer_index_remove (stream->priv->switches, name);
+
+    _mate_mixer_array_cache_invalidate (&stream->priv->switches_array);
+    stream->priv->generation++;
 }
 
 void
@@ -515,3 +662,30 @@ _mate_mixer_stream_set_default_control (MateMixerStream        *stream,
 
     g_object_notify_by_pspec (G_OBJECT (stream), properties[PROP_DEFAULT_CONTROL]);
 }
+
+void
+_mate_mixer_stream_index_control (MateMixerStream        *stream,
+                                  MateMixerStreamControl *control)
+{
+    g_return_if_fail (MATE_MIXER_IS_STREAM (stream));
+    g_return_if_fail (MATE_MIXER_IS_STREAM_CONTROL (control));
+
+    _mate_mixer_index_add (stream->priv->controls, control);
+
+    /* The main control of a stream is not announced by a signal */
+    _mate_mixer_array_cache_invalidate (&stream->priv->controls_array);
+    stream->priv->generation++;
+}
+
+void
+_mate_mixer_stream_index_switch (MateMixerStream       *stream,
+                                 MateMixerStreamSwitch *swtch)
+{
+    g_return_if_fail (MATE_MIXER_IS_STREAM (stream));
+    g_return_if_fail (MATE_MIXER_IS_STREAM_SWITCH (swtch));
+
+    _mate_mixer_index_add (stream->priv->switches, swtch);
+
+    _mate_mixer_array_cache_invalidate (&stream->priv->switches_array);
+    stream->priv->generation++;
+}
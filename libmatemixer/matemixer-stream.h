@@ -91,6 +91,7 @@ GType                   mate_mixer_stream_get_type            (void) G_GNUC_CONS
 
 const gchar *           mate_mixer_stream_get_name            (MateMixerStream *stream);
 const gchar *           mate_mixer_stream_get_label           (MateMixerStream *stream);
+guint                   mate_mixer_stream_get_generation      (MateMixerStream *stream);
 
 MateMixerDirection      mate_mixer_stream_get_direction       (MateMixerStream *stream);
 
@@ -105,6 +106,11 @@ MateMixerStreamControl *mate_mixer_stream_get_default_control (MateMixerStream *
 const GList *           mate_mixer_stream_list_controls       (MateMixerStream *stream);
 const GList *           mate_mixer_stream_list_switches       (MateMixerStream *stream);
 
+GPtrArray *             mate_mixer_stream_dup_controls        (MateMixerStream *stream,
+                                                               guint           *generation);
+GPtrArray *             mate_mixer_stream_dup_switches        (MateMixerStream *stream,
+                                                               guint           *generation);
+
 G_END_DECLS
 
 #endif /* MATEMIXER_STREAM_H */
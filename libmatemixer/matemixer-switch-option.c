@@ -18,6 +18,7 @@
 #include <glib.h>
 #include <glib-object.h>
 
+#include "matemixer-name-private.h"
 #include "matemixer-switch-option.h"
 #include "matemixer-switch-option-private.h"
 
@@ -28,9 +29,9 @@
 
 struct _MateMixerSwitchOptionPrivate
 {
-    gchar *name;
-    gchar *label;
-    gchar *icon;
+    const gchar *name;
+    gchar       *label;
+    gchar       *icon;
 };
 
 enum {
@@ -157,8 +158,8 @@ mate_mixer_switch_option_set_property (GObject      *object,
 
     switch (param_id) {
     case PROP_NAME:
-        /* Construct-only string */
-        option->priv->name = g_value_dup_string (value);
+        /* Construct-only shared name */
+        option->priv->name = _mate_mixer_name_ref (g_value_get_string (value));
         break;
     case PROP_LABEL:
         /* Construct-only string */
@@ -190,7 +191,7 @@ mate_mixer_switch_option_finalize (GObject *object)
 
     option = MATE_MIXER_SWITCH_OPTION (object);
 
-    g_free (option->priv->name);
+    _mate_mixer_name_unref (option->priv->name);
     g_free (option->priv->label);
     g_free (option->priv->icon);
 
@@ -208,6 +209,9 @@ mate_mixer_switch_option_finalize (GObject *object)
  * of a particular #MateMixerSwitch and may be used to get the #MateMixerSwitchOption
  * using mate_mixer_switch_get_option().
  *
+ * The name is shared with other objects of the same name and it may be
+ * compared by pointer with the names of other objects of the library.
+ *
  * Returns: the name of the switch option.
  */
 const gchar *
@@ -15,12 +15,13 @@
  * License along with this library; if not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <string.h>
 #include <glib.h>
 #include <glib-object.h>
 
 #include "matemixer-enums.h"
 #include "matemixer-enum-types.h"
+#include "matemixer-index-private.h"
+#include "matemixer-name-private.h"
 #include "matemixer-switch.h"
 #include "matemixer-switch-private.h"
 #include "matemixer-switch-option.h"
@@ -32,9 +33,10 @@
 
 struct _MateMixerSwitchPrivate
 {
-    gchar                 *name;
+    const gchar           *name;
     gchar                 *label;
     MateMixerSwitchOption *active;
+    MateMixerIndex        *options;
 };
 
 enum {
@@ -151,8 +153,8 @@ mate_mixer_switch_set_property (GObject      *object,
 
     switch (param_id) {
     case PROP_NAME:
-        /* Construct-only string */
-        swtch->priv->name = g_value_dup_string (value);
+        /* Construct-only shared name */
+        swtch->priv->name = _mate_mixer_name_ref (g_value_get_string (value));
         break;
     case PROP_LABEL:
         /* Construct-only string */
@@ -175,6 +177,11 @@ mate_mixer_switch_init (MateMixerSwitch *swtch)
     swtch->priv = G_TYPE_INSTANCE_GET_PRIVATE (swtch,
                                                MATE_MIXER_TYPE_SWITCH,
                                                MateMixerSwitchPrivate);
+
+    /* Options are fixed for the lifetime of a switch, so the index is only
+     * filled by lookups */
+    swtch->priv->options =
+        _mate_mixer_index_new ((MateMixerIndexNameFunc) mate_mixer_switch_option_get_name);
 }
 
 static void
@@ -184,6 +191,8 @@ mate_mixer_switch_dispose (GObject *object)
 
     swtch = MATE_MIXER_SWITCH (object);
 
+    _mate_mixer_index_clear (swtch->priv->options);
+
     g_clear_object (&swtch->priv->active);
 
     G_OBJECT_CLASS (mate_mixer_switch_parent_class)->dispose (object);
@@ -196,9 +205,11 @@ mate_mixer_switch_finalize (GObject *object)
 
     swtch = MATE_MIXER_SWITCH (object);
 
-    g_free (swtch->priv->name);
+    _mate_mixer_name_unref (swtch->priv->name);
     g_free (swtch->priv->label);
 
+    _mate_mixer_index_free (swtch->priv->options);
+
     G_OBJECT_CLASS (mate_mixer_switch_parent_class)->finalize (object);
 }
 
@@ -211,6 +222,9 @@ mate_mixer_switch_finalize (GObject *object)
  * The name serves as a unique identifier and in most cases it is not in a
  * user-readable form.
  *
+ * The name is shared with other objects of the same name and it may be
+ * compared by pointer with the names of other objects of the library.
+ *
  * Returns: the name of the switch.
  */
 const gchar *
@@ -346,19 +360,10 @@ _mate_mixer_switch_set_active_option (MateMixerSwitch       *swtch,
 static MateMixerSwitchOption *
 mate_mixer_switch_real_get_option (MateMixerSwitch *swtch, const gchar *name)
 {
-    const GList *list;
-
     g_return_val_if_fail (MATE_MIXER_IS_SWITCH (swtch), NULL);
     g_return_val_if_fail (name != NULL, NULL);
 
-    list = mate_mixer_switch_list_options (swtch);
-    while (list != NULL) {
-        MateMixerSwitchOption *option = MATE_MIXER_SWITCH_OPTION (list->data);
-
-        if (strcmp (name, mate_mixer_switch_option_get_name (option)) == 0)
-            return option;
-
-        list = list->next;
-    }
-    return NULL;
+    return _mate_mixer_index_lookup (swtch->priv->options,
+                                     name,
+                                     mate_mixer_switch_list_options (swtch));
 }
@@ -21,12 +21,20 @@
 G_BEGIN_DECLS
 
 typedef struct _MateMixerAppInfo        MateMixerAppInfo;
+typedef struct _MateMixerChange         MateMixerChange;
+typedef struct _MateMixerChangeSet      MateMixerChangeSet;
 typedef struct _MateMixerContext        MateMixerContext;
+typedef struct _MateMixerControlState   MateMixerControlState;
 typedef struct _MateMixerDevice         MateMixerDevice;
 typedef struct _MateMixerDeviceSwitch   MateMixerDeviceSwitch;
+typedef struct _MateMixerMonitorBuffer  MateMixerMonitorBuffer;
+typedef struct _MateMixerMonitorFrame   MateMixerMonitorFrame;
+typedef struct _MateMixerMonitorReading MateMixerMonitorReading;
+typedef struct _MateMixerSnapshot       MateMixerSnapshot;
 typedef struct _MateMixerStoredControl  MateMixerStoredControl;
 typedef struct _MateMixerStream         MateMixerStream;
 typedef struct _MateMixerStreamControl  MateMixerStreamControl;
+typedef struct _MateMixerStreamState    MateMixerStreamState;
 typedef struct _MateMixerStreamSwitch   MateMixerStreamSwitch;
 typedef struct _MateMixerStreamToggle   MateMixerStreamToggle;
 typedef struct _MateMixerSwitch         MateMixerSwitch;
@@ -24,11 +24,14 @@
 #include <libmatemixer/matemixer-types.h>
 
 #include <libmatemixer/matemixer-app-info.h>
+#include <libmatemixer/matemixer-change-set.h>
 #include <libmatemixer/matemixer-context.h>
 #include <libmatemixer/matemixer-device.h>
 #include <libmatemixer/matemixer-device-switch.h>
 #include <libmatemixer/matemixer-enums.h>
 #include <libmatemixer/matemixer-enum-types.h>
+#include <libmatemixer/matemixer-monitor-buffer.h>
+#include <libmatemixer/matemixer-snapshot.h>
 #include <libmatemixer/matemixer-stored-control.h>
 #include <libmatemixer/matemixer-stream.h>
 #include <libmatemixer/matemixer-stream-control.h>